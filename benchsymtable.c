@@ -0,0 +1,1981 @@
+/*--------------------------------------------------------------------*/
+/* benchsymtable.c                                                    */
+/* Author: Tharun Kumar Tiruppali Kalidoss                            */
+/*--------------------------------------------------------------------*/
+
+/* benchsymtable runs a set of named workloads against the SymTable
+   implementation it is linked with, against the same implementation
+   with a bump allocator, and against the C library's hsearch_r and
+   tsearch as baselines. Workloads that clear their table are also run
+   against the SymTable with SymTable_free and SymTable_new in place of
+   SymTable_clear, as are the baselines, which cannot clear a
+   table. Workloads that build their table from arrays of keys and
+   values at once are run against SymTable_fromArrays, and against
+   the SymTable and the baselines putting the keys one at a time.
+   Workloads that merge a second table into theirs are run against
+   SymTable_merge and against a merge made of SymTable_map and
+   SymTable_get, SymTable_put and SymTable_replace. Workloads that
+   copy their table are run against SymTable_clone and against a copy
+   made of SymTable_map and SymTable_put. Workloads that walk their
+   table run SymTable_map over it, which the baselines cannot do. The
+   misses workloads sweep
+   the share of gets for absent keys from none to 99%, and are also
+   run against the SymTable with SymTable_enableFilter. The Zipf
+   workloads, whose gets repeat a few keys, are also run against the
+   SymTable with SymTable_enableCache. The lru workloads fetch keys
+   through a table used as a cache, and are also run against the
+   SymTable made by SymTable_newBounded and against a SymTable whose
+   keys the client evicts in the order they were put, both bounded to
+   a tenth of the keys. The logging workloads are run against the
+   SymTable made by SymTable_openLogged with logs synced after every
+   change, after every 64 and every 4096 changes, and only when the
+   table is closed; their logs are written to the current directory,
+   and the recover and restart workloads time reopening the table
+   from its log and checkpoint. For each workload and table
+   it writes the
+   mean latency per operation, the 50th, 99th and 99.9th percentile
+   latencies, the growth of the peak resident set size, the number of
+   allocations per operation, and, for the SymTable, the bytes that
+   SymTable_memoryUsage reports per binding left at the end of the
+   workload.
+
+   Each run happens in a child process of its own, so that the peak
+   resident set size of one run does not hide that of the next.
+   Allocations are counted by wrapping malloc, calloc and realloc at
+   link time (-Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc), which
+   sees every allocation made by the SymTable and by this file, but not
+   those made inside the C library, such as the tree nodes of
+   tsearch. Every operation is timed on its own, so the latencies
+   include the cost of reading the clock, which is reported first. */
+
+#define _GNU_SOURCE
+#include "symtable.h"
+#include <search.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <stdint.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+/*--------------------------------------------------------------------*/
+
+/* LONG_KEY_LENGTH is the length of the keys of the longkeys
+   workload. MAX_KEY_LENGTH bounds the length of every other key. */
+enum {LONG_KEY_LENGTH = 250, MAX_KEY_LENGTH = 24};
+
+/* OpKind identifies the operation of an Op. */
+enum OpKind {OP_PUT, OP_GET, OP_REMOVE, OP_CLEAR, OP_BUILD, OP_MERGE,
+   OP_CLONE, OP_MAP, OP_FETCH, OP_CHECKPOINT, OP_RECOVER};
+
+/* Op is one operation of a workload. OP_BUILD puts the first
+   uMaxLength keys of the workload at once, and counts as that many
+   operations. OP_MERGE makes a second table of the uMergeCount keys
+   of the workload from uMergeFirst on, which is not measured, then
+   merges it into the table and frees it, and counts as uMergeCount
+   operations. OP_CLONE copies the table and frees the copy, which is
+   not measured, and counts as one operation per key in the table, as
+   does OP_MAP, which visits every binding of the table. OP_FETCH gets
+   the key and puts it if it is absent, as a client of a cache does
+   after computing the value, and is a hit if the get found it.
+   OP_CHECKPOINT writes a checkpoint of a logged table. OP_RECOVER
+   closes a logged table, which is not measured, and reopens it from
+   its log and checkpoint, and counts as one operation per key in the
+   table. */
+struct Op
+{
+   /* eKind is the operation to perform. */
+   enum OpKind eKind;
+   /* pcKey is the key it is performed on, or NULL for OP_CLEAR,
+      OP_BUILD, OP_MERGE, OP_CLONE, OP_MAP, OP_CHECKPOINT and
+      OP_RECOVER. */
+   const char *pcKey;
+};
+
+/* Workload is a named sequence of operations. The first uSetupCount
+   operations build the table and are not measured. */
+struct Workload
+{
+   /* pcName is the name given on the command line. */
+   const char *pcName;
+   /* pcDescription says what the workload does. */
+   const char *pcDescription;
+   /* psOps holds the uOpCount operations. */
+   struct Op *psOps;
+   size_t uOpCount;
+   size_t uSetupCount;
+   /* pcKeys holds the uKeyCount keys, uKeyStride bytes apart. */
+   char *pcKeys;
+   size_t uKeyCount;
+   size_t uKeyStride;
+   /* uMaxLength is the largest number of keys in the table at once. */
+   size_t uMaxLength;
+   /* iCommonPrefix is 1 if the keys differ only in their last few
+      characters. */
+   int iCommonPrefix;
+   /* uMergeFirst and uMergeCount delimit the keys of the table that
+      OP_MERGE merges. */
+   size_t uMergeFirst;
+   size_t uMergeCount;
+   /* iMissSweep is 1 if the workload is one of the misses
+      workloads. */
+   int iMissSweep;
+   /* iSkewed is 1 if the workload is one of the Zipf workloads. */
+   int iSkewed;
+   /* uBound is the number of keys that a bounded table keeps, or 0 if
+      the workload is not run against bounded tables. */
+   size_t uBound;
+   /* iLogging is 1 if the workload is one of the logging
+      workloads. */
+   int iLogging;
+};
+
+/* Table is the interface through which the runner drives a table
+   implementation. pfRemove is NULL if the implementation cannot
+   remove keys. iPrefixHash is 1 if its hash function only sees the
+   first few characters of a key. pfMemoryUsage is NULL if the
+   implementation cannot report the bytes it uses. pfClear is NULL if
+   it cannot empty a table, in which case the table is freed and a new
+   one made instead. iClearOnly is 1 if the entry differs from another
+   only in how it clears, so that it is only run on workloads that
+   clear. pfBuild makes a table from arrays of keys and values, or is
+   NULL if the keys are put one at a time instead. iBuildOnly is 1 if
+   the entry differs from another only in how it builds, so that it is
+   only run on workloads that build. pfMerge moves every binding of
+   pvSrc into pvDst, adding up the values of a key that is in both as
+   counts, and frees pvSrc, or is NULL if the implementation cannot
+   merge. iMergeOnly is 1 if the entry is only run on workloads that
+   merge. pfClone returns a copy of pvTable, or is NULL if the
+   implementation cannot copy a table. iCloneOnly is 1 if the entry is
+   only run on workloads that copy. iFiltered is 1 if the entry makes
+   its tables with SymTable_enableFilter, so that it is only run on
+   the misses workloads. iCached is 1 if the entry makes its tables
+   with SymTable_enableCache, so that it is only run on the Zipf
+   workloads. pfMap visits every binding of pvTable and returns the
+   number it visited, or is NULL if the implementation cannot walk a
+   table. iBounded is 1 if pfNew makes a table that keeps at most the
+   number of keys it is given, evicting the others, so that it is
+   given the bound of the workload and only run on the lru workloads;
+   pfNew then returns NULL if the implementation has no bound.
+   iLogged is 1 if pfNew opens a table with SymTable_openLogged, so
+   that it is only run on the logging workloads, which are the only
+   ones that checkpoint and recover a table. */
+struct Table
+{
+   const char *pcName;
+   int iPrefixHash;
+   void *(*pfNew)(size_t uMaxLength);
+   void (*pfFree)(void *pvTable);
+   int (*pfPut)(void *pvTable, const char *pcKey, void *pvValue);
+   void *(*pfGet)(void *pvTable, const char *pcKey);
+   void *(*pfRemove)(void *pvTable, const char *pcKey);
+   size_t (*pfMemoryUsage)(void *pvTable);
+   void (*pfClear)(void *pvTable);
+   int iClearOnly;
+   void *(*pfBuild)(const char *const *apcKeys,
+      const void *const *apvValues, size_t uCount);
+   int iBuildOnly;
+   void (*pfMerge)(void *pvDst, void *pvSrc);
+   int iMergeOnly;
+   void *(*pfClone)(void *pvTable);
+   int iCloneOnly;
+   int iFiltered;
+   int iCached;
+   size_t (*pfMap)(void *pvTable);
+   int iBounded;
+   int iLogged;
+};
+
+/*--------------------------------------------------------------------*/
+
+/* uAllocCount is the number of calls to malloc, calloc and realloc
+   made so far by the code linked with this file. */
+static size_t uAllocCount = 0;
+
+void *__real_malloc(size_t uSize);
+void *__real_calloc(size_t uCount, size_t uSize);
+void *__real_realloc(void *pvBlock, size_t uSize);
+
+/* Count a call to malloc, then forward it to the C library. */
+
+void *__wrap_malloc(size_t uSize)
+{
+   uAllocCount++;
+   return __real_malloc(uSize);
+}
+
+/* Count a call to calloc, then forward it to the C library. */
+
+void *__wrap_calloc(size_t uCount, size_t uSize)
+{
+   uAllocCount++;
+   return __real_calloc(uCount, uSize);
+}
+
+/* Count a call to realloc, then forward it to the C library. */
+
+void *__wrap_realloc(void *pvBlock, size_t uSize)
+{
+   uAllocCount++;
+   return __real_realloc(pvBlock, uSize);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* uRandomState is the state of nextRandom. */
+static uint64_t uRandomState = 217;
+
+/* Return the next number of a fixed xorshift64* sequence, so that
+   every table sees exactly the same workload. */
+
+static uint64_t nextRandom(void)
+{
+   uRandomState ^= uRandomState >> 12;
+   uRandomState ^= uRandomState << 25;
+   uRandomState ^= uRandomState >> 27;
+   return uRandomState * (uint64_t)0x2545F4914F6CDD1DULL;
+}
+
+/* Return the current time in nanoseconds. */
+
+static uint64_t now(void)
+{
+   struct timespec sTime;
+   clock_gettime(CLOCK_MONOTONIC, &sTime);
+   return (uint64_t)sTime.tv_sec * 1000000000U + (uint64_t)sTime.tv_nsec;
+}
+
+/* Return the resident set size of the process in kilobytes. */
+
+static long currentRss(void)
+{
+   FILE *psFile;
+   long lSize = 0;
+   long lResident = 0;
+
+   psFile = fopen("/proc/self/statm", "r");
+   if (psFile == NULL)
+      return 0;
+   if (fscanf(psFile, "%ld %ld", &lSize, &lResident) != 2)
+      lResident = 0;
+   fclose(psFile);
+   return lResident * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+/* Return the peak resident set size of the process in kilobytes. */
+
+static long peakRss(void)
+{
+   struct rusage sUsage;
+   getrusage(RUSAGE_SELF, &sUsage);
+   return sUsage.ru_maxrss;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* The SymTable implementation this file is linked with. */
+
+static void *symTableNew(size_t uMaxLength)
+{
+   (void)uMaxLength;
+   return SymTable_new();
+}
+
+static void symTableFree(void *pvTable)
+{
+   SymTable_free((SymTable_T)pvTable);
+}
+
+static int symTablePut(void *pvTable, const char *pcKey, void *pvValue)
+{
+   return SymTable_put((SymTable_T)pvTable, pcKey, pvValue);
+}
+
+static void *symTableGet(void *pvTable, const char *pcKey)
+{
+   return SymTable_get((SymTable_T)pvTable, pcKey);
+}
+
+static void *symTableRemove(void *pvTable, const char *pcKey)
+{
+   return SymTable_remove((SymTable_T)pvTable, pcKey);
+}
+
+static size_t symTableMemoryUsage(void *pvTable)
+{
+   return SymTable_memoryUsage((SymTable_T)pvTable);
+}
+
+static void symTableClear(void *pvTable)
+{
+   SymTable_clear((SymTable_T)pvTable);
+}
+
+static void *symTableFromArrays(const char *const *apcKeys,
+   const void *const *apvValues, size_t uCount)
+{
+   return SymTable_fromArrays(apcKeys, apvValues, uCount);
+}
+
+/* Return the sum of the counts pvDstValue and pvSrcValue, which the
+   merge workload stores as integers cast to void*. pcKey and pvExtra
+   are unused. */
+
+static void *addCounts(const char *pcKey, void *pvDstValue,
+   void *pvSrcValue, void *pvExtra)
+{
+   (void)pcKey;
+   (void)pvExtra;
+   return (void*)((uintptr_t)pvDstValue + (uintptr_t)pvSrcValue);
+}
+
+static void symTableMerge(void *pvDst, void *pvSrc)
+{
+   if (! SymTable_merge((SymTable_T)pvDst, (SymTable_T)pvSrc, addCounts,
+      NULL))
+      exit(EXIT_FAILURE);
+   SymTable_free((SymTable_T)pvSrc);
+}
+
+/* Merge the binding (pcKey, pvValue) into the SymTable pvExtra with a
+   lookup and a put or a replace, as SymTable_merge would. */
+
+static void mergeBinding(const char *pcKey, void *pvValue, void *pvExtra)
+{
+   SymTable_T oDst = (SymTable_T)pvExtra;
+   void *pvDstValue;
+
+   pvDstValue = SymTable_get(oDst, pcKey);
+   if (pvDstValue == NULL)
+   {
+      if (! SymTable_put(oDst, pcKey, pvValue))
+         exit(EXIT_FAILURE);
+   }
+   else
+      SymTable_replace(oDst, pcKey,
+         addCounts(pcKey, pvDstValue, pvValue, NULL));
+}
+
+static void symTableMapMerge(void *pvDst, void *pvSrc)
+{
+   SymTable_map((SymTable_T)pvSrc, mergeBinding, pvDst);
+   SymTable_free((SymTable_T)pvSrc);
+}
+
+/* Return a new SymTable with a filter, or one without if the
+   implementation has no filter. */
+
+static void *symTableFilteredNew(size_t uMaxLength)
+{
+   SymTable_T oSymTable;
+
+   (void)uMaxLength;
+   oSymTable = SymTable_new();
+   if (oSymTable != NULL)
+      (void)SymTable_enableFilter(oSymTable);
+   return oSymTable;
+}
+
+/* Return a new SymTable with a recent-lookup cache, or one without if
+   the implementation has no cache. */
+
+static void *symTableCachedNew(size_t uMaxLength)
+{
+   SymTable_T oSymTable;
+
+   (void)uMaxLength;
+   oSymTable = SymTable_new();
+   if (oSymTable != NULL)
+      (void)SymTable_enableCache(oSymTable);
+   return oSymTable;
+}
+
+/* Return 1 if the SymTable implementation has a filter, or 0
+   otherwise. */
+
+static int symTableHasFilter(void)
+{
+   SymTable_T oSymTable;
+   int iFiltered;
+
+   oSymTable = SymTable_new();
+   if (oSymTable == NULL)
+      exit(EXIT_FAILURE);
+   iFiltered = SymTable_enableFilter(oSymTable);
+   SymTable_free(oSymTable);
+   return iFiltered;
+}
+
+/* Return 1 if the SymTable implementation has a recent-lookup cache,
+   or 0 otherwise. */
+
+static int symTableHasCache(void)
+{
+   SymTable_T oSymTable;
+   int iCached;
+
+   oSymTable = SymTable_new();
+   if (oSymTable == NULL)
+      exit(EXIT_FAILURE);
+   iCached = SymTable_enableCache(oSymTable);
+   SymTable_free(oSymTable);
+   return iCached;
+}
+
+static void *symTableClone(void *pvTable)
+{
+   SymTable_T oClone = SymTable_clone((SymTable_T)pvTable);
+   if (oClone == NULL)
+      exit(EXIT_FAILURE);
+   return oClone;
+}
+
+/* Put the binding (pcKey, pvValue) into the SymTable pvExtra. */
+
+static void copyBinding(const char *pcKey, void *pvValue, void *pvExtra)
+{
+   if (! SymTable_put((SymTable_T)pvExtra, pcKey, pvValue))
+      exit(EXIT_FAILURE);
+}
+
+static void *symTableMapClone(void *pvTable)
+{
+   SymTable_T oCopy = SymTable_new();
+   if (oCopy == NULL)
+      exit(EXIT_FAILURE);
+   SymTable_map((SymTable_T)pvTable, copyBinding, oCopy);
+   return oCopy;
+}
+
+/* Count the binding (pcKey, pvValue) in the counter pvExtra. */
+
+static void countBinding(const char *pcKey, void *pvValue, void *pvExtra)
+{
+   (void)pcKey;
+   (void)pvValue;
+   (*(size_t*)pvExtra)++;
+}
+
+static size_t symTableMap(void *pvTable)
+{
+   size_t uCount = 0;
+   SymTable_map((SymTable_T)pvTable, countBinding, &uCount);
+   return uCount;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* The SymTable again, with a bump allocator: every block is carved
+   from the end of a large chunk, and nothing is given back until the
+   table is freed, when the chunks are freed all at once. This is the
+   pool that a table that lives for one compiler pass could use. */
+
+enum {CHUNK_SIZE = 1 << 20, BUMP_ALIGNMENT = 16};
+
+/* Chunk is a block that a BumpTable carves its blocks from. */
+struct Chunk
+{
+   struct Chunk *psNext;
+   /* The union aligns the first block. */
+   union {long double d; void *pv; uint64_t u;} uAligned;
+};
+
+/* BumpTable is a SymTable together with the state of its bump
+   allocator. pcNext and pcEnd delimit the unused part of the newest
+   Chunk. */
+struct BumpTable
+{
+   SymTable_T oSymTable;
+   struct Chunk *psChunks;
+   char *pcNext;
+   char *pcEnd;
+};
+
+/* Return a block of uSize bytes from the BumpTable pvContext, or NULL
+   if there is not enough memory. */
+
+static void *bumpAlloc(size_t uSize, void *pvContext)
+{
+   struct BumpTable *psBump = (struct BumpTable*)pvContext;
+   struct Chunk *psChunk;
+   size_t uChunkSize;
+   void *pvBlock;
+
+   uSize = (uSize + BUMP_ALIGNMENT - 1) & ~(size_t)(BUMP_ALIGNMENT - 1);
+   if ((size_t)(psBump->pcEnd - psBump->pcNext) < uSize)
+   {
+      uChunkSize = uSize > CHUNK_SIZE / 4 ? uSize : CHUNK_SIZE;
+      psChunk = (struct Chunk*)malloc(offsetof(struct Chunk, uAligned)
+         + uChunkSize);
+      if (psChunk == NULL)
+         return NULL;
+      psChunk->psNext = psBump->psChunks;
+      psBump->psChunks = psChunk;
+      /* A large block gets a chunk of its own, and the current chunk
+         stays in use. */
+      if (uChunkSize != CHUNK_SIZE)
+         return &psChunk->uAligned;
+      psBump->pcNext = (char*)&psChunk->uAligned;
+      psBump->pcEnd = psBump->pcNext + CHUNK_SIZE;
+   }
+   pvBlock = psBump->pcNext;
+   psBump->pcNext += uSize;
+   return pvBlock;
+}
+
+/* Free nothing: the blocks of a BumpTable are freed with it. */
+
+static void bumpFree(void *pvBlock, void *pvContext)
+{
+   (void)pvBlock;
+   (void)pvContext;
+}
+
+static void *bumpTableNew(size_t uMaxLength)
+{
+   struct BumpTable *psBump;
+   SymTable_Allocator sAllocator;
+
+   (void)uMaxLength;
+   psBump = (struct BumpTable*)calloc(1, sizeof(struct BumpTable));
+   if (psBump == NULL)
+      return NULL;
+   sAllocator.pfAlloc = bumpAlloc;
+   sAllocator.pfFree = bumpFree;
+   sAllocator.pvContext = psBump;
+   psBump->oSymTable = SymTable_newWithAllocator(&sAllocator);
+   if (psBump->oSymTable == NULL)
+   {
+      free(psBump);
+      return NULL;
+   }
+   return psBump;
+}
+
+static void bumpTableFree(void *pvTable)
+{
+   struct BumpTable *psBump = (struct BumpTable*)pvTable;
+   struct Chunk *psChunk;
+   struct Chunk *psNext;
+
+   SymTable_free(psBump->oSymTable);
+   for (psChunk = psBump->psChunks; psChunk != NULL; psChunk = psNext)
+   {
+      psNext = psChunk->psNext;
+      free(psChunk);
+   }
+   free(psBump);
+}
+
+static int bumpTablePut(void *pvTable, const char *pcKey, void *pvValue)
+{
+   return symTablePut(((struct BumpTable*)pvTable)->oSymTable, pcKey,
+      pvValue);
+}
+
+static void *bumpTableGet(void *pvTable, const char *pcKey)
+{
+   return symTableGet(((struct BumpTable*)pvTable)->oSymTable, pcKey);
+}
+
+static void *bumpTableRemove(void *pvTable, const char *pcKey)
+{
+   return symTableRemove(((struct BumpTable*)pvTable)->oSymTable, pcKey);
+}
+
+static size_t bumpTableMemoryUsage(void *pvTable)
+{
+   return symTableMemoryUsage(((struct BumpTable*)pvTable)->oSymTable);
+}
+
+static void bumpTableClear(void *pvTable)
+{
+   symTableClear(((struct BumpTable*)pvTable)->oSymTable);
+}
+
+static size_t bumpTableMap(void *pvTable)
+{
+   return symTableMap(((struct BumpTable*)pvTable)->oSymTable);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* The SymTable as a cache of at most uBound keys, evicting the least
+   recently used. The values are the workload's keys, so an evicted
+   value needs no freeing. */
+
+static void *symTableBoundedNew(size_t uBound)
+{
+   return SymTable_newBounded(uBound, NULL, NULL);
+}
+
+/* The SymTable as a cache of at most uBound keys that the client
+   evicts itself, as it must without SymTable_newBounded: it keeps the
+   keys in a ring in the order they were put, and removes the oldest
+   once the ring is full. */
+
+/* FifoTable is a SymTable together with the ring of its keys.
+   apcKeys holds the uCount keys of the table, oldest first from
+   uOldest on, and has room for uBound of them. */
+struct FifoTable
+{
+   SymTable_T oSymTable;
+   const char **apcKeys;
+   size_t uBound;
+   size_t uOldest;
+   size_t uCount;
+};
+
+static void *fifoTableNew(size_t uBound)
+{
+   struct FifoTable *psFifo;
+
+   psFifo = (struct FifoTable*)calloc(1, sizeof(struct FifoTable));
+   if (psFifo == NULL)
+      return NULL;
+   psFifo->oSymTable = SymTable_new();
+   psFifo->apcKeys = (const char**)malloc(uBound * sizeof(const char*));
+   if (psFifo->oSymTable == NULL || psFifo->apcKeys == NULL)
+      exit(EXIT_FAILURE);
+   psFifo->uBound = uBound;
+   return psFifo;
+}
+
+static void fifoTableFree(void *pvTable)
+{
+   struct FifoTable *psFifo = (struct FifoTable*)pvTable;
+
+   SymTable_free(psFifo->oSymTable);
+   free(psFifo->apcKeys);
+   free(psFifo);
+}
+
+/* Put pcKey, which must outlive the table, as the workload's keys
+   do, and remove the oldest key if the table is full. */
+
+static int fifoTablePut(void *pvTable, const char *pcKey, void *pvValue)
+{
+   struct FifoTable *psFifo = (struct FifoTable*)pvTable;
+
+   if (! SymTable_put(psFifo->oSymTable, pcKey, pvValue))
+      return 0;
+   if (psFifo->uCount == psFifo->uBound)
+   {
+      (void)SymTable_remove(psFifo->oSymTable,
+         psFifo->apcKeys[psFifo->uOldest]);
+      psFifo->apcKeys[psFifo->uOldest] = pcKey;
+      psFifo->uOldest = (psFifo->uOldest + 1) % psFifo->uBound;
+   }
+   else
+      psFifo->apcKeys[(psFifo->uOldest + psFifo->uCount++)
+         % psFifo->uBound] = pcKey;
+   return 1;
+}
+
+static void *fifoTableGet(void *pvTable, const char *pcKey)
+{
+   return symTableGet(((struct FifoTable*)pvTable)->oSymTable, pcKey);
+}
+
+static size_t fifoTableMemoryUsage(void *pvTable)
+{
+   struct FifoTable *psFifo = (struct FifoTable*)pvTable;
+
+   return symTableMemoryUsage(psFifo->oSymTable)
+      + psFifo->uBound * sizeof(const char*);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* The SymTable made by SymTable_openLogged, which logs every change
+   to LOG_PATH and syncs the log once every batch of changes. The
+   values are the workload's keys, whose addresses are the same in
+   every run, so a recovered table holds the same values. */
+
+/* LOG_PATH is the log of a logged table, and CHECKPOINT_PATH its
+   checkpoint. */
+static const char LOG_PATH[] = "benchsymtable.log";
+static const char CHECKPOINT_PATH[] = "benchsymtable.log.checkpoint";
+
+/* Remove the log and checkpoint of a logged table. */
+
+static void removeLog(void)
+{
+   remove(LOG_PATH);
+   remove(CHECKPOINT_PATH);
+}
+
+/* Return a new logged table that syncs its log once every uBatch
+   changes, or only when it is closed if uBatch is 0. The log left by
+   an earlier run is removed first. Exit if the log cannot be
+   opened. */
+
+static void *loggedTableNew(size_t uBatch)
+{
+   SymTable_T oSymTable;
+
+   removeLog();
+   oSymTable = SymTable_openLogged(LOG_PATH);
+   if (oSymTable == NULL)
+      exit(EXIT_FAILURE);
+   (void)SymTable_setLogBatch(oSymTable, uBatch);
+   return oSymTable;
+}
+
+static void *loggedTableNew1(size_t uMaxLength)
+{
+   (void)uMaxLength;
+   return loggedTableNew(1);
+}
+
+static void *loggedTableNew64(size_t uMaxLength)
+{
+   (void)uMaxLength;
+   return loggedTableNew(64);
+}
+
+static void *loggedTableNew4096(size_t uMaxLength)
+{
+   (void)uMaxLength;
+   return loggedTableNew(4096);
+}
+
+static void *loggedTableNewUnsynced(size_t uMaxLength)
+{
+   (void)uMaxLength;
+   return loggedTableNew(0);
+}
+
+static void loggedTableFree(void *pvTable)
+{
+   SymTable_free((SymTable_T)pvTable);
+   removeLog();
+}
+
+/*--------------------------------------------------------------------*/
+
+/* hsearch_r, an open-addressing table whose size is fixed when it is
+   created and which cannot remove keys. It does not copy its keys,
+   which saves it an allocation per put that the others pay. Its hash
+   function shifts each character four bits further left than the
+   next, so that only the first eight characters of a key survive,
+   and keys with a long common prefix all collide. */
+
+static void *hsearchNew(size_t uMaxLength)
+{
+   struct hsearch_data *psData;
+
+   psData = (struct hsearch_data*)calloc(1, sizeof(struct hsearch_data));
+   if (psData == NULL)
+      return NULL;
+   if (! hcreate_r(uMaxLength + uMaxLength / 4 + 1, psData))
+   {
+      free(psData);
+      return NULL;
+   }
+   return psData;
+}
+
+static void hsearchFree(void *pvTable)
+{
+   hdestroy_r((struct hsearch_data*)pvTable);
+   free(pvTable);
+}
+
+static int hsearchPut(void *pvTable, const char *pcKey, void *pvValue)
+{
+   ENTRY sEntry;
+   ENTRY *psFound;
+
+   sEntry.key = (char*)pcKey;
+   sEntry.data = pvValue;
+   return hsearch_r(sEntry, ENTER, &psFound,
+      (struct hsearch_data*)pvTable) != 0;
+}
+
+static void *hsearchGet(void *pvTable, const char *pcKey)
+{
+   ENTRY sEntry;
+   ENTRY *psFound;
+
+   sEntry.key = (char*)pcKey;
+   sEntry.data = NULL;
+   if (! hsearch_r(sEntry, FIND, &psFound, (struct hsearch_data*)pvTable))
+      return NULL;
+   return psFound->data;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* tsearch, a balanced binary tree. Each key-value pair is a
+   TreeEntry holding a copy of the key, like a SymTable Binding. */
+
+struct TreeEntry
+{
+   void *pvValue;
+   char acKey[1];
+};
+
+/* TreeRoot holds the root of a tsearch tree, so that it can be passed
+   around as a void*. */
+struct TreeRoot
+{
+   void *pvRoot;
+};
+
+static int compareTreeEntries(const void *pvFirst, const void *pvSecond)
+{
+   return strcmp(((const struct TreeEntry*)pvFirst)->acKey,
+      ((const struct TreeEntry*)pvSecond)->acKey);
+}
+
+static void *tsearchNew(size_t uMaxLength)
+{
+   (void)uMaxLength;
+   return calloc(1, sizeof(struct TreeRoot));
+}
+
+static void tsearchFree(void *pvTable)
+{
+   tdestroy(((struct TreeRoot*)pvTable)->pvRoot, free);
+   free(pvTable);
+}
+
+static int tsearchPut(void *pvTable, const char *pcKey, void *pvValue)
+{
+   struct TreeEntry *psEntry;
+   void *pvNode;
+   size_t uLength = strlen(pcKey);
+
+   psEntry = (struct TreeEntry*)malloc(offsetof(struct TreeEntry, acKey)
+      + uLength + 1);
+   if (psEntry == NULL)
+      return 0;
+   memcpy(psEntry->acKey, pcKey, uLength + 1);
+   psEntry->pvValue = pvValue;
+   pvNode = tsearch(psEntry, &((struct TreeRoot*)pvTable)->pvRoot,
+      compareTreeEntries);
+   if (pvNode == NULL || *(struct TreeEntry**)pvNode != psEntry)
+   {
+      free(psEntry);
+      return 0;
+   }
+   return 1;
+}
+
+/* Return the TreeEntry of the tree pvTable whose key is pcKey, or
+   NULL. */
+
+static struct TreeEntry *tsearchEntry(void *pvTable, const char *pcKey)
+{
+   union
+   {
+      struct TreeEntry sEntry;
+      char acBytes[sizeof(struct TreeEntry) + LONG_KEY_LENGTH];
+   } uProbe;
+   void *pvNode;
+
+   assert(strlen(pcKey) <= LONG_KEY_LENGTH);
+   strcpy(uProbe.sEntry.acKey, pcKey);
+   pvNode = tfind(&uProbe.sEntry, &((struct TreeRoot*)pvTable)->pvRoot,
+      compareTreeEntries);
+   if (pvNode == NULL)
+      return NULL;
+   return *(struct TreeEntry**)pvNode;
+}
+
+static void *tsearchGet(void *pvTable, const char *pcKey)
+{
+   struct TreeEntry *psEntry = tsearchEntry(pvTable, pcKey);
+   return psEntry == NULL ? NULL : psEntry->pvValue;
+}
+
+static void *tsearchRemove(void *pvTable, const char *pcKey)
+{
+   struct TreeEntry *psEntry;
+   void *pvValue;
+
+   psEntry = tsearchEntry(pvTable, pcKey);
+   if (psEntry == NULL)
+      return NULL;
+   tdelete(psEntry, &((struct TreeRoot*)pvTable)->pvRoot,
+      compareTreeEntries);
+   pvValue = psEntry->pvValue;
+   free(psEntry);
+   return pvValue;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* TABLES lists the tables that every workload is run against. */
+static const struct Table TABLES[] =
+{
+   {"SymTable", 0, symTableNew, symTableFree, symTablePut, symTableGet,
+      symTableRemove, symTableMemoryUsage, symTableClear, 0,
+      symTableFromArrays, 0, symTableMerge, 0, symTableClone, 0, 0, 0,
+      symTableMap, 0, 0},
+   {"free+new", 0, symTableNew, symTableFree, symTablePut, symTableGet,
+      symTableRemove, symTableMemoryUsage, NULL, 1, NULL, 0, NULL, 0, NULL,
+      0, 0, 0, NULL, 0, 0},
+   {"putloop", 0, symTableNew, symTableFree, symTablePut, symTableGet,
+      symTableRemove, symTableMemoryUsage, symTableClear, 0, NULL, 1, NULL,
+      0, NULL, 0, 0, 0, NULL, 0, 0},
+   {"mapmerge", 0, symTableNew, symTableFree, symTablePut, symTableGet,
+      symTableRemove, symTableMemoryUsage, symTableClear, 0, NULL, 0,
+      symTableMapMerge, 1, NULL, 0, 0, 0, NULL, 0, 0},
+   {"mapclone", 0, symTableNew, symTableFree, symTablePut, symTableGet,
+      symTableRemove, symTableMemoryUsage, symTableClear, 0, NULL, 0, NULL,
+      0, symTableMapClone, 1, 0, 0, NULL, 0, 0},
+   {"filter", 0, symTableFilteredNew, symTableFree, symTablePut,
+      symTableGet, symTableRemove, symTableMemoryUsage, symTableClear, 0,
+      NULL, 0, NULL, 0, NULL, 0, 1, 0, NULL, 0, 0},
+   {"cache", 0, symTableCachedNew, symTableFree, symTablePut,
+      symTableGet, symTableRemove, symTableMemoryUsage, symTableClear, 0,
+      NULL, 0, NULL, 0, NULL, 0, 0, 1, NULL, 0, 0},
+   {"bumpalloc", 0, bumpTableNew, bumpTableFree, bumpTablePut,
+      bumpTableGet, bumpTableRemove, bumpTableMemoryUsage, bumpTableClear,
+      0, NULL, 0, NULL, 0, NULL, 0, 0, 0, bumpTableMap, 0, 0},
+   {"bounded", 0, symTableBoundedNew, symTableFree, symTablePut,
+      symTableGet, NULL, symTableMemoryUsage, NULL, 0, NULL, 0, NULL, 0,
+      NULL, 0, 0, 0, NULL, 1, 0},
+   {"fifo", 0, fifoTableNew, fifoTableFree, fifoTablePut, fifoTableGet,
+      NULL, fifoTableMemoryUsage, NULL, 0, NULL, 0, NULL, 0, NULL, 0, 0, 0,
+      NULL, 1, 0},
+   {"log1", 0, loggedTableNew1, loggedTableFree, symTablePut,
+      symTableGet, symTableRemove, symTableMemoryUsage, NULL, 0, NULL, 0,
+      NULL, 0, NULL, 0, 0, 0, NULL, 0, 1},
+   {"log64", 0, loggedTableNew64, loggedTableFree, symTablePut,
+      symTableGet, symTableRemove, symTableMemoryUsage, NULL, 0, NULL, 0,
+      NULL, 0, NULL, 0, 0, 0, NULL, 0, 1},
+   {"log4096", 0, loggedTableNew4096, loggedTableFree, symTablePut,
+      symTableGet, symTableRemove, symTableMemoryUsage, NULL, 0, NULL, 0,
+      NULL, 0, NULL, 0, 0, 0, NULL, 0, 1},
+   {"lognosync", 0, loggedTableNewUnsynced, loggedTableFree,
+      symTablePut, symTableGet, symTableRemove, symTableMemoryUsage, NULL,
+      0, NULL, 0, NULL, 0, NULL, 0, 0, 0, NULL, 0, 1},
+   {"hsearch_r", 1, hsearchNew, hsearchFree, hsearchPut, hsearchGet, NULL,
+      NULL, NULL, 0, NULL, 0, NULL, 0, NULL, 0, 0, 0, NULL, 0, 0},
+   {"tsearch", 0, tsearchNew, tsearchFree, tsearchPut, tsearchGet,
+      tsearchRemove, NULL, NULL, 0, NULL, 0, NULL, 0, NULL, 0, 0, 0,
+      NULL, 0, 0}
+};
+
+/*--------------------------------------------------------------------*/
+
+/* Allocate a Workload named pcName with room for uOpCount operations
+   and uKeyCount keys of up to uKeyStride-1 characters. Exit if there
+   is not enough memory. */
+
+static struct Workload *newWorkload(const char *pcName,
+   const char *pcDescription, size_t uOpCount, size_t uKeyCount,
+   size_t uKeyStride)
+{
+   struct Workload *psWorkload;
+
+   psWorkload = (struct Workload*)calloc(1, sizeof(struct Workload));
+   if (psWorkload == NULL)
+      exit(EXIT_FAILURE);
+   psWorkload->pcName = pcName;
+   psWorkload->pcDescription = pcDescription;
+   psWorkload->psOps = (struct Op*)malloc(uOpCount * sizeof(struct Op) + 1);
+   psWorkload->pcKeys = (char*)malloc(uKeyCount * uKeyStride + 1);
+   if (psWorkload->psOps == NULL || psWorkload->pcKeys == NULL)
+      exit(EXIT_FAILURE);
+   psWorkload->uKeyCount = uKeyCount;
+   psWorkload->uKeyStride = uKeyStride;
+   return psWorkload;
+}
+
+/* Free psWorkload. */
+
+static void freeWorkload(struct Workload *psWorkload)
+{
+   free(psWorkload->psOps);
+   free(psWorkload->pcKeys);
+   free(psWorkload);
+}
+
+/* Return the uIndex-th key of psWorkload. */
+
+static char *keyAt(struct Workload *psWorkload, size_t uIndex)
+{
+   assert(uIndex < psWorkload->uKeyCount);
+   return psWorkload->pcKeys + uIndex * psWorkload->uKeyStride;
+}
+
+/* Append an operation of kind eKind on the uIndex-th key to
+   psWorkload. uIndex is ignored for OP_CLEAR, OP_BUILD, OP_MERGE,
+   OP_CLONE, OP_MAP, OP_CHECKPOINT and OP_RECOVER. */
+
+static void addOp(struct Workload *psWorkload, enum OpKind eKind,
+   size_t uIndex)
+{
+   psWorkload->psOps[psWorkload->uOpCount].eKind = eKind;
+   psWorkload->psOps[psWorkload->uOpCount].pcKey =
+      eKind == OP_CLEAR || eKind == OP_BUILD || eKind == OP_MERGE
+         || eKind == OP_CLONE || eKind == OP_MAP || eKind == OP_CHECKPOINT
+         || eKind == OP_RECOVER
+         ? NULL : keyAt(psWorkload, uIndex);
+   psWorkload->uOpCount++;
+}
+
+/* Return 1 if psWorkload has an operation of kind eKind, or 0
+   otherwise. */
+
+static int hasOp(const struct Workload *psWorkload, enum OpKind eKind)
+{
+   size_t u;
+
+   for (u = 0; u < psWorkload->uOpCount; u++)
+      if (psWorkload->psOps[u].eKind == eKind)
+         return 1;
+   return 0;
+}
+
+/* Fill puOrder with 0 to uCount-1 in random order. */
+
+static void shuffle(size_t *puOrder, size_t uCount)
+{
+   size_t u;
+   size_t uOther;
+   size_t uSwap;
+
+   for (u = 0; u < uCount; u++)
+      puOrder[u] = u;
+   for (u = uCount; u > 1; u--)
+   {
+      uOther = (size_t)(nextRandom() % u);
+      uSwap = puOrder[u - 1];
+      puOrder[u - 1] = puOrder[uOther];
+      puOrder[uOther] = uSwap;
+   }
+}
+
+/* Return a new array of uCount indexes in random order. Exit if there
+   is not enough memory. */
+
+static size_t *newOrder(size_t uCount)
+{
+   size_t *puOrder = (size_t*)malloc(uCount * sizeof(size_t) + 1);
+   if (puOrder == NULL)
+      exit(EXIT_FAILURE);
+   shuffle(puOrder, uCount);
+   return puOrder;
+}
+
+/* Append to psWorkload a put of each of its first uCount keys in
+   order, then a get of each of them in the order puOrder, or in
+   order if puOrder is NULL. */
+
+static void addPutsAndGets(struct Workload *psWorkload, size_t uCount,
+   const size_t *puOrder)
+{
+   size_t u;
+
+   for (u = 0; u < uCount; u++)
+      addOp(psWorkload, OP_PUT, u);
+   for (u = 0; u < uCount; u++)
+      addOp(psWorkload, OP_GET, puOrder == NULL ? u : puOrder[u]);
+   psWorkload->uMaxLength = uCount;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* The workloads. Each takes the number of bindings uCount and returns
+   a new Workload. */
+
+/* Sequential decimal keys, put and then looked up in order, as in
+   testLargeTable. */
+
+static struct Workload *makeSequentialInts(size_t uCount)
+{
+   struct Workload *psWorkload;
+   size_t u;
+
+   psWorkload = newWorkload("seqints",
+      "put then get sequential decimal keys", 2 * uCount, uCount,
+      MAX_KEY_LENGTH);
+   for (u = 0; u < uCount; u++)
+      sprintf(keyAt(psWorkload, u), "%lu", (unsigned long)u);
+   addPutsAndGets(psWorkload, uCount, NULL);
+   return psWorkload;
+}
+
+/* Random alphanumeric keys of 8 to 23 characters, put and then looked
+   up in random order. */
+
+static struct Workload *makeRandomStrings(size_t uCount)
+{
+   static const char acAlphabet[] =
+      "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789_";
+   struct Workload *psWorkload;
+   size_t *puOrder;
+   size_t uLength;
+   size_t u;
+   size_t v;
+   char *pcKey;
+
+   psWorkload = newWorkload("randstrings",
+      "put then get random 8-23 character keys", 2 * uCount, uCount,
+      MAX_KEY_LENGTH);
+   for (u = 0; u < uCount; u++)
+   {
+      pcKey = keyAt(psWorkload, u);
+      uLength = 8 + (size_t)(nextRandom() % 16);
+      for (v = 0; v < uLength; v++)
+         pcKey[v] = acAlphabet[nextRandom() % (sizeof(acAlphabet) - 1)];
+      pcKey[uLength] = '\0';
+   }
+   puOrder = newOrder(uCount);
+   addPutsAndGets(psWorkload, uCount, puOrder);
+   free(puOrder);
+   return psWorkload;
+}
+
+/* Append to psWorkload uOpCount operations of kind eKind on its
+   first uKeyCount keys, drawn from a Zipf distribution with exponent
+   dExponent, so that a few keys receive most of them, as identifiers
+   do in source code. */
+
+static void addZipfOps(struct Workload *psWorkload, enum OpKind eKind,
+   size_t uKeyCount, size_t uOpCount, double dExponent)
+{
+   double *pdCumulative;
+   double dTotal = 0.0;
+   double dTarget;
+   size_t *puOrder;
+   size_t uLow;
+   size_t uHigh;
+   size_t uMiddle;
+   size_t u;
+
+   pdCumulative = (double*)malloc(uKeyCount * sizeof(double) + 1);
+   if (pdCumulative == NULL)
+      exit(EXIT_FAILURE);
+   for (u = 0; u < uKeyCount; u++)
+   {
+      dTotal += 1.0 / pow((double)(u + 1), dExponent);
+      pdCumulative[u] = dTotal;
+   }
+   /* The ranks are given to random keys so that the popular keys are
+      not neighbours in the table. */
+   puOrder = newOrder(uKeyCount);
+   for (u = 0; u < uOpCount; u++)
+   {
+      dTarget = (double)(nextRandom() >> 11) / 9007199254740992.0 * dTotal;
+      uLow = 0;
+      uHigh = uKeyCount - 1;
+      while (uLow < uHigh)
+      {
+         uMiddle = uLow + (uHigh - uLow) / 2;
+         if (pdCumulative[uMiddle] < dTarget)
+            uLow = uMiddle + 1;
+         else
+            uHigh = uMiddle;
+      }
+      addOp(psWorkload, eKind, puOrder[uLow]);
+   }
+   free(puOrder);
+   free(pdCumulative);
+}
+
+/* uCount gets whose keys follow a Zipf distribution with exponent
+   dExponent. Building the table is not measured. */
+
+static struct Workload *makeZipfWith(size_t uCount, const char *pcName,
+   const char *pcDescription, double dExponent)
+{
+   struct Workload *psWorkload;
+   size_t u;
+
+   psWorkload = newWorkload(pcName, pcDescription, 2 * uCount, uCount,
+      MAX_KEY_LENGTH);
+   psWorkload->iSkewed = 1;
+   for (u = 0; u < uCount; u++)
+   {
+      sprintf(keyAt(psWorkload, u), "%lu", (unsigned long)u);
+      addOp(psWorkload, OP_PUT, u);
+   }
+   psWorkload->uSetupCount = uCount;
+   psWorkload->uMaxLength = uCount;
+   addZipfOps(psWorkload, OP_GET, uCount, uCount, dExponent);
+   return psWorkload;
+}
+
+/* The Zipf distribution of identifiers in source code. */
+
+static struct Workload *makeZipf(size_t uCount)
+{
+   return makeZipfWith(uCount, "zipf", "Zipf(0.99) gets on a full table",
+      0.99);
+}
+
+/* A steeper Zipf distribution, as in a tight loop over a few names. */
+
+static struct Workload *makeHotZipf(size_t uCount)
+{
+   return makeZipfWith(uCount, "hotzipf",
+      "Zipf(1.3) gets on a full table", 1.3);
+}
+
+/* uCount gets on a full table, uMissPercent in a hundred of them for
+   keys that are absent. Building the table is not measured. */
+
+static struct Workload *makeMissSweep(size_t uCount, const char *pcName,
+   const char *pcDescription, unsigned uMissPercent)
+{
+   struct Workload *psWorkload;
+   size_t u;
+
+   psWorkload = newWorkload(pcName, pcDescription, 2 * uCount,
+      2 * uCount, MAX_KEY_LENGTH);
+   psWorkload->iMissSweep = 1;
+   for (u = 0; u < uCount; u++)
+   {
+      sprintf(keyAt(psWorkload, u), "%lu", (unsigned long)u);
+      sprintf(keyAt(psWorkload, uCount + u), "miss%lu", (unsigned long)u);
+      addOp(psWorkload, OP_PUT, u);
+   }
+   psWorkload->uSetupCount = uCount;
+   psWorkload->uMaxLength = uCount;
+   for (u = 0; u < uCount; u++)
+   {
+      if (nextRandom() % 100 >= uMissPercent)
+         addOp(psWorkload, OP_GET, (size_t)(nextRandom() % uCount));
+      else
+         addOp(psWorkload, OP_GET, uCount + (size_t)(nextRandom() % uCount));
+   }
+   return psWorkload;
+}
+
+/* The miss sweep: none, half, nine in ten and 99 in a hundred of the
+   gets are for absent keys. */
+
+static struct Workload *makeHits(size_t uCount)
+{
+   return makeMissSweep(uCount, "misses0",
+      "gets on a full table, no misses", 0);
+}
+
+static struct Workload *makeHalfMisses(size_t uCount)
+{
+   return makeMissSweep(uCount, "misses50",
+      "gets on a full table, 50% misses", 50);
+}
+
+static struct Workload *makeMisses(size_t uCount)
+{
+   return makeMissSweep(uCount, "misses",
+      "gets on a full table, 90% misses", 90);
+}
+
+static struct Workload *makeMostlyMisses(size_t uCount)
+{
+   return makeMissSweep(uCount, "misses99",
+      "gets on a full table, 99% misses", 99);
+}
+
+/* A sliding window of uCount/10 keys: each step puts a new key and
+   removes the oldest, so the table keeps its size while every
+   binding is eventually freed. Filling the first window is not
+   measured. */
+
+static struct Workload *makeChurn(size_t uCount)
+{
+   struct Workload *psWorkload;
+   size_t uWindow = uCount / 10 + 1;
+   size_t u;
+
+   psWorkload = newWorkload("churn", "put a new key, remove the oldest",
+      uWindow + 2 * uCount, uWindow + uCount, MAX_KEY_LENGTH);
+   for (u = 0; u < uWindow + uCount; u++)
+      sprintf(keyAt(psWorkload, u), "%lu", (unsigned long)u);
+   for (u = 0; u < uWindow; u++)
+      addOp(psWorkload, OP_PUT, u);
+   psWorkload->uSetupCount = uWindow;
+   psWorkload->uMaxLength = uWindow + 1;
+   for (u = 0; u < uCount; u++)
+   {
+      addOp(psWorkload, OP_PUT, uWindow + u);
+      addOp(psWorkload, OP_REMOVE, u);
+   }
+   return psWorkload;
+}
+
+/* Keys of LONG_KEY_LENGTH characters that share all but their last
+   few characters, like qualified names, put and then looked up in
+   random order. Hashing and comparing dominate. */
+
+static struct Workload *makeLongKeys(size_t uCount)
+{
+   struct Workload *psWorkload;
+   size_t *puOrder;
+   size_t u;
+   char *pcKey;
+
+   psWorkload = newWorkload("longkeys",
+      "put then get 250-character keys with a common prefix", 2 * uCount,
+      uCount, LONG_KEY_LENGTH + 1);
+   for (u = 0; u < uCount; u++)
+   {
+      pcKey = keyAt(psWorkload, u);
+      memset(pcKey, 'k', LONG_KEY_LENGTH);
+      sprintf(pcKey + LONG_KEY_LENGTH - 12, "%012lu", (unsigned long)u);
+   }
+   puOrder = newOrder(uCount);
+   addPutsAndGets(psWorkload, uCount, puOrder);
+   free(puOrder);
+   psWorkload->iCommonPrefix = 1;
+   return psWorkload;
+}
+
+/* WORKLOADS lists the workloads in the order they are run. */
+/* Return a workload that serves requests with one table: each request
+   puts REQUEST_SIZE keys, gets each of them, and clears the table. */
+
+static struct Workload *makeRequests(size_t uCount)
+{
+   enum {REQUEST_SIZE = 100};
+   struct Workload *psWorkload;
+   size_t uRequestCount = uCount / REQUEST_SIZE + 1;
+   size_t uRequest;
+   size_t u;
+
+   psWorkload = newWorkload("requests",
+      "reuse one table per request of 100 puts and gets",
+      uRequestCount * (2 * REQUEST_SIZE + 1), uCount + REQUEST_SIZE,
+      MAX_KEY_LENGTH);
+   for (u = 0; u < uCount + REQUEST_SIZE; u++)
+      sprintf(keyAt(psWorkload, u), "%lu", (unsigned long)u);
+   psWorkload->uMaxLength = REQUEST_SIZE;
+   for (uRequest = 0; uRequest < uRequestCount; uRequest++)
+   {
+      /* Consecutive requests share half of their keys. */
+      for (u = 0; u < REQUEST_SIZE; u++)
+         addOp(psWorkload, OP_PUT,
+            (uRequest * REQUEST_SIZE / 2 + u) % psWorkload->uKeyCount);
+      for (u = 0; u < REQUEST_SIZE; u++)
+         addOp(psWorkload, OP_GET,
+            (uRequest * REQUEST_SIZE / 2 + u) % psWorkload->uKeyCount);
+      addOp(psWorkload, OP_CLEAR, 0);
+   }
+   return psWorkload;
+}
+
+/* Return a workload that builds a table of uCount random
+   alphanumeric keys of 8 to 23 characters in one operation, as a
+   compiler loads a table of predefined names. */
+
+static struct Workload *makeBuild(size_t uCount)
+{
+   static const char acAlphabet[] =
+      "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789_";
+   struct Workload *psWorkload;
+   size_t uLength;
+   size_t u;
+   size_t v;
+   char *pcKey;
+
+   psWorkload = newWorkload("build",
+      "build a table of random 8-23 character keys at once", 1, uCount,
+      MAX_KEY_LENGTH);
+   for (u = 0; u < uCount; u++)
+   {
+      pcKey = keyAt(psWorkload, u);
+      uLength = 8 + (size_t)(nextRandom() % 16);
+      for (v = 0; v < uLength; v++)
+         pcKey[v] = acAlphabet[nextRandom() % (sizeof(acAlphabet) - 1)];
+      pcKey[uLength] = '\0';
+   }
+   psWorkload->uMaxLength = uCount;
+   addOp(psWorkload, OP_BUILD, 0);
+   return psWorkload;
+}
+
+/* Return a workload that merges a table of uCount word counts into
+   another, as when the tables of several workers are combined. Half
+   of the keys of each table are in the other. Building the first
+   table is not measured. */
+
+static struct Workload *makeMerge(size_t uCount)
+{
+   struct Workload *psWorkload;
+   size_t u;
+
+   psWorkload = newWorkload("merge",
+      "merge a table of counts into another sharing half the keys",
+      uCount + 1, uCount + uCount / 2, MAX_KEY_LENGTH);
+   for (u = 0; u < uCount + uCount / 2; u++)
+      sprintf(keyAt(psWorkload, u), "w%lu", (unsigned long)u);
+   for (u = 0; u < uCount; u++)
+      addOp(psWorkload, OP_PUT, u);
+   psWorkload->uSetupCount = uCount;
+   psWorkload->uMaxLength = uCount + uCount / 2;
+   psWorkload->uMergeFirst = uCount / 2;
+   psWorkload->uMergeCount = uCount;
+   addOp(psWorkload, OP_MERGE, 0);
+   return psWorkload;
+}
+
+/* Return a workload that copies a table of uCount configuration
+   settings CLONE_COUNT times, as a server that gives each request a
+   copy of its configuration to change. Building the table is not
+   measured. */
+
+static struct Workload *makeClone(size_t uCount)
+{
+   enum {CLONE_COUNT = 16};
+   struct Workload *psWorkload;
+   size_t u;
+
+   psWorkload = newWorkload("clone",
+      "copy a table of configuration settings 16 times",
+      uCount + CLONE_COUNT, uCount, MAX_KEY_LENGTH);
+   for (u = 0; u < uCount; u++)
+   {
+      sprintf(keyAt(psWorkload, u), "opt.%lu.%lu",
+         (unsigned long)(u % 97), (unsigned long)u);
+      addOp(psWorkload, OP_PUT, u);
+   }
+   psWorkload->uSetupCount = uCount;
+   psWorkload->uMaxLength = uCount;
+   for (u = 0; u < CLONE_COUNT; u++)
+      addOp(psWorkload, OP_CLONE, 0);
+   return psWorkload;
+}
+
+/* Return a workload that puts uCount keys, removes all but every
+   uKeepEvery-th of them, and then walks the table MAP_COUNT times, as
+   a compiler that dumps its symbols. Filling the table and the
+   removals are not measured. */
+
+static struct Workload *makeMapWith(size_t uCount, const char *pcName,
+   const char *pcDescription, size_t uKeepEvery)
+{
+   enum {MAP_COUNT = 16};
+   struct Workload *psWorkload;
+   size_t uRemoved = 0;
+   size_t u;
+
+   psWorkload = newWorkload(pcName, pcDescription, 2 * uCount + MAP_COUNT,
+      uCount, MAX_KEY_LENGTH);
+   for (u = 0; u < uCount; u++)
+   {
+      sprintf(keyAt(psWorkload, u), "sym%lu", (unsigned long)u);
+      addOp(psWorkload, OP_PUT, u);
+   }
+   for (u = 0; u < uCount; u++)
+      if (u % uKeepEvery != 0)
+      {
+         addOp(psWorkload, OP_REMOVE, u);
+         uRemoved++;
+      }
+   psWorkload->uSetupCount = uCount + uRemoved;
+   psWorkload->uMaxLength = uCount;
+   for (u = 0; u < MAP_COUNT; u++)
+      addOp(psWorkload, OP_MAP, 0);
+   return psWorkload;
+}
+
+static struct Workload *makeMap(size_t uCount)
+{
+   return makeMapWith(uCount, "map", "walk a full table 16 times", 1);
+}
+
+static struct Workload *makeSparseMap(size_t uCount)
+{
+   return makeMapWith(uCount, "sparsemap",
+      "walk a table after removing 90% of its keys, 16 times", 10);
+}
+
+/* 2*uCount fetches of uCount keys whose keys follow a Zipf
+   distribution with exponent dExponent, through a table used as a
+   cache. The bounded tables keep a tenth of the keys, and the others
+   all of them, so the hits column gives the hit ratio of each. */
+
+static struct Workload *makeLruWith(size_t uCount, const char *pcName,
+   const char *pcDescription, double dExponent)
+{
+   struct Workload *psWorkload;
+   size_t u;
+
+   psWorkload = newWorkload(pcName, pcDescription, 2 * uCount, uCount,
+      MAX_KEY_LENGTH);
+   for (u = 0; u < uCount; u++)
+      sprintf(keyAt(psWorkload, u), "%lu", (unsigned long)u);
+   psWorkload->uMaxLength = uCount;
+   psWorkload->uBound = uCount / 10 > 0 ? uCount / 10 : 1;
+   addZipfOps(psWorkload, OP_FETCH, uCount, 2 * uCount, dExponent);
+   return psWorkload;
+}
+
+static struct Workload *makeLru(size_t uCount)
+{
+   return makeLruWith(uCount, "lru",
+      "Zipf(0.99) fetches through a cache of a tenth of the keys", 0.99);
+}
+
+static struct Workload *makeHotLru(size_t uCount)
+{
+   return makeLruWith(uCount, "hotlru",
+      "Zipf(1.3) fetches through a cache of a tenth of the keys", 1.3);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Put a new key and remove the oldest, as in churn, logging every
+   change. */
+
+static struct Workload *makeLogChurn(size_t uCount)
+{
+   struct Workload *psWorkload;
+
+   psWorkload = makeChurn(uCount);
+   psWorkload->pcName = "logchurn";
+   psWorkload->pcDescription =
+      "put a new key, remove the oldest, logging each change";
+   psWorkload->iLogging = 1;
+   return psWorkload;
+}
+
+/* Reopen a table of uCount keys by replaying the log of their puts,
+   or, if iCheckpoint is 1, from a checkpoint of them, and then get
+   every key in random order. */
+
+static struct Workload *makeRecoverWith(size_t uCount, const char *pcName,
+   const char *pcDescription, int iCheckpoint)
+{
+   struct Workload *psWorkload;
+   size_t *puOrder;
+   size_t u;
+
+   psWorkload = newWorkload(pcName, pcDescription, 2 * uCount + 2, uCount,
+      MAX_KEY_LENGTH);
+   for (u = 0; u < uCount; u++)
+      sprintf(keyAt(psWorkload, u), "%lu", (unsigned long)u);
+   for (u = 0; u < uCount; u++)
+      addOp(psWorkload, OP_PUT, u);
+   if (iCheckpoint)
+      addOp(psWorkload, OP_CHECKPOINT, 0);
+   psWorkload->uSetupCount = psWorkload->uOpCount;
+   addOp(psWorkload, OP_RECOVER, 0);
+   puOrder = newOrder(uCount);
+   for (u = 0; u < uCount; u++)
+      addOp(psWorkload, OP_GET, puOrder[u]);
+   free(puOrder);
+   psWorkload->uMaxLength = uCount;
+   psWorkload->iLogging = 1;
+   return psWorkload;
+}
+
+static struct Workload *makeRecover(size_t uCount)
+{
+   return makeRecoverWith(uCount, "recover",
+      "replay a log of puts, then get every key", 0);
+}
+
+static struct Workload *makeRestart(size_t uCount)
+{
+   return makeRecoverWith(uCount, "restart",
+      "map a checkpoint with an empty log, then get every key", 1);
+}
+
+static struct Workload *(*const WORKLOADS[])(size_t uCount) =
+{
+   makeSequentialInts, makeRandomStrings, makeZipf, makeHotZipf,
+   makeHits, makeHalfMisses, makeMisses, makeMostlyMisses, makeChurn,
+   makeLongKeys, makeRequests, makeBuild, makeMerge, makeClone, makeMap,
+   makeSparseMap, makeLru, makeHotLru, makeLogChurn, makeRecover,
+   makeRestart
+};
+
+/*--------------------------------------------------------------------*/
+
+/* Compare the latencies pointed to by pvFirst and pvSecond for
+   qsort. */
+
+static int compareLatencies(const void *pvFirst, const void *pvSecond)
+{
+   uint64_t uFirst = *(const uint64_t*)pvFirst;
+   uint64_t uSecond = *(const uint64_t*)pvSecond;
+   return (uFirst > uSecond) - (uFirst < uSecond);
+}
+
+/* Return the median cost in nanoseconds of reading the clock twice,
+   which every measured latency includes. */
+
+static uint64_t clockOverhead(void)
+{
+   enum {SAMPLE_COUNT = 1001};
+   uint64_t auSamples[SAMPLE_COUNT];
+   uint64_t uStart;
+   int i;
+
+   for (i = 0; i < SAMPLE_COUNT; i++)
+   {
+      uStart = now();
+      auSamples[i] = now() - uStart;
+   }
+   qsort(auSamples, SAMPLE_COUNT, sizeof(uint64_t), compareLatencies);
+   return auSamples[SAMPLE_COUNT / 2];
+}
+
+/* Build a table of the first uMaxLength keys of psWorkload, each
+   bound to itself, with the pfBuild of psTable, or by putting them
+   into the table *ppvTable one at a time if pfBuild is NULL. The keys
+   and values are in apcKeys and apvValues. Return the number of keys
+   added. Exit if there is not enough memory. */
+
+static size_t buildTable(const struct Workload *psWorkload,
+   const struct Table *psTable, void **ppvTable,
+   const char *const *apcKeys, const void *const *apvValues)
+{
+   size_t uAdded = 0;
+   size_t u;
+
+   if (psTable->pfBuild == NULL)
+   {
+      for (u = 0; u < psWorkload->uMaxLength; u++)
+         uAdded += (size_t)(*psTable->pfPut)(*ppvTable, apcKeys[u],
+            (void*)apvValues[u]);
+      return uAdded;
+   }
+   if (*ppvTable != NULL)
+      (*psTable->pfFree)(*ppvTable);
+   *ppvTable = (*psTable->pfBuild)(apcKeys, apvValues,
+      psWorkload->uMaxLength);
+   if (*ppvTable == NULL)
+      exit(EXIT_FAILURE);
+   return psWorkload->uMaxLength;
+}
+
+/* Run psWorkload against psTable and write one line of results to
+   stdout. Write "n/a" instead if psTable cannot perform one of the
+   operations. */
+
+static void runWorkload(const struct Workload *psWorkload,
+   const struct Table *psTable)
+{
+   void *pvTable;
+   uint64_t *puLatencies;
+   uint64_t uTotal = 0;
+   uint64_t uStart;
+   size_t uTimedCount = psWorkload->uOpCount - psWorkload->uSetupCount;
+   size_t uCountedOps = 0;
+   size_t uWeight;
+   size_t uAdded;
+   size_t uAllocsBefore;
+   size_t v;
+   size_t uHits = 0;
+   size_t uLength = 0;
+   size_t u;
+   int iHit;
+   int iBuilds;
+   long lRssBefore;
+   const struct Op *psOp;
+   const char **apcKeys = NULL;
+   const void **apvValues = NULL;
+   void *pvSource;
+   void *pvClone = NULL;
+
+   printf("%-12s %-10s ", psWorkload->pcName, psTable->pcName);
+   if (psWorkload->iCommonPrefix && psTable->iPrefixHash)
+   {
+      printf("n/a (every key collides)\n");
+      return;
+   }
+   if (hasOp(psWorkload, OP_REMOVE) && psTable->pfRemove == NULL)
+   {
+      printf("n/a (no remove)\n");
+      return;
+   }
+   if (hasOp(psWorkload, OP_MERGE) && psTable->pfMerge == NULL)
+   {
+      printf("n/a (no merge)\n");
+      return;
+   }
+   if (hasOp(psWorkload, OP_CLONE) && psTable->pfClone == NULL)
+   {
+      printf("n/a (no clone)\n");
+      return;
+   }
+   if (hasOp(psWorkload, OP_MAP) && psTable->pfMap == NULL)
+   {
+      printf("n/a (no map)\n");
+      return;
+   }
+   if (psTable->iFiltered && ! symTableHasFilter())
+   {
+      printf("n/a (no filter)\n");
+      return;
+   }
+   if (psTable->iCached && ! symTableHasCache())
+   {
+      printf("n/a (no cache)\n");
+      return;
+   }
+   if (hasOp(psWorkload, OP_RECOVER) && ! psTable->iLogged)
+   {
+      printf("n/a (no log)\n");
+      return;
+   }
+
+   puLatencies = (uint64_t*)calloc(uTimedCount + 1, sizeof(uint64_t));
+   if (puLatencies == NULL)
+      exit(EXIT_FAILURE);
+   iBuilds = hasOp(psWorkload, OP_BUILD);
+   if (iBuilds)
+   {
+      apcKeys = (const char**)malloc(psWorkload->uMaxLength
+         * sizeof(const char*) + 1);
+      apvValues = (const void**)malloc(psWorkload->uMaxLength
+         * sizeof(const void*) + 1);
+      if (apcKeys == NULL || apvValues == NULL)
+         exit(EXIT_FAILURE);
+      for (u = 0; u < psWorkload->uMaxLength; u++)
+      {
+         apcKeys[u] = psWorkload->pcKeys + u * psWorkload->uKeyStride;
+         apvValues[u] = apcKeys[u];
+      }
+   }
+   lRssBefore = currentRss();
+   /* A table that is built from arrays is made by the build. */
+   if (iBuilds && psTable->pfBuild != NULL)
+      pvTable = NULL;
+   else if (psTable->iBounded)
+   {
+      pvTable = (*psTable->pfNew)(psWorkload->uBound);
+      if (pvTable == NULL)
+      {
+         printf("n/a (no bound)\n");
+         free(puLatencies);
+         return;
+      }
+   }
+   else
+   {
+      pvTable = (*psTable->pfNew)(psWorkload->uMaxLength);
+      if (pvTable == NULL)
+         exit(EXIT_FAILURE);
+   }
+
+   uAllocsBefore = uAllocCount;
+   for (u = 0; u < psWorkload->uOpCount; u++)
+   {
+      /* Allocations are counted for the measured operations only. */
+      if (u == psWorkload->uSetupCount)
+         uAllocsBefore = uAllocCount;
+      psOp = &psWorkload->psOps[u];
+      uStart = now();
+      switch (psOp->eKind)
+      {
+         case OP_PUT:
+            iHit = (*psTable->pfPut)(pvTable, psOp->pcKey,
+               (void*)psOp->pcKey);
+            uLength += (size_t)iHit;
+            uHits += (size_t)iHit;
+            break;
+         case OP_GET:
+            uHits += (*psTable->pfGet)(pvTable, psOp->pcKey) != NULL;
+            break;
+         case OP_REMOVE:
+            iHit = (*psTable->pfRemove)(pvTable, psOp->pcKey) != NULL;
+            uLength -= (size_t)iHit;
+            uHits += (size_t)iHit;
+            break;
+         case OP_CLEAR:
+            if (psTable->pfClear != NULL)
+               (*psTable->pfClear)(pvTable);
+            else
+            {
+               (*psTable->pfFree)(pvTable);
+               pvTable = (*psTable->pfNew)(psWorkload->uMaxLength);
+               if (pvTable == NULL)
+                  exit(EXIT_FAILURE);
+            }
+            uLength = 0;
+            break;
+         case OP_BUILD:
+            uAdded = buildTable(psWorkload, psTable, &pvTable, apcKeys,
+               apvValues);
+            uLength += uAdded;
+            uHits += uAdded;
+            break;
+         case OP_MERGE:
+            pvSource = (*psTable->pfNew)(psWorkload->uMergeCount);
+            if (pvSource == NULL)
+               exit(EXIT_FAILURE);
+            for (v = 0; v < psWorkload->uMergeCount; v++)
+               (*psTable->pfPut)(pvSource, psWorkload->pcKeys
+                  + (psWorkload->uMergeFirst + v) * psWorkload->uKeyStride,
+                  (void*)(uintptr_t)1);
+            uAllocsBefore = uAllocCount;
+            uStart = now();
+            (*psTable->pfMerge)(pvTable, pvSource);
+            uLength = psWorkload->uMaxLength;
+            break;
+         case OP_CLONE:
+            pvClone = (*psTable->pfClone)(pvTable);
+            break;
+         case OP_MAP:
+            uHits += (*psTable->pfMap)(pvTable) != 0;
+            break;
+         case OP_FETCH:
+            if ((*psTable->pfGet)(pvTable, psOp->pcKey) != NULL)
+               uHits++;
+            else if ((*psTable->pfPut)(pvTable, psOp->pcKey,
+               (void*)psOp->pcKey))
+               uLength++;
+            if (psTable->iBounded && uLength > psWorkload->uBound)
+               uLength = psWorkload->uBound;
+            break;
+         case OP_CHECKPOINT:
+            if (! SymTable_checkpoint((SymTable_T)pvTable))
+               exit(EXIT_FAILURE);
+            break;
+         case OP_RECOVER:
+            SymTable_free((SymTable_T)pvTable);
+            uStart = now();
+            pvTable = SymTable_openLogged(LOG_PATH);
+            if (pvTable == NULL)
+               exit(EXIT_FAILURE);
+            break;
+      }
+      /* A build, a merge, a clone, a map or a recovery is reported as
+         the puts or visits it stands for, each taking an equal share
+         of its time. */
+      if (u >= psWorkload->uSetupCount)
+      {
+         if (psOp->eKind == OP_BUILD)
+            uWeight = psWorkload->uMaxLength;
+         else if (psOp->eKind == OP_MERGE)
+            uWeight = psWorkload->uMergeCount;
+         else if (psOp->eKind == OP_CLONE || psOp->eKind == OP_MAP
+            || psOp->eKind == OP_RECOVER)
+            uWeight = uLength;
+         else
+            uWeight = 1;
+         puLatencies[u - psWorkload->uSetupCount] = now() - uStart;
+         uTotal += puLatencies[u - psWorkload->uSetupCount];
+         puLatencies[u - psWorkload->uSetupCount] /= uWeight;
+         uCountedOps += uWeight;
+      }
+      if (pvClone != NULL)
+      {
+         (*psTable->pfFree)(pvClone);
+         pvClone = NULL;
+      }
+   }
+
+   qsort(puLatencies, uTimedCount, sizeof(uint64_t), compareLatencies);
+   if (uTimedCount == 0)
+      uTimedCount = 1;
+   if (uCountedOps == 0)
+      uCountedOps = 1;
+   printf("%9.1f %7lu %7lu %7lu %9ld %9.2f %9lu",
+      (double)uTotal / (double)uCountedOps,
+      (unsigned long)puLatencies[(uTimedCount - 1) / 2],
+      (unsigned long)puLatencies[(uTimedCount - 1) * 99 / 100],
+      (unsigned long)puLatencies[(uTimedCount - 1) * 999 / 1000],
+      peakRss() - lRssBefore,
+      (double)(uAllocCount - uAllocsBefore) / (double)uCountedOps,
+      (unsigned long)uHits);
+   /* The bytes per binding are those of the bindings left at the end. */
+   if (psTable->pfMemoryUsage != NULL && uLength > 0)
+      printf(" %9.1f\n", (double)(*psTable->pfMemoryUsage)(pvTable)
+         / (double)uLength);
+   else
+      printf(" %9s\n", "-");
+   fflush(stdout);
+
+   (*psTable->pfFree)(pvTable);
+   free(puLatencies);
+   free(apcKeys);
+   free(apvValues);
+}
+
+/* Run psWorkload against psTable in a child process, so that the
+   peak resident set size is that of this run alone, and wait for it
+   to finish. Run it in this process if a child cannot be created. */
+
+static void runInChild(const struct Workload *psWorkload,
+   const struct Table *psTable)
+{
+   pid_t iPid;
+
+   fflush(stdout);
+   iPid = fork();
+   if (iPid == 0)
+   {
+      runWorkload(psWorkload, psTable);
+      exit(0);
+   }
+   if (iPid < 0)
+      runWorkload(psWorkload, psTable);
+   else
+      waitpid(iPid, NULL, 0);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Benchmark the SymTable implementation this program is linked with.
+   argv[1] is the number of bindings of each workload. argv[2], if
+   present, is the name of the only workload to run. Write a table of
+   results to stdout. Exit with EXIT_FAILURE if argv[1] is missing or
+   not numeric. Otherwise return 0. */
+
+int main(int argc, char *argv[])
+{
+   struct Workload *psWorkload;
+   int iBindingCount;
+   size_t uWorkload;
+   size_t uTable;
+
+   if (argc != 2 && argc != 3)
+   {
+      fprintf(stderr, "Usage: %s bindingcount [workload]\n", argv[0]);
+      exit(EXIT_FAILURE);
+   }
+   if (sscanf(argv[1], "%d", &iBindingCount) != 1 || iBindingCount <= 0)
+   {
+      fprintf(stderr, "bindingcount must be a positive number\n");
+      exit(EXIT_FAILURE);
+   }
+
+   printf("%s: %d bindings per workload, clock overhead %lu ns\n",
+      argv[0], iBindingCount, (unsigned long)clockOverhead());
+   printf("%-12s %-10s %9s %7s %7s %7s %9s %9s %9s %9s\n", "workload",
+      "table", "ns/op", "p50", "p99", "p999", "peakRSSkB", "allocs/op",
+      "hits", "B/binding");
+
+   for (uWorkload = 0;
+      uWorkload < sizeof(WORKLOADS) / sizeof(WORKLOADS[0]); uWorkload++)
+   {
+      psWorkload = (*WORKLOADS[uWorkload])((size_t)iBindingCount);
+      if (argc == 2 || strcmp(argv[2], psWorkload->pcName) == 0)
+      {
+         printf("# %s: %s\n", psWorkload->pcName, psWorkload->pcDescription);
+         for (uTable = 0; uTable < sizeof(TABLES) / sizeof(TABLES[0]);
+            uTable++)
+            if ((! TABLES[uTable].iClearOnly || hasOp(psWorkload, OP_CLEAR))
+               && (! TABLES[uTable].iBuildOnly
+                  || hasOp(psWorkload, OP_BUILD))
+               && (! TABLES[uTable].iMergeOnly
+                  || hasOp(psWorkload, OP_MERGE))
+               && (! TABLES[uTable].iCloneOnly
+                  || hasOp(psWorkload, OP_CLONE))
+               && (! TABLES[uTable].iFiltered || psWorkload->iMissSweep)
+               && (! TABLES[uTable].iCached || psWorkload->iSkewed)
+               && (! TABLES[uTable].iBounded || psWorkload->uBound != 0)
+               && (! TABLES[uTable].iLogged || psWorkload->iLogging))
+               runInChild(psWorkload, &TABLES[uTable]);
+      }
+      freeWorkload(psWorkload);
+   }
+   return 0;
+}
@@ -0,0 +1,632 @@
+/*--------------------------------------------------------------------*/
+/* replaysymtable.c                                                   */
+/* Author: Tharun Kumar Tiruppali Kalidoss                            */
+/*--------------------------------------------------------------------*/
+
+/* replaysymtable replays a trace, recorded from a program linked with
+   the tracing layer (see symtabletrace.h), against the SymTable
+   implementation it is linked with, and writes for each traced
+   function the number of calls, the mean latency per call, the 50th,
+   99th and 99.9th percentile latencies, and the number of calls whose
+   result differed from the recorded one. The trace is decoded in full
+   before the replay, so decoding is not timed. Values are not in the
+   trace, so each put or replace passes NULL if the recorded value was
+   NULL and the address of a static object otherwise, and each key
+   inserted by an upsert is bound to that address. A call on a table
+   that the trace never saw made is replayed on a table made up with
+   SymTable_new just before it, and so is every call on a table opened
+   with SymTable_openLogged, since replaying those would change its
+   log; the number of such tables and of the calls made on them is
+   reported last, since their results may well differ from the
+   recorded ones. Every call is timed on its own, so the latencies
+   include the cost of reading the clock, which is reported first.
+   The pairs that follow a fromArrays call are gathered before it is
+   timed, and are not counted as calls. SymTable_save,
+   SymTable_getStats and SymTable_memoryUsage are not traced, as the
+   report says last. */
+
+#define _POSIX_C_SOURCE 200809L
+#include "symtable.h"
+#include "symtabletrace.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <stdint.h>
+#include <time.h>
+
+/*--------------------------------------------------------------------*/
+
+/* A Call is one recorded call, with its key copied into the key
+   block of the replay and NUL-terminated. */
+
+struct Call
+{
+   /* eOp, uTable, uArgument and uResult are those of the record. */
+   SymTableTrace_Op eOp;
+   size_t uTable;
+   size_t uArgument;
+   size_t uResult;
+   /* uKey is the offset of the key in the key block, and uKeyLength
+      its length. */
+   size_t uKey;
+   size_t uKeyLength;
+};
+
+/* A Replay is a decoded trace. */
+
+struct Replay
+{
+   /* psCalls holds the uCallCount calls, in room for uCallCapacity. */
+   struct Call *psCalls;
+   size_t uCallCount;
+   size_t uCallCapacity;
+   /* pcKeys is the key block, holding uKeyBytes bytes in room for
+      uKeyCapacity. */
+   char *pcKeys;
+   size_t uKeyBytes;
+   size_t uKeyCapacity;
+   /* uTableCount is one more than the largest table number. */
+   size_t uTableCount;
+};
+
+/* The Tables of a replay are the tables it has made so far. */
+
+struct Tables
+{
+   /* aoTables holds the table of each number, or NULL. */
+   SymTable_T *aoTables;
+   /* acMadeUp[u] is 1 if table u was made up, and 0 otherwise. */
+   char *acMadeUp;
+   /* uMadeUpTables is the number of tables made up, and
+      uMadeUpCalls the number of calls replayed on them. */
+   size_t uMadeUpTables;
+   size_t uMadeUpCalls;
+};
+
+/* cValue is the object whose address stands in for every value that
+   was not NULL. */
+static char cValue;
+
+/*--------------------------------------------------------------------*/
+
+/* Return the current time in nanoseconds. */
+
+static uint64_t now(void)
+{
+   struct timespec sTime;
+   clock_gettime(CLOCK_MONOTONIC, &sTime);
+   return (uint64_t)sTime.tv_sec * 1000000000U + (uint64_t)sTime.tv_nsec;
+}
+
+/* Compare the latencies pointed to by pvFirst and pvSecond for
+   qsort. */
+
+static int compareLatencies(const void *pvFirst, const void *pvSecond)
+{
+   uint64_t uFirst = *(const uint64_t*)pvFirst;
+   uint64_t uSecond = *(const uint64_t*)pvSecond;
+   return (uFirst > uSecond) - (uFirst < uSecond);
+}
+
+/* Return the median cost in nanoseconds of reading the clock twice,
+   which every measured latency includes. */
+
+static uint64_t clockOverhead(void)
+{
+   enum {SAMPLE_COUNT = 1001};
+   uint64_t auSamples[SAMPLE_COUNT];
+   uint64_t uStart;
+   int i;
+
+   for (i = 0; i < SAMPLE_COUNT; i++)
+   {
+      uStart = now();
+      auSamples[i] = now() - uStart;
+   }
+   qsort(auSamples, SAMPLE_COUNT, sizeof(uint64_t), compareLatencies);
+   return auSamples[SAMPLE_COUNT / 2];
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return pvBlock resized to uCount elements of uSize bytes. Exit if
+   there is not enough memory. */
+
+static void *grow(void *pvBlock, size_t uCount, size_t uSize)
+{
+   if (uCount > (size_t)-1 / uSize)
+      exit(EXIT_FAILURE);
+   pvBlock = realloc(pvBlock, uCount * uSize);
+   if (pvBlock == NULL)
+      exit(EXIT_FAILURE);
+   return pvBlock;
+}
+
+/* Append the record *psRecord to psReplay. */
+
+static void addCall(struct Replay *psReplay,
+   const SymTableTrace_Record *psRecord)
+{
+   struct Call *psCall;
+   size_t uTable;
+
+   if (psReplay->uCallCount == psReplay->uCallCapacity)
+   {
+      psReplay->uCallCapacity = 2 * psReplay->uCallCapacity + 1024;
+      psReplay->psCalls = (struct Call*)grow(psReplay->psCalls,
+         psReplay->uCallCapacity, sizeof(struct Call));
+   }
+   while (psReplay->uKeyCapacity - psReplay->uKeyBytes
+      <= psRecord->uKeyLength)
+   {
+      psReplay->uKeyCapacity = 2 * psReplay->uKeyCapacity + 65536;
+      psReplay->pcKeys = (char*)grow(psReplay->pcKeys,
+         psReplay->uKeyCapacity, 1);
+   }
+
+   psCall = &psReplay->psCalls[psReplay->uCallCount++];
+   psCall->eOp = psRecord->eOp;
+   psCall->uTable = psRecord->uTable;
+   psCall->uArgument = psRecord->uArgument;
+   psCall->uResult = psRecord->uResult;
+   psCall->uKey = psReplay->uKeyBytes;
+   psCall->uKeyLength = psRecord->uKeyLength;
+   if (psRecord->uKeyLength > 0)
+      memcpy(psReplay->pcKeys + psReplay->uKeyBytes, psRecord->pcKey,
+         psRecord->uKeyLength);
+   psReplay->pcKeys[psReplay->uKeyBytes + psRecord->uKeyLength] = '\0';
+   psReplay->uKeyBytes += psRecord->uKeyLength + 1;
+
+   /* A clone's or snapshot's number is its argument, and a merge's
+      second table is half of it. */
+   uTable = psRecord->uTable;
+   if ((psRecord->eOp == SYMTABLETRACE_CLONE
+         || psRecord->eOp == SYMTABLETRACE_SNAPSHOT)
+      && psRecord->uArgument > uTable)
+      uTable = psRecord->uArgument;
+   if (psRecord->eOp == SYMTABLETRACE_MERGE
+      && psRecord->uArgument / 2 > uTable)
+      uTable = psRecord->uArgument / 2;
+   if (uTable >= psReplay->uTableCount)
+      psReplay->uTableCount = uTable + 1;
+}
+
+/* Read the trace file pcPath into psReplay. Exit if it cannot be
+   read, and warn if it is damaged. */
+
+static void loadTrace(const char *pcPath, struct Replay *psReplay)
+{
+   SymTableTrace_T oTrace;
+   SymTableTrace_Record sRecord;
+   int iStatus;
+
+   memset(psReplay, 0, sizeof(*psReplay));
+   psReplay->uTableCount = 1;
+   oTrace = SymTableTrace_open(pcPath);
+   if (oTrace == NULL)
+   {
+      fprintf(stderr, "%s is not a readable trace\n", pcPath);
+      exit(EXIT_FAILURE);
+   }
+   while ((iStatus = SymTableTrace_next(oTrace, &sRecord)) == 1)
+      addCall(psReplay, &sRecord);
+   if (iStatus < 0)
+      fprintf(stderr, "%s is damaged after %lu calls; replaying those\n",
+         pcPath, (unsigned long)psReplay->uCallCount);
+   SymTableTrace_close(oTrace);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Do nothing; the function passed to SymTable_map. */
+
+static void visitBinding(const char *pcKey, void *pvValue,
+   void *pvExtra)
+{
+   (void)pcKey;
+   (void)pvValue;
+   (void)pvExtra;
+}
+
+/* Return pvSrcValue; the function passed to SymTable_merge. */
+
+static void *combineValues(const char *pcKey, void *pvDstValue,
+   void *pvSrcValue, void *pvExtra)
+{
+   (void)pcKey;
+   (void)pvDstValue;
+   (void)pvExtra;
+   return pvSrcValue;
+}
+
+/* Return a block of uSize bytes from malloc; the allocation function
+   of sAllocator. */
+
+static void *allocateBlock(size_t uSize, void *pvContext)
+{
+   (void)pvContext;
+   return malloc(uSize);
+}
+
+/* Free pvBlock; the freeing function of sAllocator. */
+
+static void freeBlock(void *pvBlock, void *pvContext)
+{
+   (void)pvContext;
+   free(pvBlock);
+}
+
+/* sAllocator is the allocator passed to SymTable_newWithAllocator. */
+static const SymTable_Allocator sAllocator = {allocateBlock, freeBlock,
+   NULL};
+
+/* Return 1 if eOp makes the table it is recorded with, and 0
+   otherwise. */
+
+static int makesTable(SymTableTrace_Op eOp)
+{
+   switch (eOp)
+   {
+      case SYMTABLETRACE_NEW: case SYMTABLETRACE_NEWWITHCAPACITY:
+      case SYMTABLETRACE_NEWWITHALLOCATOR: case SYMTABLETRACE_NEWBOUNDED:
+      case SYMTABLETRACE_FROMARRAYS: case SYMTABLETRACE_OPENMAPPED:
+      case SYMTABLETRACE_OPENLOGGED:
+         return 1;
+      default:
+         return 0;
+   }
+}
+
+/* Return table uTable of psTables, making it up with SymTable_new if
+   it does not exist. Count the call being replayed on it if it is made
+   up. */
+
+static SymTable_T tableOf(struct Tables *psTables, size_t uTable)
+{
+   if (psTables->aoTables[uTable] == NULL)
+   {
+      psTables->aoTables[uTable] = SymTable_new();
+      if (psTables->aoTables[uTable] == NULL)
+         exit(EXIT_FAILURE);
+      psTables->acMadeUp[uTable] = 1;
+      psTables->uMadeUpTables++;
+   }
+   if (psTables->acMadeUp[uTable])
+      psTables->uMadeUpCalls++;
+   return psTables->aoTables[uTable];
+}
+
+/* Return the result of an upsert that returned ppvSlot and stored
+   iInserted, as it is recorded, binding an inserted key to
+   &cValue. */
+
+static size_t upsertResult(void **ppvSlot, int iInserted)
+{
+   if (ppvSlot == NULL)
+      return 0;
+   if (! iInserted)
+      return 1;
+   *ppvSlot = &cValue;
+   return 2;
+}
+
+/* Replay call uCall of psReplay on psTables, making its tables first
+   if they do not exist, and return its result as it is recorded.
+   Store in *puStart the time at which the call itself began. */
+
+static size_t replayCall(const struct Replay *psReplay, size_t uCall,
+   struct Tables *psTables, uint64_t *puStart)
+{
+   const struct Call *psCall = &psReplay->psCalls[uCall];
+   const char *pcKey = psReplay->pcKeys + psCall->uKey;
+   SymTable_T *aoTables = psTables->aoTables;
+   SymTable_T oSymTable = NULL;
+   SymTable_T oSource = NULL;
+   const void *pvValue = psCall->uArgument ? &cValue : NULL;
+   const char **apcKeys = NULL;
+   const void **apvValues = NULL;
+   void **ppvSlot;
+   int iInserted;
+   size_t uResult = 0;
+   size_t uPairs = 0;
+
+   if (! makesTable(psCall->eOp))
+      oSymTable = tableOf(psTables, psCall->uTable);
+   if (psCall->eOp == SYMTABLETRACE_MERGE)
+      oSource = tableOf(psTables, psCall->uArgument / 2);
+   if (psCall->eOp == SYMTABLETRACE_FROMARRAYS)
+   {
+      apcKeys = (const char**)grow(NULL, psCall->uArgument + 1,
+         sizeof(const char*));
+      apvValues = (const void**)grow(NULL, psCall->uArgument + 1,
+         sizeof(const void*));
+      /* A damaged trace may hold fewer pairs than were passed. */
+      while (uPairs < psCall->uArgument
+         && uCall + 1 + uPairs < psReplay->uCallCount
+         && psCall[1 + uPairs].eOp == SYMTABLETRACE_FROMARRAYSPAIR)
+      {
+         apcKeys[uPairs] = psReplay->pcKeys + psCall[1 + uPairs].uKey;
+         apvValues[uPairs] = psCall[1 + uPairs].uArgument ? &cValue
+            : NULL;
+         uPairs++;
+      }
+   }
+
+   *puStart = now();
+   switch (psCall->eOp)
+   {
+      case SYMTABLETRACE_NEW:
+         oSymTable = SymTable_new();
+         uResult = oSymTable != NULL;
+         break;
+      case SYMTABLETRACE_NEWWITHCAPACITY:
+         oSymTable = SymTable_newWithCapacity(psCall->uArgument);
+         uResult = oSymTable != NULL;
+         break;
+      case SYMTABLETRACE_RESERVE:
+         uResult = (size_t)SymTable_reserve(oSymTable, psCall->uArgument);
+         break;
+      case SYMTABLETRACE_FREE:
+         SymTable_free(oSymTable);
+         oSymTable = NULL;
+         break;
+      case SYMTABLETRACE_GETLENGTH:
+         uResult = SymTable_getLength(oSymTable);
+         break;
+      case SYMTABLETRACE_PUT:
+         uResult = (size_t)SymTable_put(oSymTable, pcKey, pvValue);
+         break;
+      case SYMTABLETRACE_PUTBORROWED:
+         uResult = (size_t)SymTable_putBorrowed(oSymTable, pcKey, pvValue);
+         break;
+      case SYMTABLETRACE_REPLACE:
+         uResult = SymTable_replace(oSymTable, pcKey, pvValue) != NULL;
+         break;
+      case SYMTABLETRACE_UPSERT:
+         ppvSlot = SymTable_upsert(oSymTable, pcKey, &iInserted);
+         uResult = upsertResult(ppvSlot, iInserted);
+         break;
+      case SYMTABLETRACE_PUTN:
+         uResult = (size_t)SymTable_putN(oSymTable, pcKey,
+            psCall->uKeyLength, pvValue);
+         break;
+      case SYMTABLETRACE_REPLACEN:
+         uResult = SymTable_replaceN(oSymTable, pcKey, psCall->uKeyLength,
+            pvValue) != NULL;
+         break;
+      case SYMTABLETRACE_UPSERTN:
+         ppvSlot = SymTable_upsertN(oSymTable, pcKey, psCall->uKeyLength,
+            &iInserted);
+         uResult = upsertResult(ppvSlot, iInserted);
+         break;
+      case SYMTABLETRACE_CONTAINSN:
+         uResult = (size_t)SymTable_containsN(oSymTable, pcKey,
+            psCall->uKeyLength);
+         break;
+      case SYMTABLETRACE_GETN:
+         uResult = SymTable_getN(oSymTable, pcKey, psCall->uKeyLength)
+            != NULL;
+         break;
+      case SYMTABLETRACE_REMOVEN:
+         uResult = SymTable_removeN(oSymTable, pcKey, psCall->uKeyLength)
+            != NULL;
+         break;
+      case SYMTABLETRACE_CONTAINS:
+         uResult = (size_t)SymTable_contains(oSymTable, pcKey);
+         break;
+      case SYMTABLETRACE_GET:
+         uResult = SymTable_get(oSymTable, pcKey) != NULL;
+         break;
+      case SYMTABLETRACE_REMOVE:
+         uResult = SymTable_remove(oSymTable, pcKey) != NULL;
+         break;
+      case SYMTABLETRACE_MAP:
+         SymTable_map(oSymTable, visitBinding, NULL);
+         break;
+      case SYMTABLETRACE_CLONE:
+         aoTables[psCall->uArgument] = SymTable_clone(oSymTable);
+         uResult = aoTables[psCall->uArgument] != NULL;
+         break;
+      case SYMTABLETRACE_CLEAR:
+         SymTable_clear(oSymTable);
+         break;
+      case SYMTABLETRACE_NEWWITHALLOCATOR:
+         oSymTable = SymTable_newWithAllocator(&sAllocator);
+         uResult = oSymTable != NULL;
+         break;
+      case SYMTABLETRACE_NEWBOUNDED:
+         oSymTable = SymTable_newBounded(psCall->uArgument, NULL, NULL);
+         uResult = oSymTable != NULL;
+         break;
+      case SYMTABLETRACE_FROMARRAYS:
+         oSymTable = SymTable_fromArrays(apcKeys, apvValues, uPairs);
+         uResult = oSymTable != NULL;
+         break;
+      case SYMTABLETRACE_MERGE:
+         uResult = (size_t)SymTable_merge(oSymTable, oSource,
+            psCall->uArgument % 2 ? combineValues : NULL, NULL);
+         break;
+      case SYMTABLETRACE_SNAPSHOT:
+         aoTables[psCall->uArgument] = SymTable_snapshot(oSymTable);
+         uResult = aoTables[psCall->uArgument] != NULL;
+         break;
+      case SYMTABLETRACE_PUSHSCOPE:
+         uResult = (size_t)SymTable_pushScope(oSymTable);
+         break;
+      case SYMTABLETRACE_POPSCOPE:
+         uResult = (size_t)SymTable_popScope(oSymTable);
+         break;
+      case SYMTABLETRACE_OPENMAPPED:
+         oSymTable = SymTable_openMapped(pcKey);
+         uResult = oSymTable != NULL;
+         break;
+      case SYMTABLETRACE_OPENLOGGED:
+         if (psCall->uTable != 0)
+            oSymTable = tableOf(psTables, psCall->uTable);
+         uResult = oSymTable != NULL;
+         break;
+      case SYMTABLETRACE_ENABLEFILTER:
+         uResult = (size_t)SymTable_enableFilter(oSymTable);
+         break;
+      case SYMTABLETRACE_ENABLECACHE:
+         uResult = (size_t)SymTable_enableCache(oSymTable);
+         break;
+      case SYMTABLETRACE_SETLOGBATCH:
+         uResult = (size_t)SymTable_setLogBatch(oSymTable,
+            psCall->uArgument);
+         break;
+      case SYMTABLETRACE_SYNCLOG:
+         uResult = (size_t)SymTable_syncLog(oSymTable);
+         break;
+      case SYMTABLETRACE_CHECKPOINT:
+         uResult = (size_t)SymTable_checkpoint(oSymTable);
+         break;
+      default:
+         break;
+   }
+
+   free(apcKeys);
+   free(apvValues);
+   /* Table 0 stands for a table that was never made. */
+   aoTables[psCall->uTable] = psCall->uTable == 0 ? NULL : oSymTable;
+   if (aoTables[psCall->uTable] == NULL)
+      psTables->acMadeUp[psCall->uTable] = 0;
+   if (psCall->uTable == 0 && oSymTable != NULL
+      && psCall->eOp != SYMTABLETRACE_FREE)
+      SymTable_free(oSymTable);
+   return uResult;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Replay the trace named by argv[1] against the SymTable
+   implementation, and write the latencies of each traced function to
+   stdout. As always, argc is the command-line argument count, argv
+   contains the command-line arguments, and argv[0] is the name of the
+   executable binary file. Exit with EXIT_FAILURE if argv[1] is
+   missing or is not a readable trace. Otherwise return 0. */
+
+int main(int argc, char *argv[])
+{
+   struct Replay sReplay;
+   struct Tables sTables;
+   uint64_t *puLatencies;
+   uint64_t *puSorted;
+   uint64_t uStart;
+   uint64_t uEnd;
+   uint64_t uTotal;
+   size_t auCalls[SYMTABLETRACE_OP_COUNT];
+   size_t auMismatches[SYMTABLETRACE_OP_COUNT];
+   size_t uResult;
+   size_t uCount;
+   size_t uTimed;
+   size_t u;
+   const struct Call *psCall;
+   int iOp;
+
+   if (argc != 2)
+   {
+      fprintf(stderr, "Usage: %s tracefile\n", argv[0]);
+      exit(EXIT_FAILURE);
+   }
+
+   loadTrace(argv[1], &sReplay);
+   memset(&sTables, 0, sizeof(sTables));
+   sTables.aoTables = (SymTable_T*)calloc(sReplay.uTableCount,
+      sizeof(SymTable_T));
+   sTables.acMadeUp = (char*)calloc(sReplay.uTableCount, 1);
+   puLatencies = (uint64_t*)grow(NULL, sReplay.uCallCount + 1,
+      sizeof(uint64_t));
+   puSorted = (uint64_t*)grow(NULL, sReplay.uCallCount + 1,
+      sizeof(uint64_t));
+   if (sTables.aoTables == NULL || sTables.acMadeUp == NULL)
+      exit(EXIT_FAILURE);
+   memset(auCalls, 0, sizeof(auCalls));
+   memset(auMismatches, 0, sizeof(auMismatches));
+
+   printf("%s: %lu calls on %lu tables, clock overhead %lu ns\n",
+      argv[0], (unsigned long)sReplay.uCallCount,
+      (unsigned long)(sReplay.uTableCount - 1),
+      (unsigned long)clockOverhead());
+   fflush(stdout);
+
+   for (u = 0; u < sReplay.uCallCount; u++)
+   {
+      psCall = &sReplay.psCalls[u];
+      /* The pairs were passed with the fromArrays call before them. */
+      if (psCall->eOp == SYMTABLETRACE_FROMARRAYSPAIR)
+         continue;
+      uResult = replayCall(&sReplay, u, &sTables, &uStart);
+      uEnd = now();
+      puLatencies[u] = uEnd - uStart;
+      auCalls[psCall->eOp]++;
+      if (uResult != psCall->uResult)
+         auMismatches[psCall->eOp]++;
+   }
+
+   printf("%-16s %10s %9s %7s %7s %7s %10s\n", "function", "calls",
+      "ns/call", "p50", "p99", "p999", "mismatches");
+   for (iOp = SYMTABLETRACE_NEW; iOp < SYMTABLETRACE_OP_COUNT; iOp++)
+   {
+      if (auCalls[iOp] == 0)
+         continue;
+      uCount = 0;
+      uTotal = 0;
+      for (u = 0; u < sReplay.uCallCount; u++)
+         if ((int)sReplay.psCalls[u].eOp == iOp)
+         {
+            puSorted[uCount++] = puLatencies[u];
+            uTotal += puLatencies[u];
+         }
+      qsort(puSorted, uCount, sizeof(uint64_t), compareLatencies);
+      printf("%-16s %10lu %9.1f %7lu %7lu %7lu %10lu\n",
+         SymTableTrace_opName((SymTableTrace_Op)iOp),
+         (unsigned long)uCount, (double)uTotal / (double)uCount,
+         (unsigned long)puSorted[(uCount - 1) / 2],
+         (unsigned long)puSorted[(uCount - 1) * 99 / 100],
+         (unsigned long)puSorted[(uCount - 1) * 999 / 1000],
+         (unsigned long)auMismatches[iOp]);
+   }
+   uTimed = 0;
+   uTotal = 0;
+   for (u = 0; u < sReplay.uCallCount; u++)
+      if (sReplay.psCalls[u].eOp != SYMTABLETRACE_FROMARRAYSPAIR)
+      {
+         puSorted[uTimed++] = puLatencies[u];
+         uTotal += puLatencies[u];
+      }
+   if (uTimed > 0)
+   {
+      uCount = 0;
+      for (iOp = SYMTABLETRACE_NEW; iOp < SYMTABLETRACE_OP_COUNT; iOp++)
+         uCount += auMismatches[iOp];
+      qsort(puSorted, uTimed, sizeof(uint64_t), compareLatencies);
+      printf("%-16s %10lu %9.1f %7lu %7lu %7lu %10lu\n", "all",
+         (unsigned long)uTimed, (double)uTotal / (double)uTimed,
+         (unsigned long)puSorted[(uTimed - 1) / 2],
+         (unsigned long)puSorted[(uTimed - 1) * 99 / 100],
+         (unsigned long)puSorted[(uTimed - 1) * 999 / 1000],
+         (unsigned long)uCount);
+   }
+   if (sTables.uMadeUpTables > 0)
+      printf("%lu calls were replayed on %lu tables made up with "
+         "SymTable_new, which the trace never saw made or which were "
+         "opened with SymTable_openLogged; their results may differ\n",
+         (unsigned long)sTables.uMadeUpCalls,
+         (unsigned long)sTables.uMadeUpTables);
+   printf("SymTable_save, SymTable_getStats and SymTable_memoryUsage are "
+      "not traced, so no calls of them were replayed\n");
+
+   /* The tables that the trace never freed are freed untimed. */
+   for (u = 0; u < sReplay.uTableCount; u++)
+      if (sTables.aoTables[u] != NULL)
+         SymTable_free(sTables.aoTables[u]);
+   free(sTables.aoTables);
+   free(sTables.acMadeUp);
+   free(puLatencies);
+   free(puSorted);
+   free(sReplay.psCalls);
+   free(sReplay.pcKeys);
+   return 0;
+}
@@ -18,8 +18,109 @@ typedef struct SymTable *SymTable_T;
 SymTable_T SymTable_new(void);
 
 /*
-   SymTable_free frees all memory occupied by oSymTable. There is one parameter
-   called oSymTable of type SymTable_T. Returns nothing.
+   SymTable_Allocator is an allocator that a SymTable_T gets all of its memory from. pfAlloc 
+   returns a block of uSize bytes, suitably aligned for any type, or NULL if there is not enough 
+   memory. pfFree gives back a block that pfAlloc returned. Both are passed pvContext as their 
+   last parameter, which lets several SymTable_T values share one pool, or keep one each. There 
+   is no reallocation function: a SymTable_T that needs a larger block gets a new one, copies 
+   the old one into it, and frees the old one.
+*/
+typedef struct SymTable_Allocator
+{
+   void *(*pfAlloc)(size_t uSize, void *pvContext);
+   void (*pfFree)(void *pvBlock, void *pvContext);
+   void *pvContext;
+} SymTable_Allocator;
+
+/*
+   SymTable_newWithAllocator returns a new SymTable_T value that contains no key-value pairs, or 
+   NULL if insufficient memory is available, like SymTable_new(). Every block of memory of the 
+   new SymTable_T, including the SymTable_T itself, its buckets, its key-value pairs and the 
+   copies of their keys, comes from *psAllocator and is given back to it, and so is every block 
+   of the SymTable_T values that SymTable_snapshot() makes of it. *psAllocator is copied, but 
+   its pvContext must stay valid until the last of those SymTable_T values is freed. 
+   SymTable_new() uses malloc and free, with realloc and calloc where they help. The mapping of 
+   SymTable_openMapped() is not allocated from any SymTable_Allocator. Takes in a parameter of 
+   type const SymTable_Allocator* called psAllocator representing the allocator.
+*/
+SymTable_T SymTable_newWithAllocator(const SymTable_Allocator *psAllocator);
+
+/*
+   SymTable_newWithCapacity returns a new SymTable_T value that contains no key-value pairs and 
+   has room for uCapacity key-value pairs before it needs to grow, or NULL if insufficient memory 
+   is available. In the hash table implementation the bucket array is sized for uCapacity 
+   key-value pairs up front (up to its largest size), and the array of key-value pairs has room 
+   for them, so putting them never rehashes the table or moves the array. 
+   The list and hash array mapped trie implementations never rehash, and behave like 
+   SymTable_new(). Takes in a parameter of type size_t called uCapacity representing the number 
+   of key-value pairs to make room for.
+*/
+SymTable_T SymTable_newWithCapacity(size_t uCapacity);
+
+/*
+   SymTable_newBounded returns a new SymTable_T value that contains no key-value pairs and holds 
+   at most uMaxEntries of them, evicting the least recently used, as a cache in front of a slow 
+   computation does, or NULL if insufficient memory is available or the implementation has no 
+   bound. A key-value pair is used when it is added by SymTable_put(), SymTable_putBorrowed() or 
+   SymTable_upsert(), and when SymTable_get(), SymTable_replace() or SymTable_upsert() find it; 
+   SymTable_contains() and SymTable_map() do not count as uses. A put that takes the SymTable over 
+   uMaxEntries key-value pairs then removes the least recently used one, first calling 
+   (*pfEvict)(pcKey, pvValue, pvExtra) with its key and value, if pfEvict is not NULL, so that the 
+   value can be freed; pfEvict must not change the SymTable. A put that fails evicts nothing. 
+   SymTable_merge() into a bounded SymTable makes the key-value pairs of oSrc the most recently 
+   used, and then evicts. SymTable_remove(), SymTable_clear() and SymTable_free() do not call 
+   pfEvict. The hash table implementation threads a list in order of use through its array of 
+   key-value pairs, with two links for each in an array of their own, so that a use or an 
+   eviction costs O(1) on top of the lookup and an unbounded SymTable pays nothing for the list. 
+   A bounded SymTable cannot open a scope, since popping it could not bring back an evicted 
+   key-value pair. Its clone has the same bound, pfEvict and pvExtra and the same order of use. 
+   uMaxEntries must be at least 1. Only the hash table implementation has a bound. Takes in a 
+   parameter of type size_t called uMaxEntries representing the largest number of key-value 
+   pairs, a parameter of type void (*)(const char*, void*, void*) called pfEvict representing the 
+   function that is passed each evicted key-value pair, and a parameter of type const void* 
+   called pvExtra representing the extra argument passed to pfEvict.
+*/
+SymTable_T SymTable_newBounded(size_t uMaxEntries,
+   void (*pfEvict)(const char *pcKey, void *pvValue, void *pvExtra),
+   const void *pvExtra);
+
+/*
+   SymTable_fromArrays returns a new SymTable_T value that contains the uCount key-value pairs
+   whose keys are apcKeys[0] to apcKeys[uCount-1] and whose values are apvValues[0] to
+   apvValues[uCount-1], or NULL if insufficient memory is available. If a key appears more than
+   once, the first of its pairs is kept and the others are ignored, as if the pairs had been put
+   in order with SymTable_put(). The keys are copied. In the list implementation all of the
+   key-value pairs and their keys are allocated in a single block; in the hash table
+   implementation the array of key-value pairs is allocated for exactly uCount of them and their
+   keys in a single block, and the hash table is sized for uCount key-value pairs (up to its
+   largest size) before they are added, so it is never rehashed. The block is freed with the
+   SymTable_T, so removing one of those key-value pairs frees no memory for it until then. The
+   hash array mapped trie implementation allocates each key-value pair on its own, as
+   SymTable_put() does, because its nodes can outlive the SymTable_T in snapshots. Takes in a
+   parameter of type const char* const* called apcKeys representing the keys, a parameter of
+   type const void* const* called apvValues representing the values, and a parameter of type
+   size_t called uCount representing the number of pairs.
+*/
+SymTable_T SymTable_fromArrays(const char *const *apcKeys, const void *const *apvValues,
+   size_t uCount);
+
+/*
+   SymTable_reserve() makes room in oSymTable for uCapacity key-value pairs, so that putting up to 
+   that many key-value pairs never rehashes it. In the hash table implementation this grows the 
+   bucket array to the size it would reach with uCapacity key-value pairs, relinking the existing 
+   ones once from the hash codes they keep, and makes room for them in the array of key-value 
+   pairs; it never shrinks either. In the other implementations it does nothing. Returns 1 as 
+   type int on success, and 0 if insufficient memory is available, in which case oSymTable is 
+   unchanged. Takes in a parameter of type SymTable_T called oSymTable representing the SymTable 
+   that room is made in, and a parameter of type size_t called uCapacity representing the number 
+   of key-value pairs to make room for.
+*/
+int SymTable_reserve(SymTable_T oSymTable, size_t uCapacity);
+
+/*
+   SymTable_free frees all memory occupied by oSymTable, after syncing its log if it was opened
+   with SymTable_openLogged(). There is one parameter called oSymTable of type SymTable_T.
+   Returns nothing.
 */
 void SymTable_free(SymTable_T oSymTable);
 
@@ -45,6 +146,22 @@ size_t SymTable_getLength(SymTable_T oSymTable);
 int SymTable_put(SymTable_T oSymTable, 
    const char *pcKey, const void *pvValue);
 
+/*
+   SymTable_putBorrowed() is SymTable_put() without the copy of pcKey: the new key-value pair
+   points to pcKey itself, and neither SymTable_remove(), SymTable_clear() nor SymTable_free()
+   frees it. This saves an allocation per key-value pair when the keys are string literals or live
+   in memory that outlives oSymTable. The client must not change or free pcKey while the key-value
+   pair is in oSymTable, in a scope of it that can be restored, or in a hash array mapped trie
+   snapshot of it, which shares the key-value pair; the other implementations' snapshots, and a
+   table promoted from a mapped snapshot, copy their keys. Borrowed and copied keys can be mixed in
+   one SymTable_T. Returns 1 as type int on success, and 0 if a key-value pair with key pcKey is
+   already in oSymTable or insufficient memory is available. Takes in a parameter of type
+   SymTable_T called oSymTable representing the SymTable that the key-value pair is added to, a
+   parameter of type const char* called pcKey representing the key, which is borrowed, and a
+   parameter of type const void* called pvValue representing the value.
+*/
+int SymTable_putBorrowed(SymTable_T oSymTable, const char *pcKey, const void *pvValue);
+
 /*
    SymTable_put() replaces the new key-value pair with the key being pcKey with a new value pvValue
    in the SymTable oSymTable. Takes in a parameter of type const char* called pcKey representing the key 
@@ -56,6 +173,83 @@ int SymTable_put(SymTable_T oSymTable,
 void *SymTable_replace(SymTable_T oSymTable,
    const char *pcKey, const void *pvValue);
 
+/*
+   SymTable_upsert() returns a pointer to the value of the key-value pair of oSymTable whose key
+   is pcKey, as type void**, first adding a key-value pair with key pcKey and value NULL if there
+   is none. The value can then be read and written through the pointer, which lets a counter or
+   an aggregate be updated with one lookup instead of a SymTable_contains() followed by a
+   SymTable_put() or SymTable_replace(). The pointer stays valid until the next call that changes
+   oSymTable other than through it, or until oSymTable is freed. Writing through it is a replace:
+   popping the scope that was innermost when SymTable_upsert() was called restores the value it
+   had then. In the list and hash table implementations pcKey is hashed and its chain walked
+   once, except when the hash table grows; the hash array mapped trie implementation walks the
+   trie a second time to copy the nodes it shares with snapshots. If piInserted is not NULL,
+   *piInserted is set to 1 if the key-value pair was added, and 0 otherwise. Returns NULL if
+   there is not enough memory to add the key-value pair or oSymTable was opened with
+   SymTable_openLogged(), in which case oSymTable is unchanged.
+   Takes in a parameter of type SymTable_T called oSymTable representing the SymTable that is
+   searched and added to, a parameter of type const char* called pcKey representing the key,
+   and a parameter of type int* called piInserted representing where to report whether the
+   key-value pair was added.
+*/
+void **SymTable_upsert(SymTable_T oSymTable, const char *pcKey, int *piInserted);
+
+/*
+   The functions below behave like the functions of the same name without the final N, except
+   that the key is given as the uLength characters starting at pcKey instead of as a string. The
+   characters need not be followed by '\0', so a key can be looked up where it lies in an input
+   buffer without being copied out first, but they must not contain '\0' themselves. The key that
+   SymTable_putN() and SymTable_upsertN() store is a string, so SymTable_putN(oSymTable, "Ruth 3",
+   4, pvValue) binds the same key as SymTable_put(oSymTable, "Ruth", pvValue), and the functions
+   with and without the N can be mixed freely. The functions without the N compute the length of
+   pcKey and call these. Each takes in a parameter of type SymTable_T called oSymTable, a
+   parameter of type const char* called pcKey representing the first character of the key, and a
+   parameter of type size_t called uLength representing the number of characters in the key.
+*/
+
+/*
+   SymTable_putN() is SymTable_put() with the key given by pcKey and uLength. Takes in a
+   parameter of type const void* called pvValue representing the value. Returns 1 as type int on
+   success, and 0 if the key is already bound or insufficient memory is available.
+*/
+int SymTable_putN(SymTable_T oSymTable, const char *pcKey, size_t uLength,
+   const void *pvValue);
+
+/*
+   SymTable_replaceN() is SymTable_replace() with the key given by pcKey and uLength. Takes in a
+   parameter of type const void* called pvValue representing the new value. Returns the old value
+   as type void*, or NULL if the key is not bound.
+*/
+void *SymTable_replaceN(SymTable_T oSymTable, const char *pcKey, size_t uLength,
+   const void *pvValue);
+
+/*
+   SymTable_upsertN() is SymTable_upsert() with the key given by pcKey and uLength. Takes in a
+   parameter of type int* called piInserted representing where to report whether the key-value
+   pair was added. Returns the value slot as type void**, or NULL if insufficient memory is
+   available.
+*/
+void **SymTable_upsertN(SymTable_T oSymTable, const char *pcKey, size_t uLength,
+   int *piInserted);
+
+/*
+   SymTable_containsN() is SymTable_contains() with the key given by pcKey and uLength. Returns 1
+   as type int if the key is bound, and 0 otherwise.
+*/
+int SymTable_containsN(SymTable_T oSymTable, const char *pcKey, size_t uLength);
+
+/*
+   SymTable_getN() is SymTable_get() with the key given by pcKey and uLength. Returns the value as
+   type void*, or NULL if the key is not bound.
+*/
+void *SymTable_getN(SymTable_T oSymTable, const char *pcKey, size_t uLength);
+
+/*
+   SymTable_removeN() is SymTable_remove() with the key given by pcKey and uLength. Returns the
+   value of the removed key-value pair as type void*, or NULL if the key is not bound.
+*/
+void *SymTable_removeN(SymTable_T oSymTable, const char *pcKey, size_t uLength);
+
 /*
    SymTable_contains() returns 1 as type int if oSymTable contains a key-value pair whose key is pcKey, 
    and returns 0 as type int otherwise. Takes in a parameter of type const char* called pcKey representing 
@@ -86,7 +280,9 @@ void *SymTable_remove(SymTable_T oSymTable, const char *pcKey);
    SymTable_map() applies function *pfApply to each key-value pair in oSymTable, passing pvExtra as an 
    extra parameter. That is, the function must call (*pfApply)(pcKey, pvValue, pvExtra) for each key-value 
    pair, where each key is passed into the pcKey parameter and each value is passed into the pvValue 
-   parameter. Takes in a parameter of type SymTable_T called oSymTable representing the SymTable that the 
+   parameter. In the hash table implementation the key-value pairs are visited in the order they were put, 
+   in one pass over the array that holds them, so the time taken depends on the length of oSymTable and not 
+   on its bucket count. Takes in a parameter of type SymTable_T called oSymTable representing the SymTable that the 
    function is applied to. Takes in a parameter of type void* (const char*, void*, pvExtra*) called pfApply 
    which is a pointer to the function that must be applied to each key-value pair in oSymTable. Takes in a 
    parameter of type const void* called pvExtra representing potential extra arguments required for pfApply.
@@ -94,4 +290,284 @@ void *SymTable_remove(SymTable_T oSymTable, const char *pcKey);
 void SymTable_map(SymTable_T oSymTable,
    void (*pfApply)(const char *pcKey, void *pvValue, void *pvExtra),
    const void *pvExtra);
+
+/*
+   SymTable_merge() moves every key-value pair of oSrc into oDst, leaving oSrc empty. When a key
+   is in both, the key-value pair of oDst is kept and its value becomes
+   (*pfCombine)(pcKey, pvDstValue, pvSrcValue, pvExtra), or stays as it is if pfCombine is NULL;
+   pfCombine must not change either SymTable. The other key-value pairs are relinked into oDst
+   rather than copied, so their keys are not copied again; the hash array mapped trie
+   implementation relinks its leaves by sharing them. The hash table implementation first grows
+   oDst to hold both SymTables, then appends the key-value pairs of oSrc to the array of oDst in
+   the order they were put, handing over their keys and the hash codes it keeps, so no key is
+   hashed. Keys are copied instead if the two SymTables have different allocators, or come from
+   the key block of SymTable_fromArrays() or SymTable_clone(). The merge takes time proportional
+   to the length of oSrc, plus the time to compare each of its keys with those of oDst (all of
+   them in the list implementation). Returns 1 as type int on success. Returns 0 if either
+   SymTable has an open scope or a log, in which case neither is changed, or if there is not
+   enough memory, in which case the key-value pairs not yet moved are still in oSrc. oDst and
+   oSrc must be different SymTables. Takes in a parameter of type SymTable_T called oDst
+   representing the SymTable that is merged into, a parameter of type SymTable_T called oSrc
+   representing the SymTable that is emptied into it, a parameter of type
+   void* (const char*, void*, void*, void*) called pfCombine representing the function that
+   combines the values of a key that is in both, and a parameter of type const void* called
+   pvExtra representing the extra argument passed to pfCombine.
+*/
+int SymTable_merge(SymTable_T oDst, SymTable_T oSrc,
+   void *(*pfCombine)(const char *pcKey, void *pvDstValue, void *pvSrcValue, void *pvExtra),
+   const void *pvExtra);
+
+/*
+   SymTable_save() writes every key-value pair of oSymTable to the file named pcPath as a 
+   position-independent snapshot that SymTable_openMapped() can load without rebuilding the table. 
+   The snapshot holds a bucket offset array, the packed keys, and one value slot per key-value pair. 
+   Each value slot stores the bits of the value pointer itself, so a snapshot is only meaningful to 
+   a reader for which those bits still mean something (integers cast to void*, indexes, or pointers 
+   into memory that outlives the snapshot). Takes in a parameter of type SymTable_T called oSymTable 
+   representing the SymTable that is saved. Takes in a parameter of type const char* called pcPath 
+   representing the name of the file that is written. The snapshot is written to pcPath with 
+   ".tmp" appended and then renamed over pcPath, so an existing file pcPath, including one that a 
+   table is mapped from, is only replaced once the new snapshot is complete. Returns 1 as type int 
+   on success, and 0 if there is not enough memory or the file cannot be written, in which case 
+   pcPath is left as it was.
+*/
+int SymTable_save(SymTable_T oSymTable, const char *pcPath);
+
+/*
+   SymTable_openMapped() returns a new SymTable_T value containing the key-value pairs of the 
+   snapshot file pcPath written by SymTable_save(), or NULL if the file cannot be mapped, is not a 
+   snapshot, or there is not enough memory. The file is mapped into memory instead of being read, so 
+   SymTable_get(), SymTable_contains(), SymTable_replace() and SymTable_map() are served directly from 
+   the mapping with no per-key-value pair allocation, and only the pages that are touched are loaded. 
+   The first SymTable_put() or successful SymTable_remove() copies every key-value pair into an 
+   ordinary table (copy-on-promote). Changes are never written back to pcPath. Takes in a parameter 
+   of type const char* called pcPath representing the name of the snapshot file.
+*/
+SymTable_T SymTable_openMapped(const char *pcPath);
+
+/*
+   SymTable_openLogged() returns a new SymTable_T value that records every change made to it in
+   the write-ahead log file pcPath, or NULL if the log or its checkpoint cannot be read or there
+   is not enough memory. The key-value pairs of the new SymTable are those of the checkpoint, the
+   snapshot file named by pcPath followed by ".checkpoint" that SymTable_checkpoint() last wrote,
+   with every change in the log replayed on top; the log is created if it does not exist. The
+   checkpoint is opened as by SymTable_openMapped(), so a table whose log is empty is ready as
+   soon as the checkpoint is mapped. Each SymTable_put(), SymTable_replace(), SymTable_remove()
+   and SymTable_clear() appends one record to the log, and by default the log is synced before
+   the call returns; see SymTable_setLogBatch(). Records cut short by a crash are dropped when the
+   log is next opened. Values are logged as the bits of the value pointer, as SymTable_save()
+   stores them. SymTable_upsert() returns NULL and SymTable_pushScope() and SymTable_merge()
+   return 0 for a logged SymTable, since their changes could not be logged as they are made.
+   Takes in a parameter of type const char* called pcPath representing the name of the log file.
+*/
+SymTable_T SymTable_openLogged(const char *pcPath);
+
+/*
+   SymTable_setLogBatch() makes a SymTable opened with SymTable_openLogged() write and sync its
+   log once every uRecords changes instead of after each one (group commit), or only when
+   SymTable_syncLog(), SymTable_checkpoint() or SymTable_free() is called if uRecords is 0.
+   Changes are collected in memory and written together, so a larger batch costs fewer writes
+   and syncs, and a crash loses at most the changes not yet synced. Returns 1 as type int on
+   success, and 0 if oSymTable has no log. Takes in a parameter of type SymTable_T called
+   oSymTable representing the logged SymTable and a parameter of type size_t called uRecords
+   representing the number of changes per sync.
+*/
+int SymTable_setLogBatch(SymTable_T oSymTable, size_t uRecords);
+
+/*
+   SymTable_syncLog() writes every change made to oSymTable that is not yet in its log and syncs
+   the log, so that the changes survive a crash. Returns 1 as type int if every change since the
+   last checkpoint is durable, and 0 if a write or sync of the log has failed or oSymTable has no
+   log. Takes in a parameter of type SymTable_T called oSymTable representing the logged
+   SymTable.
+*/
+int SymTable_syncLog(SymTable_T oSymTable);
+
+/*
+   SymTable_checkpoint() writes a snapshot of oSymTable as the new checkpoint of its log, with
+   SymTable_save(), and then empties the log, so that the next SymTable_openLogged() maps the
+   checkpoint instead of replaying every change ever made. The checkpoint is written to a
+   temporary file, synced and renamed over the old one, so a crash at any point leaves a
+   checkpoint and log that together hold every synced change. Returns 1 as type int on success,
+   and 0 if oSymTable has no log or the checkpoint cannot be written, in which case the log is
+   kept. Takes in a parameter of type SymTable_T called oSymTable representing the logged
+   SymTable.
+*/
+int SymTable_checkpoint(SymTable_T oSymTable);
+
+/*
+   SymTable_snapshot() returns a new SymTable_T value that contains the same key-value pairs as 
+   oSymTable at the time of the call, or NULL if insufficient memory is available. Later changes to 
+   either SymTable are not visible in the other, and either may be freed first. The values are shared, 
+   not copied. In the hash array mapped trie implementation the snapshot costs O(1): both SymTables 
+   share the trie and each change copies only the nodes on its own path. The other implementations 
+   copy every key-value pair with SymTable_clone(). Takes in a parameter of type SymTable_T called 
+   oSymTable representing the SymTable that is snapshotted.
+*/
+SymTable_T SymTable_snapshot(SymTable_T oSymTable);
+
+/*
+   SymTable_clone() returns a new SymTable_T value that contains the same key-value pairs as
+   oSymTable, with the same allocator, or NULL if insufficient memory is available. The clone
+   holds only the innermost key-value pair of each key and has no open scope. The values are
+   shared, not copied, and neither SymTable sees later changes to the other. In the list and hash
+   table implementations the copy is made in one pass over oSymTable, with no rehashing: the
+   copies of the keys, including borrowed keys, are laid out in a single block in the order of
+   oSymTable, as SymTable_fromArrays() lays out its own, and the hash table clone has as many
+   buckets as oSymTable and an array of exactly its key-value pairs, which keep their hash codes
+   and their order, so its chains are rebuilt without reading a key; a
+   SymTable served from SymTable_openMapped() is copied out of its mapping instead, and stays
+   mapped. The hash array mapped trie implementation returns SymTable_snapshot(), which shares
+   the trie in O(1). Takes in a parameter of type SymTable_T called oSymTable representing the
+   SymTable that is cloned.
+*/
+SymTable_T SymTable_clone(SymTable_T oSymTable);
+
+/*
+   SymTable_pushScope() opens a new innermost scope in oSymTable. While it is open, 
+   SymTable_put() may bind a key that is already bound in an outer scope: the new key-value pair 
+   shadows the outer one, which is kept and becomes visible again when the scope is popped, and 
+   SymTable_getLength() still counts the key once. SymTable_get(), SymTable_contains() and 
+   SymTable_replace() see only the innermost key-value pair of each key, and cost one lookup 
+   whatever the number of open scopes. Returns 1 as type int on success, and 0 if insufficient 
+   memory is available or oSymTable was made by SymTable_newBounded() or
+   SymTable_openLogged(). Takes in a parameter of type SymTable_T called oSymTable representing the 
+   SymTable whose scope is opened.
+*/
+int SymTable_pushScope(SymTable_T oSymTable);
+
+/*
+   SymTable_popScope() closes the innermost scope of oSymTable and returns oSymTable to exactly 
+   the key-value pairs it had when that scope was pushed: key-value pairs put in the scope are 
+   removed, those it shadowed or removed are restored, and replaced values are restored. The list 
+   and hash table implementations keep an undo log of the changes made in the scope, so popping 
+   costs time proportional to those changes; the hash array mapped trie implementation restores 
+   the trie saved by SymTable_pushScope() in O(1). Returns 1 as type int on success, and 0 if no 
+   scope is open. Takes in a parameter of type SymTable_T called oSymTable representing the 
+   SymTable whose scope is closed.
+*/
+int SymTable_popScope(SymTable_T oSymTable);
+
+/*
+   SymTable_clear() removes every key-value pair from oSymTable and closes all of its open 
+   scopes, leaving it as SymTable_new() would, but keeping the memory it has for the key-value 
+   pairs that are put next. A table opened with SymTable_openMapped() is unmapped. In the hash 
+   table implementation the call takes constant time: the buckets are kept, and each one is 
+   recognized as stale and emptied when it is next used. In the list implementation the 
+   key-value pairs are kept on a free list that SymTable_put() reuses, and in the hash table 
+   implementation the array of key-value pairs is kept with the copies of their keys, which 
+   SymTable_put() reuses in order, so a table that is cleared and refilled with about as many 
+   keys allocates nothing; in the list 
+   implementation the call takes time proportional to the length of oSymTable if key-value pairs 
+   from an earlier clear are still unused. The hash array mapped trie implementation frees its 
+   trie, except for the nodes shared with a snapshot. Takes in a parameter of type SymTable_T 
+   called oSymTable representing the SymTable that is cleared.
+*/
+void SymTable_clear(SymTable_T oSymTable);
+
+/*
+   SymTable_enableFilter() gives oSymTable a blocked Bloom filter of its keys, so that most 
+   lookups of a key that oSymTable does not contain are answered by SymTable_get(), 
+   SymTable_contains(), SymTable_replace() and SymTable_remove() without reading a chain. The 
+   filter has one block of 32 bytes per 16 keys it is sized for, and each key sets 8 bits of one 
+   block, so a lookup reads at most one cache line of it. It is sized for twice the length of 
+   oSymTable or for its bucket count, whichever is more, and is rebuilt when the bucket array 
+   grows and once as many keys have been put as it was sized for. A removed key stays in the 
+   filter until it is next rebuilt, so removing costs nothing extra and a lookup of that key 
+   only reads its chain. SymTable_clear() empties the filter and SymTable_clone() copies it. A 
+   table served from SymTable_openMapped() uses the filter only once it is no longer mapped. 
+   Calling the function again rebuilds the filter. Only the hash table implementation has a 
+   filter. Returns 1 as type int on success, and 0 if insufficient memory is available or the 
+   implementation has no filter, in which case oSymTable works as before. Takes in a parameter 
+   of type SymTable_T called oSymTable representing the SymTable that is given a filter.
+*/
+int SymTable_enableFilter(SymTable_T oSymTable);
+
+/*
+   SymTable_enableCache() gives oSymTable a small direct-mapped cache of recent lookups, for 
+   clients that look up the same few keys over and over, such as the names in a loop. The cache 
+   is indexed by the address of the key passed to SymTable_get(), SymTable_contains() or 
+   SymTable_replace(), so a key looked up again from the same address, as a string literal or 
+   an interned name is, is found with one comparison instead of being hashed and searched for 
+   in its chain; the comparison also catches an address that now holds another key. The cache 
+   has 64 entries and is dropped as a whole whenever a key-value pair stops being visible: by 
+   SymTable_remove(), by a put that shadows it, by SymTable_popScope(), SymTable_clear() and 
+   SymTable_merge(), and by SymTable_free(). Growing the bucket array or the array of key-value 
+   pairs keeps it, since neither renumbers the key-value pairs; squeezing removed key-value pairs 
+   out of the array drops it. SymTable_clone() gives the clone an empty cache. 
+   SymTable_getStats() reports its hits and misses. Calling the function again does nothing. 
+   Only the hash table implementation has a cache. Returns 1 as type int on success, and 0 if 
+   insufficient memory is available or the implementation has no cache, in which case 
+   oSymTable works as before. Takes in a parameter of type SymTable_T called oSymTable 
+   representing the SymTable that is given a cache.
+*/
+int SymTable_enableCache(SymTable_T oSymTable);
+
+/* SYMTABLE_HISTOGRAM_SIZE is the number of entries of the chain-length histogram of a 
+   SymTable_Stats. */
+enum {SYMTABLE_HISTOGRAM_SIZE = 16};
+
+/*
+   SymTable_Stats holds the statistics that SymTable_getStats() reports about a SymTable_T. The 
+   counters cover every lookup of a key since the SymTable_T was created, including the lookups 
+   made by SymTable_put(), SymTable_replace(), SymTable_remove() and SymTable_popScope(), but not 
+   those served from a mapped snapshot. They are only kept if the implementation is compiled with 
+   SYMTABLE_STATS defined, so that they cost nothing otherwise.
+*/
+typedef struct SymTable_Stats
+{
+   /* uLookups is the number of lookups, and uHits and uMisses split it by whether the key was 
+      found. */
+   size_t uLookups;
+   size_t uHits;
+   size_t uMisses;
+   /* uFilterRejects is the number of misses that the filter of SymTable_enableFilter() answered 
+      without reading a chain. They are counted in uLookups and uMisses too. */
+   size_t uFilterRejects;
+   /* uCacheHits is the number of lookups that the cache of SymTable_enableCache() answered with 
+      one comparison, and uCacheMisses the number that it could not answer. The hits are counted 
+      in uLookups, uHits and uComparisons too. */
+   size_t uCacheHits;
+   size_t uCacheMisses;
+   /* uComparisons is the number of key comparisons made by the lookups. */
+   size_t uComparisons;
+   /* dComparisonsPerLookup is uComparisons divided by uLookups, or 0 if there was no lookup. */
+   double dComparisonsPerLookup;
+   /* uResizes is the number of times the bucket array grew, and dResizeSeconds is the CPU time 
+      spent growing it. */
+   size_t uResizes;
+   double dResizeSeconds;
+   /* uLength is the number of key-value pairs, and uBucketCount the number of chains. */
+   size_t uLength;
+   size_t uBucketCount;
+   /* auChainLengths[i] is the number of chains holding i key-value pairs, and the last entry 
+      counts every chain at least that long. The list implementation has a single chain. The 
+      hash array mapped trie implementation counts the number of Branches above each key instead, 
+      so uBucketCount is the number of keys. */
+   size_t auChainLengths[SYMTABLE_HISTOGRAM_SIZE];
+} SymTable_Stats;
+
+/*
+   SymTable_getStats() fills *psStats with statistics about oSymTable. The histogram and the 
+   length are computed on each call, in time proportional to the size of oSymTable. Returns 1 as 
+   type int if the implementation was compiled with SYMTABLE_STATS defined, and 0 otherwise, in 
+   which case the counters of *psStats are 0. Takes in a parameter of type SymTable_T called 
+   oSymTable and a parameter of type SymTable_Stats* called psStats representing where the 
+   statistics are written.
+*/
+int SymTable_getStats(SymTable_T oSymTable, SymTable_Stats *psStats);
+
+/*
+   SymTable_memoryUsage() returns the number of bytes of memory that oSymTable uses, as type 
+   size_t: the SymTable itself, its buckets, its key-value pairs with their copies of the keys, 
+   and the undo log and scope marks of its open scopes. Each allocation is counted with an 
+   estimate of the allocator's overhead (a header word and rounding to a multiple of two words, 
+   as in the GNU C library's malloc). The count is kept up to date by every change, so the call 
+   costs O(1). The pages of a mapped snapshot are not counted, since the file and not the 
+   SymTable owns them. In the hash array mapped trie implementation, nodes saved by open scopes 
+   are counted once, including those that only the saved scopes still reach, and nodes shared with 
+   snapshots are counted in full by every SymTable that reaches them. Takes in a parameter of type 
+   SymTable_T called oSymTable representing the SymTable that is measured.
+*/
+size_t SymTable_memoryUsage(SymTable_T oSymTable);
 #endif
\ No newline at end of file
@@ -0,0 +1,282 @@
+/*
+    Name: Tharun Kumar Tiruppali Kalidoss
+    File Name: symtabledefine.h
+*/
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#ifndef SYMTABLEDEFINE_INCLUDED
+#define SYMTABLEDEFINE_INCLUDED
+
+/*
+   SYMTABLE_DEFINE(Name, KeyType, ValueType, hashFn, eqFn) defines a symbol table type Name_T
+   whose keys are of type KeyType and whose values are of type ValueType, with the functions
+   below, all static inline. It is meant for a table on a hot path: a SymTable_T stores every
+   value as a void* and calls out of line for every operation, while the functions of Name_T
+   are compiled with the code that calls them, so hashFn and eqFn are inlined, values are
+   stored as they are, and a ValueType such as int needs neither a cast nor a block of its own.
+
+   The table is a hash table with separate chaining, which grows like the SymTable_T of
+   symtablehash.c: it starts with 509 buckets, moves to the next bucket count of the same
+   sequence when it holds as many key-value pairs as buckets, and stops growing at 65521
+   buckets. hashFn is called as hashFn(key) and returns a hash code of type size_t, which the
+   table reduces modulo its bucket count. eqFn is called as eqFn(key1, key2) and returns
+   nonzero as type int if the keys are equal. Keys that are equal must have the same hash code.
+   A key is stored as it is passed: a table of string keys stores the pointer, like
+   SymTable_putBorrowed, and the caller keeps the string alive and unchanged for as long as
+   the key is in the table. SymTableDefine_hashString and SymTableDefine_equalString hash and
+   compare string keys, and SymTableDefine_hashLong and SymTableDefine_equalLong integer keys.
+   SYMTABLE_DEFINE must be used at file scope, at most once for each Name in a translation unit.
+
+   Name_T Name_new(void) returns a new table with no key-value pairs, or NULL if insufficient
+   memory is available.
+   void Name_free(Name_T oTable) frees all memory occupied by oTable, which may be NULL.
+   size_t Name_getLength(Name_T oTable) returns the number of key-value pairs in oTable.
+   int Name_put(Name_T oTable, KeyType key, ValueType value) adds the key-value pair (key,
+   value) to oTable and returns 1, or returns 0 and leaves oTable unchanged if key is already
+   in oTable or insufficient memory is available.
+   ValueType *Name_get(Name_T oTable, KeyType key) returns a pointer to the value of key in
+   oTable, through which it may be read or changed, or NULL if key is not in oTable. The
+   pointer stays valid until the key is removed or oTable is cleared or freed.
+   int Name_contains(Name_T oTable, KeyType key) returns 1 if key is in oTable, and 0
+   otherwise.
+   int Name_replace(Name_T oTable, KeyType key, ValueType value, ValueType *pOldValue) makes
+   value the value of key in oTable, stores the old value in *pOldValue unless pOldValue is
+   NULL, and returns 1, or returns 0 and leaves oTable unchanged if key is not in oTable.
+   int Name_remove(Name_T oTable, KeyType key, ValueType *pOldValue) removes key from oTable,
+   stores its value in *pOldValue unless pOldValue is NULL, and returns 1, or returns 0 and
+   leaves oTable unchanged if key is not in oTable.
+   void Name_map(Name_T oTable, void (*pfApply)(KeyType key, ValueType *pValue, void *pvExtra),
+   void *pvExtra) calls (*pfApply)(key, pValue, pvExtra) for each key-value pair of oTable, in
+   no particular order. pfApply may change *pValue, but must not change oTable otherwise.
+   void Name_clear(Name_T oTable) removes every key-value pair from oTable.
+*/
+#define SYMTABLE_DEFINE(Name, KeyType, ValueType, hashFn, eqFn) \
+\
+/* Name##_Binding is one key-value pair, in the chain of its bucket. */ \
+struct Name##_Binding \
+{ \
+   KeyType key; \
+   ValueType value; \
+   struct Name##_Binding *pNextBinding; \
+}; \
+\
+/* Name is the table: the array of *puBucketCount chains and the number of key-value \
+   pairs. puBucketCount points into SYMTABLEDEFINE_BUCKET_COUNTS. */ \
+struct Name \
+{ \
+   struct Name##_Binding **head; \
+   size_t size; \
+   const size_t *puBucketCount; \
+}; \
+\
+typedef struct Name *Name##_T; \
+\
+static inline Name##_T Name##_new(void) { \
+    Name##_T oTable = (Name##_T)malloc(sizeof(struct Name)); \
+    if(oTable == NULL) \
+        return NULL; \
+    oTable->puBucketCount = &SYMTABLEDEFINE_BUCKET_COUNTS[0]; \
+    oTable->head = (struct Name##_Binding **)calloc(*oTable->puBucketCount, \
+        sizeof(struct Name##_Binding *)); \
+    if(oTable->head == NULL) { \
+        free(oTable); \
+        return NULL; \
+    } \
+    oTable->size = 0; \
+    return oTable; \
+} \
+\
+static inline void Name##_clear(Name##_T oTable) { \
+    struct Name##_Binding *pBinding; \
+    struct Name##_Binding *pNextBinding; \
+    size_t index; \
+    assert(oTable != NULL); \
+    for(index = 0; index < *oTable->puBucketCount; index++) { \
+        for(pBinding = oTable->head[index]; pBinding != NULL; pBinding = pNextBinding) { \
+            pNextBinding = pBinding->pNextBinding; \
+            free(pBinding); \
+        } \
+        oTable->head[index] = NULL; \
+    } \
+    oTable->size = 0; \
+} \
+\
+static inline void Name##_free(Name##_T oTable) { \
+    if(oTable == NULL) \
+        return; \
+    Name##_clear(oTable); \
+    free(oTable->head); \
+    free(oTable); \
+} \
+\
+static inline size_t Name##_getLength(Name##_T oTable) { \
+    assert(oTable != NULL); \
+    return oTable->size; \
+} \
+\
+/* Return the link (the bucket head or a pNextBinding field) that points to the Binding of \
+   key, or the NULL link at the end of key's bucket if key is not in oTable. */ \
+static inline struct Name##_Binding **Name##_findLink(Name##_T oTable, KeyType key) { \
+    struct Name##_Binding **ppLink = \
+        &oTable->head[(size_t)(hashFn(key)) % *oTable->puBucketCount]; \
+    while(*ppLink != NULL && !(eqFn((*ppLink)->key, key))) \
+        ppLink = &(*ppLink)->pNextBinding; \
+    return ppLink; \
+} \
+\
+/* Move every Binding of oTable into an array of the next bucket count. Return 1, or 0 if \
+   insufficient memory is available, in which case oTable is unchanged. */ \
+static inline int Name##_expand(Name##_T oTable) { \
+    const size_t *puNewBucketCount = oTable->puBucketCount + 1; \
+    struct Name##_Binding **newHead; \
+    struct Name##_Binding *pBinding; \
+    struct Name##_Binding *pNextBinding; \
+    size_t iterator; \
+    size_t index; \
+    newHead = (struct Name##_Binding **)calloc(*puNewBucketCount, \
+        sizeof(struct Name##_Binding *)); \
+    if(newHead == NULL) \
+        return 0; \
+    for(iterator = 0; iterator < *oTable->puBucketCount; iterator++) { \
+        for(pBinding = oTable->head[iterator]; pBinding != NULL; pBinding = pNextBinding) { \
+            pNextBinding = pBinding->pNextBinding; \
+            index = (size_t)(hashFn(pBinding->key)) % *puNewBucketCount; \
+            pBinding->pNextBinding = newHead[index]; \
+            newHead[index] = pBinding; \
+        } \
+    } \
+    free(oTable->head); \
+    oTable->head = newHead; \
+    oTable->puBucketCount = puNewBucketCount; \
+    return 1; \
+} \
+\
+static inline int Name##_put(Name##_T oTable, KeyType key, ValueType value) { \
+    struct Name##_Binding **ppLink; \
+    struct Name##_Binding *pNewBinding; \
+    assert(oTable != NULL); \
+    ppLink = Name##_findLink(oTable, key); \
+    if(*ppLink != NULL) \
+        return 0; \
+    /* Past the largest bucket count the table keeps its buckets and the chains grow. */ \
+    if(oTable->size == *oTable->puBucketCount && oTable->puBucketCount \
+            < &SYMTABLEDEFINE_BUCKET_COUNTS[SYMTABLEDEFINE_BUCKET_COUNT_SIZE - 1]) { \
+        if(!Name##_expand(oTable)) \
+            return 0; \
+        ppLink = Name##_findLink(oTable, key); \
+    } \
+    pNewBinding = (struct Name##_Binding *)malloc(sizeof(struct Name##_Binding)); \
+    if(pNewBinding == NULL) \
+        return 0; \
+    pNewBinding->key = key; \
+    pNewBinding->value = value; \
+    pNewBinding->pNextBinding = NULL; \
+    *ppLink = pNewBinding; \
+    oTable->size++; \
+    return 1; \
+} \
+\
+static inline ValueType *Name##_get(Name##_T oTable, KeyType key) { \
+    struct Name##_Binding *pBinding; \
+    assert(oTable != NULL); \
+    pBinding = *Name##_findLink(oTable, key); \
+    return pBinding == NULL ? NULL : &pBinding->value; \
+} \
+\
+static inline int Name##_contains(Name##_T oTable, KeyType key) { \
+    assert(oTable != NULL); \
+    return *Name##_findLink(oTable, key) != NULL; \
+} \
+\
+static inline int Name##_replace(Name##_T oTable, KeyType key, ValueType value, \
+    ValueType *pOldValue) { \
+    struct Name##_Binding *pBinding; \
+    assert(oTable != NULL); \
+    pBinding = *Name##_findLink(oTable, key); \
+    if(pBinding == NULL) \
+        return 0; \
+    if(pOldValue != NULL) \
+        *pOldValue = pBinding->value; \
+    pBinding->value = value; \
+    return 1; \
+} \
+\
+static inline int Name##_remove(Name##_T oTable, KeyType key, ValueType *pOldValue) { \
+    struct Name##_Binding **ppLink; \
+    struct Name##_Binding *pBinding; \
+    assert(oTable != NULL); \
+    ppLink = Name##_findLink(oTable, key); \
+    pBinding = *ppLink; \
+    if(pBinding == NULL) \
+        return 0; \
+    if(pOldValue != NULL) \
+        *pOldValue = pBinding->value; \
+    *ppLink = pBinding->pNextBinding; \
+    free(pBinding); \
+    oTable->size--; \
+    return 1; \
+} \
+\
+static inline void Name##_map(Name##_T oTable, \
+    void (*pfApply)(KeyType key, ValueType *pValue, void *pvExtra), void *pvExtra) { \
+    struct Name##_Binding *pBinding; \
+    size_t index; \
+    assert(oTable != NULL); \
+    assert(pfApply != NULL); \
+    for(index = 0; index < *oTable->puBucketCount; index++) \
+        for(pBinding = oTable->head[index]; pBinding != NULL; \
+            pBinding = pBinding->pNextBinding) \
+            (*pfApply)(pBinding->key, &pBinding->value, pvExtra); \
+} \
+\
+/* Let SYMTABLE_DEFINE(...); end with a semicolon at file scope. */ \
+typedef int Name##_Defined
+
+/* SYMTABLEDEFINE_BUCKET_COUNT_SIZE is the number of items in the SYMTABLEDEFINE_BUCKET_COUNTS
+    array. */
+enum {SYMTABLEDEFINE_BUCKET_COUNT_SIZE = 8};
+/* SYMTABLEDEFINE_BUCKET_COUNTS holds the bucket counts that a table can have, the same as
+    BUCKET_COUNTS in symtablehash.c. */
+static const size_t SYMTABLEDEFINE_BUCKET_COUNTS[SYMTABLEDEFINE_BUCKET_COUNT_SIZE] =
+    {(size_t)509, (size_t)1021, (size_t)2039, (size_t)4093, (size_t)8191, (size_t)16381,
+    (size_t)32749, (size_t)65521};
+
+/* Return a hash code for the string pcKey, with the hash function of symtablehash.c. */
+static inline size_t SymTableDefine_hashString(const char *pcKey)
+{
+   const size_t HASH_MULTIPLIER = 65599;
+   size_t uHash = 0;
+
+   assert(pcKey != NULL);
+
+   for ( ; *pcKey != '\0'; pcKey++)
+      uHash = uHash * HASH_MULTIPLIER + (size_t)*pcKey;
+
+   return uHash;
+}
+
+/* Return 1 if the strings pcKey1 and pcKey2 are equal, and 0 otherwise. */
+static inline int SymTableDefine_equalString(const char *pcKey1, const char *pcKey2)
+{
+   return strcmp(pcKey1, pcKey2) == 0;
+}
+
+/* Return a hash code for lKey, with its bits mixed so that keys that are a multiple of a bucket
+   count apart do not all fall into one bucket. */
+static inline size_t SymTableDefine_hashLong(long lKey)
+{
+   unsigned long ulKey = (unsigned long)lKey;
+   ulKey ^= ulKey >> 16;
+   ulKey *= 0x45D9F3BUL;
+   ulKey ^= ulKey >> 16;
+   return (size_t)ulKey;
+}
+
+/* Return 1 if lKey1 and lKey2 are equal, and 0 otherwise. */
+static inline int SymTableDefine_equalLong(long lKey1, long lKey2)
+{
+   return lKey1 == lKey2;
+}
+#endif
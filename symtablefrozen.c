@@ -0,0 +1,426 @@
+/*
+    Name: Tharun Kumar Tiruppali Kalidoss
+    File Name: symtablefrozen.c
+*/
+#include "symtablefrozen.h"
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <assert.h>
+
+/*
+    A SymTableFrozen is built with the hash-and-displace scheme of CHD. Every key has a 64-bit
+    base hash. The base hash picks one of uCount buckets; the bucket's displacement g then
+    picks the key's slot among uCount slots: a negative g stores the slot itself (-g-1) for a
+    bucket holding a single key, and a positive g is a seed that is mixed into the base hash.
+    The builder chooses the seeds so that no two keys share a slot, which makes the slot array
+    exactly as long as the number of keys.
+*/
+
+/*
+    FrozenEntry is one slot of the perfect hash: a key-value pair.
+*/
+struct FrozenEntry
+{
+    /* key points into the SymTableFrozen's packed key block. It is of type const char*. */
+   const char *key;
+    /* value is the value of the key-value pair. It is of type const void*. */
+   const void *value;
+};
+
+/*
+    SymTableFrozen is a representation of the frozen symbol table.
+*/
+struct SymTableFrozen
+{
+    /* uCount is the number of key-value pairs, buckets and slots. It is of type size_t. */
+   size_t uCount;
+    /* uSalt is mixed into every base hash. It is only changed from 0 if the keys could not
+        be placed with it, which needs a collision of two 64-bit base hashes. */
+   uint64_t uSalt;
+    /* piDisplacements holds the displacement g of each of the uCount buckets. */
+   int32_t *piDisplacements;
+    /* psEntries holds the uCount slots. */
+   struct FrozenEntry *psEntries;
+    /* pcKeys is the contiguous block that holds every key, and uKeyBytes is its size. */
+   char *pcKeys;
+   size_t uKeyBytes;
+};
+
+/*
+    FrozenBuilder collects the key-value pairs of a SymTable through SymTable_map while
+    SymTable_freeze is building a SymTableFrozen.
+*/
+struct FrozenBuilder
+{
+    /* ppcKeys and ppvValues are parallel arrays of length uCount. */
+   const char **ppcKeys;
+   const void **ppvValues;
+   size_t uCount;
+    /* uKeyBytes is the total size of the collected keys, including their '\0' characters. */
+   size_t uKeyBytes;
+};
+
+/* MAX_SEED is the largest seed that is tried for one bucket before the builder gives up on
+   the current salt. */
+static const int32_t MAX_SEED = 1 << 24;
+
+/* SEED_MULTIPLIER spreads consecutive seeds across all 64 bits before they are mixed in. */
+static const uint64_t SEED_MULTIPLIER = (uint64_t)0x9E3779B97F4A7C15ULL;
+
+/* Return uValue with its bits thoroughly mixed, using the finalizer of SplitMix64. */
+static uint64_t SymTableFrozen_mix(uint64_t uValue)
+{
+   uValue ^= uValue >> 30;
+   uValue *= (uint64_t)0xBF58476D1CE4E5B9ULL;
+   uValue ^= uValue >> 27;
+   uValue *= (uint64_t)0x94D049BB133111EBULL;
+   uValue ^= uValue >> 31;
+   return uValue;
+}
+
+/* Return the 64-bit base hash of pcKey (64-bit FNV-1a) for salt uSalt. */
+static uint64_t SymTableFrozen_hash(const char *pcKey, uint64_t uSalt)
+{
+   const uint64_t HASH_PRIME = (uint64_t)0x100000001B3ULL;
+   size_t u;
+   uint64_t uHash = (uint64_t)0xCBF29CE484222325ULL ^ uSalt;
+
+   assert(pcKey != NULL);
+
+   for (u = 0; pcKey[u] != '\0'; u++)
+   {
+      uHash ^= (uint64_t)(unsigned char)pcKey[u];
+      uHash *= HASH_PRIME;
+   }
+
+   return uHash;
+}
+
+/* Return the slot, between 0 and uCount-1 inclusive, of a key with base hash uHash in a
+   bucket with displacement iDisplacement. */
+static size_t SymTableFrozen_slot(uint64_t uHash, int32_t iDisplacement,
+   size_t uCount)
+{
+   if (iDisplacement < 0)
+      return (size_t)(-(iDisplacement + 1));
+   return (size_t)(SymTableFrozen_mix(uHash
+      ^ ((uint64_t)iDisplacement * SEED_MULTIPLIER)) % uCount);
+}
+
+/*
+    SymTableFrozen_collect is the SymTable_map callback used by SymTable_freeze. It appends the
+    key-value pair (pcKey, pvValue) to the FrozenBuilder pointed to by pvExtra.
+*/
+static void SymTableFrozen_collect(const char *pcKey, void *pvValue, void *pvExtra) {
+    struct FrozenBuilder *psBuilder = (struct FrozenBuilder *)pvExtra;
+    psBuilder->ppcKeys[psBuilder->uCount] = pcKey;
+    psBuilder->ppvValues[psBuilder->uCount] = pvValue;
+    psBuilder->uKeyBytes += strlen(pcKey) + 1;
+    psBuilder->uCount++;
+}
+
+/*
+    Placement is the scratch space used by SymTableFrozen_place. Every array has room for
+    uCount+2 elements.
+*/
+struct Placement
+{
+    /* puBucketStarts[b] is the index in puBucketKeys of the first key of bucket b. */
+   size_t *puBucketStarts;
+    /* puBucketKeys lists the keys grouped by bucket. */
+   size_t *puBucketKeys;
+    /* puBucketOrder lists the buckets by decreasing size. */
+   size_t *puBucketOrder;
+    /* puSizeStarts is the histogram of bucket sizes used to sort the buckets. */
+   size_t *puSizeStarts;
+    /* pucUsed[s] is 1 if slot s has been taken. */
+   unsigned char *pucUsed;
+};
+
+/*
+    SymTableFrozen_order fills psPlacement's bucket arrays for the keys whose base hashes are
+    puHashes, grouping the keys by bucket and listing the buckets from the largest down, both
+    with counting sorts.
+*/
+static void SymTableFrozen_order(struct Placement *psPlacement,
+    const uint64_t *puHashes, size_t uCount) {
+    size_t *puBucketStarts = psPlacement->puBucketStarts;
+    size_t *puSizeStarts = psPlacement->puSizeStarts;
+    size_t uMaxSize = 0;
+    size_t uBucket;
+    size_t uSize;
+    size_t u;
+
+    memset(puBucketStarts, 0, (uCount + 2) * sizeof(size_t));
+    memset(puSizeStarts, 0, (uCount + 2) * sizeof(size_t));
+    for (u = 0; u < uCount; u++)
+        puBucketStarts[SymTableFrozen_mix(puHashes[u]) % uCount + 2]++;
+    for (uBucket = 0; uBucket < uCount; uBucket++) {
+        if (puBucketStarts[uBucket + 2] > uMaxSize)
+            uMaxSize = puBucketStarts[uBucket + 2];
+        puBucketStarts[uBucket + 2] += puBucketStarts[uBucket + 1];
+    }
+    for (u = 0; u < uCount; u++)
+        psPlacement->puBucketKeys[puBucketStarts[
+            SymTableFrozen_mix(puHashes[u]) % uCount + 1]++] = u;
+
+    for (uBucket = 0; uBucket < uCount; uBucket++)
+        puSizeStarts[uMaxSize - (puBucketStarts[uBucket + 1]
+            - puBucketStarts[uBucket]) + 1]++;
+    for (uSize = 0; uSize <= uMaxSize; uSize++)
+        puSizeStarts[uSize + 1] += puSizeStarts[uSize];
+    for (uBucket = 0; uBucket < uCount; uBucket++)
+        psPlacement->puBucketOrder[puSizeStarts[uMaxSize
+            - (puBucketStarts[uBucket + 1] - puBucketStarts[uBucket])]++] = uBucket;
+}
+
+/*
+    SymTableFrozen_placeBucket tries seeds for the bucket uBucket, which holds more than one
+    key, until every key of the bucket lands in a distinct free slot. On success it stores the
+    seed in oSymTableFrozen, the slot of key i in puSlots[i], and returns 1. Returns 0 if no
+    seed up to MAX_SEED works.
+*/
+static int SymTableFrozen_placeBucket(SymTableFrozen_T oSymTableFrozen,
+    struct Placement *psPlacement, const uint64_t *puHashes, size_t *puSlots,
+    size_t uBucket) {
+    size_t uFirst = psPlacement->puBucketStarts[uBucket];
+    size_t uEnd = psPlacement->puBucketStarts[uBucket + 1];
+    size_t *puBucketKeys = psPlacement->puBucketKeys;
+    unsigned char *pucUsed = psPlacement->pucUsed;
+    size_t uSlot;
+    size_t v;
+    int32_t iSeed;
+    for (iSeed = 1; iSeed <= MAX_SEED; iSeed++) {
+        for (v = uFirst; v < uEnd; v++) {
+            uSlot = SymTableFrozen_slot(puHashes[puBucketKeys[v]], iSeed,
+                oSymTableFrozen->uCount);
+            if (pucUsed[uSlot])
+                break;
+            pucUsed[uSlot] = 1;
+            puSlots[puBucketKeys[v]] = uSlot;
+        }
+        if (v == uEnd) {
+            oSymTableFrozen->piDisplacements[uBucket] = iSeed;
+            return 1;
+        }
+        /* Release the slots taken by this attempt before trying the next seed. */
+        while (v > uFirst) {
+            v--;
+            pucUsed[puSlots[puBucketKeys[v]]] = 0;
+        }
+    }
+    return 0;
+}
+
+/*
+    SymTableFrozen_place tries to choose a displacement for each bucket of oSymTableFrozen so
+    that the keys, whose base hashes are puHashes, land in distinct slots. On success it stores
+    the chosen slot of key i in puSlots[i] and returns 1. It returns 0 if some bucket cannot be
+    placed with the current salt, and -1 if there is not enough memory. Buckets are placed from
+    the largest down, since large buckets are the hardest to fit and are easiest to place while
+    the slot array is still empty.
+*/
+static int SymTableFrozen_place(SymTableFrozen_T oSymTableFrozen,
+    const uint64_t *puHashes, size_t *puSlots) {
+    struct Placement sPlacement;
+    size_t uCount = oSymTableFrozen->uCount;
+    size_t uBucket;
+    size_t uSize;
+    size_t uFree = 0;
+    size_t u;
+    int iResult = -1;
+
+    sPlacement.puBucketStarts = (size_t *)malloc((uCount + 2) * sizeof(size_t));
+    sPlacement.puBucketKeys = (size_t *)malloc((uCount + 2) * sizeof(size_t));
+    sPlacement.puBucketOrder = (size_t *)malloc((uCount + 2) * sizeof(size_t));
+    sPlacement.puSizeStarts = (size_t *)malloc((uCount + 2) * sizeof(size_t));
+    sPlacement.pucUsed = (unsigned char *)calloc(uCount + 2, 1);
+    if (sPlacement.puBucketStarts != NULL && sPlacement.puBucketKeys != NULL
+            && sPlacement.puBucketOrder != NULL && sPlacement.puSizeStarts != NULL
+            && sPlacement.pucUsed != NULL) {
+        SymTableFrozen_order(&sPlacement, puHashes, uCount);
+        iResult = 1;
+        for (u = 0; u < uCount && iResult == 1; u++) {
+            uBucket = sPlacement.puBucketOrder[u];
+            uSize = sPlacement.puBucketStarts[uBucket + 1]
+                - sPlacement.puBucketStarts[uBucket];
+            if (uSize == 0) {
+                oSymTableFrozen->piDisplacements[uBucket] = 0;
+            }
+            else if (uSize == 1) {
+                /* A lone key takes the next free slot, which is stored directly. */
+                while (sPlacement.pucUsed[uFree])
+                    uFree++;
+                sPlacement.pucUsed[uFree] = 1;
+                puSlots[sPlacement.puBucketKeys[sPlacement.puBucketStarts[uBucket]]]
+                    = uFree;
+                oSymTableFrozen->piDisplacements[uBucket] = (int32_t)(-(long)uFree - 1);
+            }
+            else if (!SymTableFrozen_placeBucket(oSymTableFrozen, &sPlacement,
+                    puHashes, puSlots, uBucket)) {
+                iResult = 0;
+            }
+        }
+    }
+    free(sPlacement.puBucketStarts);
+    free(sPlacement.puBucketKeys);
+    free(sPlacement.puBucketOrder);
+    free(sPlacement.puSizeStarts);
+    free(sPlacement.pucUsed);
+    return iResult;
+}
+
+/*
+    SymTableFrozen_build fills oSymTableFrozen, whose uCount is already set, with the key-value
+    pairs collected in psBuilder. Returns 1 on success and 0 if there is not enough memory.
+*/
+static int SymTableFrozen_build(SymTableFrozen_T oSymTableFrozen,
+    const struct FrozenBuilder *psBuilder) {
+    uint64_t *puHashes;
+    size_t *puSlots;
+    char *pcNextKey;
+    size_t uKeyLength;
+    size_t u;
+    int iPlaced = 0;
+
+    puHashes = (uint64_t *)malloc((oSymTableFrozen->uCount + 1) * sizeof(uint64_t));
+    puSlots = (size_t *)malloc((oSymTableFrozen->uCount + 1) * sizeof(size_t));
+    /* Placement in practice only fails on a collision of base hashes, which a new salt
+       removes. */
+    oSymTableFrozen->uSalt = 0;
+    while (puHashes != NULL && puSlots != NULL && iPlaced == 0) {
+        for (u = 0; u < oSymTableFrozen->uCount; u++)
+            puHashes[u] = SymTableFrozen_hash(psBuilder->ppcKeys[u],
+                oSymTableFrozen->uSalt);
+        iPlaced = SymTableFrozen_place(oSymTableFrozen, puHashes, puSlots);
+        if (iPlaced == 0)
+            oSymTableFrozen->uSalt++;
+    }
+    if (iPlaced == 1) {
+        pcNextKey = oSymTableFrozen->pcKeys;
+        for (u = 0; u < oSymTableFrozen->uCount; u++) {
+            uKeyLength = strlen(psBuilder->ppcKeys[u]) + 1;
+            memcpy(pcNextKey, psBuilder->ppcKeys[u], uKeyLength);
+            oSymTableFrozen->psEntries[puSlots[u]].key = pcNextKey;
+            oSymTableFrozen->psEntries[puSlots[u]].value = psBuilder->ppvValues[u];
+            pcNextKey += uKeyLength;
+        }
+    }
+    free(puHashes);
+    free(puSlots);
+    return iPlaced == 1;
+}
+
+SymTableFrozen_T SymTable_freeze(SymTable_T oSymTable) {
+    SymTableFrozen_T oSymTableFrozen;
+    struct FrozenBuilder sBuilder;
+    size_t uLength;
+    int iSuccessful = 0;
+    assert(oSymTable != NULL);
+
+    uLength = SymTable_getLength(oSymTable);
+    /* Displacements are 32-bit, which bounds the number of slots they can name. */
+    if (uLength > (size_t)INT32_MAX)
+        return NULL;
+    oSymTableFrozen = (SymTableFrozen_T)calloc(1, sizeof(struct SymTableFrozen));
+    if (oSymTableFrozen == NULL)
+        return NULL;
+    sBuilder.ppcKeys = (const char **)malloc((uLength + 1) * sizeof(const char *));
+    sBuilder.ppvValues = (const void **)malloc((uLength + 1) * sizeof(const void *));
+    sBuilder.uCount = 0;
+    sBuilder.uKeyBytes = 0;
+    if (sBuilder.ppcKeys != NULL && sBuilder.ppvValues != NULL) {
+        SymTable_map(oSymTable, SymTableFrozen_collect, &sBuilder);
+        assert(sBuilder.uCount == uLength);
+        oSymTableFrozen->uCount = uLength;
+        oSymTableFrozen->uKeyBytes = sBuilder.uKeyBytes;
+        oSymTableFrozen->piDisplacements = (int32_t *)
+            malloc((uLength + 1) * sizeof(int32_t));
+        oSymTableFrozen->psEntries = (struct FrozenEntry *)
+            malloc((uLength + 1) * sizeof(struct FrozenEntry));
+        oSymTableFrozen->pcKeys = (char *)malloc(sBuilder.uKeyBytes + 1);
+        if (oSymTableFrozen->piDisplacements != NULL
+                && oSymTableFrozen->psEntries != NULL
+                && oSymTableFrozen->pcKeys != NULL)
+            iSuccessful = uLength == 0
+                || SymTableFrozen_build(oSymTableFrozen, &sBuilder);
+    }
+    free((void *)sBuilder.ppcKeys);
+    free((void *)sBuilder.ppvValues);
+    if (!iSuccessful) {
+        SymTableFrozen_free(oSymTableFrozen);
+        return NULL;
+    }
+    return oSymTableFrozen;
+}
+
+void SymTableFrozen_free(SymTableFrozen_T oSymTableFrozen) {
+    assert(oSymTableFrozen != NULL);
+    free(oSymTableFrozen->piDisplacements);
+    free(oSymTableFrozen->psEntries);
+    free(oSymTableFrozen->pcKeys);
+    free(oSymTableFrozen);
+}
+
+size_t SymTableFrozen_getLength(SymTableFrozen_T oSymTableFrozen) {
+    assert(oSymTableFrozen != NULL);
+    return oSymTableFrozen->uCount;
+}
+
+/*
+    SymTableFrozen_find returns the FrozenEntry of oSymTableFrozen whose key is pcKey, or NULL
+    if there is none. It computes one hash, reads one displacement and compares one key.
+*/
+static const struct FrozenEntry *SymTableFrozen_find(
+    SymTableFrozen_T oSymTableFrozen, const char *pcKey) {
+    const struct FrozenEntry *psEntry;
+    uint64_t uHash;
+    size_t uCount = oSymTableFrozen->uCount;
+    if (uCount == 0)
+        return NULL;
+    uHash = SymTableFrozen_hash(pcKey, oSymTableFrozen->uSalt);
+    psEntry = &oSymTableFrozen->psEntries[SymTableFrozen_slot(uHash,
+        oSymTableFrozen->piDisplacements[SymTableFrozen_mix(uHash) % uCount],
+        uCount)];
+    if (strcmp(psEntry->key, pcKey) != 0)
+        return NULL;
+    return psEntry;
+}
+
+int SymTableFrozen_contains(SymTableFrozen_T oSymTableFrozen, const char *pcKey) {
+    assert(oSymTableFrozen != NULL);
+    assert(pcKey != NULL);
+    return SymTableFrozen_find(oSymTableFrozen, pcKey) != NULL;
+}
+
+void *SymTableFrozen_get(SymTableFrozen_T oSymTableFrozen, const char *pcKey) {
+    const struct FrozenEntry *psEntry;
+    assert(oSymTableFrozen != NULL);
+    assert(pcKey != NULL);
+    psEntry = SymTableFrozen_find(oSymTableFrozen, pcKey);
+    if (psEntry == NULL)
+        return NULL;
+    return (void *)psEntry->value;
+}
+
+size_t SymTableFrozen_memoryUsage(SymTableFrozen_T oSymTableFrozen) {
+    assert(oSymTableFrozen != NULL);
+    return sizeof(struct SymTableFrozen)
+        + (oSymTableFrozen->uCount + 1) * sizeof(int32_t)
+        + (oSymTableFrozen->uCount + 1) * sizeof(struct FrozenEntry)
+        + oSymTableFrozen->uKeyBytes + 1;
+}
+
+void SymTableFrozen_map(SymTableFrozen_T oSymTableFrozen,
+    void (*pfApply)(const char *pcKey, void *pvValue, void *pvExtra),
+    const void *pvExtra) {
+    size_t u;
+    assert(oSymTableFrozen != NULL);
+    assert(pfApply != NULL);
+    for (u = 0; u < oSymTableFrozen->uCount; u++) {
+        (*pfApply)(oSymTableFrozen->psEntries[u].key,
+            (void *)oSymTableFrozen->psEntries[u].value, (void *)pvExtra);
+    }
+}
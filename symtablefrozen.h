@@ -0,0 +1,69 @@
+/*
+    Name: Tharun Kumar Tiruppali Kalidoss
+    File Name: symtablefrozen.h
+*/
+#include <stddef.h>
+#include "symtable.h"
+#ifndef SYMTABLEFROZEN_INCLUDED
+#define SYMTABLEFROZEN_INCLUDED
+
+/*
+   SymTableFrozen_T is of type struct SymTableFrozen*, and represents an immutable copy of a
+   SymTable_T. Its keys are placed with a minimal perfect hash function, so every lookup costs
+   exactly one probe of a displacement array, one probe of the entry array and one key
+   comparison, with no chains. All keys are packed into one contiguous block. Because nothing in a
+   SymTableFrozen_T changes after SymTable_freeze() returns, any number of threads may call its
+   lookup functions concurrently without locks.
+*/
+typedef struct SymTableFrozen *SymTableFrozen_T;
+
+/*
+   SymTable_freeze() returns a new SymTableFrozen_T value containing a copy of every key-value
+   pair of oSymTable, or NULL if insufficient memory is available. oSymTable itself is not
+   changed and may be freed afterwards; the values are shared, not copied. Takes in a parameter
+   of type SymTable_T called oSymTable representing the SymTable to freeze.
+*/
+SymTableFrozen_T SymTable_freeze(SymTable_T oSymTable);
+
+/*
+   SymTableFrozen_free frees all memory occupied by oSymTableFrozen. There is one parameter
+   called oSymTableFrozen of type SymTableFrozen_T. Returns nothing.
+*/
+void SymTableFrozen_free(SymTableFrozen_T oSymTableFrozen);
+
+/*
+   SymTableFrozen_getLength returns the number of key-value pairs in oSymTableFrozen as type
+   size_t.
+*/
+size_t SymTableFrozen_getLength(SymTableFrozen_T oSymTableFrozen);
+
+/*
+   SymTableFrozen_contains() returns 1 as type int if oSymTableFrozen contains a key-value pair
+   whose key is pcKey, and returns 0 as type int otherwise. Takes in parameters oSymTableFrozen of
+   type SymTableFrozen_T and pcKey of type const char*.
+*/
+int SymTableFrozen_contains(SymTableFrozen_T oSymTableFrozen, const char *pcKey);
+
+/*
+   SymTableFrozen_get() returns the value as a void* value of the key-value pair within
+   oSymTableFrozen whose key is pcKey, or NULL if no such key-value pair exists. Takes in
+   parameters oSymTableFrozen of type SymTableFrozen_T and pcKey of type const char*.
+*/
+void *SymTableFrozen_get(SymTableFrozen_T oSymTableFrozen, const char *pcKey);
+
+/*
+   SymTableFrozen_memoryUsage() returns the number of bytes of memory owned by oSymTableFrozen,
+   including the packed keys, as type size_t.
+*/
+size_t SymTableFrozen_memoryUsage(SymTableFrozen_T oSymTableFrozen);
+
+/*
+   SymTableFrozen_map() calls (*pfApply)(pcKey, pvValue, pvExtra) for each key-value pair in
+   oSymTableFrozen, in the order of the perfect hash. Takes in parameters oSymTableFrozen of type
+   SymTableFrozen_T, pfApply of type void (*)(const char*, void*, void*) and pvExtra of type
+   const void*.
+*/
+void SymTableFrozen_map(SymTableFrozen_T oSymTableFrozen,
+   void (*pfApply)(const char *pcKey, void *pvValue, void *pvExtra),
+   const void *pvExtra);
+#endif
@@ -0,0 +1,1626 @@
+/*
+    Name: Tharun Kumar Tiruppali Kalidoss
+    File Name: symtablehamt.c
+*/
+#include "symtable.h"
+#include "symtableimage.h"
+#include "symtablelog.h"
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <assert.h>
+#include <limits.h>
+
+#ifdef SYMTABLE_STATS
+/* STAT_ADD adds uAmount to the counter field of the statistics of oSymTable. Without
+   SYMTABLE_STATS it does nothing, so the counters cost nothing. */
+#define STAT_ADD(oSymTable, field, uAmount) ((oSymTable)->sStats.field += (uAmount))
+#else
+#define STAT_ADD(oSymTable, field, uAmount) ((void)(oSymTable))
+#endif
+
+
+/*
+    This implementation stores the key-value pairs in a persistent hash array mapped trie
+    (HAMT). Each level of the trie consumes BITS_PER_LEVEL bits of a key's 64-bit hash, and a
+    Branch stores only the children that exist, packed in an array and located with a bitmap.
+    Nodes are reference counted and may be shared by several SymTables. A change never
+    modifies a shared node: it copies the nodes on the path from the root to the change
+    (path copying) and leaves the shared ones alone, so SymTable_snapshot only has to share the
+    root. Nodes that only one SymTable can reach are modified in place, which keeps the cost of
+    a change close to that of a mutable trie when no snapshot is alive.
+*/
+
+/* NodeKind identifies the three kinds of Node. */
+enum NodeKind {LEAF, BRANCH, COLLISION};
+
+/*
+    Node is the header that every node of the trie starts with.
+*/
+struct Node
+{
+    /* uRefCount is the number of Branches, Collisions and SymTables pointing to the node. */
+   size_t uRefCount;
+    /* eKind tells which of Leaf, Branch and Collision the node is. */
+   enum NodeKind eKind;
+    /* uStamp is the scope number of the SymTable that allocated the node, when it did. A node
+        that the trie reaches with a lower number than the SymTable's was already in the trie
+        when the innermost open scope was pushed, so that scope's saved trie holds it too. */
+   unsigned int uStamp;
+};
+
+/*
+    Leaf is a node that holds a single key-value pair, with the key stored inline so that a
+    key-value pair costs one allocation, unless the key is borrowed.
+*/
+struct Leaf
+{
+    /* sNode is the common node header. */
+   struct Node sNode;
+    /* uHash is the 64-bit hash of key. */
+   uint64_t uHash;
+    /* value points to the value represented by key in the key-value pair. */
+   const void *value;
+    /* uScope is the scope number of the SymTable at the time the key was put. It is an unsigned
+        int so that iBorrowed fits beside it, and SymTable_pushScope stops at UINT_MAX. */
+   unsigned int uScope;
+    /* iBorrowed is 1 if the key was put with SymTable_putBorrowed, and 0 otherwise. */
+   int iBorrowed;
+    /* pShadowed is the Leaf of the same key from an outer scope that this Leaf hides, and that
+        a remove reveals while that scope is open, or NULL. The Leaf holds a reference to it. */
+   struct Leaf *pShadowed;
+    /* key is the key of the key-value pair: acOwned is the Leaf's own copy, and pcBorrowed is
+        the caller's string, which the Leaf neither copies nor frees, if iBorrowed is 1. Use
+        SymTable_leafKey to read it. */
+   union
+   {
+      char acOwned[1];
+      const char *pcBorrowed;
+   } key;
+};
+
+/*
+    Branch is a node with up to 32 children, one for each value of the BITS_PER_LEVEL bits of
+    the hash at its level. Bit i of uBitmap is set if there is a child for the value i, and the
+    children are stored in increasing order of i.
+*/
+struct Branch
+{
+    /* sNode is the common node header. */
+   struct Node sNode;
+    /* uBitmap records which children exist. */
+   uint32_t uBitmap;
+    /* apChildren holds the popcount(uBitmap) children. */
+   struct Node *apChildren[1];
+};
+
+/*
+    Collision is a node holding the Leaves of several keys whose 64-bit hashes are all equal.
+    It only appears once all the bits of the hash have been used.
+*/
+struct Collision
+{
+    /* sNode is the common node header. */
+   struct Node sNode;
+    /* uCount is the number of Leaves, at least 2. */
+   size_t uCount;
+    /* apLeaves holds the uCount Leaves. */
+   struct Leaf *apLeaves[1];
+};
+
+/*
+    Scope is the state that SymTable_pushScope saves and SymTable_popScope restores.
+*/
+struct Scope
+{
+    /* root is the root of the trie when the scope was pushed. The Scope holds a reference. */
+   struct Node *root;
+    /* size is the number of key-value pairs when the scope was pushed. */
+   size_t size;
+    /* uTrieBytes is the size of the trie when the scope was pushed. */
+   size_t uTrieBytes;
+    /* uScopedBytes is the uScopedBytes of the SymTable when the scope was pushed. */
+   size_t uScopedBytes;
+};
+
+/*
+    SymTable is a representation of the symbol table implemented with a persistent hash array
+    mapped trie.
+*/
+struct SymTable
+{
+    /* root points to the root node of the trie, or is NULL if the SymTable is empty. */
+   struct Node *root;
+    /* size represents the number of key-value pairs within the SymTable. It is of type size_t. */
+   size_t size;
+    /* uTrieBytes is the number of bytes of the nodes reachable from root, including the Leaves
+        they shadow, as estimated by SymTable_blockSize. Nodes shared with other SymTables are
+        counted in full. It is of type size_t. */
+   size_t uTrieBytes;
+    /* uScopedBytes is the number of bytes of the nodes that only the tries saved by open scopes
+        still reach, as estimated by SymTable_blockSize. It is of type size_t. */
+   size_t uScopedBytes;
+    /* oImage is the mapped snapshot that the SymTable is served from if it was opened with
+        SymTable_openMapped and has not been modified since, and NULL otherwise. While oImage
+        is not NULL the trie itself is empty. It is of type SymTableImage_T. */
+   SymTableImage_T oImage;
+    /* oLog is the write-ahead log that every change is recorded in if the SymTable was opened
+        with SymTable_openLogged, and NULL otherwise. It is of type SymTableLog_T. */
+   SymTableLog_T oLog;
+    /* psScopes holds the uScopeDepth open scopes, innermost last, and has room for
+        uScopeCapacity. */
+   struct Scope *psScopes;
+   size_t uScopeDepth;
+   size_t uScopeCapacity;
+    /* sAllocator is the allocator that every block of the SymTable, including the SymTable
+        itself and its nodes, comes from and goes back to. Snapshots share it along with the
+        nodes. It is of type SymTable_Allocator. */
+   SymTable_Allocator sAllocator;
+    /* uScope numbers the innermost scope. Leaves put in it carry the same number. Opening a
+        scope increments it and popping one decrements it. A snapshot starts from its original's
+        number, so the Leaves that they share count as put before any of the snapshot's scopes. */
+   size_t uScope;
+#ifdef SYMTABLE_STATS
+    /* sStats holds the counters reported by SymTable_getStats. */
+   SymTable_Stats sStats;
+#endif
+};
+
+/* BITS_PER_LEVEL is the number of hash bits consumed by each level of the trie. */
+enum {BITS_PER_LEVEL = 5};
+
+/* LEVEL_MASK selects the BITS_PER_LEVEL bits of a level. */
+static const uint64_t LEVEL_MASK = 31;
+
+/* HASH_BITS is the number of bits in a hash. Below this depth only Collisions remain. */
+enum {HASH_BITS = 64};
+
+/* Return the 64-bit hash of the uLength characters at pcKey (64-bit FNV-1a), which need not be
+   NUL-terminated. The trie needs all of the hash bits to be well distributed, which the bucket
+   hash of the other implementations does not provide. */
+static uint64_t SymTable_hash(const char *pcKey, size_t uLength)
+{
+   const uint64_t HASH_PRIME = (uint64_t)0x100000001B3ULL;
+   size_t u;
+   uint64_t uHash = (uint64_t)0xCBF29CE484222325ULL;
+
+   assert(pcKey != NULL);
+
+   for (u = 0; u < uLength; u++)
+   {
+      uHash ^= (uint64_t)(unsigned char)pcKey[u];
+      uHash *= HASH_PRIME;
+   }
+
+   return uHash;
+}
+
+/* Return the number of bits that are set in uBits. */
+static size_t SymTable_popCount(uint32_t uBits)
+{
+   uBits = uBits - ((uBits >> 1) & 0x55555555U);
+   uBits = (uBits & 0x33333333U) + ((uBits >> 2) & 0x33333333U);
+   uBits = (uBits + (uBits >> 4)) & 0x0F0F0F0FU;
+   return (size_t)((uBits * 0x01010101U) >> 24);
+}
+
+/* Allocate uSize bytes with the default allocator, which is malloc. pvContext is unused. */
+static void *SymTable_defaultAlloc(size_t uSize, void *pvContext)
+{
+   (void)pvContext;
+   return malloc(uSize);
+}
+
+/* Free pvBlock with the default allocator, which is free. pvContext is unused. */
+static void SymTable_defaultFree(void *pvBlock, void *pvContext)
+{
+   (void)pvContext;
+   free(pvBlock);
+}
+
+/* DEFAULT_ALLOCATOR is the allocator of the SymTables made by SymTable_new. */
+static const SymTable_Allocator DEFAULT_ALLOCATOR =
+   {SymTable_defaultAlloc, SymTable_defaultFree, NULL};
+
+/*
+    SymTable_allocate is a helper function that returns a block of uSize bytes from the allocator
+    of oSymTable, or NULL if there is not enough memory.
+*/
+static void *SymTable_allocate(SymTable_T oSymTable, size_t uSize) {
+    return (*oSymTable->sAllocator.pfAlloc)(uSize, oSymTable->sAllocator.pvContext);
+}
+
+/*
+    SymTable_deallocate is a helper function that gives pvBlock, which may be NULL, back to the
+    allocator of oSymTable. Returns nothing.
+*/
+static void SymTable_deallocate(SymTable_T oSymTable, void *pvBlock) {
+    if(pvBlock != NULL)
+        (*oSymTable->sAllocator.pfFree)(pvBlock, oSymTable->sAllocator.pvContext);
+}
+
+/*
+    SymTable_reallocate is a helper function that moves the block pvBlock of uOldSize bytes, which
+    may be NULL, to a block of uNewSize bytes from the allocator of oSymTable, and returns the new
+    block, or NULL if there is not enough memory, in which case pvBlock is unchanged. The default
+    allocator uses realloc, which may grow the block in place. Other allocators have no realloc,
+    so the block is copied.
+*/
+static void *SymTable_reallocate(SymTable_T oSymTable, void *pvBlock, size_t uOldSize,
+    size_t uNewSize) {
+    void *pvNewBlock;
+    if(oSymTable->sAllocator.pfAlloc == SymTable_defaultAlloc)
+        return realloc(pvBlock, uNewSize);
+    pvNewBlock = SymTable_allocate(oSymTable, uNewSize);
+    if(pvNewBlock == NULL)
+        return NULL;
+    if(pvBlock != NULL) {
+        memcpy(pvNewBlock, pvBlock, uOldSize < uNewSize ? uOldSize : uNewSize);
+        SymTable_deallocate(oSymTable, pvBlock);
+    }
+    return pvNewBlock;
+}
+
+/*
+    SymTable_shrink is a helper function that shrinks the node pNode, which is owned and uses
+    uOldSize bytes, to uNewSize bytes and returns it, possibly moved. Like a growing node, it is
+    shrunk in place by realloc with the default allocator and copied into a smaller block with
+    any other, so that every node keeps exactly the room it uses. If there is not enough memory pNode keeps its block, which is
+    harmless except that SymTable_memoryUsage then counts the node as shrunk.
+*/
+static struct Node *SymTable_shrink(SymTable_T oSymTable, struct Node *pNode, size_t uOldSize,
+    size_t uNewSize) {
+    struct Node *pShrunk;
+    pShrunk = (struct Node *)SymTable_reallocate(oSymTable, pNode, uOldSize, uNewSize);
+    return pShrunk == NULL ? pNode : pShrunk;
+}
+
+/* Return an estimate of the number of bytes that the allocator uses for a block of uBytes bytes:
+   the block rounded up, with the allocator's header, to a multiple of two words, and never less
+   than four words (as in the GNU C library's malloc). A block of 0 bytes is not allocated. */
+static size_t SymTable_blockSize(size_t uBytes)
+{
+   const size_t WORD = sizeof(size_t);
+
+   if (uBytes == 0)
+      return 0;
+   uBytes = (uBytes + WORD + 2 * WORD - 1) & ~(2 * WORD - 1);
+   return uBytes < 4 * WORD ? 4 * WORD : uBytes;
+}
+
+/*
+    SymTable_nodeSize returns the number of bytes of pNode alone, without its children, as
+    estimated by SymTable_blockSize. Every node is allocated with exactly the room it uses.
+*/
+static size_t SymTable_nodeSize(const struct Node *pNode) {
+    if(pNode->eKind == LEAF && ((const struct Leaf *)pNode)->iBorrowed)
+        return SymTable_blockSize(offsetof(struct Leaf, key) + sizeof(const char *));
+    if(pNode->eKind == LEAF)
+        return SymTable_blockSize(offsetof(struct Leaf, key)
+            + strlen(((const struct Leaf *)pNode)->key.acOwned) + 1);
+    if(pNode->eKind == COLLISION)
+        return SymTable_blockSize(offsetof(struct Collision, apLeaves)
+            + ((const struct Collision *)pNode)->uCount * sizeof(struct Leaf *));
+    return SymTable_blockSize(offsetof(struct Branch, apChildren)
+        + SymTable_popCount(((const struct Branch *)pNode)->uBitmap) * sizeof(struct Node *));
+}
+
+/*
+    SymTable_leafKey returns the key of pLeaf, whether it is owned or borrowed.
+*/
+static const char *SymTable_leafKey(const struct Leaf *pLeaf) {
+    return pLeaf->iBorrowed ? pLeaf->key.pcBorrowed : pLeaf->key.acOwned;
+}
+
+/*
+    SymTable_newLeaf returns a new Leaf for the key made of the uKeyLength characters at pcKey,
+    whose hash is uHash, and the value pvValue, or NULL if there is not enough memory. If
+    iBorrowed is 1 the Leaf points to pcKey itself, which must then be NUL-terminated; otherwise
+    it holds a NUL-terminated copy.
+*/
+static struct Leaf *SymTable_newLeaf(SymTable_T oSymTable, const char *pcKey, size_t uKeyLength,
+    uint64_t uHash, const void *pvValue, int iBorrowed) {
+    struct Leaf *pLeaf;
+    pLeaf = (struct Leaf *)SymTable_allocate(oSymTable, offsetof(struct Leaf, key)
+        + (iBorrowed ? sizeof(const char *) : uKeyLength + 1));
+    if(pLeaf == NULL)
+        return NULL;
+    pLeaf->sNode.uRefCount = 1;
+    pLeaf->sNode.eKind = LEAF;
+    pLeaf->sNode.uStamp = (unsigned int)oSymTable->uScope;
+    pLeaf->uHash = uHash;
+    pLeaf->value = pvValue;
+    pLeaf->uScope = 0;
+    pLeaf->iBorrowed = iBorrowed;
+    pLeaf->pShadowed = NULL;
+    if(iBorrowed)
+        pLeaf->key.pcBorrowed = pcKey;
+    else {
+        memcpy(pLeaf->key.acOwned, pcKey, uKeyLength);
+        pLeaf->key.acOwned[uKeyLength] = '\0';
+    }
+    return pLeaf;
+}
+
+/*
+    SymTable_newBranch returns a new Branch with room for uChildCount children and the bitmap
+    uBitmap, or NULL if there is not enough memory. The children are not initialized.
+*/
+static struct Branch *SymTable_newBranch(SymTable_T oSymTable, uint32_t uBitmap,
+    size_t uChildCount) {
+    struct Branch *pBranch;
+    pBranch = (struct Branch *)SymTable_allocate(oSymTable, offsetof(struct Branch, apChildren)
+        + uChildCount * sizeof(struct Node *));
+    if(pBranch == NULL)
+        return NULL;
+    pBranch->sNode.uRefCount = 1;
+    pBranch->sNode.eKind = BRANCH;
+    pBranch->sNode.uStamp = (unsigned int)oSymTable->uScope;
+    pBranch->uBitmap = uBitmap;
+    return pBranch;
+}
+
+/*
+    SymTable_newCollision returns a new Collision with room for uCount Leaves, or NULL if there
+    is not enough memory. The Leaves are not initialized.
+*/
+static struct Collision *SymTable_newCollision(SymTable_T oSymTable, size_t uCount) {
+    struct Collision *pCollision;
+    pCollision = (struct Collision *)SymTable_allocate(oSymTable,
+        offsetof(struct Collision, apLeaves)
+        + uCount * sizeof(struct Leaf *));
+    if(pCollision == NULL)
+        return NULL;
+    pCollision->sNode.uRefCount = 1;
+    pCollision->sNode.eKind = COLLISION;
+    pCollision->sNode.uStamp = (unsigned int)oSymTable->uScope;
+    pCollision->uCount = uCount;
+    return pCollision;
+}
+
+/*
+    SymTable_release drops one reference to pNode, freeing it, and releasing its children,
+    when no reference is left. Returns nothing.
+*/
+static void SymTable_release(SymTable_T oSymTable, struct Node *pNode) {
+    struct Branch *pBranch;
+    struct Collision *pCollision;
+    size_t u;
+    if(pNode == NULL || --pNode->uRefCount > 0)
+        return;
+    if(pNode->eKind == BRANCH) {
+        pBranch = (struct Branch *)pNode;
+        for(u = 0; u < SymTable_popCount(pBranch->uBitmap); u++)
+            SymTable_release(oSymTable, pBranch->apChildren[u]);
+    }
+    else if(pNode->eKind == COLLISION) {
+        pCollision = (struct Collision *)pNode;
+        for(u = 0; u < pCollision->uCount; u++)
+            SymTable_release(oSymTable, &pCollision->apLeaves[u]->sNode);
+    }
+    else if(((struct Leaf *)pNode)->pShadowed != NULL)
+        SymTable_release(oSymTable, &((struct Leaf *)pNode)->pShadowed->sNode);
+    SymTable_deallocate(oSymTable, pNode);
+}
+
+/*
+    SymTable_unlink is a helper function that is called just before the trie of oSymTable lets go
+    of pNode, by unlinking it or by replacing it with a copy. If another reference keeps pNode
+    alive and pNode is older than the innermost open scope, the trie saved by that scope holds it,
+    so its bytes are added to the uScopedBytes of oSymTable. Returns nothing.
+*/
+static void SymTable_unlink(SymTable_T oSymTable, const struct Node *pNode) {
+    if(oSymTable->uScopeDepth > 0 && pNode->uRefCount > 1
+            && pNode->uStamp < oSymTable->uScope)
+        oSymTable->uScopedBytes += SymTable_nodeSize(pNode);
+}
+
+/*
+    SymTable_own returns a version of pNode that only the caller references, so that the
+    caller may modify it: pNode itself if it is not shared, and otherwise a shallow copy that
+    references the same children, with pNode's reference moved to the copy. Leaves are never
+    passed to SymTable_own. Returns NULL if there is not enough memory, in which case pNode is
+    unchanged.
+*/
+static struct Node *SymTable_own(SymTable_T oSymTable, struct Node *pNode) {
+    struct Branch *pBranch;
+    struct Branch *pNewBranch;
+    struct Collision *pCollision;
+    struct Collision *pNewCollision;
+    size_t uCount;
+    size_t u;
+    assert(pNode->eKind != LEAF);
+    if(pNode->uRefCount == 1)
+        return pNode;
+    if(pNode->eKind == BRANCH) {
+        pBranch = (struct Branch *)pNode;
+        uCount = SymTable_popCount(pBranch->uBitmap);
+        pNewBranch = SymTable_newBranch(oSymTable, pBranch->uBitmap, uCount);
+        if(pNewBranch == NULL)
+            return NULL;
+        for(u = 0; u < uCount; u++) {
+            pNewBranch->apChildren[u] = pBranch->apChildren[u];
+            pNewBranch->apChildren[u]->uRefCount++;
+        }
+        SymTable_unlink(oSymTable, pNode);
+        pNode->uRefCount--;
+        return &pNewBranch->sNode;
+    }
+    pCollision = (struct Collision *)pNode;
+    pNewCollision = SymTable_newCollision(oSymTable, pCollision->uCount);
+    if(pNewCollision == NULL)
+        return NULL;
+    for(u = 0; u < pCollision->uCount; u++) {
+        pNewCollision->apLeaves[u] = pCollision->apLeaves[u];
+        pNewCollision->apLeaves[u]->sNode.uRefCount++;
+    }
+    SymTable_unlink(oSymTable, pNode);
+    pNode->uRefCount--;
+    return &pNewCollision->sNode;
+}
+
+/*
+    SymTable_sameKey returns 1 if the stored key pcStoredKey is the key made of the uLength
+    characters at pcKey, and 0 otherwise. strncmp stops at the end of pcStoredKey, so a stored
+    key shorter than uLength is never read past its end.
+*/
+static int SymTable_sameKey(const char *pcStoredKey, const char *pcKey, size_t uLength) {
+    return strncmp(pcStoredKey, pcKey, uLength) == 0 && pcStoredKey[uLength] == '\0';
+}
+
+/*
+    SymTable_isKey returns 1 if pLeaf's key is the uLength characters at pcKey, whose hash is
+    uHash, and 0 otherwise. The keys are only compared if the hashes are equal, and the
+    comparison is counted in the statistics of oSymTable.
+*/
+static int SymTable_isKey(SymTable_T oSymTable, const struct Leaf *pLeaf, const char *pcKey,
+    size_t uLength, uint64_t uHash) {
+    if(pLeaf->uHash != uHash)
+        return 0;
+    STAT_ADD(oSymTable, uComparisons, 1);
+    return SymTable_sameKey(SymTable_leafKey(pLeaf), pcKey, uLength);
+}
+
+/*
+    SymTable_findLeaf returns the Leaf of the trie of oSymTable whose key is the uLength
+    characters at pcKey, whose hash is uHash, or NULL if there is none.
+*/
+static struct Leaf *SymTable_findLeaf(SymTable_T oSymTable, const char *pcKey,
+    size_t uLength, uint64_t uHash) {
+    const struct Node *pNode = oSymTable->root;
+    const struct Branch *pBranch;
+    const struct Collision *pCollision;
+    struct Leaf *pLeaf;
+    uint32_t uBit;
+    unsigned int uShift = 0;
+    size_t u;
+    while(pNode != NULL) {
+        if(pNode->eKind == LEAF) {
+            pLeaf = (struct Leaf *)pNode;
+            if(SymTable_isKey(oSymTable, pLeaf, pcKey, uLength, uHash))
+                return pLeaf;
+            return NULL;
+        }
+        if(pNode->eKind == COLLISION) {
+            pCollision = (const struct Collision *)pNode;
+            for(u = 0; u < pCollision->uCount; u++) {
+                pLeaf = pCollision->apLeaves[u];
+                if(SymTable_isKey(oSymTable, pLeaf, pcKey, uLength, uHash))
+                    return pLeaf;
+            }
+            return NULL;
+        }
+        pBranch = (const struct Branch *)pNode;
+        uBit = (uint32_t)1 << ((uHash >> uShift) & LEVEL_MASK);
+        if((pBranch->uBitmap & uBit) == 0)
+            return NULL;
+        pNode = pBranch->apChildren[SymTable_popCount(pBranch->uBitmap & (uBit - 1))];
+        uShift += BITS_PER_LEVEL;
+    }
+    return NULL;
+}
+
+/*
+    SymTable_find returns the Leaf of the trie of oSymTable whose key is the uLength characters at
+    pcKey, whose hash is uHash, or NULL if there is none, and counts the lookup in the statistics
+    of oSymTable.
+*/
+static struct Leaf *SymTable_find(SymTable_T oSymTable, const char *pcKey, size_t uLength,
+    uint64_t uHash) {
+    struct Leaf *pLeaf = SymTable_findLeaf(oSymTable, pcKey, uLength, uHash);
+    STAT_ADD(oSymTable, uLookups, 1);
+    if(pLeaf == NULL)
+        STAT_ADD(oSymTable, uMisses, 1);
+    else
+        STAT_ADD(oSymTable, uHits, 1);
+    return pLeaf;
+}
+
+/*
+    SymTable_join returns a new node holding both pOldLeaf and pNewLeaf, which have different
+    keys, as it should appear uShift bits down the trie: a chain of single-child Branches down
+    to the level where the two hashes differ, or a Collision if they never do. Returns NULL if
+    there is not enough memory, leaving both Leaves untouched.
+*/
+static struct Node *SymTable_join(SymTable_T oSymTable, struct Leaf *pOldLeaf, struct Leaf *pNewLeaf,
+    unsigned int uShift) {
+    struct Collision *pCollision;
+    struct Branch *pBranch;
+    struct Node *pChild;
+    unsigned int uOldIndex;
+    unsigned int uNewIndex;
+    if(uShift >= HASH_BITS) {
+        pCollision = SymTable_newCollision(oSymTable, 2);
+        if(pCollision == NULL)
+            return NULL;
+        pCollision->apLeaves[0] = pOldLeaf;
+        pCollision->apLeaves[1] = pNewLeaf;
+        return &pCollision->sNode;
+    }
+    uOldIndex = (unsigned int)((pOldLeaf->uHash >> uShift) & LEVEL_MASK);
+    uNewIndex = (unsigned int)((pNewLeaf->uHash >> uShift) & LEVEL_MASK);
+    if(uOldIndex == uNewIndex) {
+        pChild = SymTable_join(oSymTable, pOldLeaf, pNewLeaf, uShift + BITS_PER_LEVEL);
+        if(pChild == NULL)
+            return NULL;
+        pBranch = SymTable_newBranch(oSymTable, (uint32_t)1 << uOldIndex, 1);
+        if(pBranch == NULL) {
+            /* Free the new nodes below without touching the Leaves. */
+            while(pChild->eKind == BRANCH) {
+                pBranch = (struct Branch *)pChild;
+                pChild = pBranch->apChildren[0];
+                SymTable_deallocate(oSymTable, pBranch);
+            }
+            if(pChild->eKind == COLLISION)
+                SymTable_deallocate(oSymTable, pChild);
+            return NULL;
+        }
+        pBranch->apChildren[0] = pChild;
+        return &pBranch->sNode;
+    }
+    pBranch = SymTable_newBranch(oSymTable, ((uint32_t)1 << uOldIndex) | ((uint32_t)1 << uNewIndex), 2);
+    if(pBranch == NULL)
+        return NULL;
+    pBranch->apChildren[uOldIndex < uNewIndex ? 0 : 1] = &pOldLeaf->sNode;
+    pBranch->apChildren[uOldIndex < uNewIndex ? 1 : 0] = &pNewLeaf->sNode;
+    return &pBranch->sNode;
+}
+
+/*
+    SymTable_insert adds pNewLeaf, whose key is not yet in the trie, to the trie of oSymTable,
+    copying every shared node on the way down, and adds the bytes that the trie grows by to its
+    uTrieBytes. Returns 1 on success and 0 if there is not enough memory.
+    Nodes copied before a failure stay in the trie, which is harmless because they are equal to
+    the nodes they replaced.
+*/
+static int SymTable_insert(SymTable_T oSymTable, struct Leaf *pNewLeaf) {
+    struct Node **ppSlot = &oSymTable->root;
+    size_t *puTrieBytes = &oSymTable->uTrieBytes;
+    struct Node *pNode;
+    struct Node *pOwned;
+    struct Branch *pBranch;
+    struct Branch *pNewBranch;
+    struct Collision *pCollision;
+    struct Collision *pNewCollision;
+    uint32_t uBit;
+    size_t uIndex;
+    size_t uCount;
+    unsigned int uShift = 0;
+    size_t u;
+    for(;;) {
+        pNode = *ppSlot;
+        if(pNode == NULL) {
+            *ppSlot = &pNewLeaf->sNode;
+            *puTrieBytes += SymTable_nodeSize(&pNewLeaf->sNode);
+            return 1;
+        }
+        if(pNode->eKind == LEAF) {
+            /* The Leaf keeps its reference, which moves into the joined node. */
+            pOwned = SymTable_join(oSymTable, (struct Leaf *)pNode, pNewLeaf, uShift);
+            if(pOwned == NULL)
+                return 0;
+            *ppSlot = pOwned;
+            *puTrieBytes += SymTable_nodeSize(&pNewLeaf->sNode);
+            /* The joined nodes are a chain of single-child Branches ending in a Branch or a
+               Collision that holds both Leaves. */
+            for(pNode = pOwned; pNode->eKind == BRANCH; pNode = pBranch->apChildren[0]) {
+                pBranch = (struct Branch *)pNode;
+                *puTrieBytes += SymTable_nodeSize(pNode);
+                if(SymTable_popCount(pBranch->uBitmap) > 1)
+                    return 1;
+            }
+            if(pNode->eKind == COLLISION)
+                *puTrieBytes += SymTable_nodeSize(pNode);
+            return 1;
+        }
+        pOwned = SymTable_own(oSymTable, pNode);
+        if(pOwned == NULL)
+            return 0;
+        *ppSlot = pOwned;
+        if(pOwned->eKind == COLLISION) {
+            pCollision = (struct Collision *)pOwned;
+            uCount = pCollision->uCount;
+            pNewCollision = (struct Collision *)SymTable_reallocate(oSymTable, pCollision,
+                offsetof(struct Collision, apLeaves) + uCount * sizeof(struct Leaf *),
+                offsetof(struct Collision, apLeaves) + (uCount + 1) * sizeof(struct Leaf *));
+            if(pNewCollision == NULL)
+                return 0;
+            *puTrieBytes -= SymTable_nodeSize(&pNewCollision->sNode);
+            pNewCollision->apLeaves[pNewCollision->uCount++] = pNewLeaf;
+            *ppSlot = &pNewCollision->sNode;
+            *puTrieBytes += SymTable_nodeSize(&pNewCollision->sNode)
+                + SymTable_nodeSize(&pNewLeaf->sNode);
+            return 1;
+        }
+        pBranch = (struct Branch *)pOwned;
+        uBit = (uint32_t)1 << ((pNewLeaf->uHash >> uShift) & LEVEL_MASK);
+        uIndex = SymTable_popCount(pBranch->uBitmap & (uBit - 1));
+        if((pBranch->uBitmap & uBit) == 0) {
+            uCount = SymTable_popCount(pBranch->uBitmap);
+            pNewBranch = (struct Branch *)SymTable_reallocate(oSymTable, pBranch,
+                offsetof(struct Branch, apChildren) + uCount * sizeof(struct Node *),
+                offsetof(struct Branch, apChildren) + (uCount + 1) * sizeof(struct Node *));
+            if(pNewBranch == NULL)
+                return 0;
+            *puTrieBytes -= SymTable_nodeSize(&pNewBranch->sNode);
+            for(u = uCount; u > uIndex; u--)
+                pNewBranch->apChildren[u] = pNewBranch->apChildren[u - 1];
+            pNewBranch->apChildren[uIndex] = &pNewLeaf->sNode;
+            pNewBranch->uBitmap |= uBit;
+            *ppSlot = &pNewBranch->sNode;
+            *puTrieBytes += SymTable_nodeSize(&pNewBranch->sNode)
+                + SymTable_nodeSize(&pNewLeaf->sNode);
+            return 1;
+        }
+        ppSlot = &pBranch->apChildren[uIndex];
+        uShift += BITS_PER_LEVEL;
+    }
+}
+
+/*
+    SymTable_ownPath returns a pointer to the slot holding the Leaf whose key is the uLength
+    characters at pcKey, whose hash is uHash, in the trie of oSymTable, after copying every shared
+    node on the path to it, so that the slot may be written. The key must be in the trie. If pppPath
+    is not NULL, the slots on the path, from the root slot down to the Leaf's slot, are
+    appended to pppPath, and *puDepth is advanced past them. Returns NULL if there is not
+    enough memory.
+*/
+static struct Node **SymTable_ownPath(SymTable_T oSymTable, const char *pcKey,
+    size_t uLength, uint64_t uHash, struct Node ***pppPath, size_t *puDepth) {
+    struct Node **ppSlot = &oSymTable->root;
+    struct Node *pOwned;
+    struct Branch *pBranch;
+    struct Collision *pCollision;
+    uint32_t uBit;
+    unsigned int uShift = 0;
+    size_t u;
+    for(;;) {
+        if(pppPath != NULL)
+            pppPath[(*puDepth)++] = ppSlot;
+        if((*ppSlot)->eKind == LEAF)
+            return ppSlot;
+        pOwned = SymTable_own(oSymTable, *ppSlot);
+        if(pOwned == NULL)
+            return NULL;
+        *ppSlot = pOwned;
+        if(pOwned->eKind == COLLISION) {
+            pCollision = (struct Collision *)pOwned;
+            for(u = 0; u < pCollision->uCount; u++) {
+                if(SymTable_sameKey(SymTable_leafKey(pCollision->apLeaves[u]), pcKey,
+                        uLength)) {
+                    ppSlot = (struct Node **)&pCollision->apLeaves[u];
+                    if(pppPath != NULL)
+                        pppPath[(*puDepth)++] = ppSlot;
+                    return ppSlot;
+                }
+            }
+            assert(0);
+        }
+        pBranch = (struct Branch *)pOwned;
+        uBit = (uint32_t)1 << ((uHash >> uShift) & LEVEL_MASK);
+        ppSlot = &pBranch->apChildren[SymTable_popCount(pBranch->uBitmap & (uBit - 1))];
+        uShift += BITS_PER_LEVEL;
+    }
+}
+
+/*
+    SymTable_ownLeaf returns the Leaf whose key is the uLength characters at pcKey, whose hash is
+    uHash, in the trie of oSymTable, after copying it and every shared node on the path to it, so that its value may
+    be written without changing any other SymTable. The key must be in the trie. Returns NULL
+    if there is not enough memory.
+*/
+static struct Leaf *SymTable_ownLeaf(SymTable_T oSymTable, const char *pcKey, size_t uLength,
+    uint64_t uHash) {
+    struct Node **ppSlot;
+    struct Leaf *pLeaf;
+    struct Leaf *pNewLeaf;
+    ppSlot = SymTable_ownPath(oSymTable, pcKey, uLength, uHash, NULL, NULL);
+    if(ppSlot == NULL)
+        return NULL;
+    pLeaf = (struct Leaf *)*ppSlot;
+    if(pLeaf->sNode.uRefCount == 1)
+        return pLeaf;
+    pNewLeaf = SymTable_newLeaf(oSymTable, SymTable_leafKey(pLeaf), uLength, uHash,
+        pLeaf->value, pLeaf->iBorrowed);
+    if(pNewLeaf == NULL)
+        return NULL;
+    pNewLeaf->uScope = pLeaf->uScope;
+    pNewLeaf->pShadowed = pLeaf->pShadowed;
+    if(pNewLeaf->pShadowed != NULL)
+        pNewLeaf->pShadowed->sNode.uRefCount++;
+    SymTable_unlink(oSymTable, &pLeaf->sNode);
+    pLeaf->sNode.uRefCount--;
+    *ppSlot = &pNewLeaf->sNode;
+    return pNewLeaf;
+}
+
+/*
+    SymTable_removeSlot removes the child stored at ppChild from the owned Branch or Collision
+    stored at ppParent, and collapses the parent into its remaining child when that child is
+    a Leaf, so that the trie never holds a Branch whose only content is one Leaf. The parent
+    is shrunk to the room it still uses, and the bytes that the trie of oSymTable shrinks by
+    are subtracted from its uTrieBytes. Returns 1 if the parent is now empty (and has been freed), and 0
+    otherwise.
+*/
+static int SymTable_removeSlot(SymTable_T oSymTable, struct Node **ppParent,
+    struct Node **ppChild) {
+    size_t *puTrieBytes = &oSymTable->uTrieBytes;
+    struct Branch *pBranch;
+    struct Collision *pCollision;
+    struct Node *pRemaining;
+    size_t uIndex;
+    size_t uCount;
+    size_t u;
+    *puTrieBytes -= SymTable_nodeSize(*ppParent);
+    if((*ppParent)->eKind == COLLISION) {
+        pCollision = (struct Collision *)*ppParent;
+        uIndex = (size_t)((struct Leaf **)ppChild - pCollision->apLeaves);
+        for(u = uIndex; u + 1 < pCollision->uCount; u++)
+            pCollision->apLeaves[u] = pCollision->apLeaves[u + 1];
+        pCollision->uCount--;
+        if(pCollision->uCount == 1) {
+            *ppParent = &pCollision->apLeaves[0]->sNode;
+            SymTable_deallocate(oSymTable, pCollision);
+            return 0;
+        }
+        *ppParent = SymTable_shrink(oSymTable, &pCollision->sNode,
+            offsetof(struct Collision, apLeaves) + (pCollision->uCount + 1) * sizeof(struct Leaf *),
+            offsetof(struct Collision, apLeaves) + pCollision->uCount * sizeof(struct Leaf *));
+        *puTrieBytes += SymTable_nodeSize(*ppParent);
+        return 0;
+    }
+    pBranch = (struct Branch *)*ppParent;
+    uCount = SymTable_popCount(pBranch->uBitmap);
+    uIndex = (size_t)(ppChild - pBranch->apChildren);
+    /* Clear the uIndex-th set bit of the bitmap. */
+    for(u = 0; u < 32; u++) {
+        if((pBranch->uBitmap & ((uint32_t)1 << u)) != 0
+                && SymTable_popCount(pBranch->uBitmap & (((uint32_t)1 << u) - 1)) == uIndex) {
+            pBranch->uBitmap &= ~((uint32_t)1 << u);
+            break;
+        }
+    }
+    for(u = uIndex; u + 1 < uCount; u++)
+        pBranch->apChildren[u] = pBranch->apChildren[u + 1];
+    uCount--;
+    if(uCount == 0) {
+        SymTable_deallocate(oSymTable, pBranch);
+        *ppParent = NULL;
+        return 1;
+    }
+    pRemaining = pBranch->apChildren[0];
+    if(uCount == 1 && pRemaining->eKind == LEAF) {
+        SymTable_deallocate(oSymTable, pBranch);
+        *ppParent = pRemaining;
+        return 0;
+    }
+    *ppParent = SymTable_shrink(oSymTable, &pBranch->sNode,
+        offsetof(struct Branch, apChildren) + (uCount + 1) * sizeof(struct Node *),
+        offsetof(struct Branch, apChildren) + uCount * sizeof(struct Node *));
+    *puTrieBytes += SymTable_nodeSize(*ppParent);
+    return 0;
+}
+
+/* MAX_DEPTH bounds the number of slots on a path from the root to a Leaf: the root slot, one
+   slot per level of Branches and one slot inside a Collision. */
+enum {MAX_DEPTH = HASH_BITS / BITS_PER_LEVEL + 4};
+
+/*
+    SymTable_freeTrie is a helper function that drops oSymTable's references to its trie and
+    to the tries saved by its open scopes, and leaves it empty with no open scope. Returns
+    nothing.
+*/
+static void SymTable_freeTrie(SymTable_T oSymTable) {
+    while(oSymTable->uScopeDepth > 0) {
+        oSymTable->uScopeDepth--;
+        SymTable_release(oSymTable, oSymTable->psScopes[oSymTable->uScopeDepth].root);
+    }
+    SymTable_release(oSymTable, oSymTable->root);
+    oSymTable->root = NULL;
+    oSymTable->size = 0;
+    oSymTable->uTrieBytes = 0;
+    oSymTable->uScopedBytes = 0;
+}
+
+SymTable_T SymTable_new(void) {
+    return SymTable_newWithAllocator(&DEFAULT_ALLOCATOR);
+}
+
+SymTable_T SymTable_newWithAllocator(const SymTable_Allocator *psAllocator) {
+    SymTable_T oSymTable;
+    assert(psAllocator != NULL);
+    assert(psAllocator->pfAlloc != NULL);
+    assert(psAllocator->pfFree != NULL);
+    oSymTable = (SymTable_T)(*psAllocator->pfAlloc)(sizeof(struct SymTable),
+        psAllocator->pvContext);
+    if (oSymTable == NULL)
+        return NULL;
+    oSymTable->sAllocator = *psAllocator;
+    oSymTable->root = NULL;
+    oSymTable->size = 0;
+    oSymTable->uTrieBytes = 0;
+    oSymTable->uScopedBytes = 0;
+    oSymTable->oImage = NULL;
+    oSymTable->oLog = NULL;
+    oSymTable->psScopes = NULL;
+    oSymTable->uScopeDepth = 0;
+    oSymTable->uScopeCapacity = 0;
+    oSymTable->uScope = 0;
+#ifdef SYMTABLE_STATS
+    memset(&oSymTable->sStats, 0, sizeof(SymTable_Stats));
+#endif
+    return oSymTable;
+}
+
+/* A trie grows one node at a time and never rehashes, so there is nothing to reserve. */
+SymTable_T SymTable_newWithCapacity(size_t uCapacity) {
+    (void)uCapacity;
+    return SymTable_new();
+}
+
+/* A trie has no order of use to evict by, so it has no bound. */
+SymTable_T SymTable_newBounded(size_t uMaxEntries,
+    void (*pfEvict)(const char *pcKey, void *pvValue, void *pvExtra), const void *pvExtra) {
+    assert(uMaxEntries > 0);
+    (void)uMaxEntries;
+    (void)pfEvict;
+    (void)pvExtra;
+    return NULL;
+}
+
+int SymTable_reserve(SymTable_T oSymTable, size_t uCapacity) {
+    assert(oSymTable != NULL);
+    (void)uCapacity;
+    return 1;
+}
+
+void SymTable_free(SymTable_T oSymTable) {
+    assert(oSymTable != NULL);
+    if(oSymTable->oLog != NULL)
+        SymTableLog_close(oSymTable->oLog);
+    if(oSymTable->oImage != NULL)
+        SymTableImage_close(oSymTable->oImage);
+    SymTable_freeTrie(oSymTable);
+    SymTable_deallocate(oSymTable, oSymTable->psScopes);
+    SymTable_deallocate(oSymTable, oSymTable);
+}
+
+size_t SymTable_getLength(SymTable_T oSymTable) {
+    assert(oSymTable != NULL);
+    if(oSymTable->oImage != NULL)
+        return SymTableImage_getLength(oSymTable->oImage);
+    return oSymTable->size;
+}
+
+/*
+    Promotion is the state that SymTable_promote passes to SymTable_promoteBinding.
+*/
+struct Promotion
+{
+    /* oSymTable is the SymTable that the key-value pairs are copied into. */
+   SymTable_T oSymTable;
+    /* iSuccessful stays 1 until a SymTable_put fails. */
+   int iSuccessful;
+};
+
+/*
+    SymTable_promoteBinding is the SymTableImage_map callback used by SymTable_promote. It puts
+    the key-value pair (pcKey, pvValue) into the SymTable of the Promotion pointed to by pvExtra,
+    and clears its iSuccessful flag if the put fails.
+*/
+static void SymTable_promoteBinding(const char *pcKey, void *pvValue,
+    void *pvExtra) {
+    struct Promotion *psPromotion = (struct Promotion *)pvExtra;
+    if(psPromotion->iSuccessful
+            && !SymTable_put(psPromotion->oSymTable, pcKey, pvValue))
+        psPromotion->iSuccessful = 0;
+}
+
+/*
+    SymTable_promote is a helper function that turns a SymTable served from a mapped snapshot
+    into an ordinary trie by copying every key-value pair out of the mapping, and then unmaps
+    the snapshot. It is called before the first change that cannot be made in the mapping
+    itself. The parameter is a SymTable_T representing the SymTable to promote. Returns 1 on
+    success (including when there is nothing to promote), and 0 if there is not enough memory,
+    in which case oSymTable is still served from the mapping.
+*/
+static int SymTable_promote(SymTable_T oSymTable) {
+    struct Promotion sPromotion;
+    SymTableImage_T oImage;
+    SymTableLog_T oLog;
+    if(oSymTable->oImage == NULL)
+        return 1;
+    /* Detach the image first so that the puts below go to the trie, and the log so that they
+       are not recorded again. */
+    oImage = oSymTable->oImage;
+    oSymTable->oImage = NULL;
+    oLog = oSymTable->oLog;
+    oSymTable->oLog = NULL;
+    sPromotion.oSymTable = oSymTable;
+    sPromotion.iSuccessful = 1;
+    SymTableImage_map(oImage, SymTable_promoteBinding, &sPromotion);
+    oSymTable->oLog = oLog;
+    if(!sPromotion.iSuccessful) {
+        SymTable_freeTrie(oSymTable);
+        oSymTable->oImage = oImage;
+        return 0;
+    }
+    SymTableImage_close(oImage);
+    return 1;
+}
+
+SymTable_T SymTable_openMapped(const char *pcPath) {
+    SymTable_T oSymTable;
+    SymTableImage_T oImage;
+    assert(pcPath != NULL);
+    oImage = SymTableImage_open(pcPath);
+    if(oImage == NULL)
+        return NULL;
+    oSymTable = SymTable_new();
+    if(oSymTable == NULL) {
+        SymTableImage_close(oImage);
+        return NULL;
+    }
+    oSymTable->oImage = oImage;
+    return oSymTable;
+}
+
+SymTable_T SymTable_openLogged(const char *pcPath) {
+    SymTable_T oSymTable;
+    SymTableLog_T oLog;
+    assert(pcPath != NULL);
+    oLog = SymTableLog_open(pcPath, &oSymTable);
+    if(oLog == NULL)
+        return NULL;
+    oSymTable->oLog = oLog;
+    return oSymTable;
+}
+
+int SymTable_setLogBatch(SymTable_T oSymTable, size_t uRecords) {
+    assert(oSymTable != NULL);
+    if(oSymTable->oLog == NULL)
+        return 0;
+    SymTableLog_setBatch(oSymTable->oLog, uRecords);
+    return 1;
+}
+
+int SymTable_syncLog(SymTable_T oSymTable) {
+    assert(oSymTable != NULL);
+    if(oSymTable->oLog == NULL)
+        return 0;
+    return SymTableLog_sync(oSymTable->oLog);
+}
+
+int SymTable_checkpoint(SymTable_T oSymTable) {
+    assert(oSymTable != NULL);
+    if(oSymTable->oLog == NULL)
+        return 0;
+    return SymTableLog_checkpoint(oSymTable->oLog, oSymTable);
+}
+
+/*
+    SymTable_logChange is a helper function that records a change of kind eKind to the key made
+    of the uLength characters at pcKey, with the value pvValue, in the log of oSymTable, if it
+    has one. Returns nothing.
+*/
+static void SymTable_logChange(SymTable_T oSymTable, SymTableLog_Kind eKind, const char *pcKey,
+    size_t uLength, const void *pvValue) {
+    if(oSymTable->oLog != NULL)
+        SymTableLog_append(oSymTable->oLog, eKind, pcKey, uLength, pvValue);
+}
+
+SymTable_T SymTable_snapshot(SymTable_T oSymTable) {
+    SymTable_T oSnapshot;
+    assert(oSymTable != NULL);
+    /* Snapshots share tries, not mappings, so a mapped table is promoted first. */
+    if(!SymTable_promote(oSymTable))
+        return NULL;
+    /* The snapshot shares nodes, so it must free them the way they were allocated. */
+    oSnapshot = SymTable_newWithAllocator(&oSymTable->sAllocator);
+    if(oSnapshot == NULL)
+        return NULL;
+    oSnapshot->root = oSymTable->root;
+    oSnapshot->size = oSymTable->size;
+    oSnapshot->uTrieBytes = oSymTable->uTrieBytes;
+    oSnapshot->uScope = oSymTable->uScope;
+    if(oSnapshot->root != NULL)
+        oSnapshot->root->uRefCount++;
+    return oSnapshot;
+}
+
+/* Copying the trie would cost more than sharing it and buy nothing, so a clone is a snapshot. */
+SymTable_T SymTable_clone(SymTable_T oSymTable) {
+    return SymTable_snapshot(oSymTable);
+}
+
+/*
+    SymTable_putKey is a helper function that does the work of SymTable_putN and
+    SymTable_putBorrowed: it puts the key made of the uLength characters at pcKey, with the value
+    pvValue, borrowing pcKey if iBorrowed is 1 and copying it otherwise. Returns 1 on success, and
+    0 if the key is already bound in the innermost scope or there is not enough memory.
+*/
+static int SymTable_putKey(SymTable_T oSymTable, const char *pcKey, size_t uLength,
+    const void *pvValue, int iBorrowed) {
+    struct Node **ppSlot;
+    struct Leaf *pLeaf;
+    struct Leaf *pNewLeaf;
+    uint64_t uHash;
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+    /* A key that is already in the mapping is rejected without promoting. */
+    if(oSymTable->oImage != NULL) {
+        if(SymTableImage_findN(oSymTable->oImage, pcKey, uLength) != NULL
+                || !SymTable_promote(oSymTable))
+            return 0;
+    }
+    uHash = SymTable_hash(pcKey, uLength);
+    /* Look before copying anything, so that a failed put never copies a path. A key put in an
+       outer scope is shadowed: its Leaf stays in the trie saved by the scope. */
+    pLeaf = SymTable_find(oSymTable, pcKey, uLength, uHash);
+    if(pLeaf != NULL
+            && (oSymTable->uScopeDepth == 0 || pLeaf->uScope == oSymTable->uScope))
+        return 0;
+    pNewLeaf = SymTable_newLeaf(oSymTable, pcKey, uLength, uHash, pvValue, iBorrowed);
+    if(pNewLeaf == NULL)
+        return 0;
+    pNewLeaf->uScope = (unsigned int)oSymTable->uScope;
+    if(pLeaf != NULL) {
+        ppSlot = SymTable_ownPath(oSymTable, pcKey, uLength, uHash, NULL, NULL);
+        if(ppSlot == NULL) {
+            SymTable_deallocate(oSymTable, pNewLeaf);
+            return 0;
+        }
+        /* The slot's reference to the outer Leaf moves to the new Leaf. */
+        pNewLeaf->pShadowed = (struct Leaf *)*ppSlot;
+        *ppSlot = &pNewLeaf->sNode;
+        oSymTable->uTrieBytes += SymTable_nodeSize(&pNewLeaf->sNode);
+        return 1;
+    }
+    if(!SymTable_insert(oSymTable, pNewLeaf)) {
+        SymTable_deallocate(oSymTable, pNewLeaf);
+        return 0;
+    }
+    oSymTable->size = oSymTable->size + 1;
+    SymTable_logChange(oSymTable, SYMTABLELOG_PUT, pcKey, uLength, pvValue);
+    return 1;
+}
+
+int SymTable_putN(SymTable_T oSymTable, const char *pcKey, size_t uLength,
+    const void *pvValue) {
+    return SymTable_putKey(oSymTable, pcKey, uLength, pvValue, 0);
+}
+
+int SymTable_put(SymTable_T oSymTable,
+   const char *pcKey, const void *pvValue) {
+    assert(pcKey != NULL);
+    return SymTable_putKey(oSymTable, pcKey, strlen(pcKey), pvValue, 0);
+}
+
+int SymTable_putBorrowed(SymTable_T oSymTable, const char *pcKey, const void *pvValue) {
+    assert(pcKey != NULL);
+    return SymTable_putKey(oSymTable, pcKey, strlen(pcKey), pvValue, 1);
+}
+
+/* Leaves are reference counted and can outlive the SymTable in snapshots, so each is allocated on
+   its own; building the trie without scopes or a mapping skips the rest of SymTable_put. */
+SymTable_T SymTable_fromArrays(const char *const *apcKeys, const void *const *apvValues,
+    size_t uCount) {
+    SymTable_T oSymTable;
+    struct Leaf *pNewLeaf;
+    uint64_t uHash;
+    size_t uLength;
+    size_t u;
+    assert(apcKeys != NULL || uCount == 0);
+    assert(apvValues != NULL || uCount == 0);
+    oSymTable = SymTable_new();
+    if(oSymTable == NULL)
+        return NULL;
+    for(u = 0; u < uCount; u++) {
+        assert(apcKeys[u] != NULL);
+        uLength = strlen(apcKeys[u]);
+        uHash = SymTable_hash(apcKeys[u], uLength);
+        if(SymTable_find(oSymTable, apcKeys[u], uLength, uHash) != NULL)
+            continue;
+        pNewLeaf = SymTable_newLeaf(oSymTable, apcKeys[u], uLength, uHash, apvValues[u], 0);
+        if(pNewLeaf == NULL || !SymTable_insert(oSymTable, pNewLeaf)) {
+            SymTable_deallocate(oSymTable, pNewLeaf);
+            SymTable_free(oSymTable);
+            return NULL;
+        }
+        oSymTable->size = oSymTable->size + 1;
+    }
+    return oSymTable;
+}
+
+void *SymTable_replaceN(SymTable_T oSymTable,
+    const char *pcKey, size_t uLength, const void *pvValue) {
+    struct Leaf *pLeaf;
+    void **ppvSlot;
+    void *ret;
+    uint64_t uHash;
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+    /* Values can be replaced inside the private mapping without promoting. */
+    if(oSymTable->oImage != NULL) {
+        ppvSlot = SymTableImage_findN(oSymTable->oImage, pcKey, uLength);
+        if(ppvSlot == NULL)
+            return NULL;
+        ret = *ppvSlot;
+        *ppvSlot = (void *)pvValue;
+        SymTable_logChange(oSymTable, SYMTABLELOG_REPLACE, pcKey, uLength, pvValue);
+        return ret;
+    }
+    uHash = SymTable_hash(pcKey, uLength);
+    pLeaf = SymTable_find(oSymTable, pcKey, uLength, uHash);
+    if(pLeaf == NULL)
+        return NULL;
+    ret = (void *)pLeaf->value;
+    pLeaf = SymTable_ownLeaf(oSymTable, pcKey, uLength, uHash);
+    if(pLeaf == NULL)
+        return NULL;
+    pLeaf->value = pvValue;
+    SymTable_logChange(oSymTable, SYMTABLELOG_REPLACE, pcKey, uLength, pvValue);
+    return ret;
+}
+
+void *SymTable_replace(SymTable_T oSymTable,
+    const char *pcKey, const void *pvValue) {
+    assert(pcKey != NULL);
+    return SymTable_replaceN(oSymTable, pcKey, strlen(pcKey), pvValue);
+}
+
+void **SymTable_upsertN(SymTable_T oSymTable, const char *pcKey, size_t uLength,
+    int *piInserted) {
+    struct Leaf *pLeaf;
+    void **ppvSlot;
+    uint64_t uHash;
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+    if(piInserted != NULL)
+        *piInserted = 0;
+    /* A value stored through the slot would never reach the log. */
+    if(oSymTable->oLog != NULL)
+        return NULL;
+    /* A key that is already in the mapping has its slot there, as for SymTable_replace. */
+    if(oSymTable->oImage != NULL) {
+        ppvSlot = SymTableImage_findN(oSymTable->oImage, pcKey, uLength);
+        if(ppvSlot != NULL)
+            return ppvSlot;
+        if(!SymTable_promote(oSymTable))
+            return NULL;
+    }
+    uHash = SymTable_hash(pcKey, uLength);
+    /* The slot is written after the call returns, so its Leaf must not be shared with a
+       snapshot or with the trie saved by an open scope. */
+    if(SymTable_find(oSymTable, pcKey, uLength, uHash) != NULL) {
+        pLeaf = SymTable_ownLeaf(oSymTable, pcKey, uLength, uHash);
+        return pLeaf == NULL ? NULL : (void **)&pLeaf->value;
+    }
+    pLeaf = SymTable_newLeaf(oSymTable, pcKey, uLength, uHash, NULL, 0);
+    if(pLeaf == NULL)
+        return NULL;
+    pLeaf->uScope = (unsigned int)oSymTable->uScope;
+    if(!SymTable_insert(oSymTable, pLeaf)) {
+        SymTable_deallocate(oSymTable, pLeaf);
+        return NULL;
+    }
+    oSymTable->size = oSymTable->size + 1;
+    if(piInserted != NULL)
+        *piInserted = 1;
+    return (void **)&pLeaf->value;
+}
+
+void **SymTable_upsert(SymTable_T oSymTable, const char *pcKey, int *piInserted) {
+    assert(pcKey != NULL);
+    return SymTable_upsertN(oSymTable, pcKey, strlen(pcKey), piInserted);
+}
+
+int SymTable_containsN(SymTable_T oSymTable, const char *pcKey, size_t uLength) {
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+    if(oSymTable->oImage != NULL)
+        return SymTableImage_findN(oSymTable->oImage, pcKey, uLength) != NULL;
+    return SymTable_find(oSymTable, pcKey, uLength, SymTable_hash(pcKey, uLength)) != NULL;
+}
+
+int SymTable_contains(SymTable_T oSymTable, const char *pcKey) {
+    assert(pcKey != NULL);
+    return SymTable_containsN(oSymTable, pcKey, strlen(pcKey));
+}
+
+void *SymTable_getN(SymTable_T oSymTable, const char *pcKey, size_t uLength) {
+    struct Leaf *pLeaf;
+    void **ppvSlot;
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+    if(oSymTable->oImage != NULL) {
+        ppvSlot = SymTableImage_findN(oSymTable->oImage, pcKey, uLength);
+        return ppvSlot == NULL ? NULL : *ppvSlot;
+    }
+    pLeaf = SymTable_find(oSymTable, pcKey, uLength, SymTable_hash(pcKey, uLength));
+    if(pLeaf == NULL)
+        return NULL;
+    return (void *)pLeaf->value;
+}
+
+void *SymTable_get(SymTable_T oSymTable, const char *pcKey) {
+    assert(pcKey != NULL);
+    return SymTable_getN(oSymTable, pcKey, strlen(pcKey));
+}
+
+void *SymTable_removeN(SymTable_T oSymTable, const char *pcKey, size_t uLength) {
+    struct Node **appPath[MAX_DEPTH];
+    struct Node **ppSlot;
+    struct Leaf *pLeaf;
+    void *prevValue;
+    uint64_t uHash;
+    size_t uDepth = 0;
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+    /* Removing a key that is not in the mapping changes nothing, so only promote for a hit. */
+    if(oSymTable->oImage != NULL) {
+        if(SymTableImage_findN(oSymTable->oImage, pcKey, uLength) == NULL
+                || !SymTable_promote(oSymTable))
+            return NULL;
+    }
+    uHash = SymTable_hash(pcKey, uLength);
+    pLeaf = SymTable_find(oSymTable, pcKey, uLength, uHash);
+    if(pLeaf == NULL)
+        return NULL;
+    prevValue = (void *)pLeaf->value;
+    ppSlot = SymTable_ownPath(oSymTable, pcKey, uLength, uHash, appPath, &uDepth);
+    if(ppSlot == NULL)
+        return NULL;
+    SymTable_logChange(oSymTable, SYMTABLELOG_REMOVE, pcKey, uLength, NULL);
+    /* A Leaf put in an open scope that shadows another is replaced by it, and the key stays in
+       the SymTable. A Leaf from before the scopes of oSymTable, which a snapshot can share with
+       a SymTable whose scope is still open, shadows nothing in oSymTable. */
+    pLeaf = (struct Leaf *)*ppSlot;
+    oSymTable->uTrieBytes -= SymTable_nodeSize(&pLeaf->sNode);
+    SymTable_unlink(oSymTable, &pLeaf->sNode);
+    if(pLeaf->pShadowed != NULL
+            && pLeaf->uScope > oSymTable->uScope - oSymTable->uScopeDepth) {
+        *ppSlot = &pLeaf->pShadowed->sNode;
+        (*ppSlot)->uRefCount++;
+        SymTable_release(oSymTable, &pLeaf->sNode);
+        return prevValue;
+    }
+    /* Unlink the Leaf, then remove every parent that the removal leaves empty. */
+    SymTable_release(oSymTable, *ppSlot);
+    *ppSlot = NULL;
+    uDepth--;
+    while(uDepth > 0 && SymTable_removeSlot(oSymTable, appPath[uDepth - 1], appPath[uDepth]))
+        uDepth--;
+    oSymTable->size = oSymTable->size - 1;
+    return prevValue;
+}
+
+void *SymTable_remove(SymTable_T oSymTable, const char *pcKey) {
+    assert(pcKey != NULL);
+    return SymTable_removeN(oSymTable, pcKey, strlen(pcKey));
+}
+
+/*
+    SymTable_mapNode applies pfApply to every key-value pair in the trie rooted at pNode,
+    passing pvExtra as the extra parameter. Returns nothing.
+*/
+static void SymTable_mapNode(const struct Node *pNode,
+    void (*pfApply)(const char *pcKey, void *pvValue, void *pvExtra),
+    const void *pvExtra) {
+    const struct Branch *pBranch;
+    const struct Collision *pCollision;
+    const struct Leaf *pLeaf;
+    size_t u;
+    if(pNode == NULL)
+        return;
+    if(pNode->eKind == LEAF) {
+        pLeaf = (const struct Leaf *)pNode;
+        (*pfApply)(SymTable_leafKey(pLeaf), (void *)pLeaf->value, (void *)pvExtra);
+    }
+    else if(pNode->eKind == COLLISION) {
+        pCollision = (const struct Collision *)pNode;
+        for(u = 0; u < pCollision->uCount; u++)
+            SymTable_mapNode(&pCollision->apLeaves[u]->sNode, pfApply, pvExtra);
+    }
+    else {
+        pBranch = (const struct Branch *)pNode;
+        for(u = 0; u < SymTable_popCount(pBranch->uBitmap); u++)
+            SymTable_mapNode(pBranch->apChildren[u], pfApply, pvExtra);
+    }
+}
+
+void SymTable_map(SymTable_T oSymTable,
+    void (*pfApply)(const char *pcKey, void *pvValue, void *pvExtra),
+    const void *pvExtra) {
+    assert(oSymTable != NULL);
+    assert(pfApply != NULL);
+    if(oSymTable->oImage != NULL) {
+        SymTableImage_map(oSymTable->oImage, pfApply, pvExtra);
+        return;
+    }
+    SymTable_mapNode(oSymTable->root, pfApply, pvExtra);
+}
+
+/*
+    SymTable_gatherLeaves stores the Leaves of the trie rooted at pNode at *pppLeaves and advances
+    *pppLeaves past them. Returns nothing.
+*/
+static void SymTable_gatherLeaves(struct Node *pNode, struct Leaf ***pppLeaves) {
+    struct Branch *pBranch;
+    struct Collision *pCollision;
+    size_t u;
+    if(pNode == NULL)
+        return;
+    if(pNode->eKind == LEAF) {
+        **pppLeaves = (struct Leaf *)pNode;
+        (*pppLeaves)++;
+    }
+    else if(pNode->eKind == COLLISION) {
+        pCollision = (struct Collision *)pNode;
+        for(u = 0; u < pCollision->uCount; u++)
+            SymTable_gatherLeaves(&pCollision->apLeaves[u]->sNode, pppLeaves);
+    }
+    else {
+        pBranch = (struct Branch *)pNode;
+        for(u = 0; u < SymTable_popCount(pBranch->uBitmap); u++)
+            SymTable_gatherLeaves(pBranch->apChildren[u], pppLeaves);
+    }
+}
+
+/*
+    SymTable_shareLeaf is a helper function for SymTable_merge that adds pLeaf of oSrc, whose key
+    is not in oDst, to the trie of oDst. The Leaf itself is shared, with one more reference,
+    unless the two SymTables have different allocators or number their scopes differently; then
+    a copy is added. Returns 1 on success and 0 if there is not enough memory.
+*/
+static int SymTable_shareLeaf(SymTable_T oDst, SymTable_T oSrc, struct Leaf *pLeaf) {
+    struct Leaf *pNewLeaf;
+    const char *pcKey;
+    if(oDst->sAllocator.pfAlloc == oSrc->sAllocator.pfAlloc
+            && oDst->sAllocator.pfFree == oSrc->sAllocator.pfFree
+            && oDst->sAllocator.pvContext == oSrc->sAllocator.pvContext
+            && pLeaf->uScope == oDst->uScope) {
+        pLeaf->sNode.uRefCount++;
+        if(SymTable_insert(oDst, pLeaf))
+            return 1;
+        pLeaf->sNode.uRefCount--;
+        return 0;
+    }
+    pcKey = SymTable_leafKey(pLeaf);
+    pNewLeaf = SymTable_newLeaf(oDst, pcKey, strlen(pcKey), pLeaf->uHash, pLeaf->value,
+        pLeaf->iBorrowed);
+    if(pNewLeaf == NULL)
+        return 0;
+    pNewLeaf->uScope = (unsigned int)oDst->uScope;
+    if(SymTable_insert(oDst, pNewLeaf))
+        return 1;
+    SymTable_deallocate(oDst, pNewLeaf);
+    return 0;
+}
+
+/* The Leaves of oSrc are shared with oDst rather than copied, and oSrc then lets go of them. */
+int SymTable_merge(SymTable_T oDst, SymTable_T oSrc,
+    void *(*pfCombine)(const char *pcKey, void *pvDstValue, void *pvSrcValue, void *pvExtra),
+    const void *pvExtra) {
+    struct Leaf **ppLeaves;
+    struct Leaf **ppEnd;
+    struct Leaf *pLeaf;
+    struct Leaf *pDstLeaf;
+    const char *pcKey;
+    size_t uLength;
+    size_t uCount;
+    size_t uMerged;
+    size_t u;
+    assert(oDst != NULL);
+    assert(oSrc != NULL);
+    assert(oDst != oSrc);
+    /* A merged Leaf could not be told apart from one put in a scope of either SymTable, nor
+       logged one at a time. */
+    if(oDst->uScopeDepth > 0 || oSrc->uScopeDepth > 0)
+        return 0;
+    if(oDst->oLog != NULL || oSrc->oLog != NULL)
+        return 0;
+    if(!SymTable_promote(oDst) || !SymTable_promote(oSrc))
+        return 0;
+    uCount = oSrc->size;
+    if(uCount == 0)
+        return 1;
+    ppLeaves = (struct Leaf **)SymTable_allocate(oSrc, uCount * sizeof(struct Leaf *));
+    if(ppLeaves == NULL)
+        return 0;
+    ppEnd = ppLeaves;
+    SymTable_gatherLeaves(oSrc->root, &ppEnd);
+    assert((size_t)(ppEnd - ppLeaves) == uCount);
+    for(uMerged = 0; uMerged < uCount; uMerged++) {
+        pLeaf = ppLeaves[uMerged];
+        pcKey = SymTable_leafKey(pLeaf);
+        uLength = strlen(pcKey);
+        pDstLeaf = SymTable_find(oDst, pcKey, uLength, pLeaf->uHash);
+        if(pDstLeaf == NULL) {
+            if(!SymTable_shareLeaf(oDst, oSrc, pLeaf))
+                break;
+            oDst->size = oDst->size + 1;
+        }
+        else if(pfCombine != NULL) {
+            pDstLeaf = SymTable_ownLeaf(oDst, pcKey, uLength, pLeaf->uHash);
+            if(pDstLeaf == NULL)
+                break;
+            pDstLeaf->value = (*pfCombine)(SymTable_leafKey(pDstLeaf), (void *)pDstLeaf->value,
+                (void *)pLeaf->value, (void *)pvExtra);
+        }
+    }
+    if(uMerged < uCount) {
+        /* Take the merged key-value pairs out of oSrc, so that a retry does not merge them twice.
+           The reference held meanwhile keeps each key alive while it is removed. */
+        for(u = 0; u < uMerged; u++) {
+            pLeaf = ppLeaves[u];
+            pLeaf->sNode.uRefCount++;
+            pcKey = SymTable_leafKey(pLeaf);
+            SymTable_removeN(oSrc, pcKey, strlen(pcKey));
+            SymTable_release(oSrc, &pLeaf->sNode);
+        }
+        SymTable_deallocate(oSrc, ppLeaves);
+        return 0;
+    }
+    SymTable_deallocate(oSrc, ppLeaves);
+    SymTable_freeTrie(oSrc);
+    return 1;
+}
+
+int SymTable_pushScope(SymTable_T oSymTable) {
+    struct Scope *psScopes;
+    size_t uScopeCapacity;
+    assert(oSymTable != NULL);
+    /* Popping a scope could not take its changes back out of the log. */
+    if(oSymTable->oLog != NULL)
+        return 0;
+    /* Scopes save tries, not mappings, so a mapped table is promoted first. */
+    if(!SymTable_promote(oSymTable))
+        return 0;
+    /* Leaves record their scope number in an unsigned int. */
+    if(oSymTable->uScope == UINT_MAX)
+        return 0;
+    if(oSymTable->uScopeDepth == oSymTable->uScopeCapacity) {
+        uScopeCapacity = oSymTable->uScopeCapacity == 0 ? 8 : 2 * oSymTable->uScopeCapacity;
+        psScopes = (struct Scope *)SymTable_reallocate(oSymTable, oSymTable->psScopes,
+            oSymTable->uScopeCapacity * sizeof(struct Scope), uScopeCapacity * sizeof(struct Scope));
+        if(psScopes == NULL)
+            return 0;
+        oSymTable->psScopes = psScopes;
+        oSymTable->uScopeCapacity = uScopeCapacity;
+    }
+    /* The saved root is shared, so the changes made in the scope copy their paths. */
+    oSymTable->psScopes[oSymTable->uScopeDepth].root = oSymTable->root;
+    oSymTable->psScopes[oSymTable->uScopeDepth].size = oSymTable->size;
+    oSymTable->psScopes[oSymTable->uScopeDepth].uTrieBytes = oSymTable->uTrieBytes;
+    oSymTable->psScopes[oSymTable->uScopeDepth].uScopedBytes = oSymTable->uScopedBytes;
+    if(oSymTable->root != NULL)
+        oSymTable->root->uRefCount++;
+    oSymTable->uScopeDepth++;
+    oSymTable->uScope++;
+    return 1;
+}
+
+int SymTable_popScope(SymTable_T oSymTable) {
+    assert(oSymTable != NULL);
+    if(oSymTable->uScopeDepth == 0)
+        return 0;
+    oSymTable->uScopeDepth--;
+    oSymTable->uScope--;
+    SymTable_release(oSymTable, oSymTable->root);
+    oSymTable->root = oSymTable->psScopes[oSymTable->uScopeDepth].root;
+    oSymTable->size = oSymTable->psScopes[oSymTable->uScopeDepth].size;
+    oSymTable->uTrieBytes = oSymTable->psScopes[oSymTable->uScopeDepth].uTrieBytes;
+    /* The nodes copied away in the scope are reached by the restored trie again. */
+    oSymTable->uScopedBytes = oSymTable->psScopes[oSymTable->uScopeDepth].uScopedBytes;
+    return 1;
+}
+
+void SymTable_clear(SymTable_T oSymTable) {
+    assert(oSymTable != NULL);
+    SymTable_logChange(oSymTable, SYMTABLELOG_CLEAR, NULL, 0, NULL);
+    if(oSymTable->oImage != NULL) {
+        SymTableImage_close(oSymTable->oImage);
+        oSymTable->oImage = NULL;
+    }
+    /* Nodes shared with a snapshot or a saved scope only lose a reference. */
+    SymTable_freeTrie(oSymTable);
+}
+
+/* A lookup in the trie stops at the first Branch without the key's bit, so it needs no filter. */
+int SymTable_enableFilter(SymTable_T oSymTable) {
+    assert(oSymTable != NULL);
+    return 0;
+}
+
+/* The cache is only kept by the hash table implementation. */
+int SymTable_enableCache(SymTable_T oSymTable) {
+    assert(oSymTable != NULL);
+    return 0;
+}
+
+/*
+    SymTable_countChain is a helper function for SymTable_getStats that adds a chain of
+    uChainLength key-value pairs to the histogram of psStats. Returns nothing.
+*/
+static void SymTable_countChain(SymTable_Stats *psStats, size_t uChainLength) {
+    if(uChainLength >= SYMTABLE_HISTOGRAM_SIZE)
+        uChainLength = SYMTABLE_HISTOGRAM_SIZE - 1;
+    psStats->auChainLengths[uChainLength]++;
+}
+
+/*
+    SymTable_countDepths is a helper function for SymTable_getStats that adds the depth of every
+    Leaf of the trie rooted at pNode, which is uDepth Branches deep, to the histogram of psStats.
+    Returns nothing.
+*/
+static void SymTable_countDepths(SymTable_Stats *psStats, const struct Node *pNode,
+    size_t uDepth) {
+    const struct Branch *pBranch;
+    const struct Collision *pCollision;
+    size_t u;
+    if(pNode == NULL)
+        return;
+    if(pNode->eKind == LEAF)
+        SymTable_countChain(psStats, uDepth);
+    else if(pNode->eKind == COLLISION) {
+        pCollision = (const struct Collision *)pNode;
+        for(u = 0; u < pCollision->uCount; u++)
+            SymTable_countChain(psStats, uDepth);
+    }
+    else {
+        pBranch = (const struct Branch *)pNode;
+        for(u = 0; u < SymTable_popCount(pBranch->uBitmap); u++)
+            SymTable_countDepths(psStats, pBranch->apChildren[u], uDepth + 1);
+    }
+}
+
+int SymTable_getStats(SymTable_T oSymTable, SymTable_Stats *psStats) {
+    assert(oSymTable != NULL);
+    assert(psStats != NULL);
+#ifdef SYMTABLE_STATS
+    *psStats = oSymTable->sStats;
+#else
+    memset(psStats, 0, sizeof(SymTable_Stats));
+#endif
+    if(psStats->uLookups > 0)
+        psStats->dComparisonsPerLookup =
+            (double)psStats->uComparisons / (double)psStats->uLookups;
+    psStats->uLength = SymTable_getLength(oSymTable);
+    /* A table served from a mapped snapshot has no chains of its own yet. */
+    SymTable_countDepths(psStats, oSymTable->root, 0);
+    psStats->uBucketCount = oSymTable->size;
+#ifdef SYMTABLE_STATS
+    return 1;
+#else
+    return 0;
+#endif
+}
+
+size_t SymTable_memoryUsage(SymTable_T oSymTable) {
+    assert(oSymTable != NULL);
+    return SymTable_blockSize(sizeof(struct SymTable))
+        + SymTable_blockSize(oSymTable->uScopeCapacity * sizeof(struct Scope))
+        + oSymTable->uTrieBytes + oSymTable->uScopedBytes;
+}
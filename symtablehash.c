@@ -3,44 +3,208 @@
     File Name: symtablehash.c
 */
 #include "symtable.h"
+#include "symtableimage.h"
+#include "symtablelog.h"
 #include <string.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <assert.h>
+#include <limits.h>
+#include <stdint.h>
+#include <time.h>
 
+#ifdef SYMTABLE_STATS
+/* STAT_ADD adds uAmount to the counter field of the statistics of oSymTable. Without
+   SYMTABLE_STATS it does nothing, so the counters cost nothing. */
+#define STAT_ADD(oSymTable, field, uAmount) ((oSymTable)->sStats.field += (uAmount))
+#else
+#define STAT_ADD(oSymTable, field, uAmount) ((void)(oSymTable))
+#endif
 
 /*
-    Binding is a representation of a key-value pair and acts like a Node in the linkedlists 
-    inside SymTable. 
+    The key-value pairs of a SymTable live in one dense array of Bindings, in the order they
+    were put, and the buckets are an index into it: each bucket holds the number of the first
+    Binding of its chain, and each Binding the number of the next one. Bindings are numbered
+    from 1, so that 0 can end a chain. A Binding keeps the hash code of its key, so growing the
+    bucket array only rebuilds the index, and SymTable_map is one pass over the array. A removed
+    Binding leaves a hole, which is squeezed out when the array fills up or is half holes.
+*/
+
+/*
+    Binding is a representation of a key-value pair, and is one entry of the array of
+    key-value pairs of a SymTable.
 */
 struct Binding
 {
-    /* key points to an immutable key in the key-value pair. It is of type char*. */
+    /* key points to an immutable key in the key-value pair, or is NULL if the Binding is a
+        hole. It is of type char*. */
    const char *key;
     /* value points to the value represented by key in the key-value pair. It is of type void*
         and can be any type that the client defines. */
    const void *value;
-   /* pNextBinding points to the next key-value pair in the linkedlist. It is of type struct 
-        Binding*.*/
-   struct Binding *pNextBinding;
+    /* uCode is the full hash code of key, as returned by SymTable_hashCode. It is of type
+        size_t. */
+   size_t uCode;
+    /* uNext is the number of the next Binding in the chain of its bucket, or 0 at the end of
+        the chain. It is of type size_t. */
+   size_t uNext;
+    /* uShadowed is the number of the Binding of the same key in an outer scope that this
+        Binding hides until its scope is popped, or 0. It is of type size_t. */
+   size_t uShadowed;
+    /* uScope is the scope depth at which the Binding was put. It is of type unsigned int rather
+        than size_t so that the flags fit beside it, and SymTable_pushScope stops at UINT_MAX. */
+   unsigned int uScope;
+    /* iBorrowed is 1 if key is not a block of its own: either the caller's string, put with
+        SymTable_putBorrowed, which the SymTable neither copies nor frees, or a copy in the key
+        block of SymTable_fromArrays or SymTable_clone, which is freed with the block. It is 0 if
+        key is the SymTable's own copy. */
+   unsigned char iBorrowed;
+    /* iVisible is 1 if the Binding is in the chain of its bucket, and 0 if it is shadowed,
+        removed in an open scope, or a hole. */
+   unsigned char iVisible;
+};
+
+/* UndoKind identifies the change that an Undo entry reverts. */
+enum UndoKind {UNDO_PUT, UNDO_REMOVE, UNDO_REPLACE};
+
+/*
+    Undo is an entry of the undo log, which records every change made while a scope is open so
+    that SymTable_popScope can revert the changes of the innermost scope in reverse order.
+*/
+struct Undo
+{
+    /* eKind tells whether uBinding was put, removed or had its value replaced. */
+   enum UndoKind eKind;
+    /* uBinding is the number of the Binding that was changed. A removed Binding is kept in the
+        array until its entry is reverted. */
+   size_t uBinding;
+    /* pvOldValue is the value that an UNDO_REPLACE entry restores. */
+   const void *pvOldValue;
+};
+
+/*
+    CacheEntry is an entry of the recent-lookup cache: the Binding that a lookup of the key at
+    the address pcKey found, while uCacheEpoch of the SymTable was uEpoch.
+*/
+struct CacheEntry
+{
+    /* pcKey is the address of the key that was looked up, as passed by the client. */
+   const char *pcKey;
+    /* uBinding is the number of the visible Binding that the lookup found. */
+   size_t uBinding;
+    /* uEpoch is the value of uCacheEpoch when the entry was made. */
+   size_t uEpoch;
+};
+
+/*
+    Recency holds the links of a Binding in the list that a bounded SymTable keeps of its visible
+    Bindings, from the least recently used to the most recently used. The links are kept in an
+    array parallel to the array of Bindings, so that a SymTable without a bound pays nothing for
+    them.
+*/
+struct Recency
+{
+    /* uOlder is the number of the Binding used just before this one, or 0 if this one is the
+        least recently used. */
+   size_t uOlder;
+    /* uNewer is the number of the Binding used just after this one, or 0 if this one is the most
+        recently used. */
+   size_t uNewer;
 };
 
 /*
     SymTable is a representation of the symbol table implemented with a hash table. It contains
-    an array of size uBucketCount containing struct Binding linkedlists, where each linkedlist 
-    in the array corresponds to a hash.
+    an array of Bindings in the order they were put, and an array of size uBucketCount of
+    chains through it, where each chain in the array corresponds to a hash.
 */
 struct SymTable
 {
-    /* head points to the first linked list in the array, and head+i-1 represents the ith linked
-        list in the array. It is of type struct Binding**. */
-   struct Binding **head;
+    /* head points to the first bucket of the array, and head[i] is the number of the first
+        Binding of the ith chain, or 0 if the chain is empty. It is of type size_t*. */
+   size_t *head;
     /* size represents the number of key-value pairs within the SymTable. It is of type size_t. */
    size_t size;
     /* uBucketCount points to a size_t value representing the number of buckets of the hash table.
-        (the number of buckets is the number of items in the linkedlist array). It is of type 
+        (the number of buckets is the number of items in the head array). It is of type
         size_t*. */
    size_t *uBucketCount;
+    /* puGenerations holds, for each bucket, the value of uGeneration when the bucket was last
+        known to hold only current Bindings. SymTable_clear increments uGeneration instead of
+        emptying the buckets, which makes every bucket stale at once, and a stale bucket is
+        emptied the next time it is used. */
+   size_t *puGenerations;
+   size_t uGeneration;
+    /* psBindings points to the array of Bindings, which has room for uBindingCapacity. The
+        first uBindingCount are in use, uFreeCount of them as holes, and are appended to in the
+        order they are put. The Bindings from uBindingCount to uBindingEnd were left by
+        SymTable_clear, and an append reuses the key block of the one it overwrites. */
+   struct Binding *psBindings;
+   size_t uBindingCount;
+   size_t uBindingEnd;
+   size_t uBindingCapacity;
+   size_t uFreeCount;
+    /* pcBulkKeys points to the block of uBulkKeyCapacity bytes that holds the keys of the
+        Bindings made by SymTable_fromArrays or SymTable_clone, or is NULL. It is freed with the
+        SymTable. */
+   char *pcBulkKeys;
+   size_t uBulkKeyCapacity;
+    /* puFilter is the blocked Bloom filter added by SymTable_enableFilter, or NULL. It holds
+        uFilterBlocks blocks of FILTER_WORDS words, uFilterBlocks being a power of two, and lies
+        in the block pvFilterBlock, aligned so that no block of the filter straddles a cache
+        line. Every visible key is in the filter, as are the keys removed since it was built.
+        uFilterAdded keys have been added since it was built, and it is rebuilt by the next put
+        once that reaches uFilterCapacity, the number of keys it was sized for. */
+   uint32_t *puFilter;
+   void *pvFilterBlock;
+   size_t uFilterBlocks;
+   size_t uFilterAdded;
+   size_t uFilterCapacity;
+    /* psCache holds the CACHE_SLOTS entries of the recent-lookup cache added by
+        SymTable_enableCache, or is NULL. An entry is valid only if its uEpoch is uCacheEpoch,
+        which grows whenever a Binding stops being visible or the Bindings are renumbered, so
+        that one increment drops every entry that could point to it. */
+   struct CacheEntry *psCache;
+   size_t uCacheEpoch;
+    /* uMaxEntries is the bound given to SymTable_newBounded, or 0 if the SymTable has none. A
+        bounded SymTable keeps its visible Bindings on a list in order of use, from uOldest to
+        uNewest, whose links are in psRecency. psRecency is parallel to psBindings and has room for
+        uRecencyCapacity links, never fewer than uBindingCapacity. pfEvict and pvEvictExtra are the
+        callback that an evicted key-value pair is passed to. */
+   size_t uMaxEntries;
+   struct Recency *psRecency;
+   size_t uRecencyCapacity;
+   size_t uOldest;
+   size_t uNewest;
+   void (*pfEvict)(const char *pcKey, void *pvValue, void *pvExtra);
+   const void *pvEvictExtra;
+    /* oImage is the mapped snapshot that the SymTable is served from if it was opened with
+        SymTable_openMapped and has not been modified since, and NULL otherwise. While oImage
+        is not NULL the hash table itself is empty. It is of type SymTableImage_T. */
+   SymTableImage_T oImage;
+    /* oLog is the write-ahead log that every change is recorded in if the SymTable was opened
+        with SymTable_openLogged, and NULL otherwise. It is of type SymTableLog_T. */
+   SymTableLog_T oLog;
+    /* psUndoLog points to the uUndoCount entries of the undo log, which has room for
+        uUndoCapacity entries. The log is empty while no scope is open. */
+   struct Undo *psUndoLog;
+   size_t uUndoCount;
+   size_t uUndoCapacity;
+    /* puScopeMarks holds, for each of the uScopeDepth open scopes, the length that the undo log
+        had when the scope was pushed. It has room for uScopeCapacity marks. */
+   size_t *puScopeMarks;
+   size_t uScopeDepth;
+   size_t uScopeCapacity;
+    /* sAllocator is the allocator that every block of the SymTable, including the SymTable
+        itself, comes from and goes back to. It is of type SymTable_Allocator. */
+   SymTable_Allocator sAllocator;
+    /* uMemoryUsage is the number of bytes allocated for the SymTable, as estimated by
+        SymTable_blockSize. Every function that allocates or frees keeps it up to date. It is of
+        type size_t. */
+   size_t uMemoryUsage;
+#ifdef SYMTABLE_STATS
+    /* sStats holds the counters reported by SymTable_getStats. */
+   SymTable_Stats sStats;
+#endif
 };
 
 /* BUCKET_COUNT_SIZE is a size_t variable representing the number of items in the BUCKET_COUNTS
@@ -48,14 +212,15 @@ struct SymTable
 static const size_t BUCKET_COUNT_SIZE = 8;
 /* BUCKET_COUNTS is a size_t array representing the possible bucket counts that the symbol table
     can have. These values are chosen because they are efficient with the hash function. */
-static const size_t BUCKET_COUNTS[8] = {(size_t)509, (size_t)1021, (size_t)2039, 
+static const size_t BUCKET_COUNTS[8] = {(size_t)509, (size_t)1021, (size_t)2039,
     (size_t)4093, (size_t)8191, (size_t)16381, (size_t)32749, (size_t)65521};
 
-/* Return a hash code for pcKey that is between 0 and uBucketCount-1,
-   inclusive. Takes in parameters pcKey of type const char* and uBucketCount of type size_t. 
-   pcKey represents the key that the function retrieves a hash code for. uBucketCount represents
-   the number of buckets that the hash code is calculated for.  */
-static size_t SymTable_hash(const char *pcKey, size_t uBucketCount)
+/* MIN_BINDINGS is the number of Bindings that the array of Bindings first has room for. */
+static const size_t MIN_BINDINGS = 8;
+
+/* Return the full hash code of the uLength characters at pcKey, which need not be
+   NUL-terminated. Taken modulo the bucket count it picks the bucket, and the filter mixes it. */
+static size_t SymTable_hashCode(const char *pcKey, size_t uLength)
 {
    const size_t HASH_MULTIPLIER = 65599;
    size_t u;
@@ -63,245 +228,1997 @@ static size_t SymTable_hash(const char *pcKey, size_t uBucketCount)
 
    assert(pcKey != NULL);
 
-   for (u = 0; pcKey[u] != '\0'; u++)
+   for (u = 0; u < uLength; u++)
       uHash = uHash * HASH_MULTIPLIER + (size_t)pcKey[u];
 
-   return uHash % uBucketCount;
+   return uHash;
+}
+
+/* FILTER_WORDS is the number of 32-bit words of a block of the filter. A key sets one bit in
+   each word of one block, so a lookup reads 32 bytes, within one cache line. */
+enum {FILTER_WORDS = 8};
+
+/* FILTER_BITS_PER_KEY is the number of bits of filter given to each key the filter is sized
+   for, which keeps the rate of false positives under one percent. */
+static const size_t FILTER_BITS_PER_KEY = 16;
+
+/* CACHE_SLOTS is the number of entries of the recent-lookup cache, 1 << CACHE_BITS. */
+enum {CACHE_BITS = 6, CACHE_SLOTS = 1 << CACHE_BITS};
+
+/* FILTER_SALTS are the odd multipliers that pick the bit a key sets in each word of its
+   block, as in the split block Bloom filter of Apache Parquet. */
+static const uint32_t FILTER_SALTS[FILTER_WORDS] = {0x47B6137BU, 0x44974D91U, 0x8824AD5BU,
+    0xA2B7289DU, 0x705495C7U, 0x2DF1424BU, 0x9EFC4947U, 0x5C6BFB31U};
+
+/* Return the block of the filter puFilter, which has uBlocks blocks, that the key with hash
+   code uCode sets bits in, and store in *puBits the bits it picks from each word. The code is
+   mixed with the finalizer of SplitMix64 first, since the bucket hash leaves short keys in its
+   low bits. */
+static uint32_t *SymTable_filterBlock(uint32_t *puFilter, size_t uBlocks, size_t uCode,
+   uint32_t *puBits)
+{
+   uint64_t uMixed = (uint64_t)uCode;
+
+   uMixed ^= uMixed >> 30;
+   uMixed *= (uint64_t)0xBF58476D1CE4E5B9ULL;
+   uMixed ^= uMixed >> 27;
+   uMixed *= (uint64_t)0x94D049BB133111EBULL;
+   uMixed ^= uMixed >> 31;
+   *puBits = (uint32_t)uMixed;
+   return puFilter + ((size_t)(uMixed >> 32) & (uBlocks - 1)) * FILTER_WORDS;
+}
+
+/* Add the key with hash code uCode to the filter puFilter of uBlocks blocks. */
+static void SymTable_filterSet(uint32_t *puFilter, size_t uBlocks, size_t uCode)
+{
+   uint32_t uBits;
+   uint32_t *puBlock = SymTable_filterBlock(puFilter, uBlocks, uCode, &uBits);
+   size_t u;
+
+   for (u = 0; u < FILTER_WORDS; u++)
+      puBlock[u] |= (uint32_t)1 << ((uBits * FILTER_SALTS[u]) >> 27);
+}
+
+/* Return 0 if the key with hash code uCode is not in the filter puFilter of uBlocks blocks,
+   and 1 if it may be. */
+static int SymTable_filterTest(uint32_t *puFilter, size_t uBlocks, size_t uCode)
+{
+   uint32_t uBits;
+   uint32_t *puBlock = SymTable_filterBlock(puFilter, uBlocks, uCode, &uBits);
+   size_t u;
+
+   for (u = 0; u < FILTER_WORDS; u++)
+      if ((puBlock[u] & ((uint32_t)1 << ((uBits * FILTER_SALTS[u]) >> 27))) == 0)
+         return 0;
+   return 1;
+}
+
+/* Allocate uSize bytes with the default allocator, which is malloc. pvContext is unused. */
+static void *SymTable_defaultAlloc(size_t uSize, void *pvContext)
+{
+   (void)pvContext;
+   return malloc(uSize);
+}
+
+/* Free pvBlock with the default allocator, which is free. pvContext is unused. */
+static void SymTable_defaultFree(void *pvBlock, void *pvContext)
+{
+   (void)pvContext;
+   free(pvBlock);
+}
+
+/* DEFAULT_ALLOCATOR is the allocator of the SymTables made by SymTable_new. */
+static const SymTable_Allocator DEFAULT_ALLOCATOR =
+   {SymTable_defaultAlloc, SymTable_defaultFree, NULL};
+
+/*
+    SymTable_allocate is a helper function that returns a block of uSize bytes from the allocator
+    of oSymTable, or NULL if there is not enough memory.
+*/
+static void *SymTable_allocate(SymTable_T oSymTable, size_t uSize) {
+    return (*oSymTable->sAllocator.pfAlloc)(uSize, oSymTable->sAllocator.pvContext);
+}
+
+/*
+    SymTable_allocateZeroed is a helper function that returns a block of uCount elements of uSize
+    bytes each, all set to zero, from the allocator of oSymTable, or NULL if there is not enough
+    memory. The default allocator uses calloc, which gets large blocks already zeroed.
+*/
+static void *SymTable_allocateZeroed(SymTable_T oSymTable, size_t uCount, size_t uSize) {
+    void *pvBlock;
+    if(oSymTable->sAllocator.pfAlloc == SymTable_defaultAlloc)
+        return calloc(uCount, uSize);
+    pvBlock = SymTable_allocate(oSymTable, uCount * uSize);
+    if(pvBlock != NULL)
+        memset(pvBlock, 0, uCount * uSize);
+    return pvBlock;
+}
+
+/*
+    SymTable_deallocate is a helper function that gives pvBlock, which may be NULL, back to the
+    allocator of oSymTable. Returns nothing.
+*/
+static void SymTable_deallocate(SymTable_T oSymTable, void *pvBlock) {
+    if(pvBlock != NULL)
+        (*oSymTable->sAllocator.pfFree)(pvBlock, oSymTable->sAllocator.pvContext);
+}
+
+/*
+    SymTable_reallocate is a helper function that moves the block pvBlock of uOldSize bytes, which
+    may be NULL, to a block of uNewSize bytes from the allocator of oSymTable, and returns the new
+    block, or NULL if there is not enough memory, in which case pvBlock is unchanged. The default
+    allocator uses realloc, which may grow the block in place. Other allocators have no realloc,
+    so the block is copied.
+*/
+static void *SymTable_reallocate(SymTable_T oSymTable, void *pvBlock, size_t uOldSize,
+    size_t uNewSize) {
+    void *pvNewBlock;
+    if(oSymTable->sAllocator.pfAlloc == SymTable_defaultAlloc)
+        return realloc(pvBlock, uNewSize);
+    pvNewBlock = SymTable_allocate(oSymTable, uNewSize);
+    if(pvNewBlock == NULL)
+        return NULL;
+    if(pvBlock != NULL) {
+        memcpy(pvNewBlock, pvBlock, uOldSize < uNewSize ? uOldSize : uNewSize);
+        SymTable_deallocate(oSymTable, pvBlock);
+    }
+    return pvNewBlock;
+}
+
+/* Return an estimate of the number of bytes that the allocator uses for a block of uBytes bytes:
+   the block rounded up, with the allocator's header, to a multiple of two words, and never less
+   than four words (as in the GNU C library's malloc). A block of 0 bytes is not allocated. */
+static size_t SymTable_blockSize(size_t uBytes)
+{
+   const size_t WORD = sizeof(size_t);
+
+   if (uBytes == 0)
+      return 0;
+   uBytes = (uBytes + WORD + 2 * WORD - 1) & ~(2 * WORD - 1);
+   return uBytes < 4 * WORD ? 4 * WORD : uBytes;
+}
+
+/* Return the number of bytes, as estimated by SymTable_blockSize, of the copy of its key that
+   pBinding owns, or 0 if the key is borrowed. */
+static size_t SymTable_keySize(const struct Binding *pBinding)
+{
+   if (pBinding->iBorrowed)
+      return 0;
+   return SymTable_blockSize(strlen(pBinding->key) + 1);
+}
+
+/*
+    SymTable_binding is a helper function that returns the Binding of oSymTable numbered
+    uBinding, which must not be 0.
+*/
+static struct Binding *SymTable_binding(SymTable_T oSymTable, size_t uBinding) {
+    assert(uBinding != 0 && uBinding <= oSymTable->uBindingCount);
+    return &oSymTable->psBindings[uBinding - 1];
 }
 
 SymTable_T SymTable_new(void) {
+    return SymTable_newWithAllocator(&DEFAULT_ALLOCATOR);
+}
+
+/*
+    SymTable_bucketCountFor is a helper function that returns a pointer to the smallest entry of
+    BUCKET_COUNTS that holds uCapacity key-value pairs without expanding, or to the largest
+    entry if none does.
+*/
+static size_t *SymTable_bucketCountFor(size_t uCapacity) {
+    size_t index;
+    for(index = 0; index < BUCKET_COUNT_SIZE-1; index++) {
+        if(BUCKET_COUNTS[index] >= uCapacity)
+            break;
+    }
+    return (size_t *)&BUCKET_COUNTS[index];
+}
+
+/*
+    SymTable_create is a helper function that returns a new empty SymTable whose memory comes
+    from *psAllocator and which has *uBucketCount buckets, or NULL if there is not enough memory.
+    It is used by SymTable_newWithAllocator and SymTable_newWithCapacity.
+*/
+static SymTable_T SymTable_create(const SymTable_Allocator *psAllocator,
+    size_t *uBucketCount) {
     SymTable_T oSymTable;
-    oSymTable = (SymTable_T)malloc(sizeof(struct SymTable));
+    oSymTable = (SymTable_T)(*psAllocator->pfAlloc)(sizeof(struct SymTable),
+        psAllocator->pvContext);
     if (oSymTable == NULL)
         return NULL;
-    oSymTable->uBucketCount = (size_t *)&BUCKET_COUNTS[0];
-    oSymTable->head = (struct Binding **)
-        calloc(*(oSymTable->uBucketCount),sizeof(struct Binding*));
-    if(oSymTable->head == NULL) {
-        free(oSymTable);
+    oSymTable->sAllocator = *psAllocator;
+    oSymTable->uBucketCount = uBucketCount;
+    oSymTable->head = (size_t *)SymTable_allocateZeroed(oSymTable,
+        *(oSymTable->uBucketCount), sizeof(size_t));
+    oSymTable->puGenerations = (size_t *)SymTable_allocateZeroed(oSymTable,
+        *(oSymTable->uBucketCount), sizeof(size_t));
+    if(oSymTable->head == NULL || oSymTable->puGenerations == NULL) {
+        SymTable_deallocate(oSymTable, oSymTable->head);
+        SymTable_deallocate(oSymTable, oSymTable->puGenerations);
+        SymTable_deallocate(oSymTable, oSymTable);
         return NULL;
     }
+    oSymTable->uGeneration = 0;
+    oSymTable->psBindings = NULL;
+    oSymTable->uBindingCount = 0;
+    oSymTable->uBindingEnd = 0;
+    oSymTable->uBindingCapacity = 0;
+    oSymTable->uFreeCount = 0;
+    oSymTable->pcBulkKeys = NULL;
+    oSymTable->uBulkKeyCapacity = 0;
     oSymTable->size = 0;
+    oSymTable->oImage = NULL;
+    oSymTable->oLog = NULL;
+    oSymTable->puFilter = NULL;
+    oSymTable->pvFilterBlock = NULL;
+    oSymTable->uFilterBlocks = 0;
+    oSymTable->uFilterAdded = 0;
+    oSymTable->uFilterCapacity = 0;
+    oSymTable->psCache = NULL;
+    oSymTable->uCacheEpoch = 1;
+    oSymTable->uMaxEntries = 0;
+    oSymTable->psRecency = NULL;
+    oSymTable->uRecencyCapacity = 0;
+    oSymTable->uOldest = 0;
+    oSymTable->uNewest = 0;
+    oSymTable->pfEvict = NULL;
+    oSymTable->pvEvictExtra = NULL;
+    oSymTable->uMemoryUsage = SymTable_blockSize(sizeof(struct SymTable))
+        + 2 * SymTable_blockSize(*(oSymTable->uBucketCount) * sizeof(size_t));
+    oSymTable->psUndoLog = NULL;
+    oSymTable->uUndoCount = 0;
+    oSymTable->uUndoCapacity = 0;
+    oSymTable->puScopeMarks = NULL;
+    oSymTable->uScopeDepth = 0;
+    oSymTable->uScopeCapacity = 0;
+#ifdef SYMTABLE_STATS
+    memset(&oSymTable->sStats, 0, sizeof(SymTable_Stats));
+#endif
     return oSymTable;
 }
 
-void SymTable_free(SymTable_T oSymTable) {
-    struct Binding *pCurrentBinding;
-    struct Binding *pNextBinding;
-    size_t index;
-    assert(oSymTable != NULL);
-    index = 0;
-    for(index = 0; index<*(oSymTable->uBucketCount); index++) {
-        for (pCurrentBinding = oSymTable->head[index];
-            pCurrentBinding != NULL;
-            pCurrentBinding = pNextBinding)
-        {
-            pNextBinding = pCurrentBinding->pNextBinding;
-            free((char *) (pCurrentBinding->key));
-            free(pCurrentBinding);
-        }
+/*
+    SymTable_resizeRecency is a helper function that moves the links of the list in order of use
+    of oSymTable to a block with room for uCapacity of them, or frees them if uCapacity is 0.
+    Returns 1 on success, and 0 if there is not enough memory, in which case the links are
+    unchanged.
+*/
+static int SymTable_resizeRecency(SymTable_T oSymTable, size_t uCapacity) {
+    struct Recency *psRecency = NULL;
+    if(uCapacity > (size_t)-1 / sizeof(struct Recency))
+        return 0;
+    if(uCapacity > 0) {
+        psRecency = (struct Recency *)SymTable_reallocate(oSymTable, oSymTable->psRecency,
+            oSymTable->uRecencyCapacity * sizeof(struct Recency),
+            uCapacity * sizeof(struct Recency));
+        if(psRecency == NULL)
+            return 0;
     }
-    free(oSymTable->head);
-    free(oSymTable);
-}
-
-size_t SymTable_getLength(SymTable_T oSymTable) {
-    assert(oSymTable != NULL);
-    return oSymTable->size;
+    else
+        SymTable_deallocate(oSymTable, oSymTable->psRecency);
+    oSymTable->uMemoryUsage += SymTable_blockSize(uCapacity * sizeof(struct Recency));
+    oSymTable->uMemoryUsage -= SymTable_blockSize(
+        oSymTable->uRecencyCapacity * sizeof(struct Recency));
+    oSymTable->psRecency = psRecency;
+    oSymTable->uRecencyCapacity = uCapacity;
+    return 1;
 }
 
 /*
-    SymTable_expand is a helper function for the SymTable_put function that expands 
-    the parameter oSymTable by increasing its bucket counts. It is a static function
-    that is only required and called on by SymTable_put. The parameter is a SymTable_T
-    representing the SymTable that needs to be expanded. The function returns an integer
-    representing whether the expansion was successful or not. It returns 1 representing
-    success, and 0 representing failure due to lack of memory, and -1 representing failure 
-    due to reaching max buckets. 
+    SymTable_resizeBindings is a helper function that moves the array of Bindings of oSymTable
+    to a block with room for uCapacity Bindings, which must hold the first uBindingEnd, or frees
+    it if uCapacity is 0. Bindings keep their numbers. The links of a bounded SymTable grow first
+    and shrink last, so that there is always one for each Binding. Returns 1 on success, and 0
+    if there is not enough memory, in which case the array is unchanged.
 */
-static int SymTable_expand(SymTable_T oSymTable) {
-    SymTable_T newSymTable;
-    struct Binding *pCurrentBinding;
-    size_t iterator;
-    if((size_t)(oSymTable->uBucketCount-BUCKET_COUNTS) 
-            == BUCKET_COUNT_SIZE-1) {
-        return -1;
-    }
-    newSymTable = SymTable_new();
-    if(newSymTable==NULL) {
+static int SymTable_resizeBindings(SymTable_T oSymTable, size_t uCapacity) {
+    struct Binding *psBindings = NULL;
+    assert(uCapacity >= oSymTable->uBindingEnd);
+    if(uCapacity > (size_t)-1 / sizeof(struct Binding))
         return 0;
-    }
-    newSymTable->uBucketCount = oSymTable->uBucketCount+1;
-    free(newSymTable->head);
-    newSymTable->head = (struct Binding **)
-        calloc(*(newSymTable->uBucketCount),sizeof(struct Binding*));
-    if (newSymTable->head == NULL) {
-        free(newSymTable);
+    if(oSymTable->uMaxEntries != 0 && uCapacity > oSymTable->uRecencyCapacity
+            && !SymTable_resizeRecency(oSymTable, uCapacity))
         return 0;
+    if(uCapacity > 0) {
+        psBindings = (struct Binding *)SymTable_reallocate(oSymTable, oSymTable->psBindings,
+            oSymTable->uBindingCapacity * sizeof(struct Binding),
+            uCapacity * sizeof(struct Binding));
+        if(psBindings == NULL)
+            return 0;
     }
-    for(iterator = 0; iterator<*(oSymTable->uBucketCount); iterator++) {
-        for (pCurrentBinding = oSymTable->head[iterator];
-            pCurrentBinding != NULL;
-            pCurrentBinding = pCurrentBinding->pNextBinding)
-        {
-            SymTable_put(newSymTable,pCurrentBinding->key,
-                pCurrentBinding->value);
-        }
-    }
-    free(oSymTable->head);
-    oSymTable->head = newSymTable->head; 
-    oSymTable->uBucketCount = newSymTable->uBucketCount;
-    oSymTable->size = newSymTable->size;
+    else
+        SymTable_deallocate(oSymTable, oSymTable->psBindings);
+    oSymTable->uMemoryUsage += SymTable_blockSize(uCapacity * sizeof(struct Binding));
+    oSymTable->uMemoryUsage -= SymTable_blockSize(
+        oSymTable->uBindingCapacity * sizeof(struct Binding));
+    oSymTable->psBindings = psBindings;
+    oSymTable->uBindingCapacity = uCapacity;
+    /* Links that cannot be shrunk are kept, since there are enough of them. */
+    if(uCapacity < oSymTable->uRecencyCapacity)
+        (void)SymTable_resizeRecency(oSymTable, uCapacity);
     return 1;
 }
 
-int SymTable_put(SymTable_T oSymTable, 
-   const char *pcKey, const void *pvValue) {
-    struct Binding *pNewBinding;
-    struct Binding *pCurrentBinding;
-    size_t index;
-    assert(oSymTable != NULL);
-    assert(pcKey != NULL);
-    /*
-        Checking if oSymTable needs to be expanded. If it requires expansion,
-        call the SymTable_expand() function. 
-    */
-    if(oSymTable->size == *(oSymTable->uBucketCount)) {
-        if(SymTable_expand(oSymTable)==0)
-            return 0;
+SymTable_T SymTable_newWithAllocator(const SymTable_Allocator *psAllocator) {
+    assert(psAllocator != NULL);
+    assert(psAllocator->pfAlloc != NULL);
+    assert(psAllocator->pfFree != NULL);
+    return SymTable_create(psAllocator, (size_t *)&BUCKET_COUNTS[0]);
+}
+
+SymTable_T SymTable_newWithCapacity(size_t uCapacity) {
+    SymTable_T oSymTable = SymTable_create(&DEFAULT_ALLOCATOR,
+        SymTable_bucketCountFor(uCapacity));
+    if(oSymTable != NULL && !SymTable_resizeBindings(oSymTable, uCapacity)) {
+        SymTable_free(oSymTable);
+        return NULL;
+    }
+    return oSymTable;
+}
+
+SymTable_T SymTable_newBounded(size_t uMaxEntries,
+    void (*pfEvict)(const char *pcKey, void *pvValue, void *pvExtra), const void *pvExtra) {
+    SymTable_T oSymTable;
+    assert(uMaxEntries > 0);
+    /* The buckets are sized for the bound, which the SymTable never goes past for long. */
+    oSymTable = SymTable_create(&DEFAULT_ALLOCATOR, SymTable_bucketCountFor(uMaxEntries));
+    if(oSymTable == NULL)
+        return NULL;
+    oSymTable->uMaxEntries = uMaxEntries;
+    oSymTable->pfEvict = pfEvict;
+    oSymTable->pvEvictExtra = pvExtra;
+    return oSymTable;
+}
+
+/*
+    SymTable_recency is a helper function that returns the links of the Binding of the bounded
+    oSymTable numbered uBinding, which must not be 0.
+*/
+static struct Recency *SymTable_recency(SymTable_T oSymTable, size_t uBinding) {
+    assert(uBinding != 0 && uBinding <= oSymTable->uBindingCount);
+    return &oSymTable->psRecency[uBinding - 1];
+}
+
+/*
+    SymTable_attach is a helper function that adds the Binding numbered uBinding to the list in
+    order of use of the bounded oSymTable as the most recently used. Returns nothing.
+*/
+static void SymTable_attach(SymTable_T oSymTable, size_t uBinding) {
+    struct Recency *psRecency = SymTable_recency(oSymTable, uBinding);
+    psRecency->uOlder = oSymTable->uNewest;
+    psRecency->uNewer = 0;
+    if(oSymTable->uNewest != 0)
+        SymTable_recency(oSymTable, oSymTable->uNewest)->uNewer = uBinding;
+    else
+        oSymTable->uOldest = uBinding;
+    oSymTable->uNewest = uBinding;
+}
+
+/*
+    SymTable_detach is a helper function that takes the Binding numbered uBinding off the list
+    in order of use of the bounded oSymTable. Returns nothing.
+*/
+static void SymTable_detach(SymTable_T oSymTable, size_t uBinding) {
+    struct Recency *psRecency = SymTable_recency(oSymTable, uBinding);
+    if(psRecency->uOlder != 0)
+        SymTable_recency(oSymTable, psRecency->uOlder)->uNewer = psRecency->uNewer;
+    else
+        oSymTable->uOldest = psRecency->uNewer;
+    if(psRecency->uNewer != 0)
+        SymTable_recency(oSymTable, psRecency->uNewer)->uOlder = psRecency->uOlder;
+    else
+        oSymTable->uNewest = psRecency->uOlder;
+}
+
+/*
+    SymTable_touch is a helper function that makes pBinding, a visible Binding of oSymTable, the
+    most recently used if oSymTable is bounded, in constant time. Returns nothing.
+*/
+static void SymTable_touch(SymTable_T oSymTable, const struct Binding *pBinding) {
+    size_t uBinding;
+    if(oSymTable->uMaxEntries == 0)
+        return;
+    uBinding = (size_t)(pBinding - oSymTable->psBindings) + 1;
+    if(uBinding == oSymTable->uNewest)
+        return;
+    SymTable_detach(oSymTable, uBinding);
+    SymTable_attach(oSymTable, uBinding);
+}
+
+/*
+    SymTable_isBulkKey is a helper function that returns 1 if pcKey lies in the key block that
+    SymTable_fromArrays or SymTable_clone allocated for oSymTable, and 0 otherwise.
+*/
+static int SymTable_isBulkKey(SymTable_T oSymTable, const char *pcKey) {
+    return oSymTable->pcBulkKeys != NULL && pcKey >= oSymTable->pcBulkKeys
+        && pcKey < oSymTable->pcBulkKeys + oSymTable->uBulkKeyCapacity;
+}
+
+/*
+    SymTable_freeBinding is a helper function that turns the parameter pBinding of oSymTable
+    into a hole, freeing its key unless the key is borrowed. Returns nothing.
+*/
+static void SymTable_freeBinding(SymTable_T oSymTable, struct Binding *pBinding) {
+    if(!pBinding->iBorrowed) {
+        oSymTable->uMemoryUsage -= SymTable_keySize(pBinding);
+        SymTable_deallocate(oSymTable, (char *) (pBinding->key));
+    }
+    pBinding->key = NULL;
+    pBinding->iVisible = 0;
+    oSymTable->uFreeCount++;
+}
+
+/*
+    SymTable_newBinding is a helper function that appends a Binding to the array of oSymTable,
+    which must have room for it, for the key made of the uLength characters at pcKey, whose hash
+    code is uCode, and returns its number, or 0 if there is not enough memory. If iBorrowed is 1
+    the Binding points to pcKey itself, which must then be NUL-terminated; otherwise it holds a
+    NUL-terminated copy. A Binding left by SymTable_clear has its key block resized, allocated or
+    freed as the key needs. The Binding is not visible, and its value, uShadowed and uScope are
+    not initialized.
+*/
+static size_t SymTable_newBinding(SymTable_T oSymTable, const char *pcKey,
+    size_t uLength, size_t uCode, int iBorrowed) {
+    struct Binding *pBinding;
+    char *pcOldKey = NULL;
+    char *pcNewKey;
+    size_t uOldSize = 0;
+    size_t uNewSize = iBorrowed ? 0 : uLength + 1;
+    assert(oSymTable->uBindingCount < oSymTable->uBindingCapacity);
+    pBinding = &oSymTable->psBindings[oSymTable->uBindingCount];
+    if(oSymTable->uBindingCount < oSymTable->uBindingEnd && pBinding->key != NULL
+            && !pBinding->iBorrowed) {
+        pcOldKey = (char *)pBinding->key;
+        uOldSize = strlen(pcOldKey) + 1;
     }
-    /* Traversing to the end of the linkedlist at the hashed index. */
-    index = SymTable_hash(pcKey, *(oSymTable->uBucketCount));
-    for (pCurrentBinding = oSymTable->head[index];
-        pCurrentBinding != NULL;
-        pCurrentBinding = pCurrentBinding->pNextBinding)
-    {
-        if(strcmp(pCurrentBinding->key,pcKey)==0) 
+    if(iBorrowed)
+        pcNewKey = (char *)pcKey;
+    /* A key that is no longer and needs a block of the same size is copied in place. */
+    else if(uNewSize <= uOldSize && SymTable_blockSize(uNewSize) == SymTable_blockSize(uOldSize))
+        pcNewKey = pcOldKey;
+    else {
+        pcNewKey = (char *)SymTable_reallocate(oSymTable, pcOldKey, uOldSize, uNewSize);
+        if(pcNewKey == NULL)
             return 0;
-        if(pCurrentBinding->pNextBinding==NULL) break;
     }
-    /* Create a new binding with the given key-value pair. */
-    pNewBinding = (struct Binding*)malloc(sizeof(struct Binding));
-    if(pNewBinding==NULL) return 0;
-    pNewBinding->key = (const char*)malloc(strlen(pcKey) + 1);
-    if(pNewBinding->key == NULL) {
-        free(pNewBinding);
-        return 0;
+    /* Nothing can fail from here on. */
+    if(iBorrowed && uOldSize != 0)
+        SymTable_deallocate(oSymTable, pcOldKey);
+    oSymTable->uMemoryUsage += SymTable_blockSize(uNewSize);
+    oSymTable->uMemoryUsage -= SymTable_blockSize(uOldSize);
+    if(!iBorrowed) {
+        memcpy(pcNewKey, pcKey, uLength);
+        pcNewKey[uLength] = '\0';
     }
-    strcpy((char*)pNewBinding->key, pcKey);
-    pNewBinding->value = pvValue;
-    pNewBinding->pNextBinding = NULL;
-    /* Handling if item is first Binding in LinkedList. */
-    if(oSymTable->head[index] == NULL) {
-        oSymTable->head[index] = pNewBinding;
-        oSymTable->size = oSymTable->size + 1;
-        return 1;
+    pBinding->key = pcNewKey;
+    pBinding->uCode = uCode;
+    pBinding->uNext = 0;
+    pBinding->iBorrowed = (unsigned char)iBorrowed;
+    pBinding->iVisible = 0;
+    oSymTable->uBindingCount++;
+    if(oSymTable->uBindingEnd < oSymTable->uBindingCount)
+        oSymTable->uBindingEnd = oSymTable->uBindingCount;
+    return oSymTable->uBindingCount;
+}
+
+/*
+    SymTable_bucket is a helper function that returns a pointer to the first link of bucket
+    index of oSymTable, after emptying the bucket if it is stale since the last SymTable_clear.
+*/
+static size_t *SymTable_bucket(SymTable_T oSymTable, size_t index) {
+    if(oSymTable->puGenerations[index] != oSymTable->uGeneration) {
+        oSymTable->head[index] = 0;
+        oSymTable->puGenerations[index] = oSymTable->uGeneration;
     }
-    pCurrentBinding->pNextBinding = pNewBinding;
-    oSymTable->size = oSymTable->size + 1;
-    return 1;
+    return &oSymTable->head[index];
 }
 
-void *SymTable_replace(SymTable_T oSymTable,
-    const char *pcKey, const void *pvValue) {
-    struct Binding *pCurrentBinding;
-    void *ret;
-    size_t index;
-    assert(oSymTable != NULL);
-    assert(pcKey != NULL);
-    index = SymTable_hash(pcKey,*(oSymTable->uBucketCount));
-    for (pCurrentBinding = oSymTable->head[index];
-        pCurrentBinding != NULL;
-        pCurrentBinding = pCurrentBinding->pNextBinding)
-    {
-        if(strcmp(pCurrentBinding->key,pcKey)==0) {
-            ret = (void *)pCurrentBinding->value;
-            pCurrentBinding->value=pvValue;
-            return ret;
-        }
+/*
+    SymTable_emptyBuckets is a helper function that makes every bucket of oSymTable stale, so
+    that each one is emptied when it is next used. It takes constant time, except when the
+    generation counter wraps around. Returns nothing.
+*/
+static void SymTable_emptyBuckets(SymTable_T oSymTable) {
+    oSymTable->uGeneration++;
+    /* Once the counter wraps around, an old bucket could pass for a current one. */
+    if(oSymTable->uGeneration == 0) {
+        memset(oSymTable->head, 0, *(oSymTable->uBucketCount) * sizeof(size_t));
+        memset(oSymTable->puGenerations, 0, *(oSymTable->uBucketCount) * sizeof(size_t));
     }
-    return NULL;
 }
 
-int SymTable_contains(SymTable_T oSymTable, const char *pcKey) {
-    struct Binding *pCurrentBinding;
+/*
+    SymTable_relink is a helper function that rebuilds every chain of oSymTable from the
+    visible Bindings of its array and the hash codes they keep, so no key is hashed or read.
+    Returns nothing.
+*/
+static void SymTable_relink(SymTable_T oSymTable) {
+    struct Binding *pBinding;
     size_t index;
-    assert(oSymTable != NULL);
-    assert(pcKey != NULL);
-    index = SymTable_hash(pcKey,*(oSymTable->uBucketCount));
-    for (pCurrentBinding = oSymTable->head[index];
-        pCurrentBinding != NULL;
-        pCurrentBinding = pCurrentBinding->pNextBinding)
-    {
-        if(strcmp(pCurrentBinding->key,pcKey)==0)
-            return 1;
+    size_t u;
+    memset(oSymTable->head, 0, *(oSymTable->uBucketCount) * sizeof(size_t));
+    memset(oSymTable->puGenerations, 0, *(oSymTable->uBucketCount) * sizeof(size_t));
+    oSymTable->uGeneration = 0;
+    for(u = 0; u < oSymTable->uBindingCount; u++) {
+        pBinding = &oSymTable->psBindings[u];
+        if(!pBinding->iVisible)
+            continue;
+        index = pBinding->uCode % *(oSymTable->uBucketCount);
+        pBinding->uNext = oSymTable->head[index];
+        oSymTable->head[index] = u + 1;
     }
-    return 0;
 }
 
-void *SymTable_get(SymTable_T oSymTable, const char *pcKey) {
-    struct Binding *pCurrentBinding;
-    size_t index;
-    assert(oSymTable != NULL);
-    assert(pcKey != NULL);
-    index = SymTable_hash(pcKey,*(oSymTable->uBucketCount));
-    for (pCurrentBinding = oSymTable->head[index];
-        pCurrentBinding != NULL;
-        pCurrentBinding = pCurrentBinding->pNextBinding)
-    {
-        if(strcmp(pCurrentBinding->key,pcKey)==0)
-            return (void *)pCurrentBinding->value;
+/*
+    SymTable_invalidateCache is a helper function that drops every entry of the recent-lookup
+    cache of oSymTable, because a Binding has stopped being visible or the Bindings have been
+    renumbered. Returns nothing.
+*/
+static void SymTable_invalidateCache(SymTable_T oSymTable) {
+    oSymTable->uCacheEpoch++;
+    /* Once the counter wraps around, an old entry could pass for a current one. */
+    if(oSymTable->uCacheEpoch == 0 && oSymTable->psCache != NULL)
+        memset(oSymTable->psCache, 0, CACHE_SLOTS * sizeof(struct CacheEntry));
+}
+
+/*
+    SymTable_compact is a helper function that squeezes the holes out of the array of Bindings
+    of oSymTable, keeping the order of the others. The Bindings are renumbered, so the uShadowed
+    fields, the undo log and the chains are brought up to date and the recent-lookup cache is
+    dropped. It takes time proportional to the length of the array, and allocates nothing.
+    Returns nothing.
+*/
+static void SymTable_compact(SymTable_T oSymTable) {
+    struct Binding *psBindings = oSymTable->psBindings;
+    size_t uCount = 0;
+    size_t u;
+    /* The chains are rebuilt below, so uNext first holds the new number of each Binding. */
+    for(u = 0; u < oSymTable->uBindingCount; u++) {
+        if(psBindings[u].key != NULL)
+            psBindings[u].uNext = ++uCount;
+    }
+    for(u = 0; u < oSymTable->uBindingCount; u++) {
+        if(psBindings[u].key != NULL && psBindings[u].uShadowed != 0)
+            psBindings[u].uShadowed = psBindings[psBindings[u].uShadowed - 1].uNext;
+    }
+    for(u = 0; u < oSymTable->uUndoCount; u++)
+        oSymTable->psUndoLog[u].uBinding =
+            psBindings[oSymTable->psUndoLog[u].uBinding - 1].uNext;
+    /* The list in order of use of a bounded SymTable holds every Binding in use and no hole. */
+    if(oSymTable->uMaxEntries != 0 && oSymTable->size > 0) {
+        for(u = 0; u < oSymTable->uBindingCount; u++) {
+            if(psBindings[u].key == NULL)
+                continue;
+            if(oSymTable->psRecency[u].uOlder != 0)
+                oSymTable->psRecency[u].uOlder =
+                    psBindings[oSymTable->psRecency[u].uOlder - 1].uNext;
+            if(oSymTable->psRecency[u].uNewer != 0)
+                oSymTable->psRecency[u].uNewer =
+                    psBindings[oSymTable->psRecency[u].uNewer - 1].uNext;
+        }
+        oSymTable->uOldest = psBindings[oSymTable->uOldest - 1].uNext;
+        oSymTable->uNewest = psBindings[oSymTable->uNewest - 1].uNext;
+    }
+    uCount = 0;
+    for(u = 0; u < oSymTable->uBindingCount; u++) {
+        if(psBindings[u].key == NULL)
+            continue;
+        if(oSymTable->uMaxEntries != 0)
+            oSymTable->psRecency[uCount] = oSymTable->psRecency[u];
+        psBindings[uCount++] = psBindings[u];
     }
-    return NULL;
+    /* The Bindings left behind point to keys that have moved down. */
+    for(u = uCount; u < oSymTable->uBindingCount; u++)
+        psBindings[u].key = NULL;
+    if(oSymTable->uBindingEnd == oSymTable->uBindingCount)
+        oSymTable->uBindingEnd = uCount;
+    oSymTable->uBindingCount = uCount;
+    oSymTable->uFreeCount = 0;
+    SymTable_invalidateCache(oSymTable);
+    SymTable_relink(oSymTable);
 }
 
-void *SymTable_remove(SymTable_T oSymTable, const char *pcKey) {
-    struct Binding *pCurrentBinding;
-    struct Binding *prevBinding;
-    void *prevValue;
-    size_t index;
-    assert(oSymTable != NULL);
-    assert(pcKey != NULL);
-    index = SymTable_hash(pcKey,*(oSymTable->uBucketCount));
-    prevBinding = oSymTable->head[index];
-    for (pCurrentBinding = oSymTable->head[index];
-        pCurrentBinding != NULL;
-        pCurrentBinding = pCurrentBinding->pNextBinding)
-    {
-        if(strcmp(pCurrentBinding->key,pcKey)==0) {
-            oSymTable->size = oSymTable->size - 1;
-            prevValue = (void *) pCurrentBinding->value;
-            if(pCurrentBinding==oSymTable->head[index]) {
-                oSymTable->head[index] = pCurrentBinding->pNextBinding;
-                free((void *)pCurrentBinding->key);
-                free((void *)pCurrentBinding);
-                return prevValue;
-            }
-            prevBinding->pNextBinding= pCurrentBinding->pNextBinding;
-            free((void *)pCurrentBinding->key);
-            free((void *)pCurrentBinding);
-            return prevValue;
+/*
+    SymTable_freeBindings is a helper function that frees the key of every Binding of the
+    parameter oSymTable that owns its key, empties the array of Bindings, and leaves all of its
+    buckets empty. This includes the Bindings shadowed by a visible one, the removed Bindings
+    held by the undo log, which is emptied along with every open scope, and the Bindings left by
+    SymTable_clear. It is used by SymTable_free and by SymTable_promote when a promotion has to
+    be undone. Returns nothing.
+*/
+static void SymTable_freeBindings(SymTable_T oSymTable) {
+    struct Binding *pBinding;
+    size_t u;
+    for(u = 0; u < oSymTable->uBindingEnd; u++) {
+        pBinding = &oSymTable->psBindings[u];
+        if(pBinding->key != NULL && !pBinding->iBorrowed) {
+            oSymTable->uMemoryUsage -= SymTable_keySize(pBinding);
+            SymTable_deallocate(oSymTable, (char *) (pBinding->key));
         }
-        prevBinding = pCurrentBinding;
     }
-    return NULL;
+    oSymTable->uBindingCount = 0;
+    oSymTable->uBindingEnd = 0;
+    oSymTable->uFreeCount = 0;
+    oSymTable->uUndoCount = 0;
+    oSymTable->uScopeDepth = 0;
+    oSymTable->size = 0;
+    oSymTable->uOldest = 0;
+    oSymTable->uNewest = 0;
+    SymTable_emptyBuckets(oSymTable);
+    SymTable_invalidateCache(oSymTable);
 }
 
-void SymTable_map(SymTable_T oSymTable,
-    void (*pfApply)(const char *pcKey, void *pvValue, void *pvExtra),
-    const void *pvExtra) {
-    struct Binding *pCurrentBinding;
-    size_t index;
+void SymTable_free(SymTable_T oSymTable) {
     assert(oSymTable != NULL);
-    assert(pfApply != NULL);
-    for(index = 0; index<*(oSymTable->uBucketCount); index++) {
-        for (pCurrentBinding = oSymTable->head[index];
-            pCurrentBinding != NULL;
-            pCurrentBinding = pCurrentBinding->pNextBinding)
-        {
-            (*pfApply)(pCurrentBinding->key,
-                (void *)pCurrentBinding->value,(void *)pvExtra);
-        }
+    if(oSymTable->oLog != NULL)
+        SymTableLog_close(oSymTable->oLog);
+    if(oSymTable->oImage != NULL)
+        SymTableImage_close(oSymTable->oImage);
+    SymTable_freeBindings(oSymTable);
+    SymTable_deallocate(oSymTable, oSymTable->psBindings);
+    SymTable_deallocate(oSymTable, oSymTable->psRecency);
+    SymTable_deallocate(oSymTable, oSymTable->pcBulkKeys);
+    SymTable_deallocate(oSymTable, oSymTable->psUndoLog);
+    SymTable_deallocate(oSymTable, oSymTable->puScopeMarks);
+    SymTable_deallocate(oSymTable, oSymTable->head);
+    SymTable_deallocate(oSymTable, oSymTable->puGenerations);
+    SymTable_deallocate(oSymTable, oSymTable->pvFilterBlock);
+    SymTable_deallocate(oSymTable, oSymTable->psCache);
+    SymTable_deallocate(oSymTable, oSymTable);
+}
+
+size_t SymTable_getLength(SymTable_T oSymTable) {
+    assert(oSymTable != NULL);
+    if(oSymTable->oImage != NULL)
+        return SymTableImage_getLength(oSymTable->oImage);
+    return oSymTable->size;
+}
+
+/*
+    Promotion is the state that SymTable_promote and SymTable_cloneMapped pass to
+    SymTable_promoteBinding.
+*/
+struct Promotion
+{
+    /* oSymTable is the SymTable that the key-value pairs are copied into. */
+   SymTable_T oSymTable;
+    /* iSuccessful stays 1 until a SymTable_put fails. */
+   int iSuccessful;
+};
+
+/*
+    SymTable_promoteBinding is the map callback used by SymTable_promote and
+    SymTable_cloneMapped. It puts the key-value pair (pcKey, pvValue) into the SymTable of the
+    Promotion pointed to by pvExtra, and clears its iSuccessful flag if the put fails.
+*/
+static void SymTable_promoteBinding(const char *pcKey, void *pvValue,
+    void *pvExtra) {
+    struct Promotion *psPromotion = (struct Promotion *)pvExtra;
+    if(psPromotion->iSuccessful
+            && !SymTable_put(psPromotion->oSymTable, pcKey, pvValue))
+        psPromotion->iSuccessful = 0;
+}
+
+/*
+    SymTable_promote is a helper function that turns a SymTable served from a mapped snapshot
+    into an ordinary hash table by copying every key-value pair out of the mapping, and then
+    unmaps the snapshot. It is called before the first change that cannot be made in the
+    mapping itself. The parameter is a SymTable_T representing the SymTable to promote. Returns
+    1 on success (including when there is nothing to promote), and 0 if there is not enough
+    memory, in which case oSymTable is still served from the mapping.
+*/
+static int SymTable_promote(SymTable_T oSymTable) {
+    struct Promotion sPromotion;
+    SymTableImage_T oImage;
+    SymTableLog_T oLog;
+    if(oSymTable->oImage == NULL)
+        return 1;
+    /* Detach the image first so that the puts below go to the hash table, and the log so that
+        they are not recorded again. */
+    oImage = oSymTable->oImage;
+    oSymTable->oImage = NULL;
+    oLog = oSymTable->oLog;
+    oSymTable->oLog = NULL;
+    sPromotion.oSymTable = oSymTable;
+    sPromotion.iSuccessful = 1;
+    SymTableImage_map(oImage, SymTable_promoteBinding, &sPromotion);
+    oSymTable->oLog = oLog;
+    if(!sPromotion.iSuccessful) {
+        SymTable_freeBindings(oSymTable);
+        oSymTable->oImage = oImage;
+        return 0;
+    }
+    SymTableImage_close(oImage);
+    return 1;
+}
+
+SymTable_T SymTable_openMapped(const char *pcPath) {
+    SymTable_T oSymTable;
+    SymTableImage_T oImage;
+    assert(pcPath != NULL);
+    oImage = SymTableImage_open(pcPath);
+    if(oImage == NULL)
+        return NULL;
+    oSymTable = SymTable_new();
+    if(oSymTable == NULL) {
+        SymTableImage_close(oImage);
+        return NULL;
     }
+    oSymTable->oImage = oImage;
+    return oSymTable;
+}
+
+SymTable_T SymTable_openLogged(const char *pcPath) {
+    SymTable_T oSymTable;
+    SymTableLog_T oLog;
+    assert(pcPath != NULL);
+    oLog = SymTableLog_open(pcPath, &oSymTable);
+    if(oLog == NULL)
+        return NULL;
+    oSymTable->oLog = oLog;
+    return oSymTable;
 }
 
+int SymTable_setLogBatch(SymTable_T oSymTable, size_t uRecords) {
+    assert(oSymTable != NULL);
+    if(oSymTable->oLog == NULL)
+        return 0;
+    SymTableLog_setBatch(oSymTable->oLog, uRecords);
+    return 1;
+}
+
+int SymTable_syncLog(SymTable_T oSymTable) {
+    assert(oSymTable != NULL);
+    if(oSymTable->oLog == NULL)
+        return 0;
+    return SymTableLog_sync(oSymTable->oLog);
+}
+
+int SymTable_checkpoint(SymTable_T oSymTable) {
+    assert(oSymTable != NULL);
+    if(oSymTable->oLog == NULL)
+        return 0;
+    return SymTableLog_checkpoint(oSymTable->oLog, oSymTable);
+}
+
+/*
+    SymTable_logChange is a helper function that records a change of kind eKind to the key made
+    of the uLength characters at pcKey, with the value pvValue, in the log of oSymTable, if it
+    has one. Returns nothing.
+*/
+static void SymTable_logChange(SymTable_T oSymTable, SymTableLog_Kind eKind, const char *pcKey,
+    size_t uLength, const void *pvValue) {
+    if(oSymTable->oLog != NULL)
+        SymTableLog_append(oSymTable->oLog, eKind, pcKey, uLength, pvValue);
+}
+
+/*
+    SymTable_alignFilter is a helper function that returns the first address in pvBlock at which
+    a block of the filter starts a cache line or its second half.
+*/
+static uint32_t *SymTable_alignFilter(void *pvBlock) {
+    const uintptr_t uAlignment = FILTER_WORDS * sizeof(uint32_t);
+    return (uint32_t *)(((uintptr_t)pvBlock + uAlignment - 1) & ~(uAlignment - 1));
+}
+
+/*
+    SymTable_filterBytes is a helper function that returns the size of the block holding a
+    filter of uBlocks blocks, with room to align it.
+*/
+static size_t SymTable_filterBytes(size_t uBlocks) {
+    return (uBlocks + 1) * FILTER_WORDS * sizeof(uint32_t);
+}
+
+/*
+    SymTable_setFilter is a helper function that makes the filter of uBlocks blocks in pvBlock,
+    which holds uAdded keys, the filter of oSymTable, freeing the old one. Returns nothing.
+*/
+static void SymTable_setFilter(SymTable_T oSymTable, void *pvBlock, size_t uBlocks,
+    size_t uAdded) {
+    if(oSymTable->pvFilterBlock != NULL) {
+        oSymTable->uMemoryUsage -= SymTable_blockSize(
+            SymTable_filterBytes(oSymTable->uFilterBlocks));
+        SymTable_deallocate(oSymTable, oSymTable->pvFilterBlock);
+    }
+    oSymTable->uMemoryUsage += SymTable_blockSize(SymTable_filterBytes(uBlocks));
+    oSymTable->pvFilterBlock = pvBlock;
+    oSymTable->puFilter = SymTable_alignFilter(pvBlock);
+    oSymTable->uFilterBlocks = uBlocks;
+    oSymTable->uFilterAdded = uAdded;
+    oSymTable->uFilterCapacity = uBlocks * FILTER_WORDS * 32 / FILTER_BITS_PER_KEY;
+}
+
+/*
+    SymTable_buildFilter is a helper function that gives oSymTable a new filter holding its
+    visible keys, sized for twice as many keys as it holds or for as many as it has buckets,
+    whichever is more, and frees the old filter. The keys are added from the hash codes that
+    the Bindings keep. Returns 1 on success, and 0 if there is not enough memory, in which case
+    the old filter, which still holds every key, is kept.
+*/
+static int SymTable_buildFilter(SymTable_T oSymTable) {
+    void *pvBlock;
+    uint32_t *puFilter;
+    size_t uCapacity = 2 * oSymTable->size;
+    size_t uBlocks = 1;
+    size_t u;
+    if(uCapacity < *(oSymTable->uBucketCount))
+        uCapacity = *(oSymTable->uBucketCount);
+    while(uBlocks * FILTER_WORDS * 32 < uCapacity * FILTER_BITS_PER_KEY)
+        uBlocks *= 2;
+    pvBlock = SymTable_allocateZeroed(oSymTable, SymTable_filterBytes(uBlocks), 1);
+    if(pvBlock == NULL)
+        return 0;
+    puFilter = SymTable_alignFilter(pvBlock);
+    for(u = 0; u < oSymTable->uBindingCount; u++) {
+        if(oSymTable->psBindings[u].iVisible)
+            SymTable_filterSet(puFilter, uBlocks, oSymTable->psBindings[u].uCode);
+    }
+    SymTable_setFilter(oSymTable, pvBlock, uBlocks, oSymTable->size);
+    return 1;
+}
+
+/*
+    SymTable_refreshFilter is a helper function that rebuilds the filter of oSymTable, if it has
+    one, once as many keys have been added to it as it was sized for, so that neither growth
+    nor the keys of removed Bindings push its rate of false positives up. If there is not
+    enough memory the filter is kept, and is tried again after as many keys again. Returns
+    nothing.
+*/
+static void SymTable_refreshFilter(SymTable_T oSymTable) {
+    if(oSymTable->puFilter == NULL || oSymTable->uFilterAdded < oSymTable->uFilterCapacity)
+        return;
+    if(!SymTable_buildFilter(oSymTable))
+        oSymTable->uFilterCapacity *= 2;
+}
+
+/*
+    SymTable_filterAdd is a helper function that adds the key with hash code uCode, a key that
+    has just become visible in oSymTable, to the filter of oSymTable if it has one. Returns
+    nothing.
+*/
+static void SymTable_filterAdd(SymTable_T oSymTable, size_t uCode) {
+    if(oSymTable->puFilter == NULL)
+        return;
+    SymTable_filterSet(oSymTable->puFilter, oSymTable->uFilterBlocks, uCode);
+    oSymTable->uFilterAdded++;
+}
+
+int SymTable_enableFilter(SymTable_T oSymTable) {
+    assert(oSymTable != NULL);
+    return SymTable_buildFilter(oSymTable);
+}
+
+int SymTable_enableCache(SymTable_T oSymTable) {
+    assert(oSymTable != NULL);
+    if(oSymTable->psCache != NULL)
+        return 1;
+    oSymTable->psCache = (struct CacheEntry *)SymTable_allocateZeroed(oSymTable, CACHE_SLOTS,
+        sizeof(struct CacheEntry));
+    if(oSymTable->psCache == NULL)
+        return 0;
+    oSymTable->uMemoryUsage += SymTable_blockSize(CACHE_SLOTS * sizeof(struct CacheEntry));
+    return 1;
+}
+
+/*
+    SymTable_rehash is a helper function that gives the parameter oSymTable a new array of
+    *newBucketCount buckets and rebuilds its chains in it. The Bindings stay where they are and
+    keep their numbers, so the Bindings they shadow and the undo log stay valid, and no key is
+    hashed again. Returns 1 on success, and 0 if there is not enough memory, in which case
+    oSymTable is unchanged.
+*/
+static int SymTable_rehash(SymTable_T oSymTable, size_t *newBucketCount) {
+    size_t *newHead;
+    size_t *puNewGenerations;
+#ifdef SYMTABLE_STATS
+    clock_t iInitialClock = clock();
+#endif
+    newHead = (size_t *)SymTable_allocate(oSymTable, *newBucketCount * sizeof(size_t));
+    puNewGenerations = (size_t *)SymTable_allocate(oSymTable,
+        *newBucketCount * sizeof(size_t));
+    if (newHead == NULL || puNewGenerations == NULL) {
+        SymTable_deallocate(oSymTable, newHead);
+        SymTable_deallocate(oSymTable, puNewGenerations);
+        return 0;
+    }
+    oSymTable->uMemoryUsage += 2 * SymTable_blockSize(*newBucketCount * sizeof(size_t))
+        - 2 * SymTable_blockSize(*(oSymTable->uBucketCount) * sizeof(size_t));
+    SymTable_deallocate(oSymTable, oSymTable->head);
+    SymTable_deallocate(oSymTable, oSymTable->puGenerations);
+    oSymTable->head = newHead;
+    oSymTable->puGenerations = puNewGenerations;
+    oSymTable->uBucketCount = newBucketCount;
+    SymTable_relink(oSymTable);
+    /* The filter is sized for the new bucket count. The old one still holds every key, so it
+        is kept if there is not enough memory for a new one. */
+    if(oSymTable->puFilter != NULL)
+        (void)SymTable_buildFilter(oSymTable);
+    STAT_ADD(oSymTable, uResizes, 1);
+    STAT_ADD(oSymTable, dResizeSeconds,
+        (double)(clock() - iInitialClock) / CLOCKS_PER_SEC);
+    return 1;
+}
+
+/*
+    SymTable_expand is a helper function for the SymTable_put function that expands
+    the parameter oSymTable by increasing its bucket counts. It is a static function
+    that is only required and called on by SymTable_put. The parameter is a SymTable_T
+    representing the SymTable that needs to be expanded. The function returns an integer
+    representing whether the expansion was successful or not. It returns 1 representing
+    success, and 0 representing failure due to lack of memory, and -1 representing failure
+    due to reaching max buckets.
+*/
+static int SymTable_expand(SymTable_T oSymTable) {
+    if((size_t)(oSymTable->uBucketCount-BUCKET_COUNTS)
+            == BUCKET_COUNT_SIZE-1) {
+        return -1;
+    }
+    return SymTable_rehash(oSymTable, oSymTable->uBucketCount+1);
+}
+
+/*
+    SymTable_makeRoom is a helper function that makes room in oSymTable for one more Binding
+    before it is put: the bucket array is expanded once the SymTable holds as many key-value
+    pairs as it has buckets, and a full array of Bindings is compacted if a quarter of it is
+    holes and doubled otherwise. Returns 2 if the links returned by SymTable_findLink are no
+    longer valid, 1 if they are, and 0 if there is not enough memory.
+*/
+static int SymTable_makeRoom(SymTable_T oSymTable) {
+    int iExpanded = -1;
+    size_t uCapacity;
+    if(oSymTable->size == *(oSymTable->uBucketCount)) {
+        iExpanded = SymTable_expand(oSymTable);
+        if(iExpanded == 0)
+            return 0;
+    }
+    if(oSymTable->uBindingCount < oSymTable->uBindingCapacity)
+        return iExpanded == 1 ? 2 : 1;
+    if(oSymTable->uFreeCount > 0 && oSymTable->uFreeCount >= oSymTable->uBindingCount / 4)
+        SymTable_compact(oSymTable);
+    else {
+        uCapacity = oSymTable->uBindingCapacity == 0 ? MIN_BINDINGS
+            : 2 * oSymTable->uBindingCapacity;
+        if(uCapacity < oSymTable->uBindingCapacity
+                || !SymTable_resizeBindings(oSymTable, uCapacity))
+            return 0;
+    }
+    return 2;
+}
+
+int SymTable_reserve(SymTable_T oSymTable, size_t uCapacity) {
+    size_t *newBucketCount;
+    size_t uBindings;
+    assert(oSymTable != NULL);
+    newBucketCount = SymTable_bucketCountFor(uCapacity);
+    if(newBucketCount > oSymTable->uBucketCount
+            && !SymTable_rehash(oSymTable, newBucketCount))
+        return 0;
+    if(uCapacity <= oSymTable->size)
+        return 1;
+    /* The holes are kept, so the new key-value pairs go after them. */
+    uBindings = oSymTable->uBindingCount + (uCapacity - oSymTable->size);
+    if(uBindings < oSymTable->uBindingCount)
+        return 0;
+    if(uBindings <= oSymTable->uBindingCapacity)
+        return 1;
+    return SymTable_resizeBindings(oSymTable, uBindings);
+}
+
+/* CLONE_KEY_BYTES is the number of bytes per key that SymTable_clone first makes room for. */
+static const size_t CLONE_KEY_BYTES = 16;
+
+/*
+    SymTable_resizeKeys is a helper function for SymTable_clone that moves the key block of
+    oClone, of which the first uKeyBytes are in use, to a block of uCapacity bytes, and points the
+    key of each of the first uCount Bindings of oClone at its place in the new block. The keys
+    are in the order of the Bindings, so this is one pass over each block. Returns 1 on success,
+    and 0 if there is not enough memory, in which case the key block is unchanged.
+*/
+static int SymTable_resizeKeys(SymTable_T oClone, size_t uKeyBytes, size_t uCapacity,
+    size_t uCount) {
+    char *pcKey;
+    size_t u;
+    pcKey = (char *)SymTable_reallocate(oClone, oClone->pcBulkKeys, uKeyBytes, uCapacity);
+    if(pcKey == NULL)
+        return 0;
+    oClone->uMemoryUsage += SymTable_blockSize(uCapacity);
+    oClone->uMemoryUsage -= SymTable_blockSize(oClone->uBulkKeyCapacity);
+    oClone->pcBulkKeys = pcKey;
+    oClone->uBulkKeyCapacity = uCapacity;
+    for(u = 0; u < uCount; u++) {
+        oClone->psBindings[u].key = pcKey;
+        pcKey += strlen(pcKey) + 1;
+    }
+    return 1;
+}
+
+/*
+    SymTable_copyKey is a helper function for SymTable_clone that copies pcKey to the end of the
+    *puKeyBytes bytes in use of the key block of oClone, growing the block if the key does not
+    fit, and points the key of the Binding of oClone numbered uBinding, the next one of the
+    array, at the copy. Returns 1 on success, and 0 if there is not enough memory.
+*/
+static int SymTable_copyKey(SymTable_T oClone, size_t uBinding, const char *pcKey,
+    size_t *puKeyBytes) {
+    size_t uLength = strlen(pcKey) + 1;
+    size_t uCapacity = oClone->uBulkKeyCapacity;
+    if(uLength > uCapacity - *puKeyBytes) {
+        uCapacity = 2 * uCapacity < *puKeyBytes + uLength ? *puKeyBytes + uLength : 2 * uCapacity;
+        if(!SymTable_resizeKeys(oClone, *puKeyBytes, uCapacity, uBinding - 1))
+            return 0;
+    }
+    memcpy(oClone->pcBulkKeys + *puKeyBytes, pcKey, uLength);
+    oClone->psBindings[uBinding - 1].key = oClone->pcBulkKeys + *puKeyBytes;
+    *puKeyBytes += uLength;
+    return 1;
+}
+
+/*
+    SymTable_copyFilter is a helper function for SymTable_clone that gives oClone a copy of the
+    filter of oSymTable. Returns 1 on success, and 0 if there is not enough memory.
+*/
+static int SymTable_copyFilter(SymTable_T oClone, SymTable_T oSymTable) {
+    void *pvBlock = SymTable_allocate(oClone, SymTable_filterBytes(oSymTable->uFilterBlocks));
+    if(pvBlock == NULL)
+        return 0;
+    SymTable_setFilter(oClone, pvBlock, oSymTable->uFilterBlocks, oSymTable->uFilterAdded);
+    memcpy(oClone->puFilter, oSymTable->puFilter,
+        oSymTable->uFilterBlocks * FILTER_WORDS * sizeof(uint32_t));
+    return 1;
+}
+
+/*
+    SymTable_cloneMapped is a helper function for SymTable_clone that copies a SymTable served
+    from a mapped snapshot, which has no Bindings to copy, by putting every key-value pair of the
+    mapping into a new SymTable. Returns the new SymTable, or NULL if there is not enough memory.
+*/
+static SymTable_T SymTable_cloneMapped(SymTable_T oSymTable) {
+    struct Promotion sPromotion;
+    sPromotion.oSymTable = SymTable_create(&oSymTable->sAllocator,
+        SymTable_bucketCountFor(SymTableImage_getLength(oSymTable->oImage)));
+    if(sPromotion.oSymTable == NULL)
+        return NULL;
+    sPromotion.iSuccessful = 1;
+    SymTableImage_map(oSymTable->oImage, SymTable_promoteBinding, &sPromotion);
+    if(!sPromotion.iSuccessful) {
+        SymTable_free(sPromotion.oSymTable);
+        return NULL;
+    }
+    return sPromotion.oSymTable;
+}
+
+/*
+    SymTable_cloneNumber is a helper function for SymTable_clone that returns the number in oClone
+    of the Binding numbered uBinding in the SymTable it is a copy of, or 0 if uBinding is 0. Until
+    the chains of oClone are built, the uNext field of each of its Bindings holds the number it
+    was copied from, and those numbers increase, so a binary search finds it.
+*/
+static size_t SymTable_cloneNumber(SymTable_T oClone, size_t uBinding) {
+    size_t uLow = 0;
+    size_t uHigh = oClone->uBindingCount - 1;
+    size_t uMiddle;
+    if(uBinding == 0)
+        return 0;
+    while(uLow < uHigh) {
+        uMiddle = uLow + (uHigh - uLow) / 2;
+        if(oClone->psBindings[uMiddle].uNext < uBinding)
+            uLow = uMiddle + 1;
+        else
+            uHigh = uMiddle;
+    }
+    assert(oClone->psBindings[uLow].uNext == uBinding);
+    return uLow + 1;
+}
+
+/*
+    SymTable_cloneRecency is a helper function for SymTable_clone that gives oClone, a copy of the
+    bounded oSymTable that has room for its links, the same order of use as oSymTable. Returns
+    nothing.
+*/
+static void SymTable_cloneRecency(SymTable_T oClone, SymTable_T oSymTable) {
+    const struct Recency *psRecency;
+    size_t u;
+    for(u = 0; u < oClone->uBindingCount; u++) {
+        psRecency = SymTable_recency(oSymTable, oClone->psBindings[u].uNext);
+        oClone->psRecency[u].uOlder = SymTable_cloneNumber(oClone, psRecency->uOlder);
+        oClone->psRecency[u].uNewer = SymTable_cloneNumber(oClone, psRecency->uNewer);
+    }
+    oClone->uOldest = SymTable_cloneNumber(oClone, oSymTable->uOldest);
+    oClone->uNewest = SymTable_cloneNumber(oClone, oSymTable->uNewest);
+}
+
+SymTable_T SymTable_clone(SymTable_T oSymTable) {
+    SymTable_T oClone;
+    struct Binding *pBinding;
+    struct Binding *pNewBinding;
+    size_t uKeyBytes = 0;
+    size_t u;
+    assert(oSymTable != NULL);
+    if(oSymTable->oImage != NULL) {
+        oClone = SymTable_cloneMapped(oSymTable);
+        if(oClone != NULL && ((oSymTable->puFilter != NULL && !SymTable_buildFilter(oClone))
+                || (oSymTable->psCache != NULL && !SymTable_enableCache(oClone)))) {
+            SymTable_free(oClone);
+            return NULL;
+        }
+        return oClone;
+    }
+    oClone = SymTable_create(&oSymTable->sAllocator, oSymTable->uBucketCount);
+    if(oClone == NULL)
+        return NULL;
+    oClone->uMaxEntries = oSymTable->uMaxEntries;
+    oClone->pfEvict = oSymTable->pfEvict;
+    oClone->pvEvictExtra = oSymTable->pvEvictExtra;
+    if((oSymTable->puFilter != NULL && !SymTable_copyFilter(oClone, oSymTable))
+            || (oSymTable->psCache != NULL && !SymTable_enableCache(oClone))) {
+        SymTable_free(oClone);
+        return NULL;
+    }
+    if(oSymTable->size == 0)
+        return oClone;
+    if(!SymTable_resizeBindings(oClone, oSymTable->size)
+            || !SymTable_resizeKeys(oClone, 0, oSymTable->size * CLONE_KEY_BYTES, 0)) {
+        SymTable_free(oClone);
+        return NULL;
+    }
+    /* The visible Bindings are copied in order, without the holes, and each keeps its hash
+        code. The walk is the only pass over oSymTable: the key block grows as the keys are
+        copied. */
+    for(u = 0; u < oSymTable->uBindingCount; u++) {
+        pBinding = &oSymTable->psBindings[u];
+        if(!pBinding->iVisible)
+            continue;
+        pNewBinding = &oClone->psBindings[oClone->uBindingCount];
+        if(!SymTable_copyKey(oClone, oClone->uBindingCount + 1, pBinding->key, &uKeyBytes)) {
+            SymTable_free(oClone);
+            return NULL;
+        }
+        pNewBinding->value = pBinding->value;
+        pNewBinding->uCode = pBinding->uCode;
+        pNewBinding->uNext = u + 1;
+        pNewBinding->uShadowed = 0;
+        pNewBinding->uScope = 0;
+        pNewBinding->iBorrowed = 1;
+        pNewBinding->iVisible = 1;
+        oClone->uBindingCount++;
+        oClone->uBindingEnd++;
+    }
+    assert(oClone->uBindingCount == oSymTable->size);
+    oClone->size = oSymTable->size;
+    if(oClone->uMaxEntries != 0)
+        SymTable_cloneRecency(oClone, oSymTable);
+    SymTable_relink(oClone);
+    /* The room that the keys did not use is given back if the block can be shrunk. */
+    if(uKeyBytes < oClone->uBulkKeyCapacity)
+        (void)SymTable_resizeKeys(oClone, uKeyBytes, uKeyBytes, oClone->uBindingCount);
+    return oClone;
+}
+
+/* A hash table cannot share its Bindings, so a snapshot is a clone. */
+SymTable_T SymTable_snapshot(SymTable_T oSymTable) {
+    return SymTable_clone(oSymTable);
+}
+
+/*
+    SymTable_sameKey is a helper function that returns 1 if the stored key pcStoredKey is the key
+    made of the uLength characters at pcKey, and 0 otherwise. strncmp stops at the end of
+    pcStoredKey, so a stored key shorter than uLength is never read past its end.
+*/
+static int SymTable_sameKey(const char *pcStoredKey, const char *pcKey, size_t uLength) {
+    return strncmp(pcStoredKey, pcKey, uLength) == 0 && pcStoredKey[uLength] == '\0';
+}
+
+/*
+    SymTable_findLinkHashed is a helper function that returns the link (the bucket head or the
+    uNext field) that holds the number of the visible Binding of oSymTable whose key is the
+    uLength characters at pcKey, whose hash code is uCode, or the 0 link at the end of pcKey's
+    bucket if there is no such Binding. Only a Binding with the same hash code has its key
+    compared. The link is valid until the array of Bindings or the bucket array changes size.
+*/
+static size_t *SymTable_findLinkHashed(SymTable_T oSymTable, const char *pcKey,
+    size_t uLength, size_t uCode) {
+    size_t *puLink;
+    struct Binding *pBinding;
+    puLink = SymTable_bucket(oSymTable, uCode % *(oSymTable->uBucketCount));
+    STAT_ADD(oSymTable, uLookups, 1);
+    for( ; *puLink != 0; puLink = &pBinding->uNext) {
+        pBinding = SymTable_binding(oSymTable, *puLink);
+        STAT_ADD(oSymTable, uComparisons, 1);
+        if(pBinding->uCode == uCode && SymTable_sameKey(pBinding->key, pcKey, uLength)) {
+            STAT_ADD(oSymTable, uHits, 1);
+            return puLink;
+        }
+    }
+    STAT_ADD(oSymTable, uMisses, 1);
+    return puLink;
+}
+
+/*
+    SymTable_refindLink is SymTable_findLinkHashed for a key that has just been looked up, after
+    SymTable_makeRoom has moved the links. The walk is not counted as a lookup, since the client
+    made only one.
+*/
+static size_t *SymTable_refindLink(SymTable_T oSymTable, const char *pcKey, size_t uLength,
+    size_t uCode) {
+    size_t *puLink;
+    struct Binding *pBinding;
+    puLink = SymTable_bucket(oSymTable, uCode % *(oSymTable->uBucketCount));
+    for( ; *puLink != 0; puLink = &pBinding->uNext) {
+        pBinding = SymTable_binding(oSymTable, *puLink);
+        if(pBinding->uCode == uCode && SymTable_sameKey(pBinding->key, pcKey, uLength))
+            break;
+    }
+    return puLink;
+}
+
+/*
+    SymTable_filterRejects is a helper function that returns 1 if the filter of oSymTable shows
+    that the key with hash code uCode is not in oSymTable, in which case the lookup counts as a
+    miss that made no comparison, and 0 if oSymTable has no filter or the key may be in it.
+*/
+static int SymTable_filterRejects(SymTable_T oSymTable, size_t uCode) {
+    if(oSymTable->puFilter == NULL
+            || SymTable_filterTest(oSymTable->puFilter, oSymTable->uFilterBlocks, uCode))
+        return 0;
+    STAT_ADD(oSymTable, uLookups, 1);
+    STAT_ADD(oSymTable, uMisses, 1);
+    STAT_ADD(oSymTable, uFilterRejects, 1);
+    return 1;
+}
+
+/*
+    SymTable_cacheSlot is a helper function that returns the entry of the recent-lookup cache of
+    oSymTable for the key at the address pcKey. The address is hashed, not the key.
+*/
+static struct CacheEntry *SymTable_cacheSlot(SymTable_T oSymTable, const char *pcKey) {
+    uint64_t uAddress = (uint64_t)(uintptr_t)pcKey;
+    return &oSymTable->psCache[(uAddress * (uint64_t)0x9E3779B97F4A7C15ULL) >> (64 - CACHE_BITS)];
+}
+
+/*
+    SymTable_findBinding is a helper function that returns the visible Binding of oSymTable whose
+    key is the uLength characters at pcKey, or NULL if there is no such Binding. A key found at
+    the same address by an earlier lookup costs one comparison, since the cache entry is checked
+    against the key itself in case the client reused the address for another key. A key that the
+    filter rules out is a miss without a bucket being read.
+*/
+static struct Binding *SymTable_findBinding(SymTable_T oSymTable, const char *pcKey,
+    size_t uLength) {
+    struct CacheEntry *psEntry = NULL;
+    size_t uBinding;
+    size_t uCode;
+    if(oSymTable->psCache != NULL) {
+        psEntry = SymTable_cacheSlot(oSymTable, pcKey);
+        if(psEntry->pcKey == pcKey && psEntry->uEpoch == oSymTable->uCacheEpoch
+                && SymTable_sameKey(SymTable_binding(oSymTable, psEntry->uBinding)->key,
+                    pcKey, uLength)) {
+            STAT_ADD(oSymTable, uLookups, 1);
+            STAT_ADD(oSymTable, uComparisons, 1);
+            STAT_ADD(oSymTable, uHits, 1);
+            STAT_ADD(oSymTable, uCacheHits, 1);
+            return SymTable_binding(oSymTable, psEntry->uBinding);
+        }
+        STAT_ADD(oSymTable, uCacheMisses, 1);
+    }
+    uCode = SymTable_hashCode(pcKey, uLength);
+    if(SymTable_filterRejects(oSymTable, uCode))
+        return NULL;
+    uBinding = *SymTable_findLinkHashed(oSymTable, pcKey, uLength, uCode);
+    if(uBinding == 0)
+        return NULL;
+    if(psEntry != NULL) {
+        psEntry->pcKey = pcKey;
+        psEntry->uBinding = uBinding;
+        psEntry->uEpoch = oSymTable->uCacheEpoch;
+    }
+    return SymTable_binding(oSymTable, uBinding);
+}
+
+/*
+    SymTable_link is a helper function that makes the Binding numbered uBinding the visible
+    Binding at the link puLink returned by SymTable_findLinkHashed. If the link holds the
+    Binding's uShadowed, the Binding takes its place in the bucket; otherwise puLink is the end
+    of the bucket, the Binding is appended, its key is added to the filter, it becomes the most
+    recently used of a bounded oSymTable, and the size of oSymTable grows by one. Shadowing a Binding invalidates the recent-lookup cache. Returns
+    nothing.
+*/
+static void SymTable_link(SymTable_T oSymTable, size_t *puLink, size_t uBinding) {
+    struct Binding *pBinding = SymTable_binding(oSymTable, uBinding);
+    struct Binding *pShadowed;
+    assert(*puLink == pBinding->uShadowed);
+    if(*puLink == 0) {
+        pBinding->uNext = 0;
+        oSymTable->size = oSymTable->size + 1;
+        SymTable_filterAdd(oSymTable, pBinding->uCode);
+        if(oSymTable->uMaxEntries != 0)
+            SymTable_attach(oSymTable, uBinding);
+    }
+    else {
+        pShadowed = SymTable_binding(oSymTable, *puLink);
+        pBinding->uNext = pShadowed->uNext;
+        pShadowed->iVisible = 0;
+        SymTable_invalidateCache(oSymTable);
+    }
+    pBinding->iVisible = 1;
+    *puLink = uBinding;
+}
+
+/*
+    SymTable_unlink is a helper function that reverses SymTable_link: the Binding at the link
+    puLink is replaced by the Binding it shadows, or is spliced out of its bucket if it shadows
+    none, in which case it leaves the list in order of use of a bounded oSymTable and the size
+    of oSymTable shrinks by one. The recent-lookup cache is
+    invalidated. The Binding is not freed. Returns the number of the unlinked Binding.
+*/
+static size_t SymTable_unlink(SymTable_T oSymTable, size_t *puLink) {
+    size_t uBinding = *puLink;
+    struct Binding *pBinding = SymTable_binding(oSymTable, uBinding);
+    struct Binding *pShadowed;
+    SymTable_invalidateCache(oSymTable);
+    if(pBinding->uShadowed == 0) {
+        *puLink = pBinding->uNext;
+        oSymTable->size = oSymTable->size - 1;
+        if(oSymTable->uMaxEntries != 0)
+            SymTable_detach(oSymTable, uBinding);
+    }
+    else {
+        pShadowed = SymTable_binding(oSymTable, pBinding->uShadowed);
+        pShadowed->uNext = pBinding->uNext;
+        pShadowed->iVisible = 1;
+        *puLink = pBinding->uShadowed;
+    }
+    pBinding->iVisible = 0;
+    return uBinding;
+}
+
+/*
+    SymTable_linkTo is a helper function that returns the link that holds the number of the
+    visible Binding of oSymTable numbered uBinding. The bucket is walked by number, so no key is
+    compared.
+*/
+static size_t *SymTable_linkTo(SymTable_T oSymTable, size_t uBinding) {
+    size_t *puLink = SymTable_bucket(oSymTable,
+        SymTable_binding(oSymTable, uBinding)->uCode % *(oSymTable->uBucketCount));
+    while(*puLink != uBinding)
+        puLink = &SymTable_binding(oSymTable, *puLink)->uNext;
+    return puLink;
+}
+
+/*
+    SymTable_evict is a helper function that removes the least recently used key-value pairs of
+    oSymTable until it holds no more than its bound, if it has one. Each is passed to pfEvict
+    before its key is freed. The Bindings become holes and none is moved, so a pointer to a
+    value stays valid. Returns nothing.
+*/
+static void SymTable_evict(SymTable_T oSymTable) {
+    struct Binding *pBinding;
+    size_t uBinding;
+    if(oSymTable->uMaxEntries == 0)
+        return;
+    while(oSymTable->size > oSymTable->uMaxEntries) {
+        uBinding = SymTable_unlink(oSymTable, SymTable_linkTo(oSymTable, oSymTable->uOldest));
+        pBinding = SymTable_binding(oSymTable, uBinding);
+        if(oSymTable->pfEvict != NULL)
+            (*oSymTable->pfEvict)(pBinding->key, (void *)pBinding->value,
+                (void *)oSymTable->pvEvictExtra);
+        SymTable_freeBinding(oSymTable, pBinding);
+    }
+}
+
+/*
+    SymTable_reserveUndo is a helper function that makes room for one more entry in the undo log
+    of oSymTable, so that a change can be made and logged without failing halfway. Returns 1 on
+    success, and 0 if there is not enough memory.
+*/
+static int SymTable_reserveUndo(SymTable_T oSymTable) {
+    struct Undo *psUndoLog;
+    size_t uUndoCapacity;
+    if(oSymTable->uUndoCount < oSymTable->uUndoCapacity)
+        return 1;
+    uUndoCapacity = oSymTable->uUndoCapacity == 0 ? 16 : 2 * oSymTable->uUndoCapacity;
+    psUndoLog = (struct Undo *)SymTable_reallocate(oSymTable, oSymTable->psUndoLog,
+        oSymTable->uUndoCapacity * sizeof(struct Undo), uUndoCapacity * sizeof(struct Undo));
+    if(psUndoLog == NULL)
+        return 0;
+    oSymTable->uMemoryUsage += SymTable_blockSize(uUndoCapacity * sizeof(struct Undo))
+        - SymTable_blockSize(oSymTable->uUndoCapacity * sizeof(struct Undo));
+    oSymTable->psUndoLog = psUndoLog;
+    oSymTable->uUndoCapacity = uUndoCapacity;
+    return 1;
+}
+
+/*
+    SymTable_logUndo is a helper function that appends an entry of kind eKind for the Binding
+    numbered uBinding, with the old value pvOldValue, to the undo log of oSymTable if a scope is
+    open. Room must have been reserved with SymTable_reserveUndo. Returns nothing.
+*/
+static void SymTable_logUndo(SymTable_T oSymTable, enum UndoKind eKind,
+    size_t uBinding, const void *pvOldValue) {
+    struct Undo *psUndo;
+    if(oSymTable->uScopeDepth == 0)
+        return;
+    assert(oSymTable->uUndoCount < oSymTable->uUndoCapacity);
+    psUndo = &oSymTable->psUndoLog[oSymTable->uUndoCount++];
+    psUndo->eKind = eKind;
+    psUndo->uBinding = uBinding;
+    psUndo->pvOldValue = pvOldValue;
+}
+
+/*
+    SymTable_undo is a helper function that reverts the change recorded by the undo log entry
+    psUndo of oSymTable. It relies on the entries being reverted newest first, so that the
+    SymTable is in the state just after the change. A Binding that was put is left as a hole.
+    Returns nothing.
+*/
+static void SymTable_undo(SymTable_T oSymTable, const struct Undo *psUndo) {
+    struct Binding *pBinding = SymTable_binding(oSymTable, psUndo->uBinding);
+    size_t *puLink;
+    if(psUndo->eKind == UNDO_REPLACE) {
+        pBinding->value = psUndo->pvOldValue;
+        return;
+    }
+    puLink = SymTable_findLinkHashed(oSymTable, pBinding->key, strlen(pBinding->key),
+        pBinding->uCode);
+    if(psUndo->eKind == UNDO_PUT) {
+        assert(*puLink == psUndo->uBinding);
+        (void)SymTable_unlink(oSymTable, puLink);
+        SymTable_freeBinding(oSymTable, pBinding);
+    }
+    else
+        SymTable_link(oSymTable, puLink, psUndo->uBinding);
+}
+
+/*
+    SymTable_putKey is a helper function that does the work of SymTable_putN and
+    SymTable_putBorrowed: it puts the key made of the uLength characters at pcKey, with the value
+    pvValue, borrowing pcKey if iBorrowed is 1 and copying it otherwise. Returns 1 on success, and
+    0 if the key is already bound in the innermost scope or there is not enough memory.
+*/
+static int SymTable_putKey(SymTable_T oSymTable, const char *pcKey, size_t uLength,
+    const void *pvValue, int iBorrowed) {
+    struct Binding *pNewBinding;
+    size_t uNewBinding;
+    size_t *puLink;
+    size_t uCode;
+    int iRoom;
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+    /* A key that is already in the mapping is rejected without promoting. */
+    if(oSymTable->oImage != NULL) {
+        if(SymTableImage_findN(oSymTable->oImage, pcKey, uLength) != NULL
+                || !SymTable_promote(oSymTable))
+            return 0;
+    }
+    /* A key that is visible from an outer scope is shadowed; one put in this scope is kept. */
+    uCode = SymTable_hashCode(pcKey, uLength);
+    puLink = SymTable_findLinkHashed(oSymTable, pcKey, uLength, uCode);
+    if(*puLink != 0 && SymTable_binding(oSymTable, *puLink)->uScope == oSymTable->uScopeDepth)
+        return 0;
+    /* Only a put that grows or compacts the table walks the bucket a second time. */
+    iRoom = SymTable_makeRoom(oSymTable);
+    if(iRoom == 0)
+        return 0;
+    if(iRoom == 2)
+        puLink = SymTable_refindLink(oSymTable, pcKey, uLength, uCode);
+    SymTable_refreshFilter(oSymTable);
+    if(oSymTable->uScopeDepth > 0 && !SymTable_reserveUndo(oSymTable))
+        return 0;
+    /* Create a new binding with the given key-value pair. */
+    uNewBinding = SymTable_newBinding(oSymTable, pcKey, uLength, uCode, iBorrowed);
+    if(uNewBinding == 0) return 0;
+    pNewBinding = SymTable_binding(oSymTable, uNewBinding);
+    pNewBinding->value = pvValue;
+    pNewBinding->uShadowed = *puLink;
+    pNewBinding->uScope = (unsigned int)oSymTable->uScopeDepth;
+    SymTable_link(oSymTable, puLink, uNewBinding);
+    SymTable_logUndo(oSymTable, UNDO_PUT, uNewBinding, NULL);
+    SymTable_logChange(oSymTable, SYMTABLELOG_PUT, pcKey, uLength, pvValue);
+    SymTable_evict(oSymTable);
+    return 1;
+}
+
+int SymTable_putN(SymTable_T oSymTable, const char *pcKey, size_t uLength,
+    const void *pvValue) {
+    return SymTable_putKey(oSymTable, pcKey, uLength, pvValue, 0);
+}
+
+int SymTable_put(SymTable_T oSymTable,
+   const char *pcKey, const void *pvValue) {
+    assert(pcKey != NULL);
+    return SymTable_putKey(oSymTable, pcKey, strlen(pcKey), pvValue, 0);
+}
+
+int SymTable_putBorrowed(SymTable_T oSymTable, const char *pcKey, const void *pvValue) {
+    assert(pcKey != NULL);
+    return SymTable_putKey(oSymTable, pcKey, strlen(pcKey), pvValue, 1);
+}
+
+SymTable_T SymTable_fromArrays(const char *const *apcKeys, const void *const *apvValues,
+    size_t uCount) {
+    SymTable_T oSymTable;
+    struct Binding *pBinding;
+    size_t uBinding;
+    size_t *puLink;
+    char *pcKey;
+    size_t uKeyBytes = 0;
+    size_t uLength;
+    size_t uCode;
+    size_t u;
+    assert(apcKeys != NULL || uCount == 0);
+    assert(apvValues != NULL || uCount == 0);
+    for(u = 0; u < uCount; u++) {
+        assert(apcKeys[u] != NULL);
+        uKeyBytes += strlen(apcKeys[u]) + 1;
+    }
+    /* The buckets and the array are sized up front, so adding the key-value pairs never
+        rehashes or moves them. */
+    oSymTable = SymTable_create(&DEFAULT_ALLOCATOR, SymTable_bucketCountFor(uCount));
+    if(oSymTable == NULL || uCount == 0)
+        return oSymTable;
+    oSymTable->pcBulkKeys = (char *)SymTable_allocate(oSymTable, uKeyBytes);
+    if(oSymTable->pcBulkKeys == NULL || !SymTable_resizeBindings(oSymTable, uCount)) {
+        SymTable_free(oSymTable);
+        return NULL;
+    }
+    oSymTable->uBulkKeyCapacity = uKeyBytes;
+    oSymTable->uMemoryUsage += SymTable_blockSize(uKeyBytes);
+    /* A key that is already in oSymTable is skipped, which leaves room in the array and key
+        bytes at the end of the key block unused. */
+    pcKey = oSymTable->pcBulkKeys;
+    for(u = 0; u < uCount; u++) {
+        uLength = strlen(apcKeys[u]);
+        uCode = SymTable_hashCode(apcKeys[u], uLength);
+        puLink = SymTable_findLinkHashed(oSymTable, apcKeys[u], uLength, uCode);
+        if(*puLink != 0)
+            continue;
+        memcpy(pcKey, apcKeys[u], uLength + 1);
+        uBinding = SymTable_newBinding(oSymTable, pcKey, uLength, uCode, 1);
+        pBinding = SymTable_binding(oSymTable, uBinding);
+        pBinding->value = apvValues[u];
+        pBinding->uShadowed = 0;
+        pBinding->uScope = 0;
+        SymTable_link(oSymTable, puLink, uBinding);
+        pcKey += uLength + 1;
+    }
+    return oSymTable;
+}
+
+void *SymTable_replaceN(SymTable_T oSymTable,
+    const char *pcKey, size_t uLength, const void *pvValue) {
+    struct Binding *pCurrentBinding;
+    void **ppvSlot;
+    void *ret;
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+    /* Values can be replaced inside the private mapping without promoting. */
+    if(oSymTable->oImage != NULL) {
+        ppvSlot = SymTableImage_findN(oSymTable->oImage, pcKey, uLength);
+        if(ppvSlot == NULL)
+            return NULL;
+        ret = *ppvSlot;
+        *ppvSlot = (void *)pvValue;
+        SymTable_logChange(oSymTable, SYMTABLELOG_REPLACE, pcKey, uLength, pvValue);
+        return ret;
+    }
+    pCurrentBinding = SymTable_findBinding(oSymTable, pcKey, uLength);
+    if(pCurrentBinding == NULL)
+        return NULL;
+    if(oSymTable->uScopeDepth > 0 && !SymTable_reserveUndo(oSymTable))
+        return NULL;
+    SymTable_touch(oSymTable, pCurrentBinding);
+    ret = (void *)pCurrentBinding->value;
+    pCurrentBinding->value=pvValue;
+    SymTable_logUndo(oSymTable, UNDO_REPLACE,
+        (size_t)(pCurrentBinding - oSymTable->psBindings) + 1, ret);
+    SymTable_logChange(oSymTable, SYMTABLELOG_REPLACE, pcKey, uLength, pvValue);
+    return ret;
+}
+
+void *SymTable_replace(SymTable_T oSymTable,
+    const char *pcKey, const void *pvValue) {
+    assert(pcKey != NULL);
+    return SymTable_replaceN(oSymTable, pcKey, strlen(pcKey), pvValue);
+}
+
+void **SymTable_upsertN(SymTable_T oSymTable, const char *pcKey, size_t uLength,
+    int *piInserted) {
+    struct Binding *pNewBinding;
+    size_t uNewBinding;
+    size_t *puLink;
+    size_t uCode;
+    void **ppvSlot;
+    int iRoom;
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+    if(piInserted != NULL)
+        *piInserted = 0;
+    /* A value stored through the slot would never reach the log. */
+    if(oSymTable->oLog != NULL)
+        return NULL;
+    /* A key that is already in the mapping has its slot there, as for SymTable_replace. */
+    if(oSymTable->oImage != NULL) {
+        ppvSlot = SymTableImage_findN(oSymTable->oImage, pcKey, uLength);
+        if(ppvSlot != NULL)
+            return ppvSlot;
+        if(!SymTable_promote(oSymTable))
+            return NULL;
+    }
+    uCode = SymTable_hashCode(pcKey, uLength);
+    puLink = SymTable_findLinkHashed(oSymTable, pcKey, uLength, uCode);
+    /* The slot is handed out before the caller writes it, so the value it holds now is logged. */
+    if(*puLink != 0) {
+        if(oSymTable->uScopeDepth > 0 && !SymTable_reserveUndo(oSymTable))
+            return NULL;
+        pNewBinding = SymTable_binding(oSymTable, *puLink);
+        SymTable_logUndo(oSymTable, UNDO_REPLACE, *puLink, pNewBinding->value);
+        SymTable_touch(oSymTable, pNewBinding);
+        return (void **)&pNewBinding->value;
+    }
+    /* Only a miss that grows or compacts the table walks its bucket a second time. */
+    iRoom = SymTable_makeRoom(oSymTable);
+    if(iRoom == 0)
+        return NULL;
+    if(iRoom == 2)
+        puLink = SymTable_refindLink(oSymTable, pcKey, uLength, uCode);
+    SymTable_refreshFilter(oSymTable);
+    if(oSymTable->uScopeDepth > 0 && !SymTable_reserveUndo(oSymTable))
+        return NULL;
+    uNewBinding = SymTable_newBinding(oSymTable, pcKey, uLength, uCode, 0);
+    if(uNewBinding == 0) return NULL;
+    pNewBinding = SymTable_binding(oSymTable, uNewBinding);
+    pNewBinding->value = NULL;
+    pNewBinding->uShadowed = 0;
+    pNewBinding->uScope = (unsigned int)oSymTable->uScopeDepth;
+    SymTable_link(oSymTable, puLink, uNewBinding);
+    SymTable_logUndo(oSymTable, UNDO_PUT, uNewBinding, NULL);
+    SymTable_evict(oSymTable);
+    if(piInserted != NULL)
+        *piInserted = 1;
+    return (void **)&pNewBinding->value;
+}
+
+void **SymTable_upsert(SymTable_T oSymTable, const char *pcKey, int *piInserted) {
+    assert(pcKey != NULL);
+    return SymTable_upsertN(oSymTable, pcKey, strlen(pcKey), piInserted);
+}
+
+int SymTable_containsN(SymTable_T oSymTable, const char *pcKey, size_t uLength) {
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+    if(oSymTable->oImage != NULL)
+        return SymTableImage_findN(oSymTable->oImage, pcKey, uLength) != NULL;
+    return SymTable_findBinding(oSymTable, pcKey, uLength) != NULL;
+}
+
+int SymTable_contains(SymTable_T oSymTable, const char *pcKey) {
+    assert(pcKey != NULL);
+    return SymTable_containsN(oSymTable, pcKey, strlen(pcKey));
+}
+
+void *SymTable_getN(SymTable_T oSymTable, const char *pcKey, size_t uLength) {
+    struct Binding *pCurrentBinding;
+    void **ppvSlot;
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+    if(oSymTable->oImage != NULL) {
+        ppvSlot = SymTableImage_findN(oSymTable->oImage, pcKey, uLength);
+        return ppvSlot == NULL ? NULL : *ppvSlot;
+    }
+    pCurrentBinding = SymTable_findBinding(oSymTable, pcKey, uLength);
+    if(pCurrentBinding == NULL)
+        return NULL;
+    SymTable_touch(oSymTable, pCurrentBinding);
+    return (void *)pCurrentBinding->value;
+}
+
+void *SymTable_get(SymTable_T oSymTable, const char *pcKey) {
+    assert(pcKey != NULL);
+    return SymTable_getN(oSymTable, pcKey, strlen(pcKey));
+}
+
+/*
+    SymTable_shrinkBindings is a helper function that gives back the room of the array of
+    Bindings of oSymTable once three quarters of it are unused, halving it, or all of it once
+    no Binding is left. If there is not enough memory for the smaller block the array is kept.
+    Returns nothing.
+*/
+static void SymTable_shrinkBindings(SymTable_T oSymTable) {
+    if(oSymTable->uBindingEnd > oSymTable->uBindingCapacity / 4)
+        return;
+    (void)SymTable_resizeBindings(oSymTable,
+        oSymTable->uBindingEnd == 0 ? 0 : oSymTable->uBindingCapacity / 2);
+}
+
+void *SymTable_removeN(SymTable_T oSymTable, const char *pcKey, size_t uLength) {
+    size_t *puLink;
+    struct Binding *pCurrentBinding;
+    size_t uBinding;
+    void *prevValue;
+    size_t uCode;
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+    /* Removing a key that is not in the mapping changes nothing, so only promote for a hit. */
+    if(oSymTable->oImage != NULL) {
+        if(SymTableImage_findN(oSymTable->oImage, pcKey, uLength) == NULL
+                || !SymTable_promote(oSymTable))
+            return NULL;
+    }
+    uCode = SymTable_hashCode(pcKey, uLength);
+    if(SymTable_filterRejects(oSymTable, uCode))
+        return NULL;
+    puLink = SymTable_findLinkHashed(oSymTable, pcKey, uLength, uCode);
+    if(*puLink == 0)
+        return NULL;
+    if(oSymTable->uScopeDepth > 0 && !SymTable_reserveUndo(oSymTable))
+        return NULL;
+    /* The filter keeps the key until it is rebuilt. Removing a Binding reveals the one it
+        shadows; the undo log keeps it until its scope is popped. */
+    uBinding = SymTable_unlink(oSymTable, puLink);
+    pCurrentBinding = SymTable_binding(oSymTable, uBinding);
+    prevValue = (void *) pCurrentBinding->value;
+    SymTable_logChange(oSymTable, SYMTABLELOG_REMOVE, pcKey, uLength, NULL);
+    if(oSymTable->uScopeDepth > 0) {
+        SymTable_logUndo(oSymTable, UNDO_REMOVE, uBinding, NULL);
+        return prevValue;
+    }
+    SymTable_freeBinding(oSymTable, pCurrentBinding);
+    /* Once half of the array is holes, they are squeezed out, so a walk of the array never
+        reads more than twice as many Bindings as it visits. */
+    if(2 * oSymTable->uFreeCount > oSymTable->uBindingCount) {
+        SymTable_compact(oSymTable);
+        SymTable_shrinkBindings(oSymTable);
+    }
+    return prevValue;
+}
+
+void *SymTable_remove(SymTable_T oSymTable, const char *pcKey) {
+    assert(pcKey != NULL);
+    return SymTable_removeN(oSymTable, pcKey, strlen(pcKey));
+}
+
+void SymTable_map(SymTable_T oSymTable,
+    void (*pfApply)(const char *pcKey, void *pvValue, void *pvExtra),
+    const void *pvExtra) {
+    struct Binding *pCurrentBinding;
+    size_t u;
+    assert(oSymTable != NULL);
+    assert(pfApply != NULL);
+    if(oSymTable->oImage != NULL) {
+        SymTableImage_map(oSymTable->oImage, pfApply, pvExtra);
+        return;
+    }
+    /* The visible Bindings are visited in the order they were put, with no bucket read. */
+    for(u = 0; u < oSymTable->uBindingCount; u++) {
+        pCurrentBinding = &oSymTable->psBindings[u];
+        if(pCurrentBinding->iVisible)
+            (*pfApply)(pCurrentBinding->key,
+                (void *)pCurrentBinding->value,(void *)pvExtra);
+    }
+}
+
+/*
+    SymTable_sameAllocator is a helper function that returns 1 if oFirst and oSecond allocate
+    from the same allocator, so that a block of one may be freed by the other, and 0 otherwise.
+*/
+static int SymTable_sameAllocator(SymTable_T oFirst, SymTable_T oSecond) {
+    return oFirst->sAllocator.pfAlloc == oSecond->sAllocator.pfAlloc
+        && oFirst->sAllocator.pfFree == oSecond->sAllocator.pfFree
+        && oFirst->sAllocator.pvContext == oSecond->sAllocator.pvContext;
+}
+
+/*
+    SymTable_takeBinding is a helper function for SymTable_merge that appends to the array of
+    oDst, which must have room for it, a Binding with the key and value of pBinding, a visible
+    Binding of oSrc, and turns pBinding into a hole. The key is handed over rather than copied:
+    a key that oSrc owns changes owner, with its bytes moved from the memory usage of oSrc to
+    that of oDst, and a borrowed key stays borrowed. It is copied only if the allocators differ
+    or it lies in the key block of oSrc. Returns the number of the new Binding, which is not yet
+    linked, or 0 if there is not enough memory for the copy, in which case pBinding is
+    unchanged.
+*/
+static size_t SymTable_takeBinding(SymTable_T oDst, SymTable_T oSrc,
+    struct Binding *pBinding) {
+    struct Binding *pNewBinding;
+    size_t uBinding;
+    size_t uSize;
+    if(pBinding->iBorrowed ? SymTable_isBulkKey(oSrc, pBinding->key)
+            : !SymTable_sameAllocator(oDst, oSrc)) {
+        uBinding = SymTable_newBinding(oDst, pBinding->key, strlen(pBinding->key),
+            pBinding->uCode, 0);
+        if(uBinding == 0)
+            return 0;
+        SymTable_freeBinding(oSrc, pBinding);
+    }
+    else {
+        /* The key is taken as borrowed, which cannot fail, and then given its owner. */
+        uBinding = SymTable_newBinding(oDst, pBinding->key, 0, pBinding->uCode, 1);
+        if(!pBinding->iBorrowed) {
+            uSize = SymTable_keySize(pBinding);
+            oSrc->uMemoryUsage -= uSize;
+            oDst->uMemoryUsage += uSize;
+            SymTable_binding(oDst, uBinding)->iBorrowed = 0;
+        }
+        pBinding->key = NULL;
+        pBinding->iVisible = 0;
+        oSrc->uFreeCount++;
+    }
+    pNewBinding = SymTable_binding(oDst, uBinding);
+    pNewBinding->value = pBinding->value;
+    pNewBinding->uShadowed = 0;
+    pNewBinding->uScope = 0;
+    return uBinding;
+}
+
+int SymTable_merge(SymTable_T oDst, SymTable_T oSrc,
+    void *(*pfCombine)(const char *pcKey, void *pvDstValue, void *pvSrcValue, void *pvExtra),
+    const void *pvExtra) {
+    struct Binding *pBinding;
+    struct Binding *pDstBinding;
+    size_t *puLink;
+    size_t uBinding;
+    size_t u;
+    assert(oDst != NULL);
+    assert(oSrc != NULL);
+    assert(oDst != oSrc);
+    /* Moved Bindings cannot be undone by a scope of either SymTable, nor logged one at a time. */
+    if(oDst->uScopeDepth > 0 || oSrc->uScopeDepth > 0)
+        return 0;
+    if(oDst->oLog != NULL || oSrc->oLog != NULL)
+        return 0;
+    if(!SymTable_promote(oDst) || !SymTable_promote(oSrc))
+        return 0;
+    /* With no scope open every Binding in use is visible. Reserving room for all of them
+        means that no link into oDst moves while the keys are taken. */
+    if(!SymTable_reserve(oDst, oDst->size + oSrc->size))
+        return 0;
+    /* The Bindings of oSrc are moved or freed. */
+    SymTable_invalidateCache(oSrc);
+    for(u = 0; u < oSrc->uBindingCount; u++) {
+        pBinding = &oSrc->psBindings[u];
+        if(!pBinding->iVisible)
+            continue;
+        puLink = SymTable_findLinkHashed(oDst, pBinding->key, strlen(pBinding->key),
+            pBinding->uCode);
+        if(*puLink != 0) {
+            pDstBinding = SymTable_binding(oDst, *puLink);
+            if(pfCombine != NULL)
+                pDstBinding->value = (*pfCombine)(pDstBinding->key, (void *)pDstBinding->value,
+                    (void *)pBinding->value, (void *)pvExtra);
+            SymTable_touch(oDst, pDstBinding);
+            SymTable_freeBinding(oSrc, pBinding);
+        }
+        else {
+            uBinding = SymTable_takeBinding(oDst, oSrc, pBinding);
+            if(uBinding == 0) {
+                /* The chains of oSrc still run through the Bindings already taken. */
+                SymTable_relink(oSrc);
+                SymTable_evict(oDst);
+                return 0;
+            }
+            SymTable_link(oDst, puLink, uBinding);
+        }
+        if(oSrc->uMaxEntries != 0)
+            SymTable_detach(oSrc, u + 1);
+        oSrc->size--;
+    }
+    SymTable_clear(oSrc);
+    SymTable_refreshFilter(oDst);
+    /* The key-value pairs of oSrc are the most recently used, and the oldest of oDst go. */
+    SymTable_evict(oDst);
+    return 1;
+}
+
+int SymTable_pushScope(SymTable_T oSymTable) {
+    size_t *puScopeMarks;
+    size_t uScopeCapacity;
+    assert(oSymTable != NULL);
+    /* Popping a scope could not bring back a key-value pair that has been evicted, nor take its
+        changes back out of the log. */
+    if(oSymTable->uMaxEntries != 0 || oSymTable->oLog != NULL)
+        return 0;
+    /* Scopes are undone through Bindings, so a mapped table is promoted first. */
+    if(!SymTable_promote(oSymTable))
+        return 0;
+    /* Bindings record their scope depth in an unsigned int. */
+    if(oSymTable->uScopeDepth == UINT_MAX)
+        return 0;
+    if(oSymTable->uScopeDepth == oSymTable->uScopeCapacity) {
+        uScopeCapacity = oSymTable->uScopeCapacity == 0 ? 8 : 2 * oSymTable->uScopeCapacity;
+        puScopeMarks = (size_t *)SymTable_reallocate(oSymTable, oSymTable->puScopeMarks,
+            oSymTable->uScopeCapacity * sizeof(size_t), uScopeCapacity * sizeof(size_t));
+        if(puScopeMarks == NULL)
+            return 0;
+        oSymTable->uMemoryUsage += SymTable_blockSize(uScopeCapacity * sizeof(size_t))
+            - SymTable_blockSize(oSymTable->uScopeCapacity * sizeof(size_t));
+        oSymTable->puScopeMarks = puScopeMarks;
+        oSymTable->uScopeCapacity = uScopeCapacity;
+    }
+    oSymTable->puScopeMarks[oSymTable->uScopeDepth] = oSymTable->uUndoCount;
+    oSymTable->uScopeDepth++;
+    return 1;
+}
+
+int SymTable_popScope(SymTable_T oSymTable) {
+    size_t uMark;
+    assert(oSymTable != NULL);
+    if(oSymTable->uScopeDepth == 0)
+        return 0;
+    oSymTable->uScopeDepth--;
+    uMark = oSymTable->puScopeMarks[oSymTable->uScopeDepth];
+    while(oSymTable->uUndoCount > uMark) {
+        oSymTable->uUndoCount--;
+        SymTable_undo(oSymTable, &oSymTable->psUndoLog[oSymTable->uUndoCount]);
+    }
+    return 1;
+}
+
+void SymTable_clear(SymTable_T oSymTable) {
+    assert(oSymTable != NULL);
+    SymTable_logChange(oSymTable, SYMTABLELOG_CLEAR, NULL, 0, NULL);
+    if(oSymTable->oImage != NULL) {
+        SymTableImage_close(oSymTable->oImage);
+        oSymTable->oImage = NULL;
+    }
+    /* Every Binding, visible or not, is left with its key block for the puts that follow. */
+    oSymTable->uBindingCount = 0;
+    oSymTable->uFreeCount = 0;
+    oSymTable->uUndoCount = 0;
+    oSymTable->uScopeDepth = 0;
+    oSymTable->size = 0;
+    oSymTable->uOldest = 0;
+    oSymTable->uNewest = 0;
+    if(oSymTable->puFilter != NULL) {
+        memset(oSymTable->puFilter, 0,
+            oSymTable->uFilterBlocks * FILTER_WORDS * sizeof(uint32_t));
+        oSymTable->uFilterAdded = 0;
+    }
+    SymTable_invalidateCache(oSymTable);
+    SymTable_emptyBuckets(oSymTable);
+}
+
+/*
+    SymTable_countChain is a helper function for SymTable_getStats that adds a chain of
+    uChainLength key-value pairs to the histogram of psStats. Returns nothing.
+*/
+static void SymTable_countChain(SymTable_Stats *psStats, size_t uChainLength) {
+    if(uChainLength >= SYMTABLE_HISTOGRAM_SIZE)
+        uChainLength = SYMTABLE_HISTOGRAM_SIZE - 1;
+    psStats->auChainLengths[uChainLength]++;
+}
+
+int SymTable_getStats(SymTable_T oSymTable, SymTable_Stats *psStats) {
+    size_t uBinding;
+    size_t uChainLength;
+    size_t index;
+    assert(oSymTable != NULL);
+    assert(psStats != NULL);
+#ifdef SYMTABLE_STATS
+    *psStats = oSymTable->sStats;
+#else
+    memset(psStats, 0, sizeof(SymTable_Stats));
+#endif
+    if(psStats->uLookups > 0)
+        psStats->dComparisonsPerLookup =
+            (double)psStats->uComparisons / (double)psStats->uLookups;
+    psStats->uLength = SymTable_getLength(oSymTable);
+    /* A table served from a mapped snapshot has no chains of its own yet. */
+    for(index = 0; index<*(oSymTable->uBucketCount); index++) {
+        uChainLength = 0;
+        for (uBinding = *SymTable_bucket(oSymTable, index);
+            uBinding != 0;
+            uBinding = SymTable_binding(oSymTable, uBinding)->uNext)
+            uChainLength++;
+        SymTable_countChain(psStats, uChainLength);
+    }
+    psStats->uBucketCount = *(oSymTable->uBucketCount);
+#ifdef SYMTABLE_STATS
+    return 1;
+#else
+    return 0;
+#endif
+}
+
+size_t SymTable_memoryUsage(SymTable_T oSymTable) {
+    assert(oSymTable != NULL);
+    return oSymTable->uMemoryUsage;
+}
@@ -0,0 +1,425 @@
+/*
+    Name: Tharun Kumar Tiruppali Kalidoss
+    File Name: symtableimage.c
+*/
+#define _POSIX_C_SOURCE 200809L
+#include "symtableimage.h"
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <assert.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/*
+    A snapshot file is laid out as an ImageHeader, followed by uBucketCount+1 uint64_t bucket
+    offsets, followed by uCount ImageEntry records, followed by the packed keys. Every position is
+    stored as an offset from the start of the file, so the file can be mapped at any address. The
+    entries of bucket i are entries[buckets[i]] up to (but excluding) entries[buckets[i+1]].
+*/
+
+/* IMAGE_MAGIC identifies a snapshot file, including the version of its layout. */
+static const char IMAGE_MAGIC[8] = {'S', 'Y', 'M', 'T', 'B', 'L', '0', '1'};
+
+/* TEMPORARY_SUFFIX is added to the name of a snapshot to name the file it is written to before
+   it is renamed. */
+static const char TEMPORARY_SUFFIX[] = ".tmp";
+
+/*
+    ImageHeader is the fixed-size record at the start of every snapshot file.
+*/
+struct ImageHeader
+{
+    /* acMagic must equal IMAGE_MAGIC. */
+   char acMagic[8];
+    /* uSlotSize is the size of a value slot (sizeof(void*)) of the process that wrote the file. */
+   uint64_t uSlotSize;
+    /* uCount is the number of key-value pairs in the file. */
+   uint64_t uCount;
+    /* uBucketCount is the number of buckets that the entries are grouped into. */
+   uint64_t uBucketCount;
+    /* uBucketsOffset, uEntriesOffset and uKeysOffset are the offsets of the three sections. */
+   uint64_t uBucketsOffset;
+   uint64_t uEntriesOffset;
+   uint64_t uKeysOffset;
+    /* uFileSize is the total size of the file, used to reject truncated files. */
+   uint64_t uFileSize;
+};
+
+/*
+    ImageEntry is the on-disk representation of one key-value pair.
+*/
+struct ImageEntry
+{
+    /* uHash is the full hash of the key, compared before the key itself. */
+   uint64_t uHash;
+    /* uKeyOffset is the offset of the key's first character from the start of the key section. */
+   uint64_t uKeyOffset;
+    /* pvValue is the value slot. */
+   void *pvValue;
+};
+
+/*
+    SymTableImage is the in-memory description of a mapped snapshot file.
+*/
+struct SymTableImage
+{
+    /* pvBase points to the start of the mapping and uSize is its length in bytes. */
+   void *pvBase;
+   size_t uSize;
+    /* psHeader, puBuckets, psEntries and pcKeys point to the sections inside the mapping. */
+   const struct ImageHeader *psHeader;
+   const uint64_t *puBuckets;
+   struct ImageEntry *psEntries;
+   const char *pcKeys;
+};
+
+/*
+    ImageBuilder collects the key-value pairs of a SymTable through SymTable_map while
+    SymTable_save is building a snapshot.
+*/
+struct ImageBuilder
+{
+    /* ppcKeys, ppvValues and puHashes are parallel arrays of length uCount. */
+   const char **ppcKeys;
+   void **ppvValues;
+   uint64_t *puHashes;
+    /* uCount is the number of key-value pairs collected so far. */
+   size_t uCount;
+    /* uKeyBytes is the total size of the collected keys, including their '\0' characters. */
+   size_t uKeyBytes;
+};
+
+/* Return the 64-bit hash of the uLength characters at pcKey that is stored in snapshot files.
+   It uses the same multiplier as the SymTable hash tables, but is independent of any bucket
+   count. */
+static uint64_t SymTableImage_hash(const char *pcKey, size_t uLength)
+{
+   const uint64_t HASH_MULTIPLIER = 65599;
+   size_t u;
+   uint64_t uHash = 0;
+
+   assert(pcKey != NULL);
+
+   for (u = 0; u < uLength; u++)
+      uHash = uHash * HASH_MULTIPLIER + (uint64_t)(unsigned char)pcKey[u];
+
+   return uHash;
+}
+
+/*
+    SymTableImage_bucketCount returns the number of buckets used for a snapshot of uCount
+    key-value pairs: the smallest odd prime that is not less than uCount, so that chains have an
+    expected length of at most one.
+*/
+static size_t SymTableImage_bucketCount(size_t uCount) {
+    size_t uCandidate;
+    size_t uDivisor;
+    uCandidate = uCount < 3 ? 3 : uCount | 1;
+    for (;; uCandidate += 2) {
+        for (uDivisor = 3; uDivisor * uDivisor <= uCandidate; uDivisor += 2) {
+            if (uCandidate % uDivisor == 0)
+                break;
+        }
+        if (uDivisor * uDivisor > uCandidate)
+            return uCandidate;
+    }
+}
+
+/*
+    SymTableImage_collect is the SymTable_map callback used by SymTable_save. It appends the
+    key-value pair (pcKey, pvValue) to the ImageBuilder pointed to by pvExtra.
+*/
+static void SymTableImage_collect(const char *pcKey, void *pvValue, void *pvExtra) {
+    struct ImageBuilder *psBuilder = (struct ImageBuilder *)pvExtra;
+    psBuilder->ppcKeys[psBuilder->uCount] = pcKey;
+    psBuilder->ppvValues[psBuilder->uCount] = pvValue;
+    psBuilder->puHashes[psBuilder->uCount] = SymTableImage_hash(pcKey, strlen(pcKey));
+    psBuilder->uKeyBytes += strlen(pcKey) + 1;
+    psBuilder->uCount++;
+}
+
+/*
+    SymTableImage_writeSections writes the header, bucket offsets, entries and keys of the
+    snapshot described by psBuilder to psFile. puBuckets holds the uBucketCount+1 bucket offsets
+    and puOrder lists the indexes of psBuilder's key-value pairs grouped by bucket. Returns 1 on
+    success and 0 if a write fails.
+*/
+static int SymTableImage_writeSections(const struct ImageBuilder *psBuilder,
+    const uint64_t *puBuckets, const size_t *puOrder, size_t uBucketCount,
+    FILE *psFile) {
+    struct ImageHeader sHeader;
+    struct ImageEntry sEntry;
+    const char *pcKey;
+    uint64_t uKeyOffset;
+    size_t u;
+
+    memset(&sHeader, 0, sizeof(sHeader));
+    memcpy(sHeader.acMagic, IMAGE_MAGIC, sizeof(IMAGE_MAGIC));
+    sHeader.uSlotSize = sizeof(void *);
+    sHeader.uCount = psBuilder->uCount;
+    sHeader.uBucketCount = uBucketCount;
+    sHeader.uBucketsOffset = sizeof(struct ImageHeader);
+    sHeader.uEntriesOffset = sHeader.uBucketsOffset
+        + (uBucketCount + 1) * sizeof(uint64_t);
+    sHeader.uKeysOffset = sHeader.uEntriesOffset
+        + psBuilder->uCount * sizeof(struct ImageEntry);
+    sHeader.uFileSize = sHeader.uKeysOffset + psBuilder->uKeyBytes;
+
+    if (fwrite(&sHeader, sizeof(sHeader), 1, psFile) != 1)
+        return 0;
+    if (fwrite(puBuckets, sizeof(uint64_t), uBucketCount + 1, psFile)
+            != uBucketCount + 1)
+        return 0;
+    uKeyOffset = 0;
+    for (u = 0; u < psBuilder->uCount; u++) {
+        memset(&sEntry, 0, sizeof(sEntry));
+        sEntry.uHash = psBuilder->puHashes[puOrder[u]];
+        sEntry.uKeyOffset = uKeyOffset;
+        sEntry.pvValue = psBuilder->ppvValues[puOrder[u]];
+        if (fwrite(&sEntry, sizeof(sEntry), 1, psFile) != 1)
+            return 0;
+        uKeyOffset += strlen(psBuilder->ppcKeys[puOrder[u]]) + 1;
+    }
+    for (u = 0; u < psBuilder->uCount; u++) {
+        pcKey = psBuilder->ppcKeys[puOrder[u]];
+        if (fwrite(pcKey, 1, strlen(pcKey) + 1, psFile) != strlen(pcKey) + 1)
+            return 0;
+    }
+    return 1;
+}
+
+/*
+    SymTableImage_write writes the snapshot described by psBuilder to psFile, grouping the
+    entries by bucket with a counting sort. Returns 1 on success and 0 if there is not enough
+    memory or a write fails.
+*/
+static int SymTableImage_write(const struct ImageBuilder *psBuilder, FILE *psFile) {
+    uint64_t *puBuckets;
+    size_t *puOrder;
+    size_t *puNext;
+    size_t uBucketCount;
+    size_t uBucket;
+    size_t u;
+    int iSuccessful = 0;
+
+    uBucketCount = SymTableImage_bucketCount(psBuilder->uCount);
+    puBuckets = (uint64_t *)calloc(uBucketCount + 1, sizeof(uint64_t));
+    puNext = (size_t *)calloc(uBucketCount, sizeof(size_t));
+    puOrder = (size_t *)malloc((psBuilder->uCount + 1) * sizeof(size_t));
+    if (puBuckets != NULL && puNext != NULL && puOrder != NULL) {
+        /* Count the entries of every bucket, then turn the counts into start offsets. */
+        for (u = 0; u < psBuilder->uCount; u++)
+            puBuckets[psBuilder->puHashes[u] % uBucketCount + 1]++;
+        for (uBucket = 0; uBucket < uBucketCount; uBucket++) {
+            puBuckets[uBucket + 1] += puBuckets[uBucket];
+            puNext[uBucket] = (size_t)puBuckets[uBucket];
+        }
+        for (u = 0; u < psBuilder->uCount; u++) {
+            uBucket = (size_t)(psBuilder->puHashes[u] % uBucketCount);
+            puOrder[puNext[uBucket]++] = u;
+        }
+        iSuccessful = SymTableImage_writeSections(psBuilder, puBuckets,
+            puOrder, uBucketCount, psFile);
+    }
+    free(puBuckets);
+    free(puNext);
+    free(puOrder);
+    return iSuccessful;
+}
+
+int SymTable_save(SymTable_T oSymTable, const char *pcPath) {
+    struct ImageBuilder sBuilder;
+    size_t uLength;
+    FILE *psFile;
+    char *pcTemporaryPath = NULL;
+    int iSuccessful = 0;
+    assert(oSymTable != NULL);
+    assert(pcPath != NULL);
+
+    uLength = SymTable_getLength(oSymTable);
+    sBuilder.ppcKeys = (const char **)malloc((uLength + 1) * sizeof(const char *));
+    sBuilder.ppvValues = (void **)malloc((uLength + 1) * sizeof(void *));
+    sBuilder.puHashes = (uint64_t *)malloc((uLength + 1) * sizeof(uint64_t));
+    sBuilder.uCount = 0;
+    sBuilder.uKeyBytes = 0;
+    if (sBuilder.ppcKeys != NULL && sBuilder.ppvValues != NULL
+            && sBuilder.puHashes != NULL) {
+        SymTable_map(oSymTable, SymTableImage_collect, &sBuilder);
+        assert(sBuilder.uCount == uLength);
+        /* The snapshot is written beside pcPath and renamed over it, so that pcPath is never
+           truncated while oSymTable may still be reading its keys from a mapping of it. */
+        pcTemporaryPath = (char *)malloc(strlen(pcPath) + sizeof(TEMPORARY_SUFFIX));
+        if (pcTemporaryPath != NULL) {
+            strcpy(pcTemporaryPath, pcPath);
+            strcat(pcTemporaryPath, TEMPORARY_SUFFIX);
+            psFile = fopen(pcTemporaryPath, "wb");
+            if (psFile != NULL) {
+                iSuccessful = SymTableImage_write(&sBuilder, psFile);
+                if (fclose(psFile) != 0)
+                    iSuccessful = 0;
+                if (!iSuccessful || rename(pcTemporaryPath, pcPath) != 0) {
+                    remove(pcTemporaryPath);
+                    iSuccessful = 0;
+                }
+            }
+        }
+    }
+    free((void *)sBuilder.ppcKeys);
+    free(sBuilder.ppvValues);
+    free(sBuilder.puHashes);
+    free(pcTemporaryPath);
+    return iSuccessful;
+}
+
+/*
+    SymTableImage_isValid returns 1 if the uSize bytes at pvBase hold a snapshot whose sections
+    all lie inside the mapping, whose bucket offsets never decrease, whose every key starts and
+    ends inside the key section, and which was written with value slots of this process's size,
+    and 0 otherwise.
+*/
+static int SymTableImage_isValid(const void *pvBase, size_t uSize) {
+    const struct ImageHeader *psHeader = (const struct ImageHeader *)pvBase;
+    const uint64_t *puBuckets;
+    const struct ImageEntry *psEntries;
+    size_t uKeysSize;
+    size_t u;
+    if (uSize < sizeof(struct ImageHeader))
+        return 0;
+    if (memcmp(psHeader->acMagic, IMAGE_MAGIC, sizeof(IMAGE_MAGIC)) != 0)
+        return 0;
+    if (psHeader->uSlotSize != sizeof(void *) || psHeader->uFileSize != uSize)
+        return 0;
+    /* The counts are bounded by the size of the mapping before they are multiplied, so that no
+       section size can wrap around to one that seems to fit. */
+    if (psHeader->uBucketCount == 0
+            || psHeader->uBucketCount
+                >= (uSize - sizeof(struct ImageHeader)) / sizeof(uint64_t)
+            || psHeader->uBucketsOffset != sizeof(struct ImageHeader)
+            || psHeader->uEntriesOffset != psHeader->uBucketsOffset
+                + (psHeader->uBucketCount + 1) * sizeof(uint64_t))
+        return 0;
+    if (psHeader->uCount > (uSize - psHeader->uEntriesOffset) / sizeof(struct ImageEntry)
+            || psHeader->uKeysOffset != psHeader->uEntriesOffset
+                + psHeader->uCount * sizeof(struct ImageEntry))
+        return 0;
+    /* Once the last bucket ends at uCount and none ends before it starts, every bucket lies
+       inside the entries, so SymTableImage_findN can use the offsets unchecked. */
+    puBuckets = (const uint64_t *)((const char *)pvBase + psHeader->uBucketsOffset);
+    if (puBuckets[psHeader->uBucketCount] != psHeader->uCount)
+        return 0;
+    for (u = 0; u < (size_t)psHeader->uBucketCount; u++) {
+        if (puBuckets[u] > puBuckets[u + 1])
+            return 0;
+    }
+    /* An empty table has no keys, otherwise the last key must be terminated. */
+    if (psHeader->uCount != 0 && ((const char *)pvBase)[uSize - 1] != '\0')
+        return 0;
+    /* Since the key section ends with a NUL, every key that starts inside it is terminated
+       inside it, so SymTableImage_map and everything built on it can read keys unchecked. */
+    psEntries = (const struct ImageEntry *)((const char *)pvBase + psHeader->uEntriesOffset);
+    uKeysSize = uSize - (size_t)psHeader->uKeysOffset;
+    for (u = 0; u < (size_t)psHeader->uCount; u++) {
+        if (psEntries[u].uKeyOffset >= uKeysSize)
+            return 0;
+    }
+    return 1;
+}
+
+SymTableImage_T SymTableImage_open(const char *pcPath) {
+    SymTableImage_T oImage;
+    struct stat sStat;
+    void *pvBase;
+    int iFd;
+    assert(pcPath != NULL);
+
+    iFd = open(pcPath, O_RDONLY);
+    if (iFd < 0)
+        return NULL;
+    if (fstat(iFd, &sStat) != 0 || sStat.st_size <= 0) {
+        close(iFd);
+        return NULL;
+    }
+    /* A private writable mapping lets SymTable_replace update value slots in place
+       without ever touching the file. */
+    pvBase = mmap(NULL, (size_t)sStat.st_size, PROT_READ | PROT_WRITE,
+        MAP_PRIVATE, iFd, 0);
+    close(iFd);
+    if (pvBase == MAP_FAILED)
+        return NULL;
+    if (!SymTableImage_isValid(pvBase, (size_t)sStat.st_size)) {
+        munmap(pvBase, (size_t)sStat.st_size);
+        return NULL;
+    }
+    oImage = (SymTableImage_T)malloc(sizeof(struct SymTableImage));
+    if (oImage == NULL) {
+        munmap(pvBase, (size_t)sStat.st_size);
+        return NULL;
+    }
+    oImage->pvBase = pvBase;
+    oImage->uSize = (size_t)sStat.st_size;
+    oImage->psHeader = (const struct ImageHeader *)pvBase;
+    oImage->puBuckets = (const uint64_t *)
+        ((char *)pvBase + oImage->psHeader->uBucketsOffset);
+    oImage->psEntries = (struct ImageEntry *)
+        ((char *)pvBase + oImage->psHeader->uEntriesOffset);
+    oImage->pcKeys = (const char *)pvBase + oImage->psHeader->uKeysOffset;
+    return oImage;
+}
+
+void SymTableImage_close(SymTableImage_T oImage) {
+    assert(oImage != NULL);
+    munmap(oImage->pvBase, oImage->uSize);
+    free(oImage);
+}
+
+size_t SymTableImage_getLength(SymTableImage_T oImage) {
+    assert(oImage != NULL);
+    return (size_t)oImage->psHeader->uCount;
+}
+
+void **SymTableImage_findN(SymTableImage_T oImage, const char *pcKey, size_t uLength) {
+    struct ImageEntry *psEntry;
+    struct ImageEntry *psEnd;
+    uint64_t uHash;
+    size_t uBucket;
+    size_t uKeysSize;
+    assert(oImage != NULL);
+    assert(pcKey != NULL);
+    uHash = SymTableImage_hash(pcKey, uLength);
+    uBucket = (size_t)(uHash % oImage->psHeader->uBucketCount);
+    uKeysSize = oImage->uSize - (size_t)oImage->psHeader->uKeysOffset;
+    psEnd = oImage->psEntries + oImage->puBuckets[uBucket + 1];
+    for (psEntry = oImage->psEntries + oImage->puBuckets[uBucket];
+        psEntry < psEnd;
+        psEntry++)
+    {
+        /* The length is known, so the keys are compared with memcmp, and a key that would run
+           past the end of the mapping is never read. */
+        if (psEntry->uHash == uHash && uKeysSize - psEntry->uKeyOffset > uLength
+                && memcmp(oImage->pcKeys + psEntry->uKeyOffset, pcKey, uLength) == 0
+                && oImage->pcKeys[psEntry->uKeyOffset + uLength] == '\0')
+            return &psEntry->pvValue;
+    }
+    return NULL;
+}
+
+void **SymTableImage_find(SymTableImage_T oImage, const char *pcKey) {
+    assert(pcKey != NULL);
+    return SymTableImage_findN(oImage, pcKey, strlen(pcKey));
+}
+
+void SymTableImage_map(SymTableImage_T oImage,
+    void (*pfApply)(const char *pcKey, void *pvValue, void *pvExtra),
+    const void *pvExtra) {
+    size_t u;
+    assert(oImage != NULL);
+    assert(pfApply != NULL);
+    for (u = 0; u < (size_t)oImage->psHeader->uCount; u++) {
+        (*pfApply)(oImage->pcKeys + oImage->psEntries[u].uKeyOffset,
+            oImage->psEntries[u].pvValue, (void *)pvExtra);
+    }
+}
@@ -0,0 +1,61 @@
+/*
+    Name: Tharun Kumar Tiruppali Kalidoss
+    File Name: symtableimage.h
+*/
+#include <stddef.h>
+#include "symtable.h"
+#ifndef SYMTABLEIMAGE_INCLUDED
+#define SYMTABLEIMAGE_INCLUDED
+
+/*
+   SymTableImage_T is of type struct SymTableImage*, and represents a read-only view of a snapshot
+   file written by SymTable_save() that has been mapped into memory. It is shared by the SymTable
+   implementations so that each of them can serve a table opened with SymTable_openMapped() from
+   the mapping until the table is first modified.
+*/
+typedef struct SymTableImage *SymTableImage_T;
+
+/*
+   SymTableImage_open maps the snapshot file pcPath into memory and returns a SymTableImage_T
+   describing it, or NULL if the file cannot be opened or mapped, is not a snapshot, or there is
+   not enough memory. Takes in a parameter of type const char* called pcPath representing the
+   name of the snapshot file.
+*/
+SymTableImage_T SymTableImage_open(const char *pcPath);
+
+/*
+   SymTableImage_close unmaps oImage and frees all memory occupied by it. Every key and value
+   slot handed out by oImage becomes invalid. Returns nothing.
+*/
+void SymTableImage_close(SymTableImage_T oImage);
+
+/*
+   SymTableImage_getLength returns the number of key-value pairs in oImage as type size_t.
+*/
+size_t SymTableImage_getLength(SymTableImage_T oImage);
+
+/*
+   SymTableImage_find returns a pointer to the value slot of the key-value pair in oImage whose
+   key is pcKey, or NULL if no such key-value pair exists. The slot lives in a private mapping, so
+   writing to it changes the value seen by this process only. Takes in parameters oImage of type
+   SymTableImage_T and pcKey of type const char*.
+*/
+void **SymTableImage_find(SymTableImage_T oImage, const char *pcKey);
+
+/*
+   SymTableImage_findN is SymTableImage_find for the key made of the uLength characters at pcKey,
+   which need not be NUL-terminated and must not contain '\0'. Takes in parameters oImage of type
+   SymTableImage_T, pcKey of type const char* and uLength of type size_t.
+*/
+void **SymTableImage_findN(SymTableImage_T oImage, const char *pcKey, size_t uLength);
+
+/*
+   SymTableImage_map calls (*pfApply)(pcKey, pvValue, pvExtra) for each key-value pair in oImage,
+   in the order in which they are stored in the snapshot. The keys passed to pfApply point into
+   the mapping. Takes in parameters oImage of type SymTableImage_T, pfApply of type
+   void (*)(const char*, void*, void*), and pvExtra of type const void*.
+*/
+void SymTableImage_map(SymTableImage_T oImage,
+   void (*pfApply)(const char *pcKey, void *pvValue, void *pvExtra),
+   const void *pvExtra);
+#endif
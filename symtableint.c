@@ -0,0 +1,280 @@
+/*
+    Name: Tharun Kumar Tiruppali Kalidoss
+    File Name: symtableint.c
+*/
+#include "symtableint.h"
+#include <stdlib.h>
+#include <stdint.h>
+#include <assert.h>
+
+/*
+    A SymTableInt keeps its key-value pairs in one array of slots whose length is a power of
+    two, with linear probing: a key's home slot is picked by its mixed bits, and the key sits in
+    the first free slot from there on. A slot is free if its value is the address of
+    cEmptySlot, which no client can pass in, so the slots need no separate flags and a NULL
+    value is an ordinary value. Removing moves the slots that follow back into the gap, so the
+    array never fills up with markers of removed keys.
+*/
+
+/*
+    IntEntry is one slot of the array: a key-value pair, or a free slot.
+*/
+struct IntEntry
+{
+    /* key is the key of the key-value pair. It is of type long. */
+   long key;
+    /* value is the value of the key-value pair, or &cEmptySlot for a free slot. It is of type
+        const void*. */
+   const void *value;
+};
+
+/*
+    SymTableInt is a representation of the integer-keyed symbol table.
+*/
+struct SymTableInt
+{
+    /* uLength is the number of key-value pairs. It is of type size_t. */
+   size_t uLength;
+    /* uCapacity is the number of slots, a power of two. It is of type size_t. */
+   size_t uCapacity;
+    /* uGrowAt is the number of key-value pairs at which the array is doubled, three quarters
+        of uCapacity. It is of type size_t. */
+   size_t uGrowAt;
+    /* psEntries holds the uCapacity slots. */
+   struct IntEntry *psEntries;
+};
+
+/* The address of cEmptySlot marks a free slot. */
+static const char cEmptySlot = 0;
+
+/* MIN_CAPACITY is the number of slots of a new table. */
+static const size_t MIN_CAPACITY = 16;
+
+/* Return uValue with its bits thoroughly mixed, using the finalizer of SplitMix64. */
+static uint64_t SymTableInt_mix(uint64_t uValue) {
+    uValue ^= uValue >> 30;
+    uValue *= (uint64_t)0xBF58476D1CE4E5B9ULL;
+    uValue ^= uValue >> 27;
+    uValue *= (uint64_t)0x94D049BB133111EBULL;
+    uValue ^= uValue >> 31;
+    return uValue;
+}
+
+/*
+    SymTableInt_home is a helper function that returns the home slot of lKey in an array of
+    uCapacity slots, as type size_t.
+*/
+static size_t SymTableInt_home(long lKey, size_t uCapacity) {
+    return (size_t)SymTableInt_mix((uint64_t)(unsigned long)lKey) & (uCapacity - 1);
+}
+
+/*
+    SymTableInt_fillEmpty is a helper function that marks the uCapacity slots of psEntries free.
+*/
+static void SymTableInt_fillEmpty(struct IntEntry *psEntries, size_t uCapacity) {
+    size_t i;
+    for (i = 0; i < uCapacity; i++)
+        psEntries[i].value = &cEmptySlot;
+}
+
+/*
+    SymTableInt_find is a helper function that returns the slot of oSymTableInt holding lKey,
+    or the free slot where lKey would be put if oSymTableInt does not contain it.
+*/
+static struct IntEntry *SymTableInt_find(SymTableInt_T oSymTableInt, long lKey) {
+    size_t uMask = oSymTableInt->uCapacity - 1;
+    size_t i = SymTableInt_home(lKey, oSymTableInt->uCapacity);
+    struct IntEntry *psEntry = &oSymTableInt->psEntries[i];
+
+    while (psEntry->value != &cEmptySlot && psEntry->key != lKey) {
+        i = (i + 1) & uMask;
+        psEntry = &oSymTableInt->psEntries[i];
+    }
+    return psEntry;
+}
+
+/*
+    SymTableInt_grow is a helper function that doubles the array of oSymTableInt and puts every
+    key-value pair again. Returns 1 as type int, or 0 if there is not enough memory, in which
+    case oSymTableInt is unchanged.
+*/
+static int SymTableInt_grow(SymTableInt_T oSymTableInt) {
+    struct IntEntry *psOld = oSymTableInt->psEntries;
+    size_t uOldCapacity = oSymTableInt->uCapacity;
+    size_t uCapacity = uOldCapacity * 2;
+    struct IntEntry *psEntries;
+    size_t i;
+
+    if (uCapacity < uOldCapacity || uCapacity > (size_t)-1 / sizeof(struct IntEntry))
+        return 0;
+    psEntries = (struct IntEntry*)malloc(uCapacity * sizeof(struct IntEntry));
+    if (psEntries == NULL)
+        return 0;
+    SymTableInt_fillEmpty(psEntries, uCapacity);
+
+    /* Every key is distinct, so each one goes to the first free slot from its home. */
+    for (i = 0; i < uOldCapacity; i++) {
+        size_t j;
+        if (psOld[i].value == &cEmptySlot)
+            continue;
+        j = SymTableInt_home(psOld[i].key, uCapacity);
+        while (psEntries[j].value != &cEmptySlot)
+            j = (j + 1) & (uCapacity - 1);
+        psEntries[j] = psOld[i];
+    }
+    free(psOld);
+    oSymTableInt->psEntries = psEntries;
+    oSymTableInt->uCapacity = uCapacity;
+    oSymTableInt->uGrowAt = uCapacity - uCapacity / 4;
+    return 1;
+}
+
+SymTableInt_T SymTableInt_newWithCapacity(size_t uCapacity) {
+    SymTableInt_T oSymTableInt;
+    size_t uSlots = MIN_CAPACITY;
+
+    /* Leave a quarter of the slots free once uCapacity key-value pairs are in. */
+    while (uSlots - uSlots / 4 < uCapacity) {
+        if (uSlots > (size_t)-1 / 2 / sizeof(struct IntEntry))
+            return NULL;
+        uSlots *= 2;
+    }
+
+    oSymTableInt = (SymTableInt_T)malloc(sizeof(struct SymTableInt));
+    if (oSymTableInt == NULL)
+        return NULL;
+    oSymTableInt->psEntries = (struct IntEntry*)malloc(uSlots * sizeof(struct IntEntry));
+    if (oSymTableInt->psEntries == NULL) {
+        free(oSymTableInt);
+        return NULL;
+    }
+    SymTableInt_fillEmpty(oSymTableInt->psEntries, uSlots);
+    oSymTableInt->uLength = 0;
+    oSymTableInt->uCapacity = uSlots;
+    oSymTableInt->uGrowAt = uSlots - uSlots / 4;
+    return oSymTableInt;
+}
+
+SymTableInt_T SymTableInt_new(void) {
+    return SymTableInt_newWithCapacity(0);
+}
+
+void SymTableInt_free(SymTableInt_T oSymTableInt) {
+    if (oSymTableInt == NULL)
+        return;
+    free(oSymTableInt->psEntries);
+    free(oSymTableInt);
+}
+
+size_t SymTableInt_getLength(SymTableInt_T oSymTableInt) {
+    assert(oSymTableInt != NULL);
+    return oSymTableInt->uLength;
+}
+
+int SymTableInt_put(SymTableInt_T oSymTableInt, long lKey, const void *pvValue) {
+    struct IntEntry *psEntry;
+    assert(oSymTableInt != NULL);
+
+    psEntry = SymTableInt_find(oSymTableInt, lKey);
+    if (psEntry->value != &cEmptySlot)
+        return 0;
+    if (oSymTableInt->uLength + 1 > oSymTableInt->uGrowAt) {
+        if (!SymTableInt_grow(oSymTableInt))
+            return 0;
+        psEntry = SymTableInt_find(oSymTableInt, lKey);
+    }
+    psEntry->key = lKey;
+    psEntry->value = pvValue;
+    oSymTableInt->uLength++;
+    return 1;
+}
+
+void *SymTableInt_replace(SymTableInt_T oSymTableInt, long lKey, const void *pvValue) {
+    struct IntEntry *psEntry;
+    const void *pvOld;
+    assert(oSymTableInt != NULL);
+
+    psEntry = SymTableInt_find(oSymTableInt, lKey);
+    if (psEntry->value == &cEmptySlot)
+        return NULL;
+    pvOld = psEntry->value;
+    psEntry->value = pvValue;
+    return (void*)pvOld;
+}
+
+int SymTableInt_contains(SymTableInt_T oSymTableInt, long lKey) {
+    assert(oSymTableInt != NULL);
+    return SymTableInt_find(oSymTableInt, lKey)->value != &cEmptySlot;
+}
+
+void *SymTableInt_get(SymTableInt_T oSymTableInt, long lKey) {
+    struct IntEntry *psEntry;
+    assert(oSymTableInt != NULL);
+
+    psEntry = SymTableInt_find(oSymTableInt, lKey);
+    if (psEntry->value == &cEmptySlot)
+        return NULL;
+    return (void*)psEntry->value;
+}
+
+void *SymTableInt_remove(SymTableInt_T oSymTableInt, long lKey) {
+    struct IntEntry *psEntries;
+    struct IntEntry *psEntry;
+    const void *pvOld;
+    size_t uMask;
+    size_t uGap;
+    size_t i;
+    assert(oSymTableInt != NULL);
+
+    psEntry = SymTableInt_find(oSymTableInt, lKey);
+    if (psEntry->value == &cEmptySlot)
+        return NULL;
+    pvOld = psEntry->value;
+    psEntries = oSymTableInt->psEntries;
+    uMask = oSymTableInt->uCapacity - 1;
+
+    /* Walk the run of occupied slots after the gap, and move back into the gap every key
+      whose home is not between the gap and the key's slot, cyclically. Such a key would
+      otherwise be cut off from its home by the free slot. */
+    uGap = (size_t)(psEntry - psEntries);
+    i = uGap;
+    for (;;) {
+        size_t uHome;
+        i = (i + 1) & uMask;
+        if (psEntries[i].value == &cEmptySlot)
+            break;
+        uHome = SymTableInt_home(psEntries[i].key, oSymTableInt->uCapacity);
+        if (((i - uHome) & uMask) >= ((i - uGap) & uMask)) {
+            psEntries[uGap] = psEntries[i];
+            uGap = i;
+        }
+    }
+    psEntries[uGap].value = &cEmptySlot;
+    oSymTableInt->uLength--;
+    return (void*)pvOld;
+}
+
+void SymTableInt_map(SymTableInt_T oSymTableInt,
+    void (*pfApply)(long lKey, void *pvValue, void *pvExtra),
+    const void *pvExtra) {
+    size_t i;
+    assert(oSymTableInt != NULL);
+    assert(pfApply != NULL);
+
+    for (i = 0; i < oSymTableInt->uCapacity; i++) {
+        struct IntEntry *psEntry = &oSymTableInt->psEntries[i];
+        if (psEntry->value != &cEmptySlot)
+            (*pfApply)(psEntry->key, (void*)psEntry->value, (void*)pvExtra);
+    }
+}
+
+void SymTableInt_clear(SymTableInt_T oSymTableInt) {
+    assert(oSymTableInt != NULL);
+    SymTableInt_fillEmpty(oSymTableInt->psEntries, oSymTableInt->uCapacity);
+    oSymTableInt->uLength = 0;
+}
+
+size_t SymTableInt_memoryUsage(SymTableInt_T oSymTableInt) {
+    assert(oSymTableInt != NULL);
+    return sizeof(struct SymTableInt) + oSymTableInt->uCapacity * sizeof(struct IntEntry);
+}
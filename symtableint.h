@@ -0,0 +1,112 @@
+/*
+    Name: Tharun Kumar Tiruppali Kalidoss
+    File Name: symtableint.h
+*/
+#include <stddef.h>
+#ifndef SYMTABLEINT_INCLUDED
+#define SYMTABLEINT_INCLUDED
+
+/*
+   SymTableInt_T is of type struct SymTableInt*, and represents a symbol table whose keys are
+   integers of type long instead of strings: an unordered collection of key-value pairs, where
+   each key uniquely identifies its pair and the value is of type void*. It is meant for tables
+   keyed by integer IDs, which would otherwise be formatted into strings for a SymTable_T. The
+   keys are stored inline in an open-addressed array, so a key is never formatted, copied into a
+   block of its own, hashed byte by byte or compared with strcmp, and putting a key allocates
+   nothing except when the array grows.
+*/
+typedef struct SymTableInt *SymTableInt_T;
+
+/*
+   SymTableInt_new returns a new SymTableInt_T value that contains no key-value pairs, or NULL
+   if insufficient memory is available. It takes in no parameters.
+*/
+SymTableInt_T SymTableInt_new(void);
+
+/*
+   SymTableInt_newWithCapacity returns a new SymTableInt_T value that contains no key-value pairs
+   and has room for uCapacity key-value pairs before it needs to grow, or NULL if insufficient
+   memory is available. Takes in a parameter of type size_t called uCapacity representing the
+   number of key-value pairs to make room for.
+*/
+SymTableInt_T SymTableInt_newWithCapacity(size_t uCapacity);
+
+/*
+   SymTableInt_free frees all memory occupied by oSymTableInt. There is one parameter called
+   oSymTableInt of type SymTableInt_T. Returns nothing.
+*/
+void SymTableInt_free(SymTableInt_T oSymTableInt);
+
+/*
+   SymTableInt_getLength returns the number of key-value pairs in oSymTableInt as type size_t.
+   There is one parameter called oSymTableInt of type SymTableInt_T.
+*/
+size_t SymTableInt_getLength(SymTableInt_T oSymTableInt);
+
+/*
+   SymTableInt_put() adds a new key-value pair with the key lKey and the value pvValue to
+   oSymTableInt. If a key-value pair with key lKey already exists in oSymTableInt, oSymTableInt
+   is unchanged and 0 is returned. If the array of key-value pairs has to grow and there is not
+   enough memory, oSymTableInt is unchanged and 0 is returned. Otherwise returns 1 as type int.
+   Takes in a parameter of type SymTableInt_T called oSymTableInt representing the table the
+   key-value pair is added to, a parameter of type long called lKey representing the key, and a
+   parameter of type const void* called pvValue representing the value.
+*/
+int SymTableInt_put(SymTableInt_T oSymTableInt, long lKey, const void *pvValue);
+
+/*
+   SymTableInt_replace() replaces the value of the key-value pair of oSymTableInt whose key is
+   lKey with pvValue and returns the old value. If there is no such key-value pair, oSymTableInt
+   is unchanged and NULL is returned. Takes in a parameter of type SymTableInt_T called
+   oSymTableInt, a parameter of type long called lKey and a parameter of type const void*
+   called pvValue representing the new value.
+*/
+void *SymTableInt_replace(SymTableInt_T oSymTableInt, long lKey, const void *pvValue);
+
+/*
+   SymTableInt_contains() returns 1 as type int if oSymTableInt contains a key-value pair whose
+   key is lKey, and returns 0 as type int otherwise. Takes in a parameter of type SymTableInt_T
+   called oSymTableInt and a parameter of type long called lKey.
+*/
+int SymTableInt_contains(SymTableInt_T oSymTableInt, long lKey);
+
+/*
+   SymTableInt_get() returns the value as a void* value of the key-value pair of oSymTableInt
+   whose key is lKey, or NULL if no such key-value pair exists. Takes in a parameter of type
+   SymTableInt_T called oSymTableInt and a parameter of type long called lKey.
+*/
+void *SymTableInt_get(SymTableInt_T oSymTableInt, long lKey);
+
+/*
+   If oSymTableInt contains a key-value pair with key lKey, then SymTableInt_remove() removes
+   that key-value pair from oSymTableInt and returns its value. Otherwise oSymTableInt is
+   unchanged and NULL is returned. The array never shrinks, and removing leaves no marker behind,
+   so a table that is emptied and refilled is as fast as a new one. Takes in a parameter of type
+   SymTableInt_T called oSymTableInt and a parameter of type long called lKey.
+*/
+void *SymTableInt_remove(SymTableInt_T oSymTableInt, long lKey);
+
+/*
+   SymTableInt_map() calls (*pfApply)(lKey, pvValue, pvExtra) for each key-value pair in
+   oSymTableInt, in no particular order. pfApply must not change oSymTableInt. Takes in a
+   parameter of type SymTableInt_T called oSymTableInt, a parameter of type
+   void (*)(long, void*, void*) called pfApply, and a parameter of type const void* called
+   pvExtra representing the extra argument passed to pfApply.
+*/
+void SymTableInt_map(SymTableInt_T oSymTableInt,
+   void (*pfApply)(long lKey, void *pvValue, void *pvExtra),
+   const void *pvExtra);
+
+/*
+   SymTableInt_clear() removes every key-value pair from oSymTableInt, keeping its array for the
+   key-value pairs that are put next. Takes in a parameter of type SymTableInt_T called
+   oSymTableInt representing the table that is cleared.
+*/
+void SymTableInt_clear(SymTableInt_T oSymTableInt);
+
+/*
+   SymTableInt_memoryUsage() returns the number of bytes of memory owned by oSymTableInt, as
+   type size_t: the table itself and its array of key-value pairs.
+*/
+size_t SymTableInt_memoryUsage(SymTableInt_T oSymTableInt);
+#endif
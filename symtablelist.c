@@ -3,10 +3,21 @@
     File Name: symtablelist.c
 */
 #include "symtable.h"
+#include "symtableimage.h"
+#include "symtablelog.h"
 #include <string.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <assert.h>
+#include <limits.h>
+
+#ifdef SYMTABLE_STATS
+/* STAT_ADD adds uAmount to the counter field of the statistics of oSymTable. Without
+   SYMTABLE_STATS it does nothing, so the counters cost nothing. */
+#define STAT_ADD(oSymTable, field, uAmount) ((oSymTable)->sStats.field += (uAmount))
+#else
+#define STAT_ADD(oSymTable, field, uAmount) ((void)(oSymTable))
+#endif
 
 
 /*
@@ -23,6 +34,34 @@ struct Binding
    /* pNextBinding points to the next key-value pair in the linkedlist. It is of type struct 
         Binding*.*/
    struct Binding *pNextBinding;
+    /* pShadowed points to the Binding of the same key in an outer scope that this Binding hides
+        until its scope is popped, or is NULL. It is of type struct Binding*. */
+   struct Binding *pShadowed;
+    /* uScope is the scope depth at which the Binding was put. It is of type unsigned int rather
+        than size_t so that iBorrowed fits beside it, and SymTable_pushScope stops at UINT_MAX. */
+   unsigned int uScope;
+    /* iBorrowed is 1 if key is not a block of its own: either the caller's string, put with
+        SymTable_putBorrowed, which the SymTable neither copies nor frees, or a copy in the block
+        of SymTable_fromArrays, which is freed with the block. It is 0 if key is the SymTable's
+        own copy. */
+   int iBorrowed;
+};
+
+/* UndoKind identifies the change that an Undo entry reverts. */
+enum UndoKind {UNDO_PUT, UNDO_REMOVE, UNDO_REPLACE};
+
+/*
+    Undo is an entry of the undo log, which records every change made while a scope is open so
+    that SymTable_popScope can revert the changes of the innermost scope in reverse order.
+*/
+struct Undo
+{
+    /* eKind tells whether pBinding was put, removed or had its value replaced. */
+   enum UndoKind eKind;
+    /* pBinding is the Binding that was changed. A removed Binding is owned by the log. */
+   struct Binding *pBinding;
+    /* pvOldValue is the value that an UNDO_REPLACE entry restores. */
+   const void *pvOldValue;
 };
 
 /*
@@ -33,151 +72,999 @@ struct SymTable
 {
     /* head points to the first Binding in the linked list. It is of type struct Binding**. */
    struct Binding *head;
+    /* pFreeBindings is a list, linked through pNextBinding, of the Bindings left by
+        SymTable_clear for SymTable_put to reuse, each with the Bindings it shadowed. */
+   struct Binding *pFreeBindings;
+    /* psBulkBindings points to the block of uBulkCount Bindings that SymTable_fromArrays or
+        SymTable_clone allocated, or is NULL. The Bindings in it are never freed one at a time:
+        SymTable_free frees the whole block. SymTable_fromArrays puts their keys at the end of the
+        block, and SymTable_clone in the block pcBulkKeys of uBulkKeyCapacity bytes, which is
+        NULL otherwise. */
+   struct Binding *psBulkBindings;
+   size_t uBulkCount;
+   char *pcBulkKeys;
+   size_t uBulkKeyCapacity;
     /* size represents the number of key-value pairs within the SymTable. It is of type size_t. */
    size_t size;
+    /* oImage is the mapped snapshot that the SymTable is served from if it was opened with
+        SymTable_openMapped and has not been modified since, and NULL otherwise. While oImage
+        is not NULL the linked list itself is empty. It is of type SymTableImage_T. */
+   SymTableImage_T oImage;
+    /* oLog is the write-ahead log that every change is recorded in if the SymTable was opened
+        with SymTable_openLogged, and NULL otherwise. It is of type SymTableLog_T. */
+   SymTableLog_T oLog;
+    /* psUndoLog points to the uUndoCount entries of the undo log, which has room for
+        uUndoCapacity entries. The log is empty while no scope is open. */
+   struct Undo *psUndoLog;
+   size_t uUndoCount;
+   size_t uUndoCapacity;
+    /* puScopeMarks holds, for each of the uScopeDepth open scopes, the length that the undo log
+        had when the scope was pushed. It has room for uScopeCapacity marks. */
+   size_t *puScopeMarks;
+   size_t uScopeDepth;
+   size_t uScopeCapacity;
+    /* sAllocator is the allocator that every block of the SymTable, including the SymTable
+        itself, comes from and goes back to. It is of type SymTable_Allocator. */
+   SymTable_Allocator sAllocator;
+    /* uMemoryUsage is the number of bytes allocated for the SymTable, as estimated by
+        SymTable_blockSize. Every function that allocates or frees keeps it up to date. It is of
+        type size_t. */
+   size_t uMemoryUsage;
+#ifdef SYMTABLE_STATS
+    /* sStats holds the counters reported by SymTable_getStats. */
+   SymTable_Stats sStats;
+#endif
 };
 
+/* Allocate uSize bytes with the default allocator, which is malloc. pvContext is unused. */
+static void *SymTable_defaultAlloc(size_t uSize, void *pvContext)
+{
+   (void)pvContext;
+   return malloc(uSize);
+}
+
+/* Free pvBlock with the default allocator, which is free. pvContext is unused. */
+static void SymTable_defaultFree(void *pvBlock, void *pvContext)
+{
+   (void)pvContext;
+   free(pvBlock);
+}
+
+/* DEFAULT_ALLOCATOR is the allocator of the SymTables made by SymTable_new. */
+static const SymTable_Allocator DEFAULT_ALLOCATOR =
+   {SymTable_defaultAlloc, SymTable_defaultFree, NULL};
+
+/*
+    SymTable_allocate is a helper function that returns a block of uSize bytes from the allocator
+    of oSymTable, or NULL if there is not enough memory.
+*/
+static void *SymTable_allocate(SymTable_T oSymTable, size_t uSize) {
+    return (*oSymTable->sAllocator.pfAlloc)(uSize, oSymTable->sAllocator.pvContext);
+}
+
+/*
+    SymTable_deallocate is a helper function that gives pvBlock, which may be NULL, back to the
+    allocator of oSymTable. Returns nothing.
+*/
+static void SymTable_deallocate(SymTable_T oSymTable, void *pvBlock) {
+    if(pvBlock != NULL)
+        (*oSymTable->sAllocator.pfFree)(pvBlock, oSymTable->sAllocator.pvContext);
+}
+
+/*
+    SymTable_reallocate is a helper function that moves the block pvBlock of uOldSize bytes, which
+    may be NULL, to a block of uNewSize bytes from the allocator of oSymTable, and returns the new
+    block, or NULL if there is not enough memory, in which case pvBlock is unchanged. The default
+    allocator uses realloc, which may grow the block in place. Other allocators have no realloc,
+    so the block is copied.
+*/
+static void *SymTable_reallocate(SymTable_T oSymTable, void *pvBlock, size_t uOldSize,
+    size_t uNewSize) {
+    void *pvNewBlock;
+    if(oSymTable->sAllocator.pfAlloc == SymTable_defaultAlloc)
+        return realloc(pvBlock, uNewSize);
+    pvNewBlock = SymTable_allocate(oSymTable, uNewSize);
+    if(pvNewBlock == NULL)
+        return NULL;
+    if(pvBlock != NULL) {
+        memcpy(pvNewBlock, pvBlock, uOldSize < uNewSize ? uOldSize : uNewSize);
+        SymTable_deallocate(oSymTable, pvBlock);
+    }
+    return pvNewBlock;
+}
+
+/* Return an estimate of the number of bytes that the allocator uses for a block of uBytes bytes:
+   the block rounded up, with the allocator's header, to a multiple of two words, and never less
+   than four words (as in the GNU C library's malloc). A block of 0 bytes is not allocated. */
+static size_t SymTable_blockSize(size_t uBytes)
+{
+   const size_t WORD = sizeof(size_t);
+
+   if (uBytes == 0)
+      return 0;
+   uBytes = (uBytes + WORD + 2 * WORD - 1) & ~(2 * WORD - 1);
+   return uBytes < 4 * WORD ? 4 * WORD : uBytes;
+}
+
+/* Return the number of bytes, as estimated by SymTable_blockSize, of pBinding, including its
+   copy of its key unless the key is borrowed. */
+static size_t SymTable_bindingSize(const struct Binding *pBinding)
+{
+   if (pBinding->iBorrowed)
+      return SymTable_blockSize(sizeof(struct Binding));
+   return SymTable_blockSize(sizeof(struct Binding))
+      + SymTable_blockSize(strlen(pBinding->key) + 1);
+}
+
 SymTable_T SymTable_new(void) {
+    return SymTable_newWithAllocator(&DEFAULT_ALLOCATOR);
+}
+
+SymTable_T SymTable_newWithAllocator(const SymTable_Allocator *psAllocator) {
     SymTable_T oSymTable;
-    oSymTable = (SymTable_T)malloc(sizeof(struct SymTable));
+    assert(psAllocator != NULL);
+    assert(psAllocator->pfAlloc != NULL);
+    assert(psAllocator->pfFree != NULL);
+    oSymTable = (SymTable_T)(*psAllocator->pfAlloc)(sizeof(struct SymTable),
+        psAllocator->pvContext);
     if (oSymTable == NULL)
         return NULL;
+    oSymTable->sAllocator = *psAllocator;
     oSymTable->head = NULL;
+    oSymTable->pFreeBindings = NULL;
+    oSymTable->psBulkBindings = NULL;
+    oSymTable->uBulkCount = 0;
+    oSymTable->pcBulkKeys = NULL;
+    oSymTable->uBulkKeyCapacity = 0;
     oSymTable->size=0;
+    oSymTable->oImage = NULL;
+    oSymTable->oLog = NULL;
+    oSymTable->uMemoryUsage = SymTable_blockSize(sizeof(struct SymTable));
+    oSymTable->psUndoLog = NULL;
+    oSymTable->uUndoCount = 0;
+    oSymTable->uUndoCapacity = 0;
+    oSymTable->puScopeMarks = NULL;
+    oSymTable->uScopeDepth = 0;
+    oSymTable->uScopeCapacity = 0;
+#ifdef SYMTABLE_STATS
+    memset(&oSymTable->sStats, 0, sizeof(SymTable_Stats));
+#endif
     return oSymTable;
 }
 
+/* A list has no buckets to size and allocates each Binding when it is put, so there is nothing to reserve. */
+SymTable_T SymTable_newWithCapacity(size_t uCapacity) {
+    (void)uCapacity;
+    return SymTable_new();
+}
 
-void SymTable_free(SymTable_T oSymTable) {
+/* A list keeps its Bindings in the order they were put, not in order of use, so it has no bound. */
+SymTable_T SymTable_newBounded(size_t uMaxEntries,
+    void (*pfEvict)(const char *pcKey, void *pvValue, void *pvExtra), const void *pvExtra) {
+    assert(uMaxEntries > 0);
+    (void)uMaxEntries;
+    (void)pfEvict;
+    (void)pvExtra;
+    return NULL;
+}
+
+int SymTable_reserve(SymTable_T oSymTable, size_t uCapacity) {
+    assert(oSymTable != NULL);
+    (void)uCapacity;
+    return 1;
+}
+
+
+/*
+    SymTable_isBulk is a helper function that returns 1 if pBinding lies in the block of
+    Bindings that SymTable_fromArrays allocated for oSymTable, and 0 otherwise.
+*/
+static int SymTable_isBulk(SymTable_T oSymTable, const struct Binding *pBinding) {
+    return oSymTable->psBulkBindings != NULL && pBinding >= oSymTable->psBulkBindings
+        && pBinding < oSymTable->psBulkBindings + oSymTable->uBulkCount;
+}
+
+/*
+    SymTable_allocateBulk is a helper function that allocates for oSymTable, which must have
+    none yet, a single block of uCount Bindings followed by uKeyBytes bytes for their keys, and
+    returns its first Binding, or NULL if there is not enough memory. The Bindings in the block
+    are freed with oSymTable. It is used by SymTable_fromArrays and SymTable_clone.
+*/
+static struct Binding *SymTable_allocateBulk(SymTable_T oSymTable, size_t uCount,
+    size_t uKeyBytes) {
+    struct Binding *pBinding;
+    assert(oSymTable->psBulkBindings == NULL);
+    if(uCount > ((size_t)-1 - uKeyBytes) / sizeof(struct Binding))
+        return NULL;
+    pBinding = (struct Binding *)SymTable_allocate(oSymTable,
+        uCount * sizeof(struct Binding) + uKeyBytes);
+    if(pBinding == NULL)
+        return NULL;
+    oSymTable->psBulkBindings = pBinding;
+    oSymTable->uBulkCount = uCount;
+    oSymTable->uMemoryUsage += SymTable_blockSize(uCount * sizeof(struct Binding) + uKeyBytes);
+    return pBinding;
+}
+
+/*
+    SymTable_freeBinding is a helper function that frees the parameter pBinding of oSymTable
+    together with its key. A Binding of the block of SymTable_fromArrays is left for
+    SymTable_free to free with the block, and only a key of its own, given to it by a put after
+    SymTable_clear, is freed. Returns nothing.
+*/
+static void SymTable_freeBinding(SymTable_T oSymTable, struct Binding *pBinding) {
+    if(SymTable_isBulk(oSymTable, pBinding)) {
+        if(!pBinding->iBorrowed) {
+            oSymTable->uMemoryUsage -= SymTable_blockSize(strlen(pBinding->key) + 1);
+            SymTable_deallocate(oSymTable, (char *) (pBinding->key));
+        }
+        return;
+    }
+    oSymTable->uMemoryUsage -= SymTable_bindingSize(pBinding);
+    if(!pBinding->iBorrowed)
+        SymTable_deallocate(oSymTable, (char *) (pBinding->key));
+    SymTable_deallocate(oSymTable, pBinding);
+}
+
+/*
+    SymTable_recycle is a helper function that adds the Bindings of pChain, a list linked
+    through pNextBinding, together with the Bindings they shadow, to the free Bindings of
+    oSymTable. It takes time proportional to the length of pChain, unless the free list is
+    empty. Returns nothing.
+*/
+static void SymTable_recycle(SymTable_T oSymTable, struct Binding *pChain) {
+    struct Binding *pLast;
+    if(pChain == NULL)
+        return;
+    if(oSymTable->pFreeBindings != NULL) {
+        for(pLast = pChain; pLast->pNextBinding != NULL; pLast = pLast->pNextBinding)
+            ;
+        pLast->pNextBinding = oSymTable->pFreeBindings;
+    }
+    oSymTable->pFreeBindings = pChain;
+}
+
+/*
+    SymTable_popFree is a helper function that removes the first free Binding of oSymTable from
+    the free list and returns it, or returns NULL if there is none. The Bindings it shadowed
+    take its place at the front of the list.
+*/
+static struct Binding *SymTable_popFree(SymTable_T oSymTable) {
+    struct Binding *pBinding = oSymTable->pFreeBindings;
+    if(pBinding == NULL)
+        return NULL;
+    oSymTable->pFreeBindings = pBinding->pNextBinding;
+    if(pBinding->pShadowed != NULL) {
+        pBinding->pShadowed->pNextBinding = oSymTable->pFreeBindings;
+        oSymTable->pFreeBindings = pBinding->pShadowed;
+    }
+    return pBinding;
+}
+
+/*
+    SymTable_newBinding is a helper function that returns a Binding of oSymTable for the key made
+    of the uLength characters at pcKey, or NULL if there is not enough memory. If iBorrowed is 1
+    the Binding points to pcKey itself, which must then be NUL-terminated; otherwise it holds a
+    NUL-terminated copy. A free Binding is reused if there is one, with its key block resized,
+    allocated or freed as the key needs. The other fields are not initialized.
+*/
+static struct Binding *SymTable_newBinding(SymTable_T oSymTable, const char *pcKey,
+    size_t uLength, int iBorrowed) {
+    struct Binding *pBinding = oSymTable->pFreeBindings;
+    int iReused = pBinding != NULL;
+    char *pcNewKey;
+    size_t uOldSize = 0;
+    size_t uNewSize = iBorrowed ? 0 : uLength + 1;
+    if(!iReused) {
+        pBinding = (struct Binding*)SymTable_allocate(oSymTable, sizeof(struct Binding));
+        if(pBinding == NULL)
+            return NULL;
+    }
+    else if(!pBinding->iBorrowed)
+        uOldSize = strlen(pBinding->key) + 1;
+    if(iBorrowed)
+        pcNewKey = (char *)pcKey;
+    /* A key that is no longer and needs a block of the same size is copied in place. */
+    else if(uNewSize <= uOldSize && SymTable_blockSize(uNewSize) == SymTable_blockSize(uOldSize))
+        pcNewKey = (char *)pBinding->key;
+    else {
+        pcNewKey = (char *)SymTable_reallocate(oSymTable,
+            uOldSize == 0 ? NULL : (char *)pBinding->key, uOldSize, uNewSize);
+        if(pcNewKey == NULL) {
+            if(!iReused)
+                SymTable_deallocate(oSymTable, pBinding);
+            return NULL;
+        }
+    }
+    /* Nothing can fail from here on. */
+    if(iBorrowed && uOldSize != 0)
+        SymTable_deallocate(oSymTable, (char *)pBinding->key);
+    if(iReused)
+        SymTable_popFree(oSymTable);
+    else
+        oSymTable->uMemoryUsage += SymTable_blockSize(sizeof(struct Binding));
+    oSymTable->uMemoryUsage += SymTable_blockSize(uNewSize);
+    oSymTable->uMemoryUsage -= SymTable_blockSize(uOldSize);
+    if(!iBorrowed) {
+        memcpy(pcNewKey, pcKey, uLength);
+        pcNewKey[uLength] = '\0';
+    }
+    pBinding->key = pcNewKey;
+    pBinding->iBorrowed = iBorrowed;
+    return pBinding;
+}
+
+/*
+    SymTable_freeBindings is a helper function that frees every Binding of the parameter
+    oSymTable, together with its key, and leaves the linked list empty. This includes the
+    Bindings shadowed by a visible one and the removed Bindings held by the undo log, which is
+    emptied along with every open scope. It is used by SymTable_free and by SymTable_promote
+    when a promotion has to be undone. Returns nothing.
+*/
+static void SymTable_freeBindings(SymTable_T oSymTable) {
     struct Binding *pCurrentBinding;
     struct Binding *pNextBinding;
-    assert(oSymTable != NULL);
+    struct Binding *pShadowed;
+    size_t index;
     for (pCurrentBinding = oSymTable->head;
         pCurrentBinding != NULL;
         pCurrentBinding = pNextBinding)
     {
         pNextBinding = pCurrentBinding->pNextBinding;
-        free((char *) (pCurrentBinding->key));
-        free(pCurrentBinding);
+        for( ; pCurrentBinding != NULL; pCurrentBinding = pShadowed) {
+            pShadowed = pCurrentBinding->pShadowed;
+            SymTable_freeBinding(oSymTable, pCurrentBinding);
+        }
+    }
+    for(index = 0; index < oSymTable->uUndoCount; index++) {
+        if(oSymTable->psUndoLog[index].eKind == UNDO_REMOVE)
+            SymTable_freeBinding(oSymTable, oSymTable->psUndoLog[index].pBinding);
     }
-    free(oSymTable);
+    while((pCurrentBinding = SymTable_popFree(oSymTable)) != NULL)
+        SymTable_freeBinding(oSymTable, pCurrentBinding);
+    oSymTable->head = NULL;
+    oSymTable->uUndoCount = 0;
+    oSymTable->uScopeDepth = 0;
+    oSymTable->size = 0;
+}
+
+void SymTable_free(SymTable_T oSymTable) {
+    assert(oSymTable != NULL);
+    if(oSymTable->oLog != NULL)
+        SymTableLog_close(oSymTable->oLog);
+    if(oSymTable->oImage != NULL)
+        SymTableImage_close(oSymTable->oImage);
+    SymTable_freeBindings(oSymTable);
+    SymTable_deallocate(oSymTable, oSymTable->psBulkBindings);
+    SymTable_deallocate(oSymTable, oSymTable->pcBulkKeys);
+    SymTable_deallocate(oSymTable, oSymTable->psUndoLog);
+    SymTable_deallocate(oSymTable, oSymTable->puScopeMarks);
+    SymTable_deallocate(oSymTable, oSymTable);
 }
 
 size_t SymTable_getLength(SymTable_T oSymTable) {
     assert(oSymTable != NULL);
+    if(oSymTable->oImage != NULL)
+        return SymTableImage_getLength(oSymTable->oImage);
     return oSymTable->size;
 }
 
-int SymTable_put(SymTable_T oSymTable, 
-   const char *pcKey, const void *pvValue) {
+/*
+    Promotion is the state that SymTable_promote and SymTable_cloneMapped pass to
+    SymTable_promoteBinding.
+*/
+struct Promotion
+{
+    /* oSymTable is the SymTable that the key-value pairs are copied into. */
+   SymTable_T oSymTable;
+    /* pLastBinding is the last Binding of oSymTable's linked list, so that appending is O(1). */
+   struct Binding *pLastBinding;
+    /* iSuccessful stays 1 until an allocation fails. */
+   int iSuccessful;
+};
+
+/*
+    SymTable_promoteBinding is the map callback used by SymTable_promote and
+    SymTable_cloneMapped. It appends the key-value pair (pcKey, pvValue) to the SymTable of the
+    Promotion pointed to by pvExtra without searching for duplicates, since a snapshot has none,
+    and clears its iSuccessful flag if there is not enough memory.
+*/
+static void SymTable_promoteBinding(const char *pcKey, void *pvValue,
+    void *pvExtra) {
+    struct Promotion *psPromotion = (struct Promotion *)pvExtra;
     struct Binding *pNewBinding;
-    struct Binding *pCurrentBinding;
+    if(!psPromotion->iSuccessful)
+        return;
+    pNewBinding = SymTable_newBinding(psPromotion->oSymTable, pcKey, strlen(pcKey), 0);
+    if(pNewBinding == NULL) {
+        psPromotion->iSuccessful = 0;
+        return;
+    }
+    pNewBinding->value = pvValue;
+    pNewBinding->pNextBinding = NULL;
+    pNewBinding->pShadowed = NULL;
+    pNewBinding->uScope = 0;
+    if(psPromotion->pLastBinding == NULL)
+        psPromotion->oSymTable->head = pNewBinding;
+    else
+        psPromotion->pLastBinding->pNextBinding = pNewBinding;
+    psPromotion->pLastBinding = pNewBinding;
+    psPromotion->oSymTable->size++;
+}
+
+/*
+    SymTable_promote is a helper function that turns a SymTable served from a mapped snapshot
+    into an ordinary linked list by copying every key-value pair out of the mapping, and then
+    unmaps the snapshot. It is called before the first change that cannot be made in the
+    mapping itself. The parameter is a SymTable_T representing the SymTable to promote. Returns
+    1 on success (including when there is nothing to promote), and 0 if there is not enough
+    memory, in which case oSymTable is still served from the mapping.
+*/
+static int SymTable_promote(SymTable_T oSymTable) {
+    struct Promotion sPromotion;
+    if(oSymTable->oImage == NULL)
+        return 1;
+    sPromotion.oSymTable = oSymTable;
+    sPromotion.pLastBinding = NULL;
+    sPromotion.iSuccessful = 1;
+    SymTableImage_map(oSymTable->oImage, SymTable_promoteBinding, &sPromotion);
+    if(!sPromotion.iSuccessful) {
+        SymTable_freeBindings(oSymTable);
+        return 0;
+    }
+    SymTableImage_close(oSymTable->oImage);
+    oSymTable->oImage = NULL;
+    return 1;
+}
+
+SymTable_T SymTable_openMapped(const char *pcPath) {
+    SymTable_T oSymTable;
+    SymTableImage_T oImage;
+    assert(pcPath != NULL);
+    oImage = SymTableImage_open(pcPath);
+    if(oImage == NULL)
+        return NULL;
+    oSymTable = SymTable_new();
+    if(oSymTable == NULL) {
+        SymTableImage_close(oImage);
+        return NULL;
+    }
+    oSymTable->oImage = oImage;
+    return oSymTable;
+}
+
+SymTable_T SymTable_openLogged(const char *pcPath) {
+    SymTable_T oSymTable;
+    SymTableLog_T oLog;
+    assert(pcPath != NULL);
+    oLog = SymTableLog_open(pcPath, &oSymTable);
+    if(oLog == NULL)
+        return NULL;
+    oSymTable->oLog = oLog;
+    return oSymTable;
+}
+
+int SymTable_setLogBatch(SymTable_T oSymTable, size_t uRecords) {
+    assert(oSymTable != NULL);
+    if(oSymTable->oLog == NULL)
+        return 0;
+    SymTableLog_setBatch(oSymTable->oLog, uRecords);
+    return 1;
+}
+
+int SymTable_syncLog(SymTable_T oSymTable) {
+    assert(oSymTable != NULL);
+    if(oSymTable->oLog == NULL)
+        return 0;
+    return SymTableLog_sync(oSymTable->oLog);
+}
+
+int SymTable_checkpoint(SymTable_T oSymTable) {
+    assert(oSymTable != NULL);
+    if(oSymTable->oLog == NULL)
+        return 0;
+    return SymTableLog_checkpoint(oSymTable->oLog, oSymTable);
+}
+
+/*
+    SymTable_logChange is a helper function that records a change of kind eKind to the key made
+    of the uLength characters at pcKey, with the value pvValue, in the log of oSymTable, if it
+    has one. Returns nothing.
+*/
+static void SymTable_logChange(SymTable_T oSymTable, SymTableLog_Kind eKind, const char *pcKey,
+    size_t uLength, const void *pvValue) {
+    if(oSymTable->oLog != NULL)
+        SymTableLog_append(oSymTable->oLog, eKind, pcKey, uLength, pvValue);
+}
+
+/* CLONE_KEY_BYTES is the number of bytes per key that SymTable_clone first makes room for. */
+static const size_t CLONE_KEY_BYTES = 16;
+
+/*
+    SymTable_resizeKeys is a helper function for SymTable_clone that moves the key block of
+    oClone, of which the first uKeyBytes are in use, to a block of uCapacity bytes, and points the
+    key of each Binding of the bulk block before pEnd at its place in the new block. The keys are
+    in the order of the Bindings, so this is one pass over each block. Returns 1 on success, and
+    0 if there is not enough memory, in which case the key block is unchanged.
+*/
+static int SymTable_resizeKeys(SymTable_T oClone, size_t uKeyBytes, size_t uCapacity,
+    struct Binding *pEnd) {
+    struct Binding *pBinding;
+    char *pcKey;
+    pcKey = (char *)SymTable_reallocate(oClone, oClone->pcBulkKeys, uKeyBytes, uCapacity);
+    if(pcKey == NULL)
+        return 0;
+    oClone->uMemoryUsage += SymTable_blockSize(uCapacity);
+    oClone->uMemoryUsage -= SymTable_blockSize(oClone->uBulkKeyCapacity);
+    oClone->pcBulkKeys = pcKey;
+    oClone->uBulkKeyCapacity = uCapacity;
+    for(pBinding = oClone->psBulkBindings; pBinding < pEnd; pBinding++) {
+        pBinding->key = pcKey;
+        pcKey += strlen(pcKey) + 1;
+    }
+    return 1;
+}
+
+/*
+    SymTable_copyKey is a helper function for SymTable_clone that copies pcKey to the end of the
+    *puKeyBytes bytes in use of the key block of oClone, growing the block if the key does not
+    fit, and points the key of pNewBinding, the next Binding of the bulk block, at the copy.
+    Returns 1 on success, and 0 if there is not enough memory.
+*/
+static int SymTable_copyKey(SymTable_T oClone, struct Binding *pNewBinding, const char *pcKey,
+    size_t *puKeyBytes) {
+    size_t uLength = strlen(pcKey) + 1;
+    size_t uCapacity = oClone->uBulkKeyCapacity;
+    if(uLength > uCapacity - *puKeyBytes) {
+        uCapacity = 2 * uCapacity < *puKeyBytes + uLength ? *puKeyBytes + uLength : 2 * uCapacity;
+        if(!SymTable_resizeKeys(oClone, *puKeyBytes, uCapacity, pNewBinding))
+            return 0;
+    }
+    memcpy(oClone->pcBulkKeys + *puKeyBytes, pcKey, uLength);
+    pNewBinding->key = oClone->pcBulkKeys + *puKeyBytes;
+    *puKeyBytes += uLength;
+    return 1;
+}
+
+/*
+    SymTable_cloneMapped is a helper function for SymTable_clone that copies a SymTable served
+    from a mapped snapshot, which has no Bindings to copy, by appending every key-value pair of
+    the mapping to a new SymTable. Returns the new SymTable, or NULL if there is not enough
+    memory.
+*/
+static SymTable_T SymTable_cloneMapped(SymTable_T oSymTable) {
+    struct Promotion sPromotion;
+    sPromotion.oSymTable = SymTable_newWithAllocator(&oSymTable->sAllocator);
+    if(sPromotion.oSymTable == NULL)
+        return NULL;
+    sPromotion.pLastBinding = NULL;
+    sPromotion.iSuccessful = 1;
+    SymTableImage_map(oSymTable->oImage, SymTable_promoteBinding, &sPromotion);
+    if(!sPromotion.iSuccessful) {
+        SymTable_free(sPromotion.oSymTable);
+        return NULL;
+    }
+    return sPromotion.oSymTable;
+}
+
+SymTable_T SymTable_clone(SymTable_T oSymTable) {
+    SymTable_T oClone;
+    struct Binding *pBinding;
+    struct Binding *pNewBinding;
+    struct Binding **ppLink;
+    size_t uKeyBytes = 0;
+    assert(oSymTable != NULL);
+    if(oSymTable->oImage != NULL)
+        return SymTable_cloneMapped(oSymTable);
+    oClone = SymTable_newWithAllocator(&oSymTable->sAllocator);
+    if(oClone == NULL || oSymTable->size == 0)
+        return oClone;
+    pNewBinding = SymTable_allocateBulk(oClone, oSymTable->size, 0);
+    if(pNewBinding == NULL || !SymTable_resizeKeys(oClone, 0,
+            oSymTable->size * CLONE_KEY_BYTES, pNewBinding)) {
+        SymTable_free(oClone);
+        return NULL;
+    }
+    /* The Bindings and keys are laid out in the order of the list, so walking the clone reads
+        both blocks from start to end. The walk is the only pass over oSymTable: the key block
+        grows as the keys are copied. */
+    ppLink = &oClone->head;
+    for(pBinding = oSymTable->head; pBinding != NULL; pBinding = pBinding->pNextBinding) {
+        if(!SymTable_copyKey(oClone, pNewBinding, pBinding->key, &uKeyBytes)) {
+            *ppLink = NULL;
+            SymTable_free(oClone);
+            return NULL;
+        }
+        pNewBinding->value = pBinding->value;
+        pNewBinding->pShadowed = NULL;
+        pNewBinding->uScope = 0;
+        pNewBinding->iBorrowed = 1;
+        *ppLink = pNewBinding;
+        ppLink = &pNewBinding->pNextBinding;
+        pNewBinding++;
+    }
+    *ppLink = NULL;
+    assert(pNewBinding == oClone->psBulkBindings + oSymTable->size);
+    oClone->size = oSymTable->size;
+    /* The room that the keys did not use is given back if the block can be shrunk. */
+    if(uKeyBytes < oClone->uBulkKeyCapacity)
+        (void)SymTable_resizeKeys(oClone, uKeyBytes, uKeyBytes, pNewBinding);
+    return oClone;
+}
+
+/* A list cannot share its Bindings, so a snapshot is a clone. */
+SymTable_T SymTable_snapshot(SymTable_T oSymTable) {
+    return SymTable_clone(oSymTable);
+}
+
+/*
+    SymTable_sameKey is a helper function that returns 1 if the stored key pcStoredKey is the key
+    made of the uLength characters at pcKey, and 0 otherwise. strncmp stops at the end of
+    pcStoredKey, so a stored key shorter than uLength is never read past its end.
+*/
+static int SymTable_sameKey(const char *pcStoredKey, const char *pcKey, size_t uLength) {
+    return strncmp(pcStoredKey, pcKey, uLength) == 0 && pcStoredKey[uLength] == '\0';
+}
+
+/*
+    SymTable_findLink is a helper function that returns the link (the list head or the
+    pNextBinding field) that points to the visible Binding of oSymTable whose key is the uLength
+    characters at pcKey, or
+    the NULL link at the end of the linked list if there is no such Binding.
+*/
+static struct Binding **SymTable_findLink(SymTable_T oSymTable, const char *pcKey,
+    size_t uLength) {
+    struct Binding **ppLink;
+    ppLink = &oSymTable->head;
+    STAT_ADD(oSymTable, uLookups, 1);
+    for( ; *ppLink != NULL; ppLink = &(*ppLink)->pNextBinding) {
+        STAT_ADD(oSymTable, uComparisons, 1);
+        if(SymTable_sameKey((*ppLink)->key, pcKey, uLength)) {
+            STAT_ADD(oSymTable, uHits, 1);
+            return ppLink;
+        }
+    }
+    STAT_ADD(oSymTable, uMisses, 1);
+    return ppLink;
+}
+
+/*
+    SymTable_link is a helper function that makes pBinding the visible Binding at the link
+    ppLink returned by SymTable_findLink. If the link holds pBinding's pShadowed, pBinding takes
+    its place in the list; otherwise ppLink is the end of the list, pBinding is appended,
+    and the size of oSymTable grows by one. Returns nothing.
+*/
+static void SymTable_link(SymTable_T oSymTable, struct Binding **ppLink,
+    struct Binding *pBinding) {
+    assert(*ppLink == pBinding->pShadowed);
+    if(*ppLink == NULL) {
+        pBinding->pNextBinding = NULL;
+        oSymTable->size = oSymTable->size + 1;
+    }
+    else
+        pBinding->pNextBinding = (*ppLink)->pNextBinding;
+    *ppLink = pBinding;
+}
+
+/*
+    SymTable_unlink is a helper function that reverses SymTable_link: the Binding at the link
+    ppLink is replaced by the Binding it shadows, or is spliced out of the list if it shadows
+    none, in which case the size of oSymTable shrinks by one. The Binding is not freed. Returns
+    the unlinked Binding.
+*/
+static struct Binding *SymTable_unlink(SymTable_T oSymTable, struct Binding **ppLink) {
+    struct Binding *pBinding = *ppLink;
+    if(pBinding->pShadowed == NULL) {
+        *ppLink = pBinding->pNextBinding;
+        oSymTable->size = oSymTable->size - 1;
+    }
+    else {
+        pBinding->pShadowed->pNextBinding = pBinding->pNextBinding;
+        *ppLink = pBinding->pShadowed;
+    }
+    return pBinding;
+}
+
+/*
+    SymTable_reserveUndo is a helper function that makes room for one more entry in the undo log
+    of oSymTable, so that a change can be made and logged without failing halfway. Returns 1 on
+    success, and 0 if there is not enough memory.
+*/
+static int SymTable_reserveUndo(SymTable_T oSymTable) {
+    struct Undo *psUndoLog;
+    size_t uUndoCapacity;
+    if(oSymTable->uUndoCount < oSymTable->uUndoCapacity)
+        return 1;
+    uUndoCapacity = oSymTable->uUndoCapacity == 0 ? 16 : 2 * oSymTable->uUndoCapacity;
+    psUndoLog = (struct Undo *)SymTable_reallocate(oSymTable, oSymTable->psUndoLog,
+        oSymTable->uUndoCapacity * sizeof(struct Undo), uUndoCapacity * sizeof(struct Undo));
+    if(psUndoLog == NULL)
+        return 0;
+    oSymTable->uMemoryUsage += SymTable_blockSize(uUndoCapacity * sizeof(struct Undo))
+        - SymTable_blockSize(oSymTable->uUndoCapacity * sizeof(struct Undo));
+    oSymTable->psUndoLog = psUndoLog;
+    oSymTable->uUndoCapacity = uUndoCapacity;
+    return 1;
+}
+
+/*
+    SymTable_logUndo is a helper function that appends an entry of kind eKind for pBinding, with
+    the old value pvOldValue, to the undo log of oSymTable if a scope is open. Room must have been
+    reserved with SymTable_reserveUndo. Returns nothing.
+*/
+static void SymTable_logUndo(SymTable_T oSymTable, enum UndoKind eKind,
+    struct Binding *pBinding, const void *pvOldValue) {
+    struct Undo *psUndo;
+    if(oSymTable->uScopeDepth == 0)
+        return;
+    assert(oSymTable->uUndoCount < oSymTable->uUndoCapacity);
+    psUndo = &oSymTable->psUndoLog[oSymTable->uUndoCount++];
+    psUndo->eKind = eKind;
+    psUndo->pBinding = pBinding;
+    psUndo->pvOldValue = pvOldValue;
+}
+
+/*
+    SymTable_undo is a helper function that reverts the change recorded by the undo log entry
+    psUndo of oSymTable. It relies on the entries being reverted newest first, so that the
+    SymTable is in the state just after the change. Returns nothing.
+*/
+static void SymTable_undo(SymTable_T oSymTable, const struct Undo *psUndo) {
+    struct Binding *pBinding = psUndo->pBinding;
+    struct Binding **ppLink;
+    if(psUndo->eKind == UNDO_REPLACE) {
+        pBinding->value = psUndo->pvOldValue;
+        return;
+    }
+    ppLink = SymTable_findLink(oSymTable, pBinding->key, strlen(pBinding->key));
+    if(psUndo->eKind == UNDO_PUT) {
+        assert(*ppLink == pBinding);
+        SymTable_freeBinding(oSymTable, SymTable_unlink(oSymTable, ppLink));
+    }
+    else
+        SymTable_link(oSymTable, ppLink, pBinding);
+}
+
+/*
+    SymTable_putKey is a helper function that does the work of SymTable_putN and
+    SymTable_putBorrowed: it puts the key made of the uLength characters at pcKey, with the value
+    pvValue, borrowing pcKey if iBorrowed is 1 and copying it otherwise. Returns 1 on success, and
+    0 if the key is already bound in the innermost scope or there is not enough memory.
+*/
+static int SymTable_putKey(SymTable_T oSymTable, const char *pcKey, size_t uLength,
+    const void *pvValue, int iBorrowed) {
+    struct Binding *pNewBinding;
+    struct Binding **ppLink;
     assert(oSymTable != NULL);
     assert(pcKey != NULL);
-    for (pCurrentBinding = oSymTable->head;
-        pCurrentBinding != NULL;
-        pCurrentBinding = pCurrentBinding->pNextBinding)
-    {
-        if(strcmp(pCurrentBinding->key,pcKey)==0) 
+    /* A key that is already in the mapping is rejected without promoting. */
+    if(oSymTable->oImage != NULL) {
+        if(SymTableImage_findN(oSymTable->oImage, pcKey, uLength) != NULL
+                || !SymTable_promote(oSymTable))
             return 0;
-        if(pCurrentBinding->pNextBinding==NULL) break;
     }
+    /* A key that is visible from an outer scope is shadowed; one put in this scope is kept. */
+    ppLink = SymTable_findLink(oSymTable, pcKey, uLength);
+    if(*ppLink != NULL && (*ppLink)->uScope == oSymTable->uScopeDepth)
+        return 0;
+    if(oSymTable->uScopeDepth > 0 && !SymTable_reserveUndo(oSymTable))
+        return 0;
     /* Create a new binding with the given key-value pair. */
-    pNewBinding = (struct Binding*)malloc(sizeof(struct Binding));
+    pNewBinding = SymTable_newBinding(oSymTable, pcKey, uLength, iBorrowed);
     if(pNewBinding==NULL) return 0;
-    pNewBinding->key = (const char*)malloc(strlen(pcKey) + 1);
-    if(pNewBinding->key == NULL) {
-        free(pNewBinding);
-        return 0;
-    }
-    strcpy((char*)pNewBinding->key, pcKey);
     pNewBinding->value = pvValue;
-    pNewBinding->pNextBinding = NULL;
-    if(oSymTable->head == NULL) {
-        oSymTable->head = pNewBinding;
-        oSymTable->size = 1;
-        return 1;
-    }
-    pCurrentBinding->pNextBinding = pNewBinding;
-    oSymTable->size = oSymTable->size + 1;
+    pNewBinding->pShadowed = *ppLink;
+    pNewBinding->uScope = (unsigned int)oSymTable->uScopeDepth;
+    SymTable_link(oSymTable, ppLink, pNewBinding);
+    SymTable_logUndo(oSymTable, UNDO_PUT, pNewBinding, NULL);
+    SymTable_logChange(oSymTable, SYMTABLELOG_PUT, pcKey, uLength, pvValue);
     return 1;
 }
 
-void *SymTable_replace(SymTable_T oSymTable,
-    const char *pcKey, const void *pvValue) {
+int SymTable_putN(SymTable_T oSymTable, const char *pcKey, size_t uLength,
+    const void *pvValue) {
+    return SymTable_putKey(oSymTable, pcKey, uLength, pvValue, 0);
+}
+
+int SymTable_put(SymTable_T oSymTable,
+   const char *pcKey, const void *pvValue) {
+    assert(pcKey != NULL);
+    return SymTable_putKey(oSymTable, pcKey, strlen(pcKey), pvValue, 0);
+}
+
+int SymTable_putBorrowed(SymTable_T oSymTable, const char *pcKey, const void *pvValue) {
+    assert(pcKey != NULL);
+    return SymTable_putKey(oSymTable, pcKey, strlen(pcKey), pvValue, 1);
+}
+
+SymTable_T SymTable_fromArrays(const char *const *apcKeys, const void *const *apvValues,
+    size_t uCount) {
+    SymTable_T oSymTable;
+    struct Binding *pBinding;
+    struct Binding **ppLink;
+    char *pcKey;
+    size_t uKeyBytes = 0;
+    size_t uLength;
+    size_t u;
+    assert(apcKeys != NULL || uCount == 0);
+    assert(apvValues != NULL || uCount == 0);
+    for(u = 0; u < uCount; u++) {
+        assert(apcKeys[u] != NULL);
+        uKeyBytes += strlen(apcKeys[u]) + 1;
+    }
+    oSymTable = SymTable_new();
+    if(oSymTable == NULL || uCount == 0)
+        return oSymTable;
+    pBinding = SymTable_allocateBulk(oSymTable, uCount, uKeyBytes);
+    if(pBinding == NULL) {
+        SymTable_free(oSymTable);
+        return NULL;
+    }
+    /* The keys follow the Bindings. A key that is already in oSymTable is skipped, which leaves
+        the Binding and the key bytes at the end of the block unused. */
+    pcKey = (char *)(pBinding + uCount);
+    for(u = 0; u < uCount; u++) {
+        uLength = strlen(apcKeys[u]);
+        ppLink = SymTable_findLink(oSymTable, apcKeys[u], uLength);
+        if(*ppLink != NULL)
+            continue;
+        memcpy(pcKey, apcKeys[u], uLength + 1);
+        pBinding->key = pcKey;
+        pBinding->value = apvValues[u];
+        pBinding->pShadowed = NULL;
+        pBinding->uScope = 0;
+        pBinding->iBorrowed = 1;
+        SymTable_link(oSymTable, ppLink, pBinding);
+        pBinding++;
+        pcKey += uLength + 1;
+    }
+    return oSymTable;
+}
+
+void *SymTable_replaceN(SymTable_T oSymTable,
+    const char *pcKey, size_t uLength, const void *pvValue) {
     struct Binding *pCurrentBinding;
+    void **ppvSlot;
     void *ret;
     assert(oSymTable != NULL);
     assert(pcKey != NULL);
-    for (pCurrentBinding = oSymTable->head;
-        pCurrentBinding != NULL;
-        pCurrentBinding = pCurrentBinding->pNextBinding)
-    {
-        if(strcmp(pCurrentBinding->key,pcKey)==0) {
-            ret = (void *)pCurrentBinding->value;
-            pCurrentBinding->value=pvValue;
-            return ret;
-        }
+    /* Values can be replaced inside the private mapping without promoting. */
+    if(oSymTable->oImage != NULL) {
+        ppvSlot = SymTableImage_findN(oSymTable->oImage, pcKey, uLength);
+        if(ppvSlot == NULL)
+            return NULL;
+        ret = *ppvSlot;
+        *ppvSlot = (void *)pvValue;
+        SymTable_logChange(oSymTable, SYMTABLELOG_REPLACE, pcKey, uLength, pvValue);
+        return ret;
     }
-    return NULL;
+    pCurrentBinding = *SymTable_findLink(oSymTable, pcKey, uLength);
+    if(pCurrentBinding == NULL)
+        return NULL;
+    if(oSymTable->uScopeDepth > 0 && !SymTable_reserveUndo(oSymTable))
+        return NULL;
+    ret = (void *)pCurrentBinding->value;
+    pCurrentBinding->value=pvValue;
+    SymTable_logUndo(oSymTable, UNDO_REPLACE, pCurrentBinding, ret);
+    SymTable_logChange(oSymTable, SYMTABLELOG_REPLACE, pcKey, uLength, pvValue);
+    return ret;
 }
 
-int SymTable_contains(SymTable_T oSymTable, const char *pcKey) {
-    struct Binding *pCurrentBinding;
+void *SymTable_replace(SymTable_T oSymTable,
+    const char *pcKey, const void *pvValue) {
+    assert(pcKey != NULL);
+    return SymTable_replaceN(oSymTable, pcKey, strlen(pcKey), pvValue);
+}
+
+void **SymTable_upsertN(SymTable_T oSymTable, const char *pcKey, size_t uLength,
+    int *piInserted) {
+    struct Binding *pNewBinding;
+    struct Binding **ppLink;
+    void **ppvSlot;
     assert(oSymTable != NULL);
     assert(pcKey != NULL);
-    for (pCurrentBinding = oSymTable->head;
-        pCurrentBinding != NULL;
-        pCurrentBinding = pCurrentBinding->pNextBinding)
-    {
-        if(strcmp(pCurrentBinding->key,pcKey)==0)
-            return 1;
+    if(piInserted != NULL)
+        *piInserted = 0;
+    /* A value stored through the slot would never reach the log. */
+    if(oSymTable->oLog != NULL)
+        return NULL;
+    /* A key that is already in the mapping has its slot there, as for SymTable_replace. */
+    if(oSymTable->oImage != NULL) {
+        ppvSlot = SymTableImage_findN(oSymTable->oImage, pcKey, uLength);
+        if(ppvSlot != NULL)
+            return ppvSlot;
+        if(!SymTable_promote(oSymTable))
+            return NULL;
     }
-    return 0;
+    if(oSymTable->uScopeDepth > 0 && !SymTable_reserveUndo(oSymTable))
+        return NULL;
+    ppLink = SymTable_findLink(oSymTable, pcKey, uLength);
+    /* The slot is handed out before the caller writes it, so the value it holds now is logged. */
+    if(*ppLink != NULL) {
+        SymTable_logUndo(oSymTable, UNDO_REPLACE, *ppLink, (*ppLink)->value);
+        return (void **)&(*ppLink)->value;
+    }
+    pNewBinding = SymTable_newBinding(oSymTable, pcKey, uLength, 0);
+    if(pNewBinding==NULL) return NULL;
+    pNewBinding->value = NULL;
+    pNewBinding->pShadowed = NULL;
+    pNewBinding->uScope = (unsigned int)oSymTable->uScopeDepth;
+    SymTable_link(oSymTable, ppLink, pNewBinding);
+    SymTable_logUndo(oSymTable, UNDO_PUT, pNewBinding, NULL);
+    if(piInserted != NULL)
+        *piInserted = 1;
+    return (void **)&pNewBinding->value;
 }
 
-void *SymTable_get(SymTable_T oSymTable, const char *pcKey) {
+void **SymTable_upsert(SymTable_T oSymTable, const char *pcKey, int *piInserted) {
+    assert(pcKey != NULL);
+    return SymTable_upsertN(oSymTable, pcKey, strlen(pcKey), piInserted);
+}
+
+int SymTable_containsN(SymTable_T oSymTable, const char *pcKey, size_t uLength) {
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+    if(oSymTable->oImage != NULL)
+        return SymTableImage_findN(oSymTable->oImage, pcKey, uLength) != NULL;
+    return *SymTable_findLink(oSymTable, pcKey, uLength) != NULL;
+}
+
+int SymTable_contains(SymTable_T oSymTable, const char *pcKey) {
+    assert(pcKey != NULL);
+    return SymTable_containsN(oSymTable, pcKey, strlen(pcKey));
+}
+
+void *SymTable_getN(SymTable_T oSymTable, const char *pcKey, size_t uLength) {
     struct Binding *pCurrentBinding;
+    void **ppvSlot;
     assert(oSymTable != NULL);
     assert(pcKey != NULL);
-    for (pCurrentBinding = oSymTable->head;
-        pCurrentBinding != NULL;
-        pCurrentBinding = pCurrentBinding->pNextBinding)
-    {
-        if(strcmp(pCurrentBinding->key,pcKey)==0)
-            return (void *)pCurrentBinding->value;
+    if(oSymTable->oImage != NULL) {
+        ppvSlot = SymTableImage_findN(oSymTable->oImage, pcKey, uLength);
+        return ppvSlot == NULL ? NULL : *ppvSlot;
     }
-    return NULL;
+    pCurrentBinding = *SymTable_findLink(oSymTable, pcKey, uLength);
+    if(pCurrentBinding == NULL)
+        return NULL;
+    return (void *)pCurrentBinding->value;
 }
 
-void *SymTable_remove(SymTable_T oSymTable, const char *pcKey) {
+void *SymTable_get(SymTable_T oSymTable, const char *pcKey) {
+    assert(pcKey != NULL);
+    return SymTable_getN(oSymTable, pcKey, strlen(pcKey));
+}
+
+void *SymTable_removeN(SymTable_T oSymTable, const char *pcKey, size_t uLength) {
+    struct Binding **ppLink;
     struct Binding *pCurrentBinding;
-    struct Binding *prevBinding;
     void *prevValue;
     assert(oSymTable != NULL);
     assert(pcKey != NULL);
-    prevBinding=oSymTable->head;
-    for (pCurrentBinding = oSymTable->head;
-        pCurrentBinding != NULL;
-        pCurrentBinding = pCurrentBinding->pNextBinding)
-    {
-        if(strcmp(pCurrentBinding->key,pcKey)==0) {
-            oSymTable->size = oSymTable->size - 1;
-            prevValue = (void *) pCurrentBinding->value;
-            if(pCurrentBinding==oSymTable->head) {
-                oSymTable->head = pCurrentBinding->pNextBinding;
-                free((void *)pCurrentBinding->key);
-                free((void *)pCurrentBinding);
-                return prevValue;
-            }
-            prevBinding->pNextBinding= pCurrentBinding->pNextBinding;
-            free((void *)pCurrentBinding->key);
-            free((void *)pCurrentBinding);
-            return prevValue;
-        }
-        prevBinding = pCurrentBinding;
+    /* Removing a key that is not in the mapping changes nothing, so only promote for a hit. */
+    if(oSymTable->oImage != NULL) {
+        if(SymTableImage_findN(oSymTable->oImage, pcKey, uLength) == NULL
+                || !SymTable_promote(oSymTable))
+            return NULL;
     }
-    return NULL;
+    ppLink = SymTable_findLink(oSymTable, pcKey, uLength);
+    if(*ppLink == NULL)
+        return NULL;
+    if(oSymTable->uScopeDepth > 0 && !SymTable_reserveUndo(oSymTable))
+        return NULL;
+    /* Removing a Binding reveals the one it shadows; the undo log keeps it until its scope is popped. */
+    pCurrentBinding = SymTable_unlink(oSymTable, ppLink);
+    prevValue = (void *) pCurrentBinding->value;
+    SymTable_logChange(oSymTable, SYMTABLELOG_REMOVE, pcKey, uLength, NULL);
+    if(oSymTable->uScopeDepth > 0)
+        SymTable_logUndo(oSymTable, UNDO_REMOVE, pCurrentBinding, NULL);
+    else
+        SymTable_freeBinding(oSymTable, pCurrentBinding);
+    return prevValue;
+}
+
+void *SymTable_remove(SymTable_T oSymTable, const char *pcKey) {
+    assert(pcKey != NULL);
+    return SymTable_removeN(oSymTable, pcKey, strlen(pcKey));
 }
 
 void SymTable_map(SymTable_T oSymTable,
@@ -186,6 +1073,10 @@ void SymTable_map(SymTable_T oSymTable,
     struct Binding *pCurrentBinding;
     assert(oSymTable != NULL);
     assert(pfApply != NULL);
+    if(oSymTable->oImage != NULL) {
+        SymTableImage_map(oSymTable->oImage, pfApply, pvExtra);
+        return;
+    }
     for (pCurrentBinding = oSymTable->head;
         pCurrentBinding != NULL;
         pCurrentBinding = pCurrentBinding->pNextBinding)
@@ -194,3 +1085,230 @@ void SymTable_map(SymTable_T oSymTable,
     }
 }
 
+/*
+    SymTable_sameAllocator is a helper function that returns 1 if oFirst and oSecond allocate
+    from the same allocator, so that a block of one may be freed by the other, and 0 otherwise.
+*/
+static int SymTable_sameAllocator(SymTable_T oFirst, SymTable_T oSecond) {
+    return oFirst->sAllocator.pfAlloc == oSecond->sAllocator.pfAlloc
+        && oFirst->sAllocator.pfFree == oSecond->sAllocator.pfFree
+        && oFirst->sAllocator.pvContext == oSecond->sAllocator.pvContext;
+}
+
+/*
+    SymTable_takeBinding is a helper function for SymTable_merge that returns a Binding of oDst
+    with the key and value of pBinding, a Binding of oSrc that the caller has not yet unlinked.
+    pBinding itself is returned, with its bytes moved from the memory usage of oSrc to that of
+    oDst, unless it has to be copied because the allocators differ or it lies in the block of
+    SymTable_fromArrays; then the copy is returned and pBinding is freed. Returns NULL if there is
+    not enough memory for the copy, in which case pBinding is unchanged.
+*/
+static struct Binding *SymTable_takeBinding(SymTable_T oDst, SymTable_T oSrc,
+    struct Binding *pBinding) {
+    struct Binding *pCopy;
+    size_t uSize;
+    if(SymTable_sameAllocator(oDst, oSrc) && !SymTable_isBulk(oSrc, pBinding)) {
+        uSize = SymTable_bindingSize(pBinding);
+        oSrc->uMemoryUsage -= uSize;
+        oDst->uMemoryUsage += uSize;
+        return pBinding;
+    }
+    pCopy = SymTable_newBinding(oDst, pBinding->key, strlen(pBinding->key), 0);
+    if(pCopy == NULL)
+        return NULL;
+    pCopy->value = pBinding->value;
+    pCopy->pShadowed = NULL;
+    pCopy->uScope = 0;
+    SymTable_freeBinding(oSrc, pBinding);
+    return pCopy;
+}
+
+int SymTable_merge(SymTable_T oDst, SymTable_T oSrc,
+    void *(*pfCombine)(const char *pcKey, void *pvDstValue, void *pvSrcValue, void *pvExtra),
+    const void *pvExtra) {
+    struct Binding *pBinding;
+    struct Binding *pNextBinding;
+    struct Binding *pDstBinding;
+    struct Binding *pMoved = NULL;
+    struct Binding **ppMovedTail = &pMoved;
+    size_t uCount = 0;
+    size_t uSize = 0;
+    int iSuccessful = 1;
+    assert(oDst != NULL);
+    assert(oSrc != NULL);
+    assert(oDst != oSrc);
+    /* Moved Bindings cannot be undone by a scope of either SymTable, nor logged one at a time. */
+    if(oDst->uScopeDepth > 0 || oSrc->uScopeDepth > 0)
+        return 0;
+    if(oDst->oLog != NULL || oSrc->oLog != NULL)
+        return 0;
+    if(!SymTable_promote(oDst) || !SymTable_promote(oSrc))
+        return 0;
+    /* An empty oDst takes the whole list of oSrc. */
+    if(oDst->head == NULL && SymTable_sameAllocator(oDst, oSrc)
+            && oSrc->psBulkBindings == NULL) {
+        for(pBinding = oSrc->head; pBinding != NULL; pBinding = pBinding->pNextBinding) {
+            uCount++;
+            uSize += SymTable_bindingSize(pBinding);
+        }
+        oDst->head = oSrc->head;
+        oSrc->head = NULL;
+        oSrc->size -= uCount;
+        oDst->size += uCount;
+        oSrc->uMemoryUsage -= uSize;
+        oDst->uMemoryUsage += uSize;
+        return 1;
+    }
+    /* Only the Bindings that oDst already held are compared with, since the keys of oSrc are
+        distinct. */
+    while((pBinding = oSrc->head) != NULL) {
+        pNextBinding = pBinding->pNextBinding;
+        for(pDstBinding = oDst->head; pDstBinding != NULL;
+                pDstBinding = pDstBinding->pNextBinding) {
+            if(strcmp(pDstBinding->key, pBinding->key) == 0)
+                break;
+        }
+        if(pDstBinding != NULL) {
+            if(pfCombine != NULL)
+                pDstBinding->value = (*pfCombine)(pDstBinding->key, (void *)pDstBinding->value,
+                    (void *)pBinding->value, (void *)pvExtra);
+            oSrc->head = pNextBinding;
+            oSrc->size--;
+            SymTable_freeBinding(oSrc, pBinding);
+            continue;
+        }
+        pBinding = SymTable_takeBinding(oDst, oSrc, pBinding);
+        if(pBinding == NULL) {
+            iSuccessful = 0;
+            break;
+        }
+        oSrc->head = pNextBinding;
+        oSrc->size--;
+        /* The moved Bindings go in front of the list once it has been searched. */
+        pBinding->pNextBinding = NULL;
+        *ppMovedTail = pBinding;
+        ppMovedTail = &pBinding->pNextBinding;
+        oDst->size++;
+    }
+    *ppMovedTail = oDst->head;
+    oDst->head = pMoved;
+    return iSuccessful;
+}
+
+int SymTable_pushScope(SymTable_T oSymTable) {
+    size_t *puScopeMarks;
+    size_t uScopeCapacity;
+    assert(oSymTable != NULL);
+    /* Popping a scope could not take its changes back out of the log. */
+    if(oSymTable->oLog != NULL)
+        return 0;
+    /* Scopes are undone through Bindings, so a mapped table is promoted first. */
+    if(!SymTable_promote(oSymTable))
+        return 0;
+    /* Bindings record their scope depth in an unsigned int. */
+    if(oSymTable->uScopeDepth == UINT_MAX)
+        return 0;
+    if(oSymTable->uScopeDepth == oSymTable->uScopeCapacity) {
+        uScopeCapacity = oSymTable->uScopeCapacity == 0 ? 8 : 2 * oSymTable->uScopeCapacity;
+        puScopeMarks = (size_t *)SymTable_reallocate(oSymTable, oSymTable->puScopeMarks,
+            oSymTable->uScopeCapacity * sizeof(size_t), uScopeCapacity * sizeof(size_t));
+        if(puScopeMarks == NULL)
+            return 0;
+        oSymTable->uMemoryUsage += SymTable_blockSize(uScopeCapacity * sizeof(size_t))
+            - SymTable_blockSize(oSymTable->uScopeCapacity * sizeof(size_t));
+        oSymTable->puScopeMarks = puScopeMarks;
+        oSymTable->uScopeCapacity = uScopeCapacity;
+    }
+    oSymTable->puScopeMarks[oSymTable->uScopeDepth] = oSymTable->uUndoCount;
+    oSymTable->uScopeDepth++;
+    return 1;
+}
+
+int SymTable_popScope(SymTable_T oSymTable) {
+    size_t uMark;
+    assert(oSymTable != NULL);
+    if(oSymTable->uScopeDepth == 0)
+        return 0;
+    oSymTable->uScopeDepth--;
+    uMark = oSymTable->puScopeMarks[oSymTable->uScopeDepth];
+    while(oSymTable->uUndoCount > uMark) {
+        oSymTable->uUndoCount--;
+        SymTable_undo(oSymTable, &oSymTable->psUndoLog[oSymTable->uUndoCount]);
+    }
+    return 1;
+}
+
+void SymTable_clear(SymTable_T oSymTable) {
+    struct Binding *pBinding;
+    size_t index;
+    assert(oSymTable != NULL);
+    SymTable_logChange(oSymTable, SYMTABLELOG_CLEAR, NULL, 0, NULL);
+    if(oSymTable->oImage != NULL) {
+        SymTableImage_close(oSymTable->oImage);
+        oSymTable->oImage = NULL;
+    }
+    /* The list moves to the free list whole, which takes no time if the free list is empty. */
+    SymTable_recycle(oSymTable, oSymTable->head);
+    oSymTable->head = NULL;
+    /* The Bindings removed in open scopes are owned by the undo log and shadow nothing now. */
+    for(index = 0; index < oSymTable->uUndoCount; index++) {
+        if(oSymTable->psUndoLog[index].eKind == UNDO_REMOVE) {
+            pBinding = oSymTable->psUndoLog[index].pBinding;
+            pBinding->pShadowed = NULL;
+            pBinding->pNextBinding = NULL;
+            SymTable_recycle(oSymTable, pBinding);
+        }
+    }
+    oSymTable->uUndoCount = 0;
+    oSymTable->uScopeDepth = 0;
+    oSymTable->size = 0;
+}
+
+/* A list has no buckets to skip, so every lookup walks it and there is no filter. */
+int SymTable_enableFilter(SymTable_T oSymTable) {
+    assert(oSymTable != NULL);
+    return 0;
+}
+
+/* The cache is only kept by the hash table implementation. */
+int SymTable_enableCache(SymTable_T oSymTable) {
+    assert(oSymTable != NULL);
+    return 0;
+}
+
+/*
+    SymTable_countChain is a helper function for SymTable_getStats that adds a chain of
+    uChainLength key-value pairs to the histogram of psStats. Returns nothing.
+*/
+static void SymTable_countChain(SymTable_Stats *psStats, size_t uChainLength) {
+    if(uChainLength >= SYMTABLE_HISTOGRAM_SIZE)
+        uChainLength = SYMTABLE_HISTOGRAM_SIZE - 1;
+    psStats->auChainLengths[uChainLength]++;
+}
+
+int SymTable_getStats(SymTable_T oSymTable, SymTable_Stats *psStats) {
+    assert(oSymTable != NULL);
+    assert(psStats != NULL);
+#ifdef SYMTABLE_STATS
+    *psStats = oSymTable->sStats;
+#else
+    memset(psStats, 0, sizeof(SymTable_Stats));
+#endif
+    if(psStats->uLookups > 0)
+        psStats->dComparisonsPerLookup =
+            (double)psStats->uComparisons / (double)psStats->uLookups;
+    psStats->uLength = SymTable_getLength(oSymTable);
+    /* A table served from a mapped snapshot has no chains of its own yet. */
+    SymTable_countChain(psStats, oSymTable->size);
+    psStats->uBucketCount = 1;
+#ifdef SYMTABLE_STATS
+    return 1;
+#else
+    return 0;
+#endif
+}
+
+size_t SymTable_memoryUsage(SymTable_T oSymTable) {
+    assert(oSymTable != NULL);
+    return oSymTable->uMemoryUsage;
+}
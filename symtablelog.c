@@ -0,0 +1,431 @@
+/*
+    Name: Tharun Kumar Tiruppali Kalidoss
+    File Name: symtablelog.c
+*/
+#define _POSIX_C_SOURCE 200809L
+#include "symtablelog.h"
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <assert.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/*
+    A log file is laid out as a LogHeader followed by one record for every change made to the
+    table since its last checkpoint, each a LogRecord followed by the uKeyLength characters of its
+    key. Records are only ever appended, so a crash can only cut the last ones short, and a record
+    whose checksum does not match ends the log. The checkpoint is a snapshot written by
+    SymTable_save, in a file named like the log with CHECKPOINT_SUFFIX added. Replaying the log on
+    top of a checkpoint that already holds some of its changes leaves the same table, so a crash
+    between writing a checkpoint and emptying the log loses nothing.
+*/
+
+/* LOG_MAGIC identifies a log file, including the version of its layout. */
+static const char LOG_MAGIC[8] = {'S', 'Y', 'M', 'L', 'O', 'G', '0', '1'};
+
+/* CHECKPOINT_SUFFIX is added to the name of the log to name its checkpoint, and
+   TEMPORARY_SUFFIX to that to name a checkpoint while it is being written. */
+static const char CHECKPOINT_SUFFIX[] = ".checkpoint";
+static const char TEMPORARY_SUFFIX[] = ".tmp";
+
+/* LOG_BUFFER_SIZE is the number of bytes of records that are collected before they are
+   written to the log file together. */
+enum {LOG_BUFFER_SIZE = 65536};
+
+/*
+    LogHeader is the fixed-size record at the start of every log file.
+*/
+struct LogHeader
+{
+    /* acMagic must equal LOG_MAGIC. */
+   char acMagic[8];
+    /* uSlotSize is the size of a value slot (sizeof(void*)) of the process that wrote the file. */
+   uint64_t uSlotSize;
+};
+
+/*
+    LogRecord is the on-disk representation of one change, without its key.
+*/
+struct LogRecord
+{
+    /* uChecksum is the checksum of the rest of the record and of its key. */
+   uint32_t uChecksum;
+    /* uKind is the SymTableLog_Kind of the change. */
+   uint32_t uKind;
+    /* uKeyLength is the number of characters of the key that follows the record. */
+   uint64_t uKeyLength;
+    /* pvValue is the value that the change stores. */
+   const void *pvValue;
+};
+
+/*
+    SymTableLog is the in-memory state of an open log file.
+*/
+struct SymTableLog
+{
+    /* iFd is the log file, opened for appending. */
+   int iFd;
+    /* pcCheckpointPath and pcTemporaryPath are the names of the checkpoint and of the file it
+        is written to before it is renamed. */
+   char *pcCheckpointPath;
+   char *pcTemporaryPath;
+    /* acBuffer holds the uBuffered bytes of records that have not been written yet. */
+   char acBuffer[LOG_BUFFER_SIZE];
+   size_t uBuffered;
+    /* uUnsynced is the number of records appended since the file was last synced, and uBatch
+        the number at which it is synced again, or 0 if it is only synced on request. */
+   size_t uUnsynced;
+   size_t uBatch;
+    /* iFailed is 1 if a write or sync has failed since the last checkpoint. */
+   int iFailed;
+};
+
+/* Return the 32-bit FNV-1a checksum of the uLength bytes at pvBytes, continued from uSum. */
+static uint32_t SymTableLog_checksum(uint32_t uSum, const void *pvBytes, size_t uLength)
+{
+   const unsigned char *pucBytes = (const unsigned char *)pvBytes;
+   size_t u;
+
+   for (u = 0; u < uLength; u++)
+      uSum = (uSum ^ pucBytes[u]) * (uint32_t)16777619;
+
+   return uSum;
+}
+
+/*
+    SymTableLog_recordChecksum returns the checksum of psRecord, not counting its uChecksum
+    field, followed by the key pcKey.
+*/
+static uint32_t SymTableLog_recordChecksum(const struct LogRecord *psRecord, const char *pcKey) {
+    uint32_t uSum;
+    uSum = SymTableLog_checksum((uint32_t)2166136261U, &psRecord->uKind,
+        sizeof(struct LogRecord) - offsetof(struct LogRecord, uKind));
+    return SymTableLog_checksum(uSum, pcKey, (size_t)psRecord->uKeyLength);
+}
+
+/*
+    SymTableLog_writeAll writes the uLength bytes at pvBytes to the file iFd, retrying after a
+    short write or an interrupted one. Returns 1 on success and 0 if a write fails.
+*/
+static int SymTableLog_writeAll(int iFd, const void *pvBytes, size_t uLength) {
+    const char *pcBytes = (const char *)pvBytes;
+    ssize_t iWritten;
+    while (uLength > 0) {
+        iWritten = write(iFd, pcBytes, uLength);
+        if (iWritten < 0) {
+            if (errno == EINTR)
+                continue;
+            return 0;
+        }
+        pcBytes += iWritten;
+        uLength -= (size_t)iWritten;
+    }
+    return 1;
+}
+
+/*
+    SymTableLog_drain writes the buffered records of oLog to its file with one write, and
+    records a failure in oLog. Returns nothing.
+*/
+static void SymTableLog_drain(SymTableLog_T oLog) {
+    if (oLog->uBuffered == 0)
+        return;
+    if (!SymTableLog_writeAll(oLog->iFd, oLog->acBuffer, oLog->uBuffered))
+        oLog->iFailed = 1;
+    oLog->uBuffered = 0;
+}
+
+/*
+    SymTableLog_syncDirectory syncs the directory that holds the file pcPath, so that a file
+    created or renamed in it survives a crash. Returns 1 on success and 0 otherwise.
+*/
+static int SymTableLog_syncDirectory(const char *pcPath) {
+    const char *pcSlash;
+    char *pcDirectory;
+    size_t uLength;
+    int iFd;
+    int iSuccessful;
+    pcSlash = strrchr(pcPath, '/');
+    uLength = pcSlash == NULL ? 1 : (pcSlash == pcPath ? 1 : (size_t)(pcSlash - pcPath));
+    pcDirectory = (char *)malloc(uLength + 1);
+    if (pcDirectory == NULL)
+        return 0;
+    memcpy(pcDirectory, pcSlash == NULL ? "." : pcPath, uLength);
+    pcDirectory[uLength] = '\0';
+    iFd = open(pcDirectory, O_RDONLY);
+    free(pcDirectory);
+    if (iFd < 0)
+        return 0;
+    iSuccessful = fsync(iFd) == 0;
+    close(iFd);
+    return iSuccessful;
+}
+
+/*
+    SymTableLog_writeHeader writes a LogHeader to the empty log file of oLog and syncs it.
+    Returns 1 on success and 0 otherwise.
+*/
+static int SymTableLog_writeHeader(SymTableLog_T oLog) {
+    struct LogHeader sHeader;
+    memset(&sHeader, 0, sizeof(sHeader));
+    memcpy(sHeader.acMagic, LOG_MAGIC, sizeof(LOG_MAGIC));
+    sHeader.uSlotSize = sizeof(void *);
+    return SymTableLog_writeAll(oLog->iFd, &sHeader, sizeof(sHeader))
+        && fdatasync(oLog->iFd) == 0;
+}
+
+/*
+    SymTableLog_apply replays the change of kind uKind to the key made of the uLength characters
+    at pcKey, with the value pvValue, on oSymTable. A put of a key that is already there replaces
+    its value, as happens when the checkpoint already holds the change. Returns 1 on success and 0
+    if there is not enough memory or uKind is not a change.
+*/
+static int SymTableLog_apply(SymTable_T oSymTable, uint32_t uKind, const char *pcKey,
+    size_t uLength, const void *pvValue) {
+    switch (uKind) {
+    case SYMTABLELOG_PUT:
+        if (SymTable_putN(oSymTable, pcKey, uLength, pvValue))
+            return 1;
+        if (!SymTable_containsN(oSymTable, pcKey, uLength))
+            return 0;
+        (void)SymTable_replaceN(oSymTable, pcKey, uLength, pvValue);
+        return 1;
+    case SYMTABLELOG_REPLACE:
+        (void)SymTable_replaceN(oSymTable, pcKey, uLength, pvValue);
+        return 1;
+    case SYMTABLELOG_REMOVE:
+        (void)SymTable_removeN(oSymTable, pcKey, uLength);
+        return 1;
+    case SYMTABLELOG_CLEAR:
+        SymTable_clear(oSymTable);
+        return 1;
+    default:
+        return 0;
+    }
+}
+
+/*
+    SymTableLog_replay replays the records of the uSize bytes of the log file at pcBase on
+    oSymTable, and stores in *puValid the length of the log up to the end of the last whole
+    record. Returns 1 on success, and 0 if the file is not a log or there is not enough memory.
+*/
+static int SymTableLog_replay(const char *pcBase, size_t uSize, SymTable_T oSymTable,
+    size_t *puValid) {
+    const struct LogHeader *psHeader = (const struct LogHeader *)pcBase;
+    struct LogRecord sRecord;
+    const char *pcKey;
+    size_t uOffset;
+    if (uSize < sizeof(struct LogHeader)
+            || memcmp(psHeader->acMagic, LOG_MAGIC, sizeof(LOG_MAGIC)) != 0
+            || psHeader->uSlotSize != sizeof(void *))
+        return 0;
+    uOffset = sizeof(struct LogHeader);
+    /* The records are copied out, since a key can leave the next one unaligned. */
+    while (uSize - uOffset >= sizeof(struct LogRecord)) {
+        memcpy(&sRecord, pcBase + uOffset, sizeof(sRecord));
+        if (sRecord.uKeyLength > uSize - uOffset - sizeof(struct LogRecord))
+            break;
+        pcKey = pcBase + uOffset + sizeof(struct LogRecord);
+        if (SymTableLog_recordChecksum(&sRecord, pcKey) != sRecord.uChecksum)
+            break;
+        if (!SymTableLog_apply(oSymTable, sRecord.uKind, pcKey, (size_t)sRecord.uKeyLength,
+                sRecord.pvValue))
+            return 0;
+        uOffset += sizeof(struct LogRecord) + (size_t)sRecord.uKeyLength;
+    }
+    *puValid = uOffset;
+    return 1;
+}
+
+/*
+    SymTableLog_recover opens the checkpoint of oLog, or makes an empty SymTable if there is none
+    yet, and replays the log file on top of it. Drops any partial record from the end of the log.
+    Returns the SymTable, or NULL if the checkpoint or log cannot be read or there is not enough
+    memory.
+*/
+static SymTable_T SymTableLog_recover(SymTableLog_T oLog) {
+    SymTable_T oSymTable;
+    struct stat sStat;
+    void *pvBase;
+    size_t uValid;
+    int iSuccessful;
+    oSymTable = SymTable_openMapped(oLog->pcCheckpointPath);
+    if (oSymTable == NULL) {
+        /* A checkpoint that exists but cannot be mapped is never silently replaced. */
+        if (access(oLog->pcCheckpointPath, F_OK) == 0)
+            return NULL;
+        oSymTable = SymTable_new();
+        if (oSymTable == NULL)
+            return NULL;
+    }
+    if (fstat(oLog->iFd, &sStat) != 0) {
+        SymTable_free(oSymTable);
+        return NULL;
+    }
+    if (sStat.st_size == 0) {
+        if (!SymTableLog_writeHeader(oLog)) {
+            SymTable_free(oSymTable);
+            return NULL;
+        }
+        return oSymTable;
+    }
+    pvBase = mmap(NULL, (size_t)sStat.st_size, PROT_READ, MAP_PRIVATE, oLog->iFd, 0);
+    if (pvBase == MAP_FAILED) {
+        SymTable_free(oSymTable);
+        return NULL;
+    }
+    iSuccessful = SymTableLog_replay((const char *)pvBase, (size_t)sStat.st_size, oSymTable,
+        &uValid);
+    munmap(pvBase, (size_t)sStat.st_size);
+    /* New records go after the last whole one. */
+    if (iSuccessful && uValid < (size_t)sStat.st_size)
+        iSuccessful = ftruncate(oLog->iFd, (off_t)uValid) == 0 && fdatasync(oLog->iFd) == 0;
+    if (!iSuccessful) {
+        SymTable_free(oSymTable);
+        return NULL;
+    }
+    return oSymTable;
+}
+
+SymTableLog_T SymTableLog_open(const char *pcPath, SymTable_T *poSymTable) {
+    SymTableLog_T oLog;
+    SymTable_T oSymTable;
+    size_t uLength;
+    assert(pcPath != NULL);
+    assert(poSymTable != NULL);
+
+    oLog = (SymTableLog_T)malloc(sizeof(struct SymTableLog));
+    if (oLog == NULL)
+        return NULL;
+    uLength = strlen(pcPath);
+    oLog->pcCheckpointPath = (char *)malloc(uLength + sizeof(CHECKPOINT_SUFFIX));
+    oLog->pcTemporaryPath = (char *)malloc(uLength + sizeof(CHECKPOINT_SUFFIX)
+        + sizeof(TEMPORARY_SUFFIX) - 1);
+    oLog->iFd = -1;
+    if (oLog->pcCheckpointPath != NULL && oLog->pcTemporaryPath != NULL) {
+        strcpy(oLog->pcCheckpointPath, pcPath);
+        strcat(oLog->pcCheckpointPath, CHECKPOINT_SUFFIX);
+        strcpy(oLog->pcTemporaryPath, oLog->pcCheckpointPath);
+        strcat(oLog->pcTemporaryPath, TEMPORARY_SUFFIX);
+        oLog->iFd = open(pcPath, O_RDWR | O_APPEND | O_CREAT, 0666);
+    }
+    oSymTable = NULL;
+    if (oLog->iFd >= 0) {
+        oSymTable = SymTableLog_recover(oLog);
+        if (oSymTable != NULL && !SymTableLog_syncDirectory(pcPath)) {
+            SymTable_free(oSymTable);
+            oSymTable = NULL;
+        }
+    }
+    if (oSymTable == NULL) {
+        if (oLog->iFd >= 0)
+            close(oLog->iFd);
+        free(oLog->pcCheckpointPath);
+        free(oLog->pcTemporaryPath);
+        free(oLog);
+        return NULL;
+    }
+    oLog->uBuffered = 0;
+    oLog->uUnsynced = 0;
+    oLog->uBatch = 1;
+    oLog->iFailed = 0;
+    *poSymTable = oSymTable;
+    return oLog;
+}
+
+void SymTableLog_close(SymTableLog_T oLog) {
+    assert(oLog != NULL);
+    (void)SymTableLog_sync(oLog);
+    close(oLog->iFd);
+    free(oLog->pcCheckpointPath);
+    free(oLog->pcTemporaryPath);
+    free(oLog);
+}
+
+void SymTableLog_append(SymTableLog_T oLog, SymTableLog_Kind eKind, const char *pcKey,
+    size_t uLength, const void *pvValue) {
+    struct LogRecord sRecord;
+    size_t uRecordSize;
+    assert(oLog != NULL);
+    if (eKind == SYMTABLELOG_CLEAR) {
+        pcKey = "";
+        uLength = 0;
+    }
+    assert(pcKey != NULL);
+    memset(&sRecord, 0, sizeof(sRecord));
+    sRecord.uKind = (uint32_t)eKind;
+    sRecord.uKeyLength = uLength;
+    sRecord.pvValue = eKind == SYMTABLELOG_PUT || eKind == SYMTABLELOG_REPLACE ? pvValue : NULL;
+    sRecord.uChecksum = SymTableLog_recordChecksum(&sRecord, pcKey);
+    uRecordSize = sizeof(sRecord) + uLength;
+    if (oLog->uBuffered + uRecordSize > LOG_BUFFER_SIZE)
+        SymTableLog_drain(oLog);
+    /* A record too long for the buffer is written on its own. */
+    if (uRecordSize > LOG_BUFFER_SIZE) {
+        if (!SymTableLog_writeAll(oLog->iFd, &sRecord, sizeof(sRecord))
+                || !SymTableLog_writeAll(oLog->iFd, pcKey, uLength))
+            oLog->iFailed = 1;
+    }
+    else {
+        memcpy(oLog->acBuffer + oLog->uBuffered, &sRecord, sizeof(sRecord));
+        memcpy(oLog->acBuffer + oLog->uBuffered + sizeof(sRecord), pcKey, uLength);
+        oLog->uBuffered += uRecordSize;
+    }
+    oLog->uUnsynced++;
+    if (oLog->uBatch != 0 && oLog->uUnsynced >= oLog->uBatch)
+        (void)SymTableLog_sync(oLog);
+}
+
+void SymTableLog_setBatch(SymTableLog_T oLog, size_t uRecords) {
+    assert(oLog != NULL);
+    oLog->uBatch = uRecords;
+    if (uRecords != 0 && oLog->uUnsynced >= uRecords)
+        (void)SymTableLog_sync(oLog);
+}
+
+int SymTableLog_sync(SymTableLog_T oLog) {
+    assert(oLog != NULL);
+    if (oLog->uUnsynced > 0) {
+        SymTableLog_drain(oLog);
+        if (fdatasync(oLog->iFd) != 0)
+            oLog->iFailed = 1;
+        oLog->uUnsynced = 0;
+    }
+    return !oLog->iFailed;
+}
+
+int SymTableLog_checkpoint(SymTableLog_T oLog, SymTable_T oSymTable) {
+    int iFd;
+    int iSynced;
+    assert(oLog != NULL);
+    assert(oSymTable != NULL);
+
+    if (!SymTable_save(oSymTable, oLog->pcTemporaryPath)) {
+        remove(oLog->pcTemporaryPath);
+        return 0;
+    }
+    iFd = open(oLog->pcTemporaryPath, O_RDONLY);
+    iSynced = iFd >= 0 && fsync(iFd) == 0;
+    if (iFd >= 0)
+        close(iFd);
+    if (!iSynced || rename(oLog->pcTemporaryPath, oLog->pcCheckpointPath) != 0) {
+        remove(oLog->pcTemporaryPath);
+        return 0;
+    }
+    if (!SymTableLog_syncDirectory(oLog->pcCheckpointPath))
+        return 0;
+    /* Every record, written or still buffered, is in the checkpoint now. */
+    oLog->uBuffered = 0;
+    oLog->uUnsynced = 0;
+    if (ftruncate(oLog->iFd, 0) != 0 || !SymTableLog_writeHeader(oLog)) {
+        oLog->iFailed = 1;
+        return 0;
+    }
+    oLog->iFailed = 0;
+    return 1;
+}
@@ -0,0 +1,75 @@
+/*
+    Name: Tharun Kumar Tiruppali Kalidoss
+    File Name: symtablelog.h
+*/
+#include <stddef.h>
+#include "symtable.h"
+#ifndef SYMTABLELOG_INCLUDED
+#define SYMTABLELOG_INCLUDED
+
+/*
+   SymTableLog_T is of type struct SymTableLog*, and represents the write-ahead log of a SymTable
+   opened with SymTable_openLogged(), together with the checkpoint beside it. It is shared by the
+   SymTable implementations, each of which appends a record to it for every change it makes to a
+   logged table.
+*/
+typedef struct SymTableLog *SymTableLog_T;
+
+/*
+   SymTableLog_Kind identifies the change that a log record replays: a SymTable_put(), a
+   SymTable_replace(), a SymTable_remove() or a SymTable_clear().
+*/
+typedef enum {SYMTABLELOG_PUT = 1, SYMTABLELOG_REPLACE, SYMTABLELOG_REMOVE,
+   SYMTABLELOG_CLEAR} SymTableLog_Kind;
+
+/*
+   SymTableLog_open opens the log file pcPath, creating it if it does not exist, and stores in
+   *poSymTable a new SymTable_T holding the key-value pairs of the checkpoint beside it with every
+   record of the log replayed on top. Records cut short by a crash are dropped from the end of the
+   log. Returns a SymTableLog_T for appending to the log, or NULL if the log or the checkpoint
+   cannot be read or there is not enough memory, in which case *poSymTable is not changed. The new
+   SymTable_T does not log its changes until the caller attaches the SymTableLog_T to it. Takes in
+   parameters pcPath of type const char* and poSymTable of type SymTable_T*.
+*/
+SymTableLog_T SymTableLog_open(const char *pcPath, SymTable_T *poSymTable);
+
+/*
+   SymTableLog_close writes and syncs every record of oLog that is not yet durable, closes the
+   log file and frees all memory occupied by oLog. Returns nothing.
+*/
+void SymTableLog_close(SymTableLog_T oLog);
+
+/*
+   SymTableLog_append adds a record of kind eKind for the key made of the uLength characters at
+   pcKey, which need not be NUL-terminated, and the value pvValue to oLog. The records are
+   buffered and written to the log file together, and the file is synced once every uRecords
+   records, as set by SymTableLog_setBatch. A record that cannot be written makes the next
+   SymTableLog_sync fail. pcKey and pvValue are ignored for SYMTABLELOG_CLEAR, and pvValue for
+   SYMTABLELOG_REMOVE. Returns nothing.
+*/
+void SymTableLog_append(SymTableLog_T oLog, SymTableLog_Kind eKind, const char *pcKey,
+   size_t uLength, const void *pvValue);
+
+/*
+   SymTableLog_setBatch makes oLog sync its file once every uRecords appended records, or only
+   when SymTableLog_sync is called if uRecords is 0. Records already waiting are synced if there
+   are at least uRecords of them. Returns nothing.
+*/
+void SymTableLog_setBatch(SymTableLog_T oLog, size_t uRecords);
+
+/*
+   SymTableLog_sync writes every buffered record of oLog to the log file and syncs it. Returns 1
+   as type int if every record appended since the last checkpoint is durable, and 0 if a write
+   or sync has failed.
+*/
+int SymTableLog_sync(SymTableLog_T oLog);
+
+/*
+   SymTableLog_checkpoint replaces the checkpoint of oLog with a snapshot of oSymTable, written
+   with SymTable_save(), and then empties the log. The new checkpoint takes the place of the old
+   one with a rename, so a crash leaves one of them whole. Returns 1 as type int on success, and
+   0 if the checkpoint cannot be written, in which case the log is kept. Takes in parameters
+   oLog of type SymTableLog_T and oSymTable of type SymTable_T.
+*/
+int SymTableLog_checkpoint(SymTableLog_T oLog, SymTable_T oSymTable);
+#endif
@@ -0,0 +1,567 @@
+/*
+    Name: Tharun Kumar Tiruppali Kalidoss
+    File Name: symtableshared.c
+*/
+#define _POSIX_C_SOURCE 200809L
+#include "symtableshared.h"
+#include <string.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <assert.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/*
+    A shared memory segment is laid out as a SharedHeader, followed by uBucketCount uint64_t
+    bucket heads, followed by uEntryCapacity SharedEntry records, followed by uKeyCapacity
+    characters of keys. Every link is stored as an offset from the start of the segment, and 0,
+    the offset of the header, ends a chain. The bucket count is a power of two, so a bucket is
+    picked by masking the key's mixed hash. Removed entries are linked into a free list through
+    uNext and reused; the entries past uEntriesUsed have never been used. Keys are handed out
+    from the start of the key section and removed keys leave holes, which are closed by moving
+    every key down once a key no longer fits past uKeysUsed.
+*/
+
+/* SHARED_MAGIC identifies a shared table segment, including the version of its layout. */
+static const char SHARED_MAGIC[8] = {'S', 'Y', 'M', 'S', 'H', 'M', '0', '1'};
+
+/*
+    SharedHeader is the fixed-size record at the start of every segment. Every field after the
+    lock is changed only while the lock is held for writing.
+*/
+struct SharedHeader
+{
+    /* acMagic must equal SHARED_MAGIC. */
+   char acMagic[8];
+    /* uSlotSize is the size of a value slot (sizeof(void*)) of the process that created the
+        segment. */
+   uint64_t uSlotSize;
+    /* uSize is the size of the segment in bytes, used to reject truncated segments. */
+   uint64_t uSize;
+    /* uBucketCount is the number of buckets, a power of two. */
+   uint64_t uBucketCount;
+    /* uEntryCapacity and uKeyCapacity are the numbers of entries and key characters that the
+        segment has room for. */
+   uint64_t uEntryCapacity;
+   uint64_t uKeyCapacity;
+    /* uBucketsOffset, uEntriesOffset and uKeysOffset are the offsets of the three sections. */
+   uint64_t uBucketsOffset;
+   uint64_t uEntriesOffset;
+   uint64_t uKeysOffset;
+    /* sLock is the process-shared lock taken by every operation. */
+   pthread_rwlock_t sLock;
+    /* uLength is the number of key-value pairs. */
+   uint64_t uLength;
+    /* uEntriesUsed is the number of entries that have ever held a key-value pair. */
+   uint64_t uEntriesUsed;
+    /* uFreeEntry is the offset of the first removed entry, or 0 if there is none. */
+   uint64_t uFreeEntry;
+    /* uKeysUsed is the number of key characters that have been handed out since the keys were
+        last moved down, and uKeysFreed is the number of them that belong to removed keys. */
+   uint64_t uKeysUsed;
+   uint64_t uKeysFreed;
+};
+
+/*
+    SharedEntry is one key-value pair in the segment.
+*/
+struct SharedEntry
+{
+    /* uNext is the offset of the next entry in the chain, or 0 at the end of the chain. */
+   uint64_t uNext;
+    /* uHash is the full hash of the key, compared before the key itself. */
+   uint64_t uHash;
+    /* uKeyOffset is the offset of the key's first character from the start of the segment. */
+   uint64_t uKeyOffset;
+    /* pvValue is the value of the key-value pair. */
+   void *pvValue;
+};
+
+/*
+    SymTableShared is one process's view of a segment.
+*/
+struct SymTableShared
+{
+    /* pcBase points to the start of the mapping and uSize is its length in bytes. */
+   char *pcBase;
+   size_t uSize;
+    /* psHeader and puBuckets point to the sections inside the mapping. */
+   struct SharedHeader *psHeader;
+   uint64_t *puBuckets;
+};
+
+/*
+    ShareBuilder counts the key-value pairs and key characters of a SymTable through SymTable_map
+    while SymTable_share is sizing a segment.
+*/
+struct ShareBuilder
+{
+    /* uCount is the number of key-value pairs counted so far. */
+   size_t uCount;
+    /* uKeyBytes is the total size of the counted keys, including their '\0' characters. */
+   size_t uKeyBytes;
+};
+
+/* Return the hash of pcKey: the polynomial hash of the SymTable hash tables, with its bits
+   mixed by the finalizer of SplitMix64 so that every bit can pick a bucket. */
+static uint64_t SymTableShared_hash(const char *pcKey)
+{
+   const uint64_t HASH_MULTIPLIER = 65599;
+   size_t u;
+   uint64_t uHash = 0;
+
+   assert(pcKey != NULL);
+
+   for (u = 0; pcKey[u] != '\0'; u++)
+      uHash = uHash * HASH_MULTIPLIER + (uint64_t)(unsigned char)pcKey[u];
+
+   uHash ^= uHash >> 30;
+   uHash *= (uint64_t)0xBF58476D1CE4E5B9ULL;
+   uHash ^= uHash >> 27;
+   uHash *= (uint64_t)0x94D049BB133111EBULL;
+   uHash ^= uHash >> 31;
+   return uHash;
+}
+
+/*
+    SymTableShared_entry is a helper function that returns the entry at offset uOffset of the
+    segment of oSymTableShared.
+*/
+static struct SharedEntry *SymTableShared_entry(SymTableShared_T oSymTableShared,
+    uint64_t uOffset) {
+    return (struct SharedEntry *)(oSymTableShared->pcBase + uOffset);
+}
+
+/*
+    SymTableShared_find is a helper function that returns the link (a bucket head or the uNext
+    of an entry) that holds the offset of the entry of oSymTableShared whose key is pcKey, or the
+    link that ends pcKey's chain if there is no such entry, in which case the link holds 0.
+    uHash must be the hash of pcKey. The caller must hold the lock.
+*/
+static uint64_t *SymTableShared_find(SymTableShared_T oSymTableShared, const char *pcKey,
+    uint64_t uHash) {
+    uint64_t *puLink = &oSymTableShared->puBuckets[uHash
+        & (oSymTableShared->psHeader->uBucketCount - 1)];
+    struct SharedEntry *psEntry;
+
+    while (*puLink != 0) {
+        psEntry = SymTableShared_entry(oSymTableShared, *puLink);
+        if (psEntry->uHash == uHash
+                && strcmp(oSymTableShared->pcBase + psEntry->uKeyOffset, pcKey) == 0)
+            break;
+        puLink = &psEntry->uNext;
+    }
+    return puLink;
+}
+
+/*
+    SymTableShared_compact is a helper function that moves the keys of oSymTableShared down to
+    the start of the key section, so that the characters of removed keys can be handed out
+    again. The keys are gathered in a private buffer first, so that no key is overwritten before
+    it is copied. The caller must hold the lock for writing. Returns 1 as type int on success,
+    and 0 if there is not enough memory.
+*/
+static int SymTableShared_compact(SymTableShared_T oSymTableShared) {
+    struct SharedHeader *psHeader = oSymTableShared->psHeader;
+    char *pcKeys;
+    uint64_t uBucket;
+    uint64_t uOffset;
+    uint64_t uUsed = 0;
+    size_t uKeyBytes;
+    struct SharedEntry *psEntry;
+
+    pcKeys = (char *)malloc((size_t)(psHeader->uKeysUsed - psHeader->uKeysFreed) + 1);
+    if (pcKeys == NULL)
+        return 0;
+    for (uBucket = 0; uBucket < psHeader->uBucketCount; uBucket++) {
+        for (uOffset = oSymTableShared->puBuckets[uBucket]; uOffset != 0;
+                uOffset = psEntry->uNext) {
+            psEntry = SymTableShared_entry(oSymTableShared, uOffset);
+            uKeyBytes = strlen(oSymTableShared->pcBase + psEntry->uKeyOffset) + 1;
+            memcpy(pcKeys + uUsed, oSymTableShared->pcBase + psEntry->uKeyOffset, uKeyBytes);
+            psEntry->uKeyOffset = psHeader->uKeysOffset + uUsed;
+            uUsed += uKeyBytes;
+        }
+    }
+    assert(uUsed == psHeader->uKeysUsed - psHeader->uKeysFreed);
+    memcpy(oSymTableShared->pcBase + psHeader->uKeysOffset, pcKeys, (size_t)uUsed);
+    free(pcKeys);
+    psHeader->uKeysUsed = uUsed;
+    psHeader->uKeysFreed = 0;
+    return 1;
+}
+
+/*
+    SymTableShared_insert is a helper function that adds the key-value pair (pcKey, pvValue) to
+    oSymTableShared, which must not contain pcKey, at the end of the chain whose last link is
+    puLink. uHash must be the hash of pcKey. The caller must hold the lock for writing. Returns 1
+    as type int on success, and 0 if the segment has no room left or there is not enough memory
+    to move its keys down.
+*/
+static int SymTableShared_insert(SymTableShared_T oSymTableShared, uint64_t *puLink,
+    const char *pcKey, uint64_t uHash, const void *pvValue) {
+    struct SharedHeader *psHeader = oSymTableShared->psHeader;
+    size_t uKeyBytes = strlen(pcKey) + 1;
+    uint64_t uOffset;
+    struct SharedEntry *psEntry;
+
+    if (psHeader->uFreeEntry == 0 && psHeader->uEntriesUsed == psHeader->uEntryCapacity)
+        return 0;
+    if (uKeyBytes > psHeader->uKeyCapacity - psHeader->uKeysUsed) {
+        if (uKeyBytes > psHeader->uKeyCapacity - psHeader->uKeysUsed + psHeader->uKeysFreed
+                || !SymTableShared_compact(oSymTableShared))
+            return 0;
+    }
+    if (psHeader->uFreeEntry != 0) {
+        uOffset = psHeader->uFreeEntry;
+        psHeader->uFreeEntry = SymTableShared_entry(oSymTableShared, uOffset)->uNext;
+    }
+    else {
+        uOffset = psHeader->uEntriesOffset
+            + psHeader->uEntriesUsed * sizeof(struct SharedEntry);
+        psHeader->uEntriesUsed++;
+    }
+
+    psEntry = SymTableShared_entry(oSymTableShared, uOffset);
+    psEntry->uNext = 0;
+    psEntry->uHash = uHash;
+    psEntry->uKeyOffset = psHeader->uKeysOffset + psHeader->uKeysUsed;
+    psEntry->pvValue = (void *)pvValue;
+    memcpy(oSymTableShared->pcBase + psEntry->uKeyOffset, pcKey, uKeyBytes);
+    psHeader->uKeysUsed += uKeyBytes;
+    psHeader->uLength++;
+    *puLink = uOffset;
+    return 1;
+}
+
+/*
+    SymTableShared_attach is a helper function that returns a new SymTableShared_T value for the
+    segment of uSize bytes mapped at pvBase, or NULL if there is not enough memory, in which case
+    the segment is unmapped.
+*/
+static SymTableShared_T SymTableShared_attach(void *pvBase, size_t uSize) {
+    SymTableShared_T oSymTableShared;
+
+    oSymTableShared = (SymTableShared_T)malloc(sizeof(struct SymTableShared));
+    if (oSymTableShared == NULL) {
+        munmap(pvBase, uSize);
+        return NULL;
+    }
+    oSymTableShared->pcBase = (char *)pvBase;
+    oSymTableShared->uSize = uSize;
+    oSymTableShared->psHeader = (struct SharedHeader *)pvBase;
+    oSymTableShared->puBuckets = (uint64_t *)(oSymTableShared->pcBase
+        + oSymTableShared->psHeader->uBucketsOffset);
+    return oSymTableShared;
+}
+
+/*
+    SymTableShared_layout is a helper function that fills in the sizes and section offsets of
+    psHeader for a segment with room for uCapacity key-value pairs and uKeyBytes key characters.
+    Returns 1 as type int, or 0 if the segment would be too large to map.
+*/
+static int SymTableShared_layout(struct SharedHeader *psHeader, size_t uCapacity,
+    size_t uKeyBytes) {
+    const size_t uMax = (size_t)-1 / 4;
+    size_t uBucketCount = 1;
+
+    if (uCapacity > uMax / sizeof(struct SharedEntry) || uKeyBytes > uMax)
+        return 0;
+    while (uBucketCount < uCapacity)
+        uBucketCount *= 2;
+
+    psHeader->uBucketCount = uBucketCount;
+    psHeader->uEntryCapacity = uCapacity;
+    psHeader->uKeyCapacity = uKeyBytes;
+    psHeader->uBucketsOffset = sizeof(struct SharedHeader);
+    psHeader->uEntriesOffset = psHeader->uBucketsOffset + uBucketCount * sizeof(uint64_t);
+    psHeader->uKeysOffset = psHeader->uEntriesOffset
+        + uCapacity * sizeof(struct SharedEntry);
+    psHeader->uSize = psHeader->uKeysOffset + uKeyBytes;
+    return 1;
+}
+
+SymTableShared_T SymTableShared_create(const char *pcName, size_t uCapacity,
+    size_t uKeyBytes) {
+    struct SharedHeader sLayout;
+    struct SharedHeader *psHeader;
+    pthread_rwlockattr_t sAttributes;
+    void *pvBase;
+    int iFd;
+
+    assert(pcName != NULL);
+
+    if (!SymTableShared_layout(&sLayout, uCapacity, uKeyBytes))
+        return NULL;
+    iFd = shm_open(pcName, O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (iFd < 0)
+        return NULL;
+    if (ftruncate(iFd, (off_t)sLayout.uSize) != 0) {
+        close(iFd);
+        shm_unlink(pcName);
+        return NULL;
+    }
+    pvBase = mmap(NULL, (size_t)sLayout.uSize, PROT_READ | PROT_WRITE, MAP_SHARED, iFd, 0);
+    close(iFd);
+    if (pvBase == MAP_FAILED) {
+        shm_unlink(pcName);
+        return NULL;
+    }
+
+    /* The segment starts out zeroed, so the buckets are all empty already. */
+    psHeader = (struct SharedHeader *)pvBase;
+    *psHeader = sLayout;
+    psHeader->uSlotSize = sizeof(void *);
+    psHeader->uLength = 0;
+    psHeader->uEntriesUsed = 0;
+    psHeader->uFreeEntry = 0;
+    psHeader->uKeysUsed = 0;
+    psHeader->uKeysFreed = 0;
+    if (pthread_rwlockattr_init(&sAttributes) != 0) {
+        munmap(pvBase, (size_t)sLayout.uSize);
+        shm_unlink(pcName);
+        return NULL;
+    }
+    if (pthread_rwlockattr_setpshared(&sAttributes, PTHREAD_PROCESS_SHARED) != 0
+            || pthread_rwlock_init(&psHeader->sLock, &sAttributes) != 0) {
+        pthread_rwlockattr_destroy(&sAttributes);
+        munmap(pvBase, (size_t)sLayout.uSize);
+        shm_unlink(pcName);
+        return NULL;
+    }
+    pthread_rwlockattr_destroy(&sAttributes);
+    memcpy(psHeader->acMagic, SHARED_MAGIC, sizeof(SHARED_MAGIC));
+
+    return SymTableShared_attach(pvBase, (size_t)sLayout.uSize);
+}
+
+SymTableShared_T SymTableShared_open(const char *pcName) {
+    const struct SharedHeader *psHeader;
+    struct SharedHeader sExpected;
+    struct stat sStat;
+    void *pvBase;
+    size_t uSize;
+    int iFd;
+
+    assert(pcName != NULL);
+
+    iFd = shm_open(pcName, O_RDWR, 0);
+    if (iFd < 0)
+        return NULL;
+    if (fstat(iFd, &sStat) != 0 || (size_t)sStat.st_size < sizeof(struct SharedHeader)) {
+        close(iFd);
+        return NULL;
+    }
+    uSize = (size_t)sStat.st_size;
+    pvBase = mmap(NULL, uSize, PROT_READ | PROT_WRITE, MAP_SHARED, iFd, 0);
+    close(iFd);
+    if (pvBase == MAP_FAILED)
+        return NULL;
+
+    /* Check that the header describes this segment before following any offset in it. */
+    psHeader = (const struct SharedHeader *)pvBase;
+    if (memcmp(psHeader->acMagic, SHARED_MAGIC, sizeof(SHARED_MAGIC)) != 0
+            || psHeader->uSlotSize != sizeof(void *) || psHeader->uSize != uSize
+            || psHeader->uEntryCapacity > (uint64_t)((size_t)-1)
+            || psHeader->uKeyCapacity > (uint64_t)((size_t)-1)
+            || !SymTableShared_layout(&sExpected, (size_t)psHeader->uEntryCapacity,
+                (size_t)psHeader->uKeyCapacity)
+            || sExpected.uSize != uSize
+            || sExpected.uBucketCount != psHeader->uBucketCount
+            || sExpected.uBucketsOffset != psHeader->uBucketsOffset
+            || sExpected.uEntriesOffset != psHeader->uEntriesOffset
+            || sExpected.uKeysOffset != psHeader->uKeysOffset) {
+        munmap(pvBase, uSize);
+        return NULL;
+    }
+    return SymTableShared_attach(pvBase, uSize);
+}
+
+/*
+    SymTableShared_count is the SymTable_map callback used by SymTable_share. It counts the key
+    pcKey in the ShareBuilder pointed to by pvExtra.
+*/
+static void SymTableShared_count(const char *pcKey, void *pvValue, void *pvExtra) {
+    struct ShareBuilder *psBuilder = (struct ShareBuilder *)pvExtra;
+    (void)pvValue;
+    psBuilder->uKeyBytes += strlen(pcKey) + 1;
+    psBuilder->uCount++;
+}
+
+/*
+    SymTableShared_copy is the SymTable_map callback used by SymTable_share. It adds the
+    key-value pair (pcKey, pvValue) to the SymTableShared pointed to by pvExtra, whose segment
+    was sized for every key-value pair and which no other process can have open yet, so no lock
+    is taken.
+*/
+static void SymTableShared_copy(const char *pcKey, void *pvValue, void *pvExtra) {
+    SymTableShared_T oSymTableShared = (SymTableShared_T)pvExtra;
+    uint64_t uHash = SymTableShared_hash(pcKey);
+    int iSuccessful;
+
+    iSuccessful = SymTableShared_insert(oSymTableShared,
+        SymTableShared_find(oSymTableShared, pcKey, uHash), pcKey, uHash, pvValue);
+    assert(iSuccessful);
+    (void)iSuccessful;
+}
+
+SymTableShared_T SymTable_share(SymTable_T oSymTable, const char *pcName) {
+    struct ShareBuilder sBuilder;
+    SymTableShared_T oSymTableShared;
+
+    assert(oSymTable != NULL);
+    assert(pcName != NULL);
+
+    sBuilder.uCount = 0;
+    sBuilder.uKeyBytes = 0;
+    SymTable_map(oSymTable, SymTableShared_count, &sBuilder);
+    oSymTableShared = SymTableShared_create(pcName, sBuilder.uCount, sBuilder.uKeyBytes);
+    if (oSymTableShared == NULL)
+        return NULL;
+    SymTable_map(oSymTable, SymTableShared_copy, oSymTableShared);
+    return oSymTableShared;
+}
+
+void SymTableShared_close(SymTableShared_T oSymTableShared) {
+    assert(oSymTableShared != NULL);
+    munmap(oSymTableShared->pcBase, oSymTableShared->uSize);
+    free(oSymTableShared);
+}
+
+int SymTableShared_unlink(const char *pcName) {
+    assert(pcName != NULL);
+    return shm_unlink(pcName) == 0;
+}
+
+size_t SymTableShared_getLength(SymTableShared_T oSymTableShared) {
+    size_t uLength;
+
+    assert(oSymTableShared != NULL);
+
+    pthread_rwlock_rdlock(&oSymTableShared->psHeader->sLock);
+    uLength = (size_t)oSymTableShared->psHeader->uLength;
+    pthread_rwlock_unlock(&oSymTableShared->psHeader->sLock);
+    return uLength;
+}
+
+int SymTableShared_put(SymTableShared_T oSymTableShared, const char *pcKey,
+    const void *pvValue) {
+    uint64_t uHash;
+    uint64_t *puLink;
+    int iSuccessful = 0;
+
+    assert(oSymTableShared != NULL);
+    assert(pcKey != NULL);
+
+    uHash = SymTableShared_hash(pcKey);
+    pthread_rwlock_wrlock(&oSymTableShared->psHeader->sLock);
+    puLink = SymTableShared_find(oSymTableShared, pcKey, uHash);
+    if (*puLink == 0)
+        iSuccessful = SymTableShared_insert(oSymTableShared, puLink, pcKey, uHash, pvValue);
+    pthread_rwlock_unlock(&oSymTableShared->psHeader->sLock);
+    return iSuccessful;
+}
+
+void *SymTableShared_replace(SymTableShared_T oSymTableShared, const char *pcKey,
+    const void *pvValue) {
+    uint64_t *puLink;
+    struct SharedEntry *psEntry;
+    void *pvOldValue = NULL;
+
+    assert(oSymTableShared != NULL);
+    assert(pcKey != NULL);
+
+    pthread_rwlock_wrlock(&oSymTableShared->psHeader->sLock);
+    puLink = SymTableShared_find(oSymTableShared, pcKey, SymTableShared_hash(pcKey));
+    if (*puLink != 0) {
+        psEntry = SymTableShared_entry(oSymTableShared, *puLink);
+        pvOldValue = psEntry->pvValue;
+        psEntry->pvValue = (void *)pvValue;
+    }
+    pthread_rwlock_unlock(&oSymTableShared->psHeader->sLock);
+    return pvOldValue;
+}
+
+int SymTableShared_contains(SymTableShared_T oSymTableShared, const char *pcKey) {
+    int iFound;
+
+    assert(oSymTableShared != NULL);
+    assert(pcKey != NULL);
+
+    pthread_rwlock_rdlock(&oSymTableShared->psHeader->sLock);
+    iFound = *SymTableShared_find(oSymTableShared, pcKey, SymTableShared_hash(pcKey)) != 0;
+    pthread_rwlock_unlock(&oSymTableShared->psHeader->sLock);
+    return iFound;
+}
+
+void *SymTableShared_get(SymTableShared_T oSymTableShared, const char *pcKey) {
+    uint64_t *puLink;
+    void *pvValue = NULL;
+
+    assert(oSymTableShared != NULL);
+    assert(pcKey != NULL);
+
+    pthread_rwlock_rdlock(&oSymTableShared->psHeader->sLock);
+    puLink = SymTableShared_find(oSymTableShared, pcKey, SymTableShared_hash(pcKey));
+    if (*puLink != 0)
+        pvValue = SymTableShared_entry(oSymTableShared, *puLink)->pvValue;
+    pthread_rwlock_unlock(&oSymTableShared->psHeader->sLock);
+    return pvValue;
+}
+
+void *SymTableShared_remove(SymTableShared_T oSymTableShared, const char *pcKey) {
+    struct SharedHeader *psHeader;
+    uint64_t *puLink;
+    uint64_t uOffset;
+    struct SharedEntry *psEntry;
+    void *pvValue = NULL;
+
+    assert(oSymTableShared != NULL);
+    assert(pcKey != NULL);
+
+    psHeader = oSymTableShared->psHeader;
+    pthread_rwlock_wrlock(&psHeader->sLock);
+    puLink = SymTableShared_find(oSymTableShared, pcKey, SymTableShared_hash(pcKey));
+    uOffset = *puLink;
+    if (uOffset != 0) {
+        psEntry = SymTableShared_entry(oSymTableShared, uOffset);
+        pvValue = psEntry->pvValue;
+        *puLink = psEntry->uNext;
+        psHeader->uKeysFreed += strlen(oSymTableShared->pcBase + psEntry->uKeyOffset) + 1;
+        psEntry->uNext = psHeader->uFreeEntry;
+        psHeader->uFreeEntry = uOffset;
+        psHeader->uLength--;
+    }
+    pthread_rwlock_unlock(&psHeader->sLock);
+    return pvValue;
+}
+
+size_t SymTableShared_memoryUsage(SymTableShared_T oSymTableShared) {
+    assert(oSymTableShared != NULL);
+    return oSymTableShared->uSize;
+}
+
+void SymTableShared_map(SymTableShared_T oSymTableShared,
+    void (*pfApply)(const char *pcKey, void *pvValue, void *pvExtra),
+    const void *pvExtra) {
+    uint64_t uBucket;
+    uint64_t uOffset;
+    struct SharedEntry *psEntry;
+
+    assert(oSymTableShared != NULL);
+    assert(pfApply != NULL);
+
+    pthread_rwlock_rdlock(&oSymTableShared->psHeader->sLock);
+    for (uBucket = 0; uBucket < oSymTableShared->psHeader->uBucketCount; uBucket++) {
+        for (uOffset = oSymTableShared->puBuckets[uBucket]; uOffset != 0;
+                uOffset = psEntry->uNext) {
+            psEntry = SymTableShared_entry(oSymTableShared, uOffset);
+            (*pfApply)(oSymTableShared->pcBase + psEntry->uKeyOffset, psEntry->pvValue,
+                (void *)pvExtra);
+        }
+    }
+    pthread_rwlock_unlock(&oSymTableShared->psHeader->sLock);
+}
@@ -0,0 +1,133 @@
+/*
+    Name: Tharun Kumar Tiruppali Kalidoss
+    File Name: symtableshared.h
+*/
+#include <stddef.h>
+#include "symtable.h"
+#ifndef SYMTABLESHARED_INCLUDED
+#define SYMTABLESHARED_INCLUDED
+
+/*
+   SymTableShared_T is of type struct SymTableShared*, and represents one process's view of a
+   symbol table that lives in a named POSIX shared memory segment, so that any number of
+   processes can use a single copy of it. Its buckets, key-value pairs and keys all live in the
+   segment and refer to each other by offsets from the start of the segment, so each process may
+   map it at a different address. Every operation takes a process-shared read-write lock kept in
+   the segment: lookups from any number of processes run together, and each change runs alone.
+   The segment is sized when it is created and never grows. The values are stored bit for bit,
+   so they are only meaningful to another process if they mean the same there, such as integers
+   cast to void* or addresses mapped before a fork.
+*/
+typedef struct SymTableShared *SymTableShared_T;
+
+/*
+   SymTableShared_create creates the shared memory segment pcName, which must start with '/' and
+   must not already exist, with room for uCapacity key-value pairs whose keys take uKeyBytes
+   characters in all, counting their '\0' characters. Returns a new SymTableShared_T value for
+   the empty table in it, or NULL if the segment cannot be created or mapped or there is not
+   enough memory. Other processes must not open pcName until SymTableShared_create has returned.
+   Takes in parameters pcName of type const char*, uCapacity of type size_t and uKeyBytes of type
+   size_t.
+*/
+SymTableShared_T SymTableShared_create(const char *pcName, size_t uCapacity,
+   size_t uKeyBytes);
+
+/*
+   SymTableShared_open maps the shared memory segment pcName created by SymTableShared_create in
+   this or another process, and returns a new SymTableShared_T value for the table in it, or NULL
+   if the segment cannot be opened or mapped, does not hold a table, or there is not enough
+   memory. Takes in a parameter of type const char* called pcName representing the name of the
+   segment.
+*/
+SymTableShared_T SymTableShared_open(const char *pcName);
+
+/*
+   SymTable_share() creates the shared memory segment pcName as SymTableShared_create does, just
+   large enough for the key-value pairs of oSymTable, and copies them into it. oSymTable itself is
+   not changed. Returns a new SymTableShared_T value, or NULL if the segment cannot be created or
+   there is not enough memory. Takes in parameters oSymTable of type SymTable_T and pcName of
+   type const char*.
+*/
+SymTableShared_T SymTable_share(SymTable_T oSymTable, const char *pcName);
+
+/*
+   SymTableShared_close unmaps the segment of oSymTableShared and frees all memory occupied by
+   oSymTableShared. The segment and the table in it are kept for the other processes and for
+   SymTableShared_open. Returns nothing.
+*/
+void SymTableShared_close(SymTableShared_T oSymTableShared);
+
+/*
+   SymTableShared_unlink removes the name pcName of a shared memory segment. Processes that have
+   the segment open may keep using it, and it is freed when the last of them closes it. Returns
+   1 as type int on success, and 0 if there is no such segment.
+*/
+int SymTableShared_unlink(const char *pcName);
+
+/*
+   SymTableShared_getLength returns the number of key-value pairs in oSymTableShared as type
+   size_t.
+*/
+size_t SymTableShared_getLength(SymTableShared_T oSymTableShared);
+
+/*
+   SymTableShared_put() adds a new key-value pair with a copy of the key pcKey and the value
+   pvValue to oSymTableShared. Returns 1 as type int on success, and 0 if oSymTableShared already
+   contains pcKey, the segment has no room left for the pair or its key, or there is not enough
+   memory to move the keys together. The pairs and key characters of removed keys are reused:
+   when pcKey does not fit after the keys handed out so far, the keys are first moved together
+   under the lock, which takes time linear in their total size. Takes in parameters
+   oSymTableShared of type SymTableShared_T, pcKey of type const char* and pvValue of type
+   const void*.
+*/
+int SymTableShared_put(SymTableShared_T oSymTableShared, const char *pcKey,
+   const void *pvValue);
+
+/*
+   SymTableShared_replace() replaces the value of the key-value pair of oSymTableShared whose key
+   is pcKey with pvValue and returns the old value, or returns NULL and leaves oSymTableShared
+   unchanged if there is no such pair. Takes in parameters oSymTableShared of type
+   SymTableShared_T, pcKey of type const char* and pvValue of type const void*.
+*/
+void *SymTableShared_replace(SymTableShared_T oSymTableShared, const char *pcKey,
+   const void *pvValue);
+
+/*
+   SymTableShared_contains() returns 1 as type int if oSymTableShared contains a key-value pair
+   whose key is pcKey, and returns 0 as type int otherwise. Takes in parameters oSymTableShared
+   of type SymTableShared_T and pcKey of type const char*.
+*/
+int SymTableShared_contains(SymTableShared_T oSymTableShared, const char *pcKey);
+
+/*
+   SymTableShared_get() returns the value as a void* value of the key-value pair within
+   oSymTableShared whose key is pcKey, or NULL if no such key-value pair exists. Takes in
+   parameters oSymTableShared of type SymTableShared_T and pcKey of type const char*.
+*/
+void *SymTableShared_get(SymTableShared_T oSymTableShared, const char *pcKey);
+
+/*
+   SymTableShared_remove() removes the key-value pair of oSymTableShared whose key is pcKey and
+   returns its value, or returns NULL and leaves oSymTableShared unchanged if there is no such
+   pair. Takes in parameters oSymTableShared of type SymTableShared_T and pcKey of type
+   const char*.
+*/
+void *SymTableShared_remove(SymTableShared_T oSymTableShared, const char *pcKey);
+
+/*
+   SymTableShared_memoryUsage() returns the size in bytes of the segment of oSymTableShared, which
+   is shared by every process that has it open, as type size_t.
+*/
+size_t SymTableShared_memoryUsage(SymTableShared_T oSymTableShared);
+
+/*
+   SymTableShared_map() calls (*pfApply)(pcKey, pvValue, pvExtra) for each key-value pair in
+   oSymTableShared, holding the read lock throughout, so pfApply must not change
+   oSymTableShared. The keys passed to pfApply point into the segment. Takes in parameters
+   oSymTableShared of type SymTableShared_T, pfApply of type void (*)(const char*, void*, void*)
+   and pvExtra of type const void*.
+*/
+void SymTableShared_map(SymTableShared_T oSymTableShared,
+   void (*pfApply)(const char *pcKey, void *pvValue, void *pvExtra),
+   const void *pvExtra);
+#endif
@@ -0,0 +1,397 @@
+/*
+    Name: Tharun Kumar Tiruppali Kalidoss
+    File Name: symtabletrace.c
+*/
+#include "symtabletrace.h"
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <assert.h>
+
+/*
+    A trace file is TRACE_MAGIC followed by the records, each of which is the operation as one
+    byte, then the table number, then for the functions that take a key its length and its
+    characters, then the argument and the result. Every number is written as an unsigned LEB128
+    varint: seven bits per byte, low bits first, with the high bit set on every byte but the
+    last. Most records of a trace of short keys therefore take under a dozen bytes plus the key.
+*/
+
+/* TRACE_MAGIC identifies a trace file, including the version of its layout. */
+static const char TRACE_MAGIC[8] = {'S', 'Y', 'M', 'T', 'R', 'C', '0', '1'};
+
+/* TRACE_BUFFER_SIZE is the size of the stdio buffer of a trace being recorded. */
+enum {TRACE_BUFFER_SIZE = 65536};
+
+/* MAX_VARINT_LENGTH is the number of bytes of the longest varint, that of a 64-bit number. */
+enum {MAX_VARINT_LENGTH = 10};
+
+/* MIN_TABLE_SLOTS is the number of slots that the hash of traced tables starts with. */
+enum {MIN_TABLE_SLOTS = 16};
+
+/*
+    TracedTable pairs a table seen by the trace being recorded with its number.
+*/
+struct TracedTable
+{
+    /* pvTable is the address of the table, or NULL for an empty slot. */
+   const void *pvTable;
+    /* uNumber is its number in the trace. */
+   size_t uNumber;
+};
+
+/*
+    SymTableTrace is a trace file read into memory.
+*/
+struct SymTableTrace
+{
+    /* pucData holds the uSize bytes of the file, and uPosition is the offset of the next
+        record. */
+   unsigned char *pucData;
+   size_t uSize;
+   size_t uPosition;
+    /* iDamaged is 1 once a record has been found cut short or damaged. */
+   int iDamaged;
+};
+
+/* psTraceFile is the trace being recorded, or NULL if there is none, pcTraceBuffer is its
+   stdio buffer, and iTraceFailed is 1 if a write to it has failed. */
+static FILE *psTraceFile = NULL;
+static char *pcTraceBuffer = NULL;
+static int iTraceFailed = 0;
+
+/* psTables is a hash of the uTableCount live tables that the trace being recorded has
+   numbered, keyed by address with linear probing in uTableCapacity slots, a power of two that
+   is kept at least twice uTableCount so that every traced call finds its table in a probe or
+   two however many tables are live. uNextTable is the number of the next table it sees. */
+static struct TracedTable *psTables = NULL;
+static size_t uTableCount = 0;
+static size_t uTableCapacity = 0;
+static size_t uNextTable = 1;
+
+/* OP_NAMES holds the name of each operation, indexed by SymTableTrace_Op. */
+static const char *const OP_NAMES[SYMTABLETRACE_OP_COUNT] =
+{
+   "?", "new", "newWithCapacity", "reserve", "free", "getLength", "put", "putBorrowed",
+   "replace", "upsert", "putN", "replaceN", "upsertN", "containsN", "getN", "removeN",
+   "contains", "get", "remove", "map", "clone", "clear", "newWithAllocator", "newBounded",
+   "fromArrays", "fromArraysPair", "merge", "snapshot", "pushScope", "popScope", "openMapped",
+   "openLogged", "enableFilter", "enableCache", "setLogBatch", "syncLog", "checkpoint"
+};
+
+/*
+    SymTableTrace_isKeyed is a helper function that returns 1 as type int if the records of eOp
+    hold a key, and 0 otherwise.
+*/
+static int SymTableTrace_isKeyed(SymTableTrace_Op eOp) {
+    switch (eOp) {
+        case SYMTABLETRACE_PUT: case SYMTABLETRACE_PUTBORROWED: case SYMTABLETRACE_REPLACE:
+        case SYMTABLETRACE_UPSERT: case SYMTABLETRACE_PUTN: case SYMTABLETRACE_REPLACEN:
+        case SYMTABLETRACE_UPSERTN: case SYMTABLETRACE_CONTAINSN: case SYMTABLETRACE_GETN:
+        case SYMTABLETRACE_REMOVEN: case SYMTABLETRACE_CONTAINS: case SYMTABLETRACE_GET:
+        case SYMTABLETRACE_REMOVE: case SYMTABLETRACE_FROMARRAYSPAIR:
+        case SYMTABLETRACE_OPENMAPPED: case SYMTABLETRACE_OPENLOGGED:
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+/*
+    SymTableTrace_putVarint is a helper function that writes uValue as a varint to the trace being
+    recorded.
+*/
+static void SymTableTrace_putVarint(uint64_t uValue) {
+    while (uValue >= 0x80) {
+        putc((int)((uValue & 0x7F) | 0x80), psTraceFile);
+        uValue >>= 7;
+    }
+    putc((int)uValue, psTraceFile);
+}
+
+/*
+    SymTableTrace_getVarint is a helper function that reads a varint of oTrace into *puValue.
+    Returns 1 as type int on success, and 0 if it runs past the end of the trace or is too long.
+*/
+static int SymTableTrace_getVarint(SymTableTrace_T oTrace, uint64_t *puValue) {
+    uint64_t uValue = 0;
+    unsigned char ucByte;
+    int i;
+
+    for (i = 0; i < MAX_VARINT_LENGTH; i++) {
+        if (oTrace->uPosition >= oTrace->uSize)
+            return 0;
+        ucByte = oTrace->pucData[oTrace->uPosition++];
+        uValue |= (uint64_t)(ucByte & 0x7F) << (7 * i);
+        if ((ucByte & 0x80) == 0) {
+            *puValue = uValue;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/*
+    SymTableTrace_getSize is SymTableTrace_getVarint for a number that must fit in a size_t.
+*/
+static int SymTableTrace_getSize(SymTableTrace_T oTrace, size_t *puValue) {
+    uint64_t uValue;
+    if (!SymTableTrace_getVarint(oTrace, &uValue) || uValue > (uint64_t)((size_t)-1))
+        return 0;
+    *puValue = (size_t)uValue;
+    return 1;
+}
+
+/*
+    SymTableTrace_slot is a helper function that returns the slot of psTables at which the probe
+    for pvTable starts.
+*/
+static size_t SymTableTrace_slot(const void *pvTable) {
+    size_t uHash = (size_t)((uintptr_t)pvTable >> 4) * (size_t)2654435761U;
+    return (uHash ^ (uHash >> 16)) & (uTableCapacity - 1);
+}
+
+/*
+    SymTableTrace_grow is a helper function that doubles the slots of psTables, or makes its
+    first ones, and rehashes its tables into them. Returns 1 as type int on success, and 0 if
+    there is not enough memory, in which case psTables is unchanged.
+*/
+static int SymTableTrace_grow(void) {
+    struct TracedTable *psOldTables = psTables;
+    size_t uOldCapacity = uTableCapacity;
+    size_t uCapacity = uTableCapacity == 0 ? MIN_TABLE_SLOTS : 2 * uTableCapacity;
+    size_t uSlot;
+    size_t u;
+
+    psTables = (struct TracedTable *)calloc(uCapacity, sizeof(struct TracedTable));
+    if (psTables == NULL) {
+        psTables = psOldTables;
+        return 0;
+    }
+    uTableCapacity = uCapacity;
+    for (u = 0; u < uOldCapacity; u++) {
+        if (psOldTables[u].pvTable == NULL)
+            continue;
+        uSlot = SymTableTrace_slot(psOldTables[u].pvTable);
+        while (psTables[uSlot].pvTable != NULL)
+            uSlot = (uSlot + 1) & (uTableCapacity - 1);
+        psTables[uSlot] = psOldTables[u];
+    }
+    free(psOldTables);
+    return 1;
+}
+
+/*
+    SymTableTrace_forgetAll is a helper function that forgets every table numbered by the trace
+    and starts numbering from 1 again.
+*/
+static void SymTableTrace_forgetAll(void) {
+    free(psTables);
+    psTables = NULL;
+    uTableCount = 0;
+    uTableCapacity = 0;
+    uNextTable = 1;
+}
+
+int SymTableTrace_start(const char *pcPath) {
+    assert(pcPath != NULL);
+
+    if (psTraceFile != NULL)
+        (void)SymTableTrace_stop();
+    pcTraceBuffer = (char *)malloc(TRACE_BUFFER_SIZE);
+    if (pcTraceBuffer == NULL)
+        return 0;
+    psTraceFile = fopen(pcPath, "wb");
+    if (psTraceFile == NULL) {
+        free(pcTraceBuffer);
+        pcTraceBuffer = NULL;
+        return 0;
+    }
+    setvbuf(psTraceFile, pcTraceBuffer, _IOFBF, TRACE_BUFFER_SIZE);
+    iTraceFailed = fwrite(TRACE_MAGIC, sizeof(TRACE_MAGIC), 1, psTraceFile) != 1;
+    SymTableTrace_forgetAll();
+    return 1;
+}
+
+int SymTableTrace_stop(void) {
+    int iSuccessful;
+
+    if (psTraceFile == NULL)
+        return 0;
+    iSuccessful = !iTraceFailed && !ferror(psTraceFile);
+    if (fclose(psTraceFile) != 0)
+        iSuccessful = 0;
+    psTraceFile = NULL;
+    free(pcTraceBuffer);
+    pcTraceBuffer = NULL;
+    SymTableTrace_forgetAll();
+    return iSuccessful;
+}
+
+int SymTableTrace_isRecording(void) {
+    return psTraceFile != NULL;
+}
+
+size_t SymTableTrace_tableNumber(const void *pvTable) {
+    size_t uSlot;
+
+    if (pvTable == NULL || psTraceFile == NULL)
+        return 0;
+
+    if (uTableCapacity != 0) {
+        for (uSlot = SymTableTrace_slot(pvTable); psTables[uSlot].pvTable != NULL;
+                uSlot = (uSlot + 1) & (uTableCapacity - 1)) {
+            if (psTables[uSlot].pvTable == pvTable)
+                return psTables[uSlot].uNumber;
+        }
+    }
+    if (2 * (uTableCount + 1) > uTableCapacity && !SymTableTrace_grow())
+        return 0;
+    uSlot = SymTableTrace_slot(pvTable);
+    while (psTables[uSlot].pvTable != NULL)
+        uSlot = (uSlot + 1) & (uTableCapacity - 1);
+    psTables[uSlot].pvTable = pvTable;
+    psTables[uSlot].uNumber = uNextTable++;
+    uTableCount++;
+    return psTables[uSlot].uNumber;
+}
+
+void SymTableTrace_forgetTable(const void *pvTable) {
+    size_t uMask = uTableCapacity - 1;
+    size_t uSlot;
+    size_t uNext;
+    size_t uHome;
+
+    if (pvTable == NULL || uTableCount == 0)
+        return;
+    for (uSlot = SymTableTrace_slot(pvTable); psTables[uSlot].pvTable != pvTable;
+            uSlot = (uSlot + 1) & uMask) {
+        if (psTables[uSlot].pvTable == NULL)
+            return;
+    }
+    /* The tables probed past the freed slot are shifted back into it, so that no probe stops
+       early at the hole. A table moves unless its probe starts cyclically after the hole and no
+       later than where it sits. */
+    uNext = uSlot;
+    for (;;) {
+        uNext = (uNext + 1) & uMask;
+        if (psTables[uNext].pvTable == NULL)
+            break;
+        uHome = SymTableTrace_slot(psTables[uNext].pvTable);
+        if (((uNext - uHome) & uMask) >= ((uNext - uSlot) & uMask)) {
+            psTables[uSlot] = psTables[uNext];
+            uSlot = uNext;
+        }
+    }
+    psTables[uSlot].pvTable = NULL;
+    uTableCount--;
+}
+
+void SymTableTrace_write(const SymTableTrace_Record *psRecord) {
+    assert(psRecord != NULL);
+
+    if (psTraceFile == NULL)
+        return;
+    putc((int)psRecord->eOp, psTraceFile);
+    SymTableTrace_putVarint(psRecord->uTable);
+    if (SymTableTrace_isKeyed(psRecord->eOp)) {
+        SymTableTrace_putVarint(psRecord->uKeyLength);
+        if (psRecord->uKeyLength > 0
+                && fwrite(psRecord->pcKey, psRecord->uKeyLength, 1, psTraceFile) != 1)
+            iTraceFailed = 1;
+    }
+    SymTableTrace_putVarint(psRecord->uArgument);
+    SymTableTrace_putVarint(psRecord->uResult);
+}
+
+SymTableTrace_T SymTableTrace_open(const char *pcPath) {
+    SymTableTrace_T oTrace;
+    FILE *psFile;
+    long lSize;
+
+    assert(pcPath != NULL);
+
+    psFile = fopen(pcPath, "rb");
+    if (psFile == NULL)
+        return NULL;
+    if (fseek(psFile, 0, SEEK_END) != 0 || (lSize = ftell(psFile)) < (long)sizeof(TRACE_MAGIC)
+            || fseek(psFile, 0, SEEK_SET) != 0) {
+        fclose(psFile);
+        return NULL;
+    }
+    oTrace = (SymTableTrace_T)malloc(sizeof(struct SymTableTrace));
+    if (oTrace == NULL) {
+        fclose(psFile);
+        return NULL;
+    }
+    oTrace->uSize = (size_t)lSize;
+    oTrace->pucData = (unsigned char *)malloc(oTrace->uSize);
+    if (oTrace->pucData == NULL
+            || fread(oTrace->pucData, 1, oTrace->uSize, psFile) != oTrace->uSize
+            || memcmp(oTrace->pucData, TRACE_MAGIC, sizeof(TRACE_MAGIC)) != 0) {
+        fclose(psFile);
+        free(oTrace->pucData);
+        free(oTrace);
+        return NULL;
+    }
+    fclose(psFile);
+    oTrace->uPosition = sizeof(TRACE_MAGIC);
+    oTrace->iDamaged = 0;
+    return oTrace;
+}
+
+/*
+    SymTableTrace_read is a helper function that reads the record of oTrace at its current
+    position into *psRecord, as SymTableTrace_next does.
+*/
+static int SymTableTrace_read(SymTableTrace_T oTrace, SymTableTrace_Record *psRecord) {
+    unsigned char ucOp;
+
+    if (oTrace->uPosition == oTrace->uSize)
+        return 0;
+    ucOp = oTrace->pucData[oTrace->uPosition++];
+    if (ucOp < SYMTABLETRACE_NEW || ucOp >= SYMTABLETRACE_OP_COUNT)
+        return -1;
+    psRecord->eOp = (SymTableTrace_Op)ucOp;
+    if (!SymTableTrace_getSize(oTrace, &psRecord->uTable))
+        return -1;
+    psRecord->pcKey = NULL;
+    psRecord->uKeyLength = 0;
+    if (SymTableTrace_isKeyed(psRecord->eOp)) {
+        if (!SymTableTrace_getSize(oTrace, &psRecord->uKeyLength)
+                || psRecord->uKeyLength > oTrace->uSize - oTrace->uPosition)
+            return -1;
+        psRecord->pcKey = (const char *)oTrace->pucData + oTrace->uPosition;
+        oTrace->uPosition += psRecord->uKeyLength;
+    }
+    if (!SymTableTrace_getSize(oTrace, &psRecord->uArgument)
+            || !SymTableTrace_getSize(oTrace, &psRecord->uResult))
+        return -1;
+    return 1;
+}
+
+int SymTableTrace_next(SymTableTrace_T oTrace, SymTableTrace_Record *psRecord) {
+    int iStatus;
+
+    assert(oTrace != NULL);
+    assert(psRecord != NULL);
+
+    if (oTrace->iDamaged)
+        return -1;
+    iStatus = SymTableTrace_read(oTrace, psRecord);
+    if (iStatus < 0)
+        oTrace->iDamaged = 1;
+    return iStatus;
+}
+
+void SymTableTrace_close(SymTableTrace_T oTrace) {
+    assert(oTrace != NULL);
+    free(oTrace->pucData);
+    free(oTrace);
+}
+
+const char *SymTableTrace_opName(SymTableTrace_Op eOp) {
+    if (eOp < SYMTABLETRACE_NEW || eOp >= SYMTABLETRACE_OP_COUNT)
+        return OP_NAMES[0];
+    return OP_NAMES[eOp];
+}
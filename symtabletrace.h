@@ -0,0 +1,151 @@
+/*
+    Name: Tharun Kumar Tiruppali Kalidoss
+    File Name: symtabletrace.h
+*/
+#include <stddef.h>
+#ifndef SYMTABLETRACE_INCLUDED
+#define SYMTABLETRACE_INCLUDED
+
+/*
+   A trace is a compact binary file holding one record for every call that a program made to the
+   SymTable functions while tracing was on. The calls are recorded by the tracing layer in
+   symtabletracer.c, which a program enables by linking with it and with -Wl,--wrap for each
+   traced function (TRACEFLAGS in the makefile), and by calling SymTableTrace_start. No source
+   file of the program or of the SymTable implementations changes. replaysymtable replays a
+   trace against the implementation it is linked with.
+*/
+
+/*
+   SymTableTrace_Op identifies the SymTable function whose call a record describes. Only these
+   functions are traced; a table made by any other function is given a number the first time a
+   traced function is called on it, and replaysymtable makes it up with SymTable_new and reports
+   the calls made on it. The calls that SymTable_openLogged, SymTable_save and
+   SymTable_checkpoint make themselves are not recorded. SymTable_save, SymTable_getStats and
+   SymTable_memoryUsage are not traced at all: the first would make the replay write files and
+   the others change nothing. SYMTABLETRACE_FROMARRAYSPAIR is not a function: one such record
+   follows a SYMTABLETRACE_FROMARRAYS record for each pair passed.
+*/
+typedef enum {SYMTABLETRACE_NEW = 1, SYMTABLETRACE_NEWWITHCAPACITY, SYMTABLETRACE_RESERVE,
+   SYMTABLETRACE_FREE, SYMTABLETRACE_GETLENGTH, SYMTABLETRACE_PUT, SYMTABLETRACE_PUTBORROWED,
+   SYMTABLETRACE_REPLACE, SYMTABLETRACE_UPSERT, SYMTABLETRACE_PUTN, SYMTABLETRACE_REPLACEN,
+   SYMTABLETRACE_UPSERTN, SYMTABLETRACE_CONTAINSN, SYMTABLETRACE_GETN, SYMTABLETRACE_REMOVEN,
+   SYMTABLETRACE_CONTAINS, SYMTABLETRACE_GET, SYMTABLETRACE_REMOVE, SYMTABLETRACE_MAP,
+   SYMTABLETRACE_CLONE, SYMTABLETRACE_CLEAR, SYMTABLETRACE_NEWWITHALLOCATOR,
+   SYMTABLETRACE_NEWBOUNDED, SYMTABLETRACE_FROMARRAYS, SYMTABLETRACE_FROMARRAYSPAIR,
+   SYMTABLETRACE_MERGE, SYMTABLETRACE_SNAPSHOT, SYMTABLETRACE_PUSHSCOPE, SYMTABLETRACE_POPSCOPE,
+   SYMTABLETRACE_OPENMAPPED, SYMTABLETRACE_OPENLOGGED, SYMTABLETRACE_ENABLEFILTER,
+   SYMTABLETRACE_ENABLECACHE, SYMTABLETRACE_SETLOGBATCH, SYMTABLETRACE_SYNCLOG,
+   SYMTABLETRACE_CHECKPOINT, SYMTABLETRACE_OP_COUNT} SymTableTrace_Op;
+
+/*
+   SymTableTrace_Record describes one traced call. Tables are numbered from 1 in the order in
+   which the trace first sees them, and a number is not reused after the table is freed. The
+   value pointers of the program are not recorded, since they mean nothing to another process;
+   only whether each one was NULL is.
+*/
+typedef struct
+{
+   /* eOp is the function that was called. */
+   SymTableTrace_Op eOp;
+   /* uTable is the number of the table it was called on, or of the table it returned for the
+      functions that make a table other than SymTable_clone and SymTable_snapshot, where 0
+      means that it returned NULL. */
+   size_t uTable;
+   /* pcKey points to the uKeyLength characters of the key, which are not NUL-terminated, the
+      path passed to SymTable_openMapped or SymTable_openLogged, or is NULL for the functions
+      that take no key. */
+   const char *pcKey;
+   size_t uKeyLength;
+   /* uArgument is 1 if the value passed to a put or replace function or with a pair to
+      SymTable_fromArrays was not NULL and 0 if it was, the capacity passed to
+      SymTable_newWithCapacity or SymTable_reserve, the bound passed to SymTable_newBounded, the
+      number of records per sync passed to SymTable_setLogBatch, the
+      number of pairs passed to SymTable_fromArrays, the number of the table returned by
+      SymTable_clone or SymTable_snapshot, twice the number of the table merged from plus 1 if
+      a combine function was passed to SymTable_merge, or 0. */
+   size_t uArgument;
+   /* uResult is the int returned by a function returning int, the length returned by
+      SymTable_getLength, 1 if the pointer returned by any other function was not NULL and 0 if
+      it was, for an upsert 0 if it failed, 1 if the key was found and 2 if it was inserted,
+      or 0 for the functions returning nothing. */
+   size_t uResult;
+} SymTableTrace_Record;
+
+/*
+   SymTableTrace_T is of type struct SymTableTrace*, and represents a trace file opened for
+   reading.
+*/
+typedef struct SymTableTrace *SymTableTrace_T;
+
+/*
+   SymTableTrace_start creates or truncates the trace file pcPath and starts recording traced
+   calls into it, numbering tables afresh. A trace that is already being recorded is stopped
+   first. Returns 1 as type int on success, and 0 if the file cannot be created or there is not
+   enough memory, in which case nothing is recorded. Takes in a parameter of type const char*
+   called pcPath representing the name of the trace file.
+*/
+int SymTableTrace_start(const char *pcPath);
+
+/*
+   SymTableTrace_stop stops recording and closes the trace file. Returns 1 as type int if every
+   record was written, and 0 if a write failed or no trace was being recorded.
+*/
+int SymTableTrace_stop(void);
+
+/*
+   SymTableTrace_isRecording returns 1 as type int if a trace is being recorded, and 0
+   otherwise.
+*/
+int SymTableTrace_isRecording(void);
+
+/*
+   SymTableTrace_tableNumber returns the number of the table pvTable in the trace being recorded
+   as type size_t, giving it the next number if the trace has not seen it before, or 0 if pvTable
+   is NULL, no trace is being recorded or there is not enough memory. Takes in a parameter of
+   type const void* called pvTable.
+*/
+size_t SymTableTrace_tableNumber(const void *pvTable);
+
+/*
+   SymTableTrace_forgetTable tells the trace that pvTable has been freed, so that a table later
+   made at the same address gets a number of its own. It must be called for every freed table,
+   whether or not a trace is being recorded. Takes in a parameter of type const void* called
+   pvTable. Returns nothing.
+*/
+void SymTableTrace_forgetTable(const void *pvTable);
+
+/*
+   SymTableTrace_write appends the record *psRecord to the trace being recorded, and does nothing
+   if no trace is being recorded. Takes in a parameter of type const SymTableTrace_Record*
+   called psRecord. Returns nothing.
+*/
+void SymTableTrace_write(const SymTableTrace_Record *psRecord);
+
+/*
+   SymTableTrace_open reads the trace file pcPath into memory and returns a SymTableTrace_T for
+   reading its records, or NULL if the file cannot be read, is not a trace, or there is not
+   enough memory. Takes in a parameter of type const char* called pcPath representing the name
+   of the trace file.
+*/
+SymTableTrace_T SymTableTrace_open(const char *pcPath);
+
+/*
+   SymTableTrace_next stores the next record of oTrace in *psRecord. The key of the record points
+   into oTrace and stays valid until oTrace is closed. Returns 1 as type int if a record was
+   stored, 0 at the end of the trace, and -1 if the rest of the trace is cut short or damaged.
+   Takes in parameters oTrace of type SymTableTrace_T and psRecord of type SymTableTrace_Record*.
+*/
+int SymTableTrace_next(SymTableTrace_T oTrace, SymTableTrace_Record *psRecord);
+
+/*
+   SymTableTrace_close frees all memory occupied by oTrace. Returns nothing.
+*/
+void SymTableTrace_close(SymTableTrace_T oTrace);
+
+/*
+   SymTableTrace_opName returns the name of the SymTable function that eOp identifies, such as
+   "put" for SYMTABLETRACE_PUT, as type const char*. Takes in a parameter of type
+   SymTableTrace_Op called eOp.
+*/
+const char *SymTableTrace_opName(SymTableTrace_Op eOp);
+#endif
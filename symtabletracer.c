@@ -0,0 +1,448 @@
+/*
+    Name: Tharun Kumar Tiruppali Kalidoss
+    File Name: symtabletracer.c
+*/
+#include "symtable.h"
+#include "symtabletrace.h"
+#include <string.h>
+#include <stddef.h>
+
+/*
+    The tracing layer. Linking a program with -Wl,--wrap=SymTable_put (and so on for each traced
+    function, as TRACEFLAGS in the makefile does) makes every call of SymTable_put in the
+    program's object files call __wrap_SymTable_put below instead, which calls the real
+    SymTable_put as __real_SymTable_put and records the call if a trace is being recorded. Calls
+    that a SymTable implementation makes to its own functions are not wrapped, but those that
+    symtablelog.c and symtableimage.c make are, so SymTable_openLogged, SymTable_save and
+    SymTable_checkpoint record nothing while they run; only the program's calls are recorded.
+    SymTable_save is wrapped for that alone and is not recorded itself. Calls made while no trace is being recorded cost one extra function call
+    and a test, except SymTable_free, which also tells the trace that the table is gone.
+*/
+
+/* uNesting is the number of calls of SymTable_openLogged, SymTable_save and SymTable_checkpoint
+   that are running, during which the calls they make are not recorded. */
+static size_t uNesting = 0;
+
+SymTable_T __real_SymTable_new(void);
+SymTable_T __real_SymTable_newWithCapacity(size_t uCapacity);
+int __real_SymTable_reserve(SymTable_T oSymTable, size_t uCapacity);
+void __real_SymTable_free(SymTable_T oSymTable);
+size_t __real_SymTable_getLength(SymTable_T oSymTable);
+int __real_SymTable_put(SymTable_T oSymTable, const char *pcKey, const void *pvValue);
+int __real_SymTable_putBorrowed(SymTable_T oSymTable, const char *pcKey, const void *pvValue);
+void *__real_SymTable_replace(SymTable_T oSymTable, const char *pcKey, const void *pvValue);
+void **__real_SymTable_upsert(SymTable_T oSymTable, const char *pcKey, int *piInserted);
+int __real_SymTable_putN(SymTable_T oSymTable, const char *pcKey, size_t uLength,
+    const void *pvValue);
+void *__real_SymTable_replaceN(SymTable_T oSymTable, const char *pcKey, size_t uLength,
+    const void *pvValue);
+void **__real_SymTable_upsertN(SymTable_T oSymTable, const char *pcKey, size_t uLength,
+    int *piInserted);
+int __real_SymTable_containsN(SymTable_T oSymTable, const char *pcKey, size_t uLength);
+void *__real_SymTable_getN(SymTable_T oSymTable, const char *pcKey, size_t uLength);
+void *__real_SymTable_removeN(SymTable_T oSymTable, const char *pcKey, size_t uLength);
+int __real_SymTable_contains(SymTable_T oSymTable, const char *pcKey);
+void *__real_SymTable_get(SymTable_T oSymTable, const char *pcKey);
+void *__real_SymTable_remove(SymTable_T oSymTable, const char *pcKey);
+void __real_SymTable_map(SymTable_T oSymTable,
+    void (*pfApply)(const char *pcKey, void *pvValue, void *pvExtra), const void *pvExtra);
+SymTable_T __real_SymTable_clone(SymTable_T oSymTable);
+void __real_SymTable_clear(SymTable_T oSymTable);
+SymTable_T __real_SymTable_newWithAllocator(const SymTable_Allocator *psAllocator);
+SymTable_T __real_SymTable_newBounded(size_t uMaxEntries,
+    void (*pfEvict)(const char *pcKey, void *pvValue, void *pvExtra), const void *pvExtra);
+SymTable_T __real_SymTable_fromArrays(const char *const *apcKeys, const void *const *apvValues,
+    size_t uCount);
+int __real_SymTable_merge(SymTable_T oDst, SymTable_T oSrc,
+    void *(*pfCombine)(const char *pcKey, void *pvDstValue, void *pvSrcValue, void *pvExtra),
+    const void *pvExtra);
+SymTable_T __real_SymTable_snapshot(SymTable_T oSymTable);
+int __real_SymTable_pushScope(SymTable_T oSymTable);
+int __real_SymTable_popScope(SymTable_T oSymTable);
+SymTable_T __real_SymTable_openMapped(const char *pcPath);
+SymTable_T __real_SymTable_openLogged(const char *pcPath);
+int __real_SymTable_save(SymTable_T oSymTable, const char *pcPath);
+int __real_SymTable_checkpoint(SymTable_T oSymTable);
+int __real_SymTable_enableFilter(SymTable_T oSymTable);
+int __real_SymTable_enableCache(SymTable_T oSymTable);
+int __real_SymTable_setLogBatch(SymTable_T oSymTable, size_t uRecords);
+int __real_SymTable_syncLog(SymTable_T oSymTable);
+
+SymTable_T __wrap_SymTable_new(void);
+SymTable_T __wrap_SymTable_newWithCapacity(size_t uCapacity);
+int __wrap_SymTable_reserve(SymTable_T oSymTable, size_t uCapacity);
+void __wrap_SymTable_free(SymTable_T oSymTable);
+size_t __wrap_SymTable_getLength(SymTable_T oSymTable);
+int __wrap_SymTable_put(SymTable_T oSymTable, const char *pcKey, const void *pvValue);
+int __wrap_SymTable_putBorrowed(SymTable_T oSymTable, const char *pcKey, const void *pvValue);
+void *__wrap_SymTable_replace(SymTable_T oSymTable, const char *pcKey, const void *pvValue);
+void **__wrap_SymTable_upsert(SymTable_T oSymTable, const char *pcKey, int *piInserted);
+int __wrap_SymTable_putN(SymTable_T oSymTable, const char *pcKey, size_t uLength,
+    const void *pvValue);
+void *__wrap_SymTable_replaceN(SymTable_T oSymTable, const char *pcKey, size_t uLength,
+    const void *pvValue);
+void **__wrap_SymTable_upsertN(SymTable_T oSymTable, const char *pcKey, size_t uLength,
+    int *piInserted);
+int __wrap_SymTable_containsN(SymTable_T oSymTable, const char *pcKey, size_t uLength);
+void *__wrap_SymTable_getN(SymTable_T oSymTable, const char *pcKey, size_t uLength);
+void *__wrap_SymTable_removeN(SymTable_T oSymTable, const char *pcKey, size_t uLength);
+int __wrap_SymTable_contains(SymTable_T oSymTable, const char *pcKey);
+void *__wrap_SymTable_get(SymTable_T oSymTable, const char *pcKey);
+void *__wrap_SymTable_remove(SymTable_T oSymTable, const char *pcKey);
+void __wrap_SymTable_map(SymTable_T oSymTable,
+    void (*pfApply)(const char *pcKey, void *pvValue, void *pvExtra), const void *pvExtra);
+SymTable_T __wrap_SymTable_clone(SymTable_T oSymTable);
+void __wrap_SymTable_clear(SymTable_T oSymTable);
+SymTable_T __wrap_SymTable_newWithAllocator(const SymTable_Allocator *psAllocator);
+SymTable_T __wrap_SymTable_newBounded(size_t uMaxEntries,
+    void (*pfEvict)(const char *pcKey, void *pvValue, void *pvExtra), const void *pvExtra);
+SymTable_T __wrap_SymTable_fromArrays(const char *const *apcKeys, const void *const *apvValues,
+    size_t uCount);
+int __wrap_SymTable_merge(SymTable_T oDst, SymTable_T oSrc,
+    void *(*pfCombine)(const char *pcKey, void *pvDstValue, void *pvSrcValue, void *pvExtra),
+    const void *pvExtra);
+SymTable_T __wrap_SymTable_snapshot(SymTable_T oSymTable);
+int __wrap_SymTable_pushScope(SymTable_T oSymTable);
+int __wrap_SymTable_popScope(SymTable_T oSymTable);
+SymTable_T __wrap_SymTable_openMapped(const char *pcPath);
+SymTable_T __wrap_SymTable_openLogged(const char *pcPath);
+int __wrap_SymTable_save(SymTable_T oSymTable, const char *pcPath);
+int __wrap_SymTable_checkpoint(SymTable_T oSymTable);
+int __wrap_SymTable_enableFilter(SymTable_T oSymTable);
+int __wrap_SymTable_enableCache(SymTable_T oSymTable);
+int __wrap_SymTable_setLogBatch(SymTable_T oSymTable, size_t uRecords);
+int __wrap_SymTable_syncLog(SymTable_T oSymTable);
+
+/*
+    SymTableTracer_isRecording is a helper function that returns 1 as type int if the call being
+    wrapped is to be recorded, and 0 otherwise.
+*/
+static int SymTableTracer_isRecording(void) {
+    return uNesting == 0 && SymTableTrace_isRecording();
+}
+
+/*
+    SymTableTracer_record is a helper function that records a call of eOp on oSymTable with the
+    key made of the uLength characters at pcKey (NULL for none), the argument uArgument and the
+    result uResult. The caller must have checked that a trace is being recorded.
+*/
+static void SymTableTracer_record(SymTableTrace_Op eOp, SymTable_T oSymTable,
+    const char *pcKey, size_t uLength, size_t uArgument, size_t uResult) {
+    SymTableTrace_Record sRecord;
+
+    sRecord.eOp = eOp;
+    sRecord.uTable = SymTableTrace_tableNumber(oSymTable);
+    sRecord.pcKey = pcKey;
+    sRecord.uKeyLength = uLength;
+    sRecord.uArgument = uArgument;
+    sRecord.uResult = uResult;
+    SymTableTrace_write(&sRecord);
+}
+
+/*
+    SymTableTracer_upsertResult is a helper function that returns the result recorded for an
+    upsert that returned ppvSlot and stored *piInserted.
+*/
+static size_t SymTableTracer_upsertResult(void **ppvSlot, const int *piInserted) {
+    if (ppvSlot == NULL)
+        return 0;
+    return *piInserted ? 2 : 1;
+}
+
+SymTable_T __wrap_SymTable_new(void) {
+    SymTable_T oSymTable = __real_SymTable_new();
+    if (SymTableTracer_isRecording())
+        SymTableTracer_record(SYMTABLETRACE_NEW, oSymTable, NULL, 0, 0, oSymTable != NULL);
+    return oSymTable;
+}
+
+SymTable_T __wrap_SymTable_newWithCapacity(size_t uCapacity) {
+    SymTable_T oSymTable = __real_SymTable_newWithCapacity(uCapacity);
+    if (SymTableTracer_isRecording())
+        SymTableTracer_record(SYMTABLETRACE_NEWWITHCAPACITY, oSymTable, NULL, 0, uCapacity,
+            oSymTable != NULL);
+    return oSymTable;
+}
+
+int __wrap_SymTable_reserve(SymTable_T oSymTable, size_t uCapacity) {
+    int iResult = __real_SymTable_reserve(oSymTable, uCapacity);
+    if (SymTableTracer_isRecording())
+        SymTableTracer_record(SYMTABLETRACE_RESERVE, oSymTable, NULL, 0, uCapacity,
+            (size_t)iResult);
+    return iResult;
+}
+
+void __wrap_SymTable_free(SymTable_T oSymTable) {
+    if (SymTableTracer_isRecording() && oSymTable != NULL)
+        SymTableTracer_record(SYMTABLETRACE_FREE, oSymTable, NULL, 0, 0, 0);
+    SymTableTrace_forgetTable(oSymTable);
+    __real_SymTable_free(oSymTable);
+}
+
+size_t __wrap_SymTable_getLength(SymTable_T oSymTable) {
+    size_t uLength = __real_SymTable_getLength(oSymTable);
+    if (SymTableTracer_isRecording())
+        SymTableTracer_record(SYMTABLETRACE_GETLENGTH, oSymTable, NULL, 0, 0, uLength);
+    return uLength;
+}
+
+int __wrap_SymTable_put(SymTable_T oSymTable, const char *pcKey, const void *pvValue) {
+    int iResult = __real_SymTable_put(oSymTable, pcKey, pvValue);
+    if (SymTableTracer_isRecording())
+        SymTableTracer_record(SYMTABLETRACE_PUT, oSymTable, pcKey, strlen(pcKey),
+            pvValue != NULL, (size_t)iResult);
+    return iResult;
+}
+
+int __wrap_SymTable_putBorrowed(SymTable_T oSymTable, const char *pcKey, const void *pvValue) {
+    int iResult = __real_SymTable_putBorrowed(oSymTable, pcKey, pvValue);
+    if (SymTableTracer_isRecording())
+        SymTableTracer_record(SYMTABLETRACE_PUTBORROWED, oSymTable, pcKey, strlen(pcKey),
+            pvValue != NULL, (size_t)iResult);
+    return iResult;
+}
+
+void *__wrap_SymTable_replace(SymTable_T oSymTable, const char *pcKey, const void *pvValue) {
+    void *pvResult = __real_SymTable_replace(oSymTable, pcKey, pvValue);
+    if (SymTableTracer_isRecording())
+        SymTableTracer_record(SYMTABLETRACE_REPLACE, oSymTable, pcKey, strlen(pcKey),
+            pvValue != NULL, pvResult != NULL);
+    return pvResult;
+}
+
+void **__wrap_SymTable_upsert(SymTable_T oSymTable, const char *pcKey, int *piInserted) {
+    void **ppvSlot = __real_SymTable_upsert(oSymTable, pcKey, piInserted);
+    if (SymTableTracer_isRecording())
+        SymTableTracer_record(SYMTABLETRACE_UPSERT, oSymTable, pcKey, strlen(pcKey), 0,
+            SymTableTracer_upsertResult(ppvSlot, piInserted));
+    return ppvSlot;
+}
+
+int __wrap_SymTable_putN(SymTable_T oSymTable, const char *pcKey, size_t uLength,
+    const void *pvValue) {
+    int iResult = __real_SymTable_putN(oSymTable, pcKey, uLength, pvValue);
+    if (SymTableTracer_isRecording())
+        SymTableTracer_record(SYMTABLETRACE_PUTN, oSymTable, pcKey, uLength, pvValue != NULL,
+            (size_t)iResult);
+    return iResult;
+}
+
+void *__wrap_SymTable_replaceN(SymTable_T oSymTable, const char *pcKey, size_t uLength,
+    const void *pvValue) {
+    void *pvResult = __real_SymTable_replaceN(oSymTable, pcKey, uLength, pvValue);
+    if (SymTableTracer_isRecording())
+        SymTableTracer_record(SYMTABLETRACE_REPLACEN, oSymTable, pcKey, uLength,
+            pvValue != NULL, pvResult != NULL);
+    return pvResult;
+}
+
+void **__wrap_SymTable_upsertN(SymTable_T oSymTable, const char *pcKey, size_t uLength,
+    int *piInserted) {
+    void **ppvSlot = __real_SymTable_upsertN(oSymTable, pcKey, uLength, piInserted);
+    if (SymTableTracer_isRecording())
+        SymTableTracer_record(SYMTABLETRACE_UPSERTN, oSymTable, pcKey, uLength, 0,
+            SymTableTracer_upsertResult(ppvSlot, piInserted));
+    return ppvSlot;
+}
+
+int __wrap_SymTable_containsN(SymTable_T oSymTable, const char *pcKey, size_t uLength) {
+    int iResult = __real_SymTable_containsN(oSymTable, pcKey, uLength);
+    if (SymTableTracer_isRecording())
+        SymTableTracer_record(SYMTABLETRACE_CONTAINSN, oSymTable, pcKey, uLength, 0,
+            (size_t)iResult);
+    return iResult;
+}
+
+void *__wrap_SymTable_getN(SymTable_T oSymTable, const char *pcKey, size_t uLength) {
+    void *pvResult = __real_SymTable_getN(oSymTable, pcKey, uLength);
+    if (SymTableTracer_isRecording())
+        SymTableTracer_record(SYMTABLETRACE_GETN, oSymTable, pcKey, uLength, 0,
+            pvResult != NULL);
+    return pvResult;
+}
+
+void *__wrap_SymTable_removeN(SymTable_T oSymTable, const char *pcKey, size_t uLength) {
+    void *pvResult = __real_SymTable_removeN(oSymTable, pcKey, uLength);
+    if (SymTableTracer_isRecording())
+        SymTableTracer_record(SYMTABLETRACE_REMOVEN, oSymTable, pcKey, uLength, 0,
+            pvResult != NULL);
+    return pvResult;
+}
+
+int __wrap_SymTable_contains(SymTable_T oSymTable, const char *pcKey) {
+    int iResult = __real_SymTable_contains(oSymTable, pcKey);
+    if (SymTableTracer_isRecording())
+        SymTableTracer_record(SYMTABLETRACE_CONTAINS, oSymTable, pcKey, strlen(pcKey), 0,
+            (size_t)iResult);
+    return iResult;
+}
+
+void *__wrap_SymTable_get(SymTable_T oSymTable, const char *pcKey) {
+    void *pvResult = __real_SymTable_get(oSymTable, pcKey);
+    if (SymTableTracer_isRecording())
+        SymTableTracer_record(SYMTABLETRACE_GET, oSymTable, pcKey, strlen(pcKey), 0,
+            pvResult != NULL);
+    return pvResult;
+}
+
+void *__wrap_SymTable_remove(SymTable_T oSymTable, const char *pcKey) {
+    void *pvResult = __real_SymTable_remove(oSymTable, pcKey);
+    if (SymTableTracer_isRecording())
+        SymTableTracer_record(SYMTABLETRACE_REMOVE, oSymTable, pcKey, strlen(pcKey), 0,
+            pvResult != NULL);
+    return pvResult;
+}
+
+void __wrap_SymTable_map(SymTable_T oSymTable,
+    void (*pfApply)(const char *pcKey, void *pvValue, void *pvExtra), const void *pvExtra) {
+    /* The map is recorded first, so that the calls pfApply makes follow it in the trace. */
+    if (SymTableTracer_isRecording())
+        SymTableTracer_record(SYMTABLETRACE_MAP, oSymTable, NULL, 0, 0, 0);
+    __real_SymTable_map(oSymTable, pfApply, pvExtra);
+}
+
+SymTable_T __wrap_SymTable_clone(SymTable_T oSymTable) {
+    SymTable_T oClone = __real_SymTable_clone(oSymTable);
+    if (SymTableTracer_isRecording())
+        SymTableTracer_record(SYMTABLETRACE_CLONE, oSymTable, NULL, 0,
+            SymTableTrace_tableNumber(oClone), oClone != NULL);
+    return oClone;
+}
+
+void __wrap_SymTable_clear(SymTable_T oSymTable) {
+    if (SymTableTracer_isRecording())
+        SymTableTracer_record(SYMTABLETRACE_CLEAR, oSymTable, NULL, 0, 0, 0);
+    __real_SymTable_clear(oSymTable);
+}
+
+SymTable_T __wrap_SymTable_newWithAllocator(const SymTable_Allocator *psAllocator) {
+    SymTable_T oSymTable = __real_SymTable_newWithAllocator(psAllocator);
+    if (SymTableTracer_isRecording())
+        SymTableTracer_record(SYMTABLETRACE_NEWWITHALLOCATOR, oSymTable, NULL, 0, 0,
+            oSymTable != NULL);
+    return oSymTable;
+}
+
+SymTable_T __wrap_SymTable_newBounded(size_t uMaxEntries,
+    void (*pfEvict)(const char *pcKey, void *pvValue, void *pvExtra), const void *pvExtra) {
+    SymTable_T oSymTable = __real_SymTable_newBounded(uMaxEntries, pfEvict, pvExtra);
+    if (SymTableTracer_isRecording())
+        SymTableTracer_record(SYMTABLETRACE_NEWBOUNDED, oSymTable, NULL, 0, uMaxEntries,
+            oSymTable != NULL);
+    return oSymTable;
+}
+
+SymTable_T __wrap_SymTable_fromArrays(const char *const *apcKeys, const void *const *apvValues,
+    size_t uCount) {
+    SymTable_T oSymTable = __real_SymTable_fromArrays(apcKeys, apvValues, uCount);
+    size_t u;
+    if (SymTableTracer_isRecording()) {
+        SymTableTracer_record(SYMTABLETRACE_FROMARRAYS, oSymTable, NULL, 0, uCount,
+            oSymTable != NULL);
+        /* The pairs follow, so that the replay can make the table from the same keys. */
+        for (u = 0; u < uCount; u++)
+            SymTableTracer_record(SYMTABLETRACE_FROMARRAYSPAIR, oSymTable, apcKeys[u],
+                strlen(apcKeys[u]), apvValues[u] != NULL, 0);
+    }
+    return oSymTable;
+}
+
+int __wrap_SymTable_merge(SymTable_T oDst, SymTable_T oSrc,
+    void *(*pfCombine)(const char *pcKey, void *pvDstValue, void *pvSrcValue, void *pvExtra),
+    const void *pvExtra) {
+    int iResult = __real_SymTable_merge(oDst, oSrc, pfCombine, pvExtra);
+    if (SymTableTracer_isRecording())
+        SymTableTracer_record(SYMTABLETRACE_MERGE, oDst, NULL, 0,
+            2 * SymTableTrace_tableNumber(oSrc) + (pfCombine != NULL), (size_t)iResult);
+    return iResult;
+}
+
+SymTable_T __wrap_SymTable_snapshot(SymTable_T oSymTable) {
+    SymTable_T oSnapshot = __real_SymTable_snapshot(oSymTable);
+    if (SymTableTracer_isRecording())
+        SymTableTracer_record(SYMTABLETRACE_SNAPSHOT, oSymTable, NULL, 0,
+            SymTableTrace_tableNumber(oSnapshot), oSnapshot != NULL);
+    return oSnapshot;
+}
+
+int __wrap_SymTable_pushScope(SymTable_T oSymTable) {
+    int iResult = __real_SymTable_pushScope(oSymTable);
+    if (SymTableTracer_isRecording())
+        SymTableTracer_record(SYMTABLETRACE_PUSHSCOPE, oSymTable, NULL, 0, 0, (size_t)iResult);
+    return iResult;
+}
+
+int __wrap_SymTable_popScope(SymTable_T oSymTable) {
+    int iResult = __real_SymTable_popScope(oSymTable);
+    if (SymTableTracer_isRecording())
+        SymTableTracer_record(SYMTABLETRACE_POPSCOPE, oSymTable, NULL, 0, 0, (size_t)iResult);
+    return iResult;
+}
+
+SymTable_T __wrap_SymTable_openMapped(const char *pcPath) {
+    SymTable_T oSymTable = __real_SymTable_openMapped(pcPath);
+    if (SymTableTracer_isRecording())
+        SymTableTracer_record(SYMTABLETRACE_OPENMAPPED, oSymTable, pcPath, strlen(pcPath), 0,
+            oSymTable != NULL);
+    return oSymTable;
+}
+
+SymTable_T __wrap_SymTable_openLogged(const char *pcPath) {
+    SymTable_T oSymTable;
+    uNesting++;
+    oSymTable = __real_SymTable_openLogged(pcPath);
+    uNesting--;
+    if (SymTableTracer_isRecording())
+        SymTableTracer_record(SYMTABLETRACE_OPENLOGGED, oSymTable, pcPath, strlen(pcPath), 0,
+            oSymTable != NULL);
+    return oSymTable;
+}
+
+int __wrap_SymTable_save(SymTable_T oSymTable, const char *pcPath) {
+    int iResult;
+    uNesting++;
+    iResult = __real_SymTable_save(oSymTable, pcPath);
+    uNesting--;
+    return iResult;
+}
+
+int __wrap_SymTable_checkpoint(SymTable_T oSymTable) {
+    int iResult;
+    uNesting++;
+    iResult = __real_SymTable_checkpoint(oSymTable);
+    uNesting--;
+    if (SymTableTracer_isRecording())
+        SymTableTracer_record(SYMTABLETRACE_CHECKPOINT, oSymTable, NULL, 0, 0, (size_t)iResult);
+    return iResult;
+}
+
+int __wrap_SymTable_enableFilter(SymTable_T oSymTable) {
+    int iResult = __real_SymTable_enableFilter(oSymTable);
+    if (SymTableTracer_isRecording())
+        SymTableTracer_record(SYMTABLETRACE_ENABLEFILTER, oSymTable, NULL, 0, 0,
+            (size_t)iResult);
+    return iResult;
+}
+
+int __wrap_SymTable_enableCache(SymTable_T oSymTable) {
+    int iResult = __real_SymTable_enableCache(oSymTable);
+    if (SymTableTracer_isRecording())
+        SymTableTracer_record(SYMTABLETRACE_ENABLECACHE, oSymTable, NULL, 0, 0,
+            (size_t)iResult);
+    return iResult;
+}
+
+int __wrap_SymTable_setLogBatch(SymTable_T oSymTable, size_t uRecords) {
+    int iResult = __real_SymTable_setLogBatch(oSymTable, uRecords);
+    if (SymTableTracer_isRecording())
+        SymTableTracer_record(SYMTABLETRACE_SETLOGBATCH, oSymTable, NULL, 0, uRecords,
+            (size_t)iResult);
+    return iResult;
+}
+
+int __wrap_SymTable_syncLog(SymTable_T oSymTable) {
+    int iResult = __real_SymTable_syncLog(oSymTable);
+    if (SymTableTracer_isRecording())
+        SymTableTracer_record(SYMTABLETRACE_SYNCLOG, oSymTable, NULL, 0, 0, (size_t)iResult);
+    return iResult;
+}
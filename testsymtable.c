@@ -8,6 +8,7 @@
 #include <stdlib.h>
 #include <time.h>
 #include <string.h>
+#include <stdint.h>
 #include <assert.h>
 
 #ifndef S_SPLINT_S
@@ -778,9 +779,2333 @@ static void testCollisions(void)
 
 /*--------------------------------------------------------------------*/
 
+/* Increment the counter pointed to by pvExtra. pcKey and pvValue
+   are unused. */
+
+static void countBinding(const char *pcKey, void *pvValue,
+   void *pvExtra)
+{
+   assert(pcKey != NULL);
+   assert(pvExtra != NULL);
+   (void)pvValue;
+
+   (*(size_t*)pvExtra)++;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Write to the file pcPath the header of a snapshot of uCount
+   key-value pairs in uBucketCount buckets, with its section offsets
+   computed as SymTable_save() computes them, wrapping around as they
+   may in a crafted file, followed by the uWordCount words of puWords
+   and a '\0'. */
+
+static void writeSnapshotHeader(const char *pcPath, uint64_t uCount,
+   uint64_t uBucketCount, const uint64_t *puWords, size_t uWordCount)
+{
+   enum {HEADER_SIZE = 8 + 7 * sizeof(uint64_t)};
+   const uint64_t uEntrySize = 2 * sizeof(uint64_t) + sizeof(void*);
+   uint64_t auFields[7];
+   FILE *psFile;
+
+   auFields[0] = sizeof(void*);
+   auFields[1] = uCount;
+   auFields[2] = uBucketCount;
+   auFields[3] = HEADER_SIZE;
+   auFields[4] = auFields[3] + (uBucketCount + 1) * sizeof(uint64_t);
+   auFields[5] = auFields[4] + uCount * uEntrySize;
+   auFields[6] = HEADER_SIZE + uWordCount * sizeof(uint64_t) + 1;
+
+   psFile = fopen(pcPath, "wb");
+   ASSURE(psFile != NULL);
+   if (psFile == NULL)
+      return;
+   ASSURE(fwrite("SYMTBL01", 8, 1, psFile) == 1);
+   ASSURE(fwrite(auFields, sizeof(uint64_t), 7, psFile) == 7);
+   ASSURE(fwrite(puWords, sizeof(uint64_t), uWordCount, psFile)
+      == uWordCount);
+   ASSURE(putc('\0', psFile) == '\0');
+   ASSURE(fclose(psFile) == 0);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test the SymTable_save() and SymTable_openMapped() functions. */
+
+static void testSaveAndOpenMapped(void)
+{
+   SymTable_T oSymTable;
+   SymTable_T oSymTableMapped;
+   char acJeter[] = "Jeter";
+   char acMantle[] = "Mantle";
+   char acGehrig[] = "Gehrig";
+   char acRuth[] = "Ruth";
+   char acShortstop[] = "Shortstop";
+   char acCenterField[] = "Center Field";
+   char acFirstBase[] = "First Base";
+   char acRightField[] = "Right Field";
+   const char *pcPath = "testsymtable.snapshot";
+   char *pcValue;
+   int iSuccessful;
+   int iFound;
+   size_t uLength;
+   size_t uCount;
+   FILE *psFile;
+   uint64_t uField;
+   uint64_t auBuckets[2];
+
+   printf("------------------------------------------------------\n");
+   printf("Testing the SymTable_save() and SymTable_openMapped()\n");
+   printf("functions.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   oSymTable = SymTable_new();
+   ASSURE(oSymTable != NULL);
+
+   iSuccessful = SymTable_put(oSymTable, acJeter, acShortstop);
+   ASSURE(iSuccessful);
+   iSuccessful = SymTable_put(oSymTable, acMantle, acCenterField);
+   ASSURE(iSuccessful);
+   iSuccessful = SymTable_put(oSymTable, acGehrig, acFirstBase);
+   ASSURE(iSuccessful);
+   iSuccessful = SymTable_put(oSymTable, "", NULL);
+   ASSURE(iSuccessful);
+
+   iSuccessful = SymTable_save(oSymTable, pcPath);
+   ASSURE(iSuccessful);
+   SymTable_free(oSymTable);
+
+   oSymTableMapped = SymTable_openMapped("no such snapshot");
+   ASSURE(oSymTableMapped == NULL);
+
+   /* Read from the mapping. */
+
+   oSymTableMapped = SymTable_openMapped(pcPath);
+   ASSURE(oSymTableMapped != NULL);
+
+   uLength = SymTable_getLength(oSymTableMapped);
+   ASSURE(uLength == 4);
+
+   pcValue = (char*)SymTable_get(oSymTableMapped, acMantle);
+   ASSURE(pcValue == acCenterField);
+
+   iFound = SymTable_contains(oSymTableMapped, "");
+   ASSURE(iFound);
+
+   pcValue = (char*)SymTable_get(oSymTableMapped, "");
+   ASSURE(pcValue == NULL);
+
+   iFound = SymTable_contains(oSymTableMapped, acRuth);
+   ASSURE(! iFound);
+
+   pcValue = (char*)SymTable_remove(oSymTableMapped, acRuth);
+   ASSURE(pcValue == NULL);
+
+   iSuccessful = SymTable_put(oSymTableMapped, acJeter, acRightField);
+   ASSURE(! iSuccessful);
+
+   pcValue = (char*)SymTable_replace(oSymTableMapped, acGehrig,
+      acRightField);
+   ASSURE(pcValue == acFirstBase);
+
+   pcValue = (char*)SymTable_get(oSymTableMapped, acGehrig);
+   ASSURE(pcValue == acRightField);
+
+   uCount = 0;
+   SymTable_map(oSymTableMapped, countBinding, &uCount);
+   ASSURE(uCount == 4);
+
+   /* Promote the mapped table by changing it. */
+
+   iSuccessful = SymTable_put(oSymTableMapped, acRuth, acRightField);
+   ASSURE(iSuccessful);
+
+   uLength = SymTable_getLength(oSymTableMapped);
+   ASSURE(uLength == 5);
+
+   pcValue = (char*)SymTable_get(oSymTableMapped, acGehrig);
+   ASSURE(pcValue == acRightField);
+
+   pcValue = (char*)SymTable_remove(oSymTableMapped, acJeter);
+   ASSURE(pcValue == acShortstop);
+
+   iFound = SymTable_contains(oSymTableMapped, "");
+   ASSURE(iFound);
+
+   SymTable_free(oSymTableMapped);
+
+   /* A mapped table can be saved over the file that it is mapped
+      from, and keeps reading its keys from the old mapping. */
+
+   oSymTableMapped = SymTable_openMapped(pcPath);
+   ASSURE(oSymTableMapped != NULL);
+
+   pcValue = (char*)SymTable_replace(oSymTableMapped, acMantle,
+      acRightField);
+   ASSURE(pcValue == acCenterField);
+
+   iSuccessful = SymTable_save(oSymTableMapped, pcPath);
+   ASSURE(iSuccessful);
+
+   pcValue = (char*)SymTable_get(oSymTableMapped, acJeter);
+   ASSURE(pcValue == acShortstop);
+
+   uCount = 0;
+   SymTable_map(oSymTableMapped, countBinding, &uCount);
+   ASSURE(uCount == 4);
+
+   iSuccessful = SymTable_save(oSymTableMapped, pcPath);
+   ASSURE(iSuccessful);
+   SymTable_free(oSymTableMapped);
+
+   oSymTableMapped = SymTable_openMapped(pcPath);
+   ASSURE(oSymTableMapped != NULL);
+   uLength = SymTable_getLength(oSymTableMapped);
+   ASSURE(uLength == 4);
+   pcValue = (char*)SymTable_get(oSymTableMapped, acMantle);
+   ASSURE(pcValue == acRightField);
+   pcValue = (char*)SymTable_get(oSymTableMapped, acGehrig);
+   ASSURE(pcValue == acFirstBase);
+   SymTable_free(oSymTableMapped);
+
+   /* An empty table can be saved and mapped too. */
+
+   oSymTable = SymTable_new();
+   ASSURE(oSymTable != NULL);
+   iSuccessful = SymTable_save(oSymTable, pcPath);
+   ASSURE(iSuccessful);
+   SymTable_free(oSymTable);
+
+   oSymTableMapped = SymTable_openMapped(pcPath);
+   ASSURE(oSymTableMapped != NULL);
+   uLength = SymTable_getLength(oSymTableMapped);
+   ASSURE(uLength == 0);
+   iFound = SymTable_contains(oSymTableMapped, acJeter);
+   ASSURE(! iFound);
+   pcValue = (char*)SymTable_remove(oSymTableMapped, acJeter);
+   ASSURE(pcValue == NULL);
+   SymTable_free(oSymTableMapped);
+
+   /* A snapshot with a key offset outside its key section is not
+      mapped. The offset of the entries is the sixth field of the
+      header, and the key offset the second field of an entry. */
+
+   oSymTable = SymTable_new();
+   ASSURE(oSymTable != NULL);
+   iSuccessful = SymTable_put(oSymTable, acRuth, acRightField);
+   ASSURE(iSuccessful);
+   iSuccessful = SymTable_save(oSymTable, pcPath);
+   ASSURE(iSuccessful);
+   SymTable_free(oSymTable);
+
+   psFile = fopen(pcPath, "r+b");
+   ASSURE(psFile != NULL);
+   ASSURE(fseek(psFile, 5 * (long)sizeof(uint64_t), SEEK_SET) == 0);
+   ASSURE(fread(&uField, sizeof(uField), 1, psFile) == 1);
+   ASSURE(fseek(psFile, (long)(uField + sizeof(uint64_t)), SEEK_SET)
+      == 0);
+   uField = 1000000;
+   ASSURE(fwrite(&uField, sizeof(uField), 1, psFile) == 1);
+   ASSURE(fclose(psFile) == 0);
+
+   oSymTableMapped = SymTable_openMapped(pcPath);
+   ASSURE(oSymTableMapped == NULL);
+
+   /* A snapshot whose bucket offsets decrease is not mapped. The
+      bucket offsets follow the eight fields of the header. */
+
+   oSymTable = SymTable_new();
+   ASSURE(oSymTable != NULL);
+   iSuccessful = SymTable_put(oSymTable, acRuth, acRightField);
+   ASSURE(iSuccessful);
+   iSuccessful = SymTable_put(oSymTable, acJeter, acShortstop);
+   ASSURE(iSuccessful);
+   iSuccessful = SymTable_save(oSymTable, pcPath);
+   ASSURE(iSuccessful);
+   SymTable_free(oSymTable);
+
+   psFile = fopen(pcPath, "r+b");
+   ASSURE(psFile != NULL);
+   ASSURE(fseek(psFile, 8 * (long)sizeof(uint64_t), SEEK_SET) == 0);
+   uField = 3;
+   ASSURE(fwrite(&uField, sizeof(uField), 1, psFile) == 1);
+   ASSURE(fclose(psFile) == 0);
+
+   oSymTableMapped = SymTable_openMapped(pcPath);
+   ASSURE(oSymTableMapped == NULL);
+
+   /* Snapshots whose bucket count or pair count is so large that the
+      size of its section wraps around to one that fits in the file
+      are not mapped. */
+
+   auBuckets[0] = 0;
+   writeSnapshotHeader(pcPath, 0, (uint64_t)1 << 61, auBuckets, 1);
+   oSymTableMapped = SymTable_openMapped(pcPath);
+   ASSURE(oSymTableMapped == NULL);
+   if (oSymTableMapped != NULL)
+      SymTable_free(oSymTableMapped);
+
+   auBuckets[1] = (uint64_t)1 << 61;
+   writeSnapshotHeader(pcPath, auBuckets[1], 1, auBuckets, 2);
+   oSymTableMapped = SymTable_openMapped(pcPath);
+   ASSURE(oSymTableMapped == NULL);
+   if (oSymTableMapped != NULL)
+      SymTable_free(oSymTableMapped);
+
+   /* The same headers with counts that fit are mapped. */
+
+   auBuckets[1] = 0;
+   writeSnapshotHeader(pcPath, 0, 1, auBuckets, 2);
+   oSymTableMapped = SymTable_openMapped(pcPath);
+   ASSURE(oSymTableMapped != NULL);
+   if (oSymTableMapped != NULL)
+   {
+      ASSURE(SymTable_getLength(oSymTableMapped) == 0);
+      ASSURE(! SymTable_contains(oSymTableMapped, acRuth));
+      SymTable_free(oSymTableMapped);
+   }
+
+   remove(pcPath);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test the SymTable_snapshot() function. */
+
+static void testSnapshot(void)
+{
+   SymTable_T oSymTable;
+   SymTable_T oSnapshot;
+   SymTable_T oSnapshot2;
+   char acJeter[] = "Jeter";
+   char acMantle[] = "Mantle";
+   char acGehrig[] = "Gehrig";
+   char acRuth[] = "Ruth";
+   char acShortstop[] = "Shortstop";
+   char acCenterField[] = "Center Field";
+   char acFirstBase[] = "First Base";
+   char acRightField[] = "Right Field";
+   char *pcValue;
+   int iSuccessful;
+   int iFound;
+   size_t uLength;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing the SymTable_snapshot() function.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   oSymTable = SymTable_new();
+   ASSURE(oSymTable != NULL);
+
+   /* A snapshot of an empty table is empty. */
+   oSnapshot = SymTable_snapshot(oSymTable);
+   ASSURE(oSnapshot != NULL);
+   uLength = SymTable_getLength(oSnapshot);
+   ASSURE(uLength == 0);
+   SymTable_free(oSnapshot);
+
+   iSuccessful = SymTable_put(oSymTable, acJeter, acShortstop);
+   ASSURE(iSuccessful);
+   iSuccessful = SymTable_put(oSymTable, acMantle, acCenterField);
+   ASSURE(iSuccessful);
+   iSuccessful = SymTable_put(oSymTable, acGehrig, acFirstBase);
+   ASSURE(iSuccessful);
+
+   oSnapshot = SymTable_snapshot(oSymTable);
+   ASSURE(oSnapshot != NULL);
+
+   /* Change the live table; the snapshot must not change. */
+
+   iSuccessful = SymTable_put(oSymTable, acRuth, acRightField);
+   ASSURE(iSuccessful);
+   pcValue = (char*)SymTable_remove(oSymTable, acJeter);
+   ASSURE(pcValue == acShortstop);
+   pcValue = (char*)SymTable_replace(oSymTable, acMantle, acRightField);
+   ASSURE(pcValue == acCenterField);
+
+   uLength = SymTable_getLength(oSnapshot);
+   ASSURE(uLength == 3);
+   pcValue = (char*)SymTable_get(oSnapshot, acJeter);
+   ASSURE(pcValue == acShortstop);
+   pcValue = (char*)SymTable_get(oSnapshot, acMantle);
+   ASSURE(pcValue == acCenterField);
+   iFound = SymTable_contains(oSnapshot, acRuth);
+   ASSURE(! iFound);
+
+   /* Change the snapshot; the live table must not change. */
+
+   oSnapshot2 = SymTable_snapshot(oSnapshot);
+   ASSURE(oSnapshot2 != NULL);
+   pcValue = (char*)SymTable_remove(oSnapshot, acGehrig);
+   ASSURE(pcValue == acFirstBase);
+   pcValue = (char*)SymTable_replace(oSnapshot, acJeter, acFirstBase);
+   ASSURE(pcValue == acShortstop);
+
+   uLength = SymTable_getLength(oSymTable);
+   ASSURE(uLength == 3);
+   pcValue = (char*)SymTable_get(oSymTable, acGehrig);
+   ASSURE(pcValue == acFirstBase);
+   iFound = SymTable_contains(oSymTable, acJeter);
+   ASSURE(! iFound);
+
+   /* Free the original first; the snapshots must survive. */
+
+   SymTable_free(oSymTable);
+   pcValue = (char*)SymTable_get(oSnapshot, acJeter);
+   ASSURE(pcValue == acFirstBase);
+   SymTable_free(oSnapshot);
+   uLength = SymTable_getLength(oSnapshot2);
+   ASSURE(uLength == 3);
+   pcValue = (char*)SymTable_get(oSnapshot2, acJeter);
+   ASSURE(pcValue == acShortstop);
+   pcValue = (char*)SymTable_get(oSnapshot2, acGehrig);
+   ASSURE(pcValue == acFirstBase);
+   SymTable_free(oSnapshot2);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test snapshots and clones of a SymTable object that contains
+   iBindingCount bindings. Write to stdout the time consumed by the
+   snapshot, by the clone, and by a full copy made with SymTable_map()
+   and SymTable_put(). */
+
+static void copyBinding(const char *pcKey, void *pvValue,
+   void *pvExtra)
+{
+   int iSuccessful;
+
+   assert(pcKey != NULL);
+   assert(pvExtra != NULL);
+
+   iSuccessful = SymTable_put((SymTable_T)pvExtra, pcKey, pvValue);
+   ASSURE(iSuccessful);
+}
+
+static void testLargeSnapshot(int iBindingCount)
+{
+   enum {MAX_KEY_LENGTH = 12};
+
+   SymTable_T oSymTable;
+   SymTable_T oSnapshot;
+   SymTable_T oClone;
+   SymTable_T oCopy;
+   char acKey[MAX_KEY_LENGTH];
+   int i;
+   int iSuccessful;
+   size_t uLength;
+   clock_t iInitialClock;
+   clock_t iFinalClock;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing snapshots and clones of a potentially large "
+      "SymTable object.\n");
+   printf("No output except CPU time consumed should appear here:\n");
+   fflush(stdout);
+
+   oSymTable = SymTable_new();
+   ASSURE(oSymTable != NULL);
+   for (i = 0; i < iBindingCount; i++)
+   {
+      sprintf(acKey, "%d", i);
+      iSuccessful = SymTable_put(oSymTable, acKey, "x");
+      ASSURE(iSuccessful);
+   }
+
+   iInitialClock = clock();
+   oSnapshot = SymTable_snapshot(oSymTable);
+   iFinalClock = clock();
+   ASSURE(oSnapshot != NULL);
+   printf("CPU time (%d-binding snapshot):  %f seconds\n", iBindingCount,
+      ((double)(iFinalClock - iInitialClock)) / CLOCKS_PER_SEC);
+
+   iInitialClock = clock();
+   oClone = SymTable_clone(oSymTable);
+   iFinalClock = clock();
+   ASSURE(oClone != NULL);
+   printf("CPU time (%d-binding clone):  %f seconds\n", iBindingCount,
+      ((double)(iFinalClock - iInitialClock)) / CLOCKS_PER_SEC);
+
+   iInitialClock = clock();
+   oCopy = SymTable_new();
+   ASSURE(oCopy != NULL);
+   SymTable_map(oSymTable, copyBinding, oCopy);
+   iFinalClock = clock();
+   printf("CPU time (%d-binding map-and-put copy):  %f seconds\n",
+      iBindingCount,
+      ((double)(iFinalClock - iInitialClock)) / CLOCKS_PER_SEC);
+   fflush(stdout);
+
+   /* Empty the live table; the snapshot and the clone must keep
+      every binding. */
+   for (i = 0; i < iBindingCount; i++)
+   {
+      sprintf(acKey, "%d", i);
+      ASSURE(SymTable_remove(oSymTable, acKey) != NULL);
+   }
+   uLength = SymTable_getLength(oSnapshot);
+   ASSURE(uLength == (size_t)iBindingCount);
+   uLength = SymTable_getLength(oClone);
+   ASSURE(uLength == (size_t)iBindingCount);
+   for (i = 0; i < iBindingCount; i++)
+   {
+      sprintf(acKey, "%d", i);
+      ASSURE(SymTable_contains(oSnapshot, acKey));
+      ASSURE(SymTable_contains(oClone, acKey));
+   }
+
+   SymTable_free(oCopy);
+   SymTable_free(oClone);
+   SymTable_free(oSnapshot);
+   SymTable_free(oSymTable);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test SymTable_pushScope and SymTable_popScope: shadowing, removing
+   and replacing in an inner scope, deep nesting, and enough puts in
+   one scope to make a hash table grow. */
+
+static void testScopes(void)
+{
+   enum {SCOPE_COUNT = 100, MAX_KEY_LENGTH = 10};
+   SymTable_T oSymTable;
+   SymTable_T oSnapshot;
+   char acShortstop[] = "Shortstop";
+   char acCenterField[] = "Center Field";
+   char acFirstBase[] = "First Base";
+   char acKey[MAX_KEY_LENGTH];
+   char *pcValue;
+   int iSuccessful;
+   int i;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing SymTable scopes.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   oSymTable = SymTable_new();
+   ASSURE(oSymTable != NULL);
+
+   /* Popping with no open scope fails. */
+   iSuccessful = SymTable_popScope(oSymTable);
+   ASSURE(! iSuccessful);
+
+   iSuccessful = SymTable_put(oSymTable, "Jeter", acShortstop);
+   ASSURE(iSuccessful);
+   iSuccessful = SymTable_put(oSymTable, "Mantle", acCenterField);
+   ASSURE(iSuccessful);
+
+   iSuccessful = SymTable_pushScope(oSymTable);
+   ASSURE(iSuccessful);
+
+   /* An inner scope shadows an outer key, but only once. */
+   iSuccessful = SymTable_put(oSymTable, "Jeter", acFirstBase);
+   ASSURE(iSuccessful);
+   iSuccessful = SymTable_put(oSymTable, "Jeter", acCenterField);
+   ASSURE(! iSuccessful);
+   ASSURE(SymTable_getLength(oSymTable) == 2);
+   pcValue = (char*)SymTable_get(oSymTable, "Jeter");
+   ASSURE(pcValue == acFirstBase);
+
+   /* Removing the inner key reveals the outer one. */
+   pcValue = (char*)SymTable_remove(oSymTable, "Jeter");
+   ASSURE(pcValue == acFirstBase);
+   pcValue = (char*)SymTable_get(oSymTable, "Jeter");
+   ASSURE(pcValue == acShortstop);
+   ASSURE(SymTable_getLength(oSymTable) == 2);
+
+   /* Outer keys may be removed and replaced in an inner scope. */
+   pcValue = (char*)SymTable_remove(oSymTable, "Jeter");
+   ASSURE(pcValue == acShortstop);
+   ASSURE(! SymTable_contains(oSymTable, "Jeter"));
+   pcValue = (char*)SymTable_replace(oSymTable, "Mantle", acFirstBase);
+   ASSURE(pcValue == acCenterField);
+   iSuccessful = SymTable_put(oSymTable, "Ruth", acFirstBase);
+   ASSURE(iSuccessful);
+   ASSURE(SymTable_getLength(oSymTable) == 2);
+
+   /* Popping undoes all of it. */
+   iSuccessful = SymTable_popScope(oSymTable);
+   ASSURE(iSuccessful);
+   ASSURE(SymTable_getLength(oSymTable) == 2);
+   pcValue = (char*)SymTable_get(oSymTable, "Jeter");
+   ASSURE(pcValue == acShortstop);
+   pcValue = (char*)SymTable_get(oSymTable, "Mantle");
+   ASSURE(pcValue == acCenterField);
+   ASSURE(! SymTable_contains(oSymTable, "Ruth"));
+   iSuccessful = SymTable_put(oSymTable, "Jeter", acFirstBase);
+   ASSURE(! iSuccessful);
+
+   /* Each of SCOPE_COUNT nested scopes shadows "Jeter" and adds a key
+      of its own. */
+   for (i = 0; i < SCOPE_COUNT; i++)
+   {
+      iSuccessful = SymTable_pushScope(oSymTable);
+      ASSURE(iSuccessful);
+      iSuccessful = SymTable_put(oSymTable, "Jeter", (void*)(size_t)(i + 1));
+      ASSURE(iSuccessful);
+      sprintf(acKey, "%d", i);
+      iSuccessful = SymTable_put(oSymTable, acKey, acShortstop);
+      ASSURE(iSuccessful);
+   }
+   ASSURE(SymTable_getLength(oSymTable) == 2 + SCOPE_COUNT);
+
+   /* A snapshot sees only the innermost key-value pairs, and has no
+      open scope. */
+   oSnapshot = SymTable_snapshot(oSymTable);
+   ASSURE(oSnapshot != NULL);
+   ASSURE(SymTable_getLength(oSnapshot) == 2 + SCOPE_COUNT);
+   ASSURE(SymTable_get(oSnapshot, "Jeter") == (void*)(size_t)SCOPE_COUNT);
+   iSuccessful = SymTable_put(oSnapshot, "Jeter", acShortstop);
+   ASSURE(! iSuccessful);
+   ASSURE(! SymTable_popScope(oSnapshot));
+   SymTable_free(oSnapshot);
+
+   for (i = SCOPE_COUNT - 1; i >= 0; i--)
+   {
+      ASSURE(SymTable_get(oSymTable, "Jeter") == (void*)(size_t)(i + 1));
+      iSuccessful = SymTable_popScope(oSymTable);
+      ASSURE(iSuccessful);
+      sprintf(acKey, "%d", i);
+      ASSURE(! SymTable_contains(oSymTable, acKey));
+   }
+   ASSURE(SymTable_getLength(oSymTable) == 2);
+   pcValue = (char*)SymTable_get(oSymTable, "Jeter");
+   ASSURE(pcValue == acShortstop);
+
+   /* Enough puts in one scope to expand a hash table, popped with the
+      scope still open in the table that is freed. */
+   iSuccessful = SymTable_pushScope(oSymTable);
+   ASSURE(iSuccessful);
+   for (i = 0; i < 2000; i++)
+   {
+      sprintf(acKey, "%d", i);
+      iSuccessful = SymTable_put(oSymTable, acKey, acCenterField);
+      ASSURE(iSuccessful);
+   }
+   ASSURE(SymTable_getLength(oSymTable) == 2002);
+   iSuccessful = SymTable_pushScope(oSymTable);
+   ASSURE(iSuccessful);
+   pcValue = (char*)SymTable_remove(oSymTable, "1999");
+   ASSURE(pcValue == acCenterField);
+   iSuccessful = SymTable_put(oSymTable, "Mantle", acFirstBase);
+   ASSURE(iSuccessful);
+   iSuccessful = SymTable_popScope(oSymTable);
+   ASSURE(iSuccessful);
+   ASSURE(SymTable_getLength(oSymTable) == 2002);
+   ASSURE(SymTable_contains(oSymTable, "1999"));
+   pcValue = (char*)SymTable_get(oSymTable, "Mantle");
+   ASSURE(pcValue == acCenterField);
+   iSuccessful = SymTable_pushScope(oSymTable);
+   ASSURE(iSuccessful);
+   pcValue = (char*)SymTable_remove(oSymTable, "0");
+   ASSURE(pcValue == acCenterField);
+
+   SymTable_free(oSymTable);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test SymTable_getStats. The histogram and the length are checked
+   in every build, and the counters only if the implementation keeps
+   them (it was compiled with SYMTABLE_STATS defined). */
+
+static void testStats(void)
+{
+   enum {MAX_KEY_LENGTH = 10, BINDING_COUNT = 1000};
+   SymTable_T oSymTable;
+   SymTable_Stats sStats;
+   char acKey[MAX_KEY_LENGTH];
+   int iCountersKept;
+   int iSuccessful;
+   int i;
+   size_t uChains;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing SymTable_getStats.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   oSymTable = SymTable_new();
+   ASSURE(oSymTable != NULL);
+
+   for (i = 0; i < BINDING_COUNT; i++)
+   {
+      sprintf(acKey, "%d", i);
+      iSuccessful = SymTable_put(oSymTable, acKey, NULL);
+      ASSURE(iSuccessful);
+   }
+   for (i = 0; i < BINDING_COUNT; i++)
+   {
+      sprintf(acKey, "%d", i);
+      ASSURE(SymTable_contains(oSymTable, acKey));
+   }
+   ASSURE(! SymTable_contains(oSymTable, "Ruth"));
+
+   iCountersKept = SymTable_getStats(oSymTable, &sStats);
+   ASSURE(sStats.uLength == BINDING_COUNT);
+
+   /* The histogram accounts for every chain. */
+   uChains = 0;
+   for (i = 0; i < SYMTABLE_HISTOGRAM_SIZE; i++)
+      uChains += sStats.auChainLengths[i];
+   ASSURE(uChains == sStats.uBucketCount);
+
+   if (iCountersKept)
+   {
+      /* Every put and every contains made one lookup. */
+      ASSURE(sStats.uLookups == 2 * BINDING_COUNT + 1);
+      ASSURE(sStats.uHits == BINDING_COUNT);
+      ASSURE(sStats.uMisses == BINDING_COUNT + 1);
+      ASSURE(sStats.uComparisons >= BINDING_COUNT);
+      ASSURE(sStats.dComparisonsPerLookup > 0.0);
+   }
+   else
+   {
+      ASSURE(sStats.uLookups == 0);
+      ASSURE(sStats.uResizes == 0);
+   }
+
+   SymTable_free(oSymTable);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* CountingPool is the context of the counting allocator of
+   testMemoryUsage and testAllocator. */
+
+struct CountingPool
+{
+   /* uLive is the number of blocks allocated and not yet freed. */
+   size_t uLive;
+   /* uTotal is the number of blocks ever allocated. */
+   size_t uTotal;
+   /* uLimit is the number of blocks after which allocation fails. */
+   size_t uLimit;
+   /* uLiveBytes is the number of bytes of the live blocks, each
+      estimated as SymTable_memoryUsage estimates it. */
+   size_t uLiveBytes;
+};
+
+/* CountingHeader is put in front of every block of the counting
+   allocator to remember its size, aligned for any value. */
+
+union CountingHeader
+{
+   size_t uSize;
+   long double ldAlign;
+   void *pvAlign;
+};
+
+/*--------------------------------------------------------------------*/
+
+/* Return the number of bytes that SymTable_memoryUsage counts for a
+   block of uSize bytes: the block and a header word, rounded up to a
+   multiple of two words, and never less than four words. */
+
+static size_t estimateBlock(size_t uSize)
+{
+   const size_t WORD = sizeof(size_t);
+
+   uSize = (uSize + WORD + 2 * WORD - 1) & ~(2 * WORD - 1);
+   return uSize < 4 * WORD ? 4 * WORD : uSize;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Allocate uSize bytes with malloc, and count the block in the
+   CountingPool pvContext. Return NULL once its limit is reached. */
+
+static void *countingAlloc(size_t uSize, void *pvContext)
+{
+   struct CountingPool *psPool = (struct CountingPool*)pvContext;
+   union CountingHeader *psHeader;
+
+   if (psPool->uTotal == psPool->uLimit)
+      return NULL;
+   psHeader = (union CountingHeader*)
+      malloc(sizeof(union CountingHeader) + uSize);
+   if (psHeader == NULL)
+      return NULL;
+   psHeader->uSize = uSize;
+   psPool->uLive++;
+   psPool->uTotal++;
+   psPool->uLiveBytes += estimateBlock(uSize);
+   return psHeader + 1;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Free pvBlock, and count it in the CountingPool pvContext. */
+
+static void countingFree(void *pvBlock, void *pvContext)
+{
+   struct CountingPool *psPool = (struct CountingPool*)pvContext;
+   union CountingHeader *psHeader = (union CountingHeader*)pvBlock - 1;
+
+   psPool->uLive--;
+   psPool->uLiveBytes -= estimateBlock(psHeader->uSize);
+   free(psHeader);
+}
+
+/*--------------------------------------------------------------------*/
+
 /* Test the ability of a SymTable object to be large, that is, to
    contain iBindingCount bindings. Write the time consumed to stdout. */
 
+static void testMemoryUsage(void)
+{
+   enum {MAX_KEY_LENGTH = 10, BINDING_COUNT = 1000};
+   SymTable_T oSymTable;
+   char acKey[MAX_KEY_LENGTH];
+   int iSuccessful;
+   int i;
+   size_t uEmptyUsage;
+   size_t uUsage;
+   size_t uFullUsage;
+   struct CountingPool sPool = {0, 0, (size_t)-1, 0};
+   SymTable_Allocator sAllocator;
+   int iDepth;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing SymTable_memoryUsage.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   oSymTable = SymTable_new();
+   ASSURE(oSymTable != NULL);
+
+   uEmptyUsage = SymTable_memoryUsage(oSymTable);
+   ASSURE(uEmptyUsage > 0);
+
+   /* A binding costs at least its copy of the key, and removing it
+      gives back exactly what it cost. */
+   iSuccessful = SymTable_put(oSymTable, "Gehrig", "first");
+   ASSURE(iSuccessful);
+   uUsage = SymTable_memoryUsage(oSymTable);
+   ASSURE(uUsage > uEmptyUsage + strlen("Gehrig"));
+   SymTable_replace(oSymTable, "Gehrig", "second");
+   ASSURE(SymTable_memoryUsage(oSymTable) == uUsage);
+   SymTable_remove(oSymTable, "Gehrig");
+   ASSURE(SymTable_memoryUsage(oSymTable) == uEmptyUsage);
+
+   /* The usage grows with every binding. */
+   uUsage = uEmptyUsage;
+   for (i = 0; i < BINDING_COUNT; i++)
+   {
+      sprintf(acKey, "%d", i);
+      iSuccessful = SymTable_put(oSymTable, acKey, NULL);
+      ASSURE(iSuccessful);
+      ASSURE(SymTable_memoryUsage(oSymTable) > uUsage);
+      uUsage = SymTable_memoryUsage(oSymTable);
+   }
+   uFullUsage = uUsage;
+   ASSURE(uFullUsage > uEmptyUsage + BINDING_COUNT * strlen("999"));
+
+   /* A failed put costs nothing. */
+   iSuccessful = SymTable_put(oSymTable, "0", NULL);
+   ASSURE(! iSuccessful);
+   ASSURE(SymTable_memoryUsage(oSymTable) == uFullUsage);
+
+   for (i = 0; i < BINDING_COUNT; i++)
+   {
+      sprintf(acKey, "%d", i);
+      SymTable_remove(oSymTable, acKey);
+   }
+   ASSURE(SymTable_memoryUsage(oSymTable) < uFullUsage);
+   ASSURE(SymTable_memoryUsage(oSymTable) >= uEmptyUsage);
+
+   SymTable_free(oSymTable);
+
+   /* The usage is what the allocator holds, including what only
+      open scopes still hold. */
+   sAllocator.pfAlloc = countingAlloc;
+   sAllocator.pfFree = countingFree;
+   sAllocator.pvContext = &sPool;
+   oSymTable = SymTable_newWithAllocator(&sAllocator);
+   ASSURE(oSymTable != NULL);
+   for (i = 0; i < BINDING_COUNT; i++)
+   {
+      sprintf(acKey, "%d", i);
+      iSuccessful = SymTable_put(oSymTable, acKey, NULL);
+      ASSURE(iSuccessful);
+   }
+   ASSURE(SymTable_memoryUsage(oSymTable) == sPool.uLiveBytes);
+   for (iDepth = 0; iDepth < 2; iDepth++)
+   {
+      iSuccessful = SymTable_pushScope(oSymTable);
+      ASSURE(iSuccessful);
+      ASSURE(SymTable_memoryUsage(oSymTable) == sPool.uLiveBytes);
+   }
+   iSuccessful = SymTable_put(oSymTable, "Ruth", NULL);
+   ASSURE(iSuccessful);
+   ASSURE(SymTable_memoryUsage(oSymTable) == sPool.uLiveBytes);
+   iSuccessful = SymTable_put(oSymTable, "1", "shadow");
+   ASSURE(iSuccessful);
+   ASSURE(SymTable_memoryUsage(oSymTable) == sPool.uLiveBytes);
+   SymTable_remove(oSymTable, "1");
+   ASSURE(SymTable_contains(oSymTable, "1"));
+   ASSURE(SymTable_memoryUsage(oSymTable) == sPool.uLiveBytes);
+   for (i = 0; i < BINDING_COUNT; i += 3)
+   {
+      sprintf(acKey, "%d", i);
+      if (i % 2 == 0)
+         SymTable_remove(oSymTable, acKey);
+      else
+         SymTable_replace(oSymTable, acKey, "replaced");
+      ASSURE(SymTable_memoryUsage(oSymTable) == sPool.uLiveBytes);
+   }
+   for (iDepth = 0; iDepth < 2; iDepth++)
+   {
+      iSuccessful = SymTable_popScope(oSymTable);
+      ASSURE(iSuccessful);
+      ASSURE(SymTable_memoryUsage(oSymTable) == sPool.uLiveBytes);
+   }
+   SymTable_free(oSymTable);
+   ASSURE(sPool.uLiveBytes == 0);
+}
+
+/*--------------------------------------------------------------------*/
+
+static void testAllocator(void)
+{
+   enum {MAX_KEY_LENGTH = 10, BINDING_COUNT = 2000};
+   struct CountingPool sPool = {0, 0, (size_t)-1, 0};
+   SymTable_Allocator sAllocator;
+   SymTable_T oSymTable;
+   SymTable_T oSnapshot;
+   char acKey[MAX_KEY_LENGTH];
+   int iSuccessful;
+   int i;
+   size_t uTotal;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing SymTable_newWithAllocator.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   sAllocator.pfAlloc = countingAlloc;
+   sAllocator.pfFree = countingFree;
+   sAllocator.pvContext = &sPool;
+
+   oSymTable = SymTable_newWithAllocator(&sAllocator);
+   ASSURE(oSymTable != NULL);
+   ASSURE(sPool.uLive > 0);
+
+   /* Enough bindings to grow the buckets, with a scope and a
+      snapshot, so that every kind of block is allocated. */
+   for (i = 0; i < BINDING_COUNT; i++)
+   {
+      sprintf(acKey, "%d", i);
+      iSuccessful = SymTable_put(oSymTable, acKey, NULL);
+      ASSURE(iSuccessful);
+   }
+   ASSURE(sPool.uLive > BINDING_COUNT);
+   iSuccessful = SymTable_pushScope(oSymTable);
+   ASSURE(iSuccessful);
+   iSuccessful = SymTable_put(oSymTable, "0", "shadow");
+   ASSURE(iSuccessful);
+   SymTable_remove(oSymTable, "1");
+   oSnapshot = SymTable_snapshot(oSymTable);
+   ASSURE(oSnapshot != NULL);
+   ASSURE(SymTable_getLength(oSnapshot) == BINDING_COUNT - 1);
+   iSuccessful = SymTable_popScope(oSymTable);
+   ASSURE(iSuccessful);
+   ASSURE(SymTable_getLength(oSymTable) == BINDING_COUNT);
+   for (i = 0; i < BINDING_COUNT; i += 2)
+   {
+      sprintf(acKey, "%d", i);
+      SymTable_remove(oSymTable, acKey);
+   }
+
+   /* Blocks that shrink as bindings are removed are given back, so
+      the usage is still what the allocator holds. */
+   SymTable_free(oSnapshot);
+   ASSURE(SymTable_memoryUsage(oSymTable) == sPool.uLiveBytes);
+   for (i = 1; i < BINDING_COUNT; i += 4)
+   {
+      sprintf(acKey, "%d", i);
+      SymTable_remove(oSymTable, acKey);
+      ASSURE(SymTable_memoryUsage(oSymTable) == sPool.uLiveBytes);
+   }
+
+   /* A put that cannot allocate fails and leaves the table as it
+      was. */
+   sPool.uLimit = sPool.uTotal;
+   iSuccessful = SymTable_put(oSymTable, "Ruth", NULL);
+   ASSURE(! iSuccessful);
+   ASSURE(! SymTable_contains(oSymTable, "Ruth"));
+   ASSURE(SymTable_getLength(oSymTable) == BINDING_COUNT / 4);
+   sPool.uLimit = (size_t)-1;
+
+   /* Every block goes back to the allocator. */
+   SymTable_free(oSymTable);
+   ASSURE(sPool.uLive == 0);
+   ASSURE(sPool.uLiveBytes == 0);
+
+   /* SymTable_new does not use it. */
+   uTotal = sPool.uTotal;
+   oSymTable = SymTable_new();
+   ASSURE(oSymTable != NULL);
+   iSuccessful = SymTable_put(oSymTable, "Ruth", NULL);
+   ASSURE(iSuccessful);
+   SymTable_free(oSymTable);
+   ASSURE(sPool.uTotal == uTotal);
+}
+
+/*--------------------------------------------------------------------*/
+
+static void testClear(void)
+{
+   enum {MAX_KEY_LENGTH = 10, BINDING_COUNT = 2000};
+   SymTable_T oSymTable;
+   char acKey[MAX_KEY_LENGTH];
+   int iSuccessful;
+   int i;
+   size_t uFullUsage;
+   size_t uCount;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing SymTable_clear.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   oSymTable = SymTable_new();
+   ASSURE(oSymTable != NULL);
+
+   /* Clearing an empty table. */
+   SymTable_clear(oSymTable);
+   ASSURE(SymTable_getLength(oSymTable) == 0);
+
+   for (i = 0; i < BINDING_COUNT; i++)
+   {
+      sprintf(acKey, "%05d", i);
+      iSuccessful = SymTable_put(oSymTable, acKey, "first");
+      ASSURE(iSuccessful);
+   }
+   uFullUsage = SymTable_memoryUsage(oSymTable);
+
+   SymTable_clear(oSymTable);
+   ASSURE(SymTable_getLength(oSymTable) == 0);
+   ASSURE(! SymTable_contains(oSymTable, "00000"));
+   ASSURE(SymTable_get(oSymTable, "01999") == NULL);
+   ASSURE(SymTable_replace(oSymTable, "00001", "second") == NULL);
+   ASSURE(SymTable_remove(oSymTable, "00002") == NULL);
+   uCount = 0;
+   SymTable_map(oSymTable, countBinding, &uCount);
+   ASSURE(uCount == 0);
+
+   /* Refilling the table reuses what it kept. */
+   for (i = 0; i < BINDING_COUNT; i++)
+   {
+      sprintf(acKey, "%05d", i);
+      iSuccessful = SymTable_put(oSymTable, acKey, "second");
+      ASSURE(iSuccessful);
+   }
+   ASSURE(SymTable_getLength(oSymTable) == BINDING_COUNT);
+   ASSURE(SymTable_memoryUsage(oSymTable) == uFullUsage);
+   for (i = 0; i < BINDING_COUNT; i++)
+   {
+      sprintf(acKey, "%05d", i);
+      ASSURE(strcmp((char*)SymTable_get(oSymTable, acKey), "second") == 0);
+   }
+
+   /* Keys of other lengths, after a partial refill. */
+   SymTable_clear(oSymTable);
+   iSuccessful = SymTable_put(oSymTable, "Ruth", "1");
+   ASSURE(iSuccessful);
+   SymTable_clear(oSymTable);
+   iSuccessful = SymTable_put(oSymTable, "a rather long key for a binding", "2");
+   ASSURE(iSuccessful);
+   iSuccessful = SymTable_put(oSymTable, "", "3");
+   ASSURE(iSuccessful);
+   ASSURE(SymTable_getLength(oSymTable) == 2);
+   ASSURE(strcmp((char*)SymTable_get(oSymTable,
+      "a rather long key for a binding"), "2") == 0);
+   ASSURE(strcmp((char*)SymTable_get(oSymTable, ""), "3") == 0);
+   ASSURE(! SymTable_contains(oSymTable, "Ruth"));
+
+   /* Clearing closes every scope, including what they removed. */
+   iSuccessful = SymTable_pushScope(oSymTable);
+   ASSURE(iSuccessful);
+   iSuccessful = SymTable_put(oSymTable, "", "shadow");
+   ASSURE(iSuccessful);
+   SymTable_remove(oSymTable, "a rather long key for a binding");
+   SymTable_clear(oSymTable);
+   ASSURE(! SymTable_popScope(oSymTable));
+   ASSURE(SymTable_getLength(oSymTable) == 0);
+   iSuccessful = SymTable_put(oSymTable, "", "4");
+   ASSURE(iSuccessful);
+   iSuccessful = SymTable_put(oSymTable, "", "5");
+   ASSURE(! iSuccessful);
+   ASSURE(strcmp((char*)SymTable_get(oSymTable, ""), "4") == 0);
+
+   SymTable_free(oSymTable);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test the SymTable_upsert function. */
+
+static void testUpsert(void)
+{
+   enum {MAX_KEY_LENGTH = 10, KEY_COUNT = 50, ROUND_COUNT = 7};
+   SymTable_T oSymTable;
+   SymTable_T oSnapshot;
+   char acKey[MAX_KEY_LENGTH];
+   char acCounts[ROUND_COUNT + 1];
+   void **ppvValue;
+   int iInserted;
+   int iSuccessful;
+   int iRound;
+   int i;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing SymTable_upsert.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   oSymTable = SymTable_new();
+   ASSURE(oSymTable != NULL);
+
+   /* Counting occurrences: the value of a key is acCounts plus its
+      count. */
+   for (iRound = 0; iRound < ROUND_COUNT; iRound++)
+   {
+      for (i = 0; i < KEY_COUNT; i++)
+      {
+         sprintf(acKey, "%d", i);
+         ppvValue = SymTable_upsert(oSymTable, acKey, &iInserted);
+         ASSURE(ppvValue != NULL);
+         ASSURE(iInserted == (iRound == 0));
+         if (iInserted)
+         {
+            ASSURE(*ppvValue == NULL);
+            *ppvValue = acCounts;
+         }
+         *ppvValue = (char*)*ppvValue + 1;
+      }
+   }
+   ASSURE(SymTable_getLength(oSymTable) == KEY_COUNT);
+   for (i = 0; i < KEY_COUNT; i++)
+   {
+      sprintf(acKey, "%d", i);
+      ASSURE(SymTable_get(oSymTable, acKey) == acCounts + ROUND_COUNT);
+   }
+
+   /* piInserted may be NULL. */
+   ppvValue = SymTable_upsert(oSymTable, "Ruth", NULL);
+   ASSURE(ppvValue != NULL);
+   *ppvValue = "RF";
+   ASSURE(strcmp((char*)SymTable_get(oSymTable, "Ruth"), "RF") == 0);
+   ASSURE(SymTable_getLength(oSymTable) == KEY_COUNT + 1);
+
+   /* A snapshot does not see later writes through a slot. */
+   oSnapshot = SymTable_snapshot(oSymTable);
+   ASSURE(oSnapshot != NULL);
+   ppvValue = SymTable_upsert(oSymTable, "Ruth", &iInserted);
+   ASSURE(ppvValue != NULL);
+   ASSURE(! iInserted);
+   *ppvValue = "LF";
+   ASSURE(strcmp((char*)SymTable_get(oSymTable, "Ruth"), "LF") == 0);
+   ASSURE(strcmp((char*)SymTable_get(oSnapshot, "Ruth"), "RF") == 0);
+   SymTable_free(oSnapshot);
+
+   /* Writes through a slot are undone with the scope, as are the
+      keys that upsert added. */
+   iSuccessful = SymTable_pushScope(oSymTable);
+   ASSURE(iSuccessful);
+   ppvValue = SymTable_upsert(oSymTable, "Ruth", &iInserted);
+   ASSURE(ppvValue != NULL);
+   ASSURE(! iInserted);
+   *ppvValue = "CF";
+   ppvValue = SymTable_upsert(oSymTable, "Gehrig", &iInserted);
+   ASSURE(ppvValue != NULL);
+   ASSURE(iInserted);
+   *ppvValue = "1B";
+   ASSURE(strcmp((char*)SymTable_get(oSymTable, "Ruth"), "CF") == 0);
+   ASSURE(SymTable_getLength(oSymTable) == KEY_COUNT + 2);
+   iSuccessful = SymTable_popScope(oSymTable);
+   ASSURE(iSuccessful);
+   ASSURE(strcmp((char*)SymTable_get(oSymTable, "Ruth"), "LF") == 0);
+   ASSURE(! SymTable_contains(oSymTable, "Gehrig"));
+   ASSURE(SymTable_getLength(oSymTable) == KEY_COUNT + 1);
+
+   SymTable_free(oSymTable);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test the functions that take a key as a pointer and a length. */
+
+static void testLengthKeys(void)
+{
+   SymTable_T oSymTable;
+   SymTable_T oSymTableMapped;
+   /* The keys are slices of acLine, which has no '\0' between
+      them. */
+   char acLine[] = "Ruth RF Ruthless";
+   const char *pcPath = "testsymtable.snapshot";
+   void **ppvValue;
+   int iSuccessful;
+   int iInserted;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing the functions that take a key length.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   oSymTable = SymTable_new();
+   ASSURE(oSymTable != NULL);
+
+   iSuccessful = SymTable_putN(oSymTable, acLine, 4, "1");
+   ASSURE(iSuccessful);
+   ASSURE(SymTable_contains(oSymTable, "Ruth"));
+   ASSURE(! SymTable_contains(oSymTable, "Ruth RF"));
+   iSuccessful = SymTable_put(oSymTable, "Ruth", "2");
+   ASSURE(! iSuccessful);
+   iSuccessful = SymTable_putN(oSymTable, acLine + 8, 4, "3");
+   ASSURE(! iSuccessful);
+
+   /* A prefix or an extension of a key is a different key. */
+   ASSURE(SymTable_containsN(oSymTable, acLine + 8, 4));
+   ASSURE(! SymTable_containsN(oSymTable, acLine, 3));
+   ASSURE(! SymTable_containsN(oSymTable, acLine + 8, 8));
+   ASSURE(! SymTable_containsN(oSymTable, acLine, 0));
+   ASSURE(strcmp((char*)SymTable_getN(oSymTable, acLine + 8, 4), "1")
+      == 0);
+   ASSURE(SymTable_getN(oSymTable, acLine + 5, 2) == NULL);
+
+   iSuccessful = SymTable_putN(oSymTable, acLine + 8, 8, "4");
+   ASSURE(iSuccessful);
+   iSuccessful = SymTable_putN(oSymTable, acLine, 0, "5");
+   ASSURE(iSuccessful);
+   ASSURE(strcmp((char*)SymTable_get(oSymTable, ""), "5") == 0);
+   ASSURE(strcmp((char*)SymTable_get(oSymTable, "Ruthless"), "4") == 0);
+   ASSURE(SymTable_getLength(oSymTable) == 3);
+
+   ASSURE(strcmp((char*)SymTable_replaceN(oSymTable, acLine, 4, "6"), "1")
+      == 0);
+   ASSURE(SymTable_replaceN(oSymTable, acLine + 5, 2, "7") == NULL);
+   ppvValue = SymTable_upsertN(oSymTable, acLine + 5, 2, &iInserted);
+   ASSURE(ppvValue != NULL);
+   ASSURE(iInserted);
+   *ppvValue = "8";
+   ASSURE(strcmp((char*)SymTable_get(oSymTable, "RF"), "8") == 0);
+
+   ASSURE(strcmp((char*)SymTable_removeN(oSymTable, acLine + 8, 8), "4")
+      == 0);
+   ASSURE(SymTable_removeN(oSymTable, acLine + 8, 8) == NULL);
+   ASSURE(strcmp((char*)SymTable_get(oSymTable, "Ruth"), "6") == 0);
+
+   /* The same through a mapped snapshot. */
+   iSuccessful = SymTable_save(oSymTable, pcPath);
+   ASSURE(iSuccessful);
+   SymTable_free(oSymTable);
+   oSymTableMapped = SymTable_openMapped(pcPath);
+   ASSURE(oSymTableMapped != NULL);
+   ASSURE(strcmp((char*)SymTable_getN(oSymTableMapped, acLine, 4), "6")
+      == 0);
+   ASSURE(! SymTable_containsN(oSymTableMapped, acLine, 3));
+   ASSURE(! SymTable_containsN(oSymTableMapped, acLine + 8, 8));
+   ASSURE(SymTable_containsN(oSymTableMapped, acLine + 5, 2));
+   ASSURE(strcmp((char*)SymTable_removeN(oSymTableMapped, acLine + 5, 2),
+      "8") == 0);
+   ASSURE(SymTable_getLength(oSymTableMapped) == 2);
+   SymTable_free(oSymTableMapped);
+   remove(pcPath);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Increment the counter of the struct Borrowed pointed to by pvExtra
+   if pcKey is the key that it holds, as a pointer and not as a
+   string. pvValue is unused. */
+
+struct Borrowed
+{
+   const char *pcKey;
+   size_t uMatches;
+};
+
+static void findBorrowed(const char *pcKey, void *pvValue,
+   void *pvExtra)
+{
+   struct Borrowed *psBorrowed = (struct Borrowed*)pvExtra;
+
+   assert(pcKey != NULL);
+   assert(pvExtra != NULL);
+   (void)pvValue;
+
+   if (pcKey == psBorrowed->pcKey)
+      psBorrowed->uMatches++;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test the SymTable_putBorrowed() function. Run under a memory
+   checker, this also tests that a borrowed key is never freed by
+   the SymTable. */
+
+static void testPutBorrowed(void)
+{
+   SymTable_T oSymTable;
+   SymTable_T oSymTableCopied;
+   struct Borrowed sBorrowed;
+   char *pcKey;
+   int iSuccessful;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing the SymTable_putBorrowed() function.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   pcKey = (char*)malloc(sizeof("Mantle"));
+   ASSURE(pcKey != NULL);
+   strcpy(pcKey, "Mantle");
+
+   oSymTable = SymTable_new();
+   ASSURE(oSymTable != NULL);
+   oSymTableCopied = SymTable_new();
+   ASSURE(oSymTableCopied != NULL);
+
+   /* A borrowed key saves its copy. The key is long enough that the
+      hash array mapped trie implementation, which keeps a short key
+      in its leaf, saves memory too. */
+   iSuccessful = SymTable_putBorrowed(oSymTable,
+      "Mickey Charles Mantle, Center Field", "0");
+   ASSURE(iSuccessful);
+   iSuccessful = SymTable_put(oSymTableCopied,
+      "Mickey Charles Mantle, Center Field", "0");
+   ASSURE(iSuccessful);
+   ASSURE(SymTable_memoryUsage(oSymTable)
+      < SymTable_memoryUsage(oSymTableCopied));
+   SymTable_free(oSymTableCopied);
+   SymTable_remove(oSymTable, "Mickey Charles Mantle, Center Field");
+
+   iSuccessful = SymTable_putBorrowed(oSymTable, pcKey, "1");
+   ASSURE(iSuccessful);
+
+   /* The SymTable holds pcKey itself, and a second put of the same
+      key fails whichever way the key is given. */
+   sBorrowed.pcKey = pcKey;
+   sBorrowed.uMatches = 0;
+   SymTable_map(oSymTable, findBorrowed, &sBorrowed);
+   ASSURE(sBorrowed.uMatches == 1);
+   iSuccessful = SymTable_putBorrowed(oSymTable, "Mantle", "2");
+   ASSURE(! iSuccessful);
+   iSuccessful = SymTable_put(oSymTable, "Mantle", "2");
+   ASSURE(! iSuccessful);
+   ASSURE(strcmp((char*)SymTable_replace(oSymTable, "Mantle", "3"), "1")
+      == 0);
+
+   /* Borrowed and copied keys mix. */
+   iSuccessful = SymTable_put(oSymTable, "Gehrig", "4");
+   ASSURE(iSuccessful);
+   iSuccessful = SymTable_putBorrowed(oSymTable, "Ruth", "5");
+   ASSURE(iSuccessful);
+   ASSURE(SymTable_getLength(oSymTable) == 3);
+   ASSURE(strcmp((char*)SymTable_get(oSymTable, "Mantle"), "3") == 0);
+   ASSURE(strcmp((char*)SymTable_get(oSymTable, "Gehrig"), "4") == 0);
+   ASSURE(strcmp((char*)SymTable_get(oSymTable, "Ruth"), "5") == 0);
+
+   /* Removing a borrowed key leaves it to the client, and the key
+      can be borrowed again. */
+   ASSURE(strcmp((char*)SymTable_remove(oSymTable, pcKey), "3") == 0);
+   ASSURE(strcmp(pcKey, "Mantle") == 0);
+   iSuccessful = SymTable_putBorrowed(oSymTable, pcKey, "6");
+   ASSURE(iSuccessful);
+
+   /* A scope that is popped removes a borrowed key, and restores a
+      copied key that it removed. */
+   iSuccessful = SymTable_pushScope(oSymTable);
+   ASSURE(iSuccessful);
+   iSuccessful = SymTable_putBorrowed(oSymTable, "Berra", "7");
+   ASSURE(iSuccessful);
+   ASSURE(strcmp((char*)SymTable_remove(oSymTable, "Gehrig"), "4") == 0);
+   iSuccessful = SymTable_popScope(oSymTable);
+   ASSURE(iSuccessful);
+   ASSURE(! SymTable_contains(oSymTable, "Berra"));
+   ASSURE(strcmp((char*)SymTable_get(oSymTable, "Gehrig"), "4") == 0);
+   ASSURE(SymTable_getLength(oSymTable) == 3);
+
+   /* After a clear, the freed key-value pairs are reused for
+      borrowed and copied keys alike. */
+   SymTable_clear(oSymTable);
+   ASSURE(SymTable_getLength(oSymTable) == 0);
+   iSuccessful = SymTable_put(oSymTable, "Mantle", "8");
+   ASSURE(iSuccessful);
+   iSuccessful = SymTable_putBorrowed(oSymTable, "Gehrig", "9");
+   ASSURE(iSuccessful);
+   ASSURE(strcmp((char*)SymTable_get(oSymTable, pcKey), "8") == 0);
+   ASSURE(strcmp((char*)SymTable_get(oSymTable, "Gehrig"), "9") == 0);
+   SymTable_free(oSymTable);
+
+   /* The SymTable freed none of the borrowed keys. */
+   ASSURE(strcmp(pcKey, "Mantle") == 0);
+   free(pcKey);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test the SymTable_fromArrays() function. */
+
+static void testFromArrays(void)
+{
+   enum {PAIR_COUNT = 6};
+   const char *apcKeys[PAIR_COUNT] =
+      {"Ruth", "Gehrig", "Mantle", "Gehrig", "Jeter", ""};
+   const void *apvValues[PAIR_COUNT] =
+      {"Right Field", "First Base", "Center Field", "Pitcher",
+       "Shortstop", "Bench"};
+   SymTable_T oSymTable;
+   SymTable_T oSymTablePut;
+   SymTable_T oSymTableCopy;
+   int iSuccessful;
+   int i;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing the SymTable_fromArrays() function.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   oSymTable = SymTable_fromArrays(NULL, NULL, 0);
+   ASSURE(oSymTable != NULL);
+   ASSURE(SymTable_getLength(oSymTable) == 0);
+   iSuccessful = SymTable_put(oSymTable, "Ruth", "Right Field");
+   ASSURE(iSuccessful);
+   SymTable_free(oSymTable);
+
+   /* The first of the duplicate keys wins, as with SymTable_put(). */
+   oSymTable = SymTable_fromArrays(apcKeys, apvValues, PAIR_COUNT);
+   ASSURE(oSymTable != NULL);
+   ASSURE(SymTable_getLength(oSymTable) == 5);
+   ASSURE(strcmp((char*)SymTable_get(oSymTable, "Gehrig"), "First Base")
+      == 0);
+   ASSURE(strcmp((char*)SymTable_get(oSymTable, "Jeter"), "Shortstop")
+      == 0);
+   ASSURE(strcmp((char*)SymTable_get(oSymTable, ""), "Bench") == 0);
+   ASSURE(! SymTable_contains(oSymTable, "Berra"));
+
+   /* The keys are copied, and the block of key-value pairs is no
+      larger than the key-value pairs that SymTable_put() makes. */
+   oSymTablePut = SymTable_new();
+   ASSURE(oSymTablePut != NULL);
+   for (i = 0; i < PAIR_COUNT; i++)
+      SymTable_put(oSymTablePut, apcKeys[i], apvValues[i]);
+   ASSURE(SymTable_memoryUsage(oSymTable)
+      <= SymTable_memoryUsage(oSymTablePut));
+   SymTable_free(oSymTablePut);
+
+   /* The table changes like any other. */
+   iSuccessful = SymTable_put(oSymTable, "Mantle", "Pitcher");
+   ASSURE(! iSuccessful);
+   iSuccessful = SymTable_put(oSymTable, "Berra", "Catcher");
+   ASSURE(iSuccessful);
+   ASSURE(strcmp((char*)SymTable_replace(oSymTable, "Ruth", "Pitcher"),
+      "Right Field") == 0);
+   ASSURE(strcmp((char*)SymTable_remove(oSymTable, "Mantle"),
+      "Center Field") == 0);
+   ASSURE(! SymTable_contains(oSymTable, "Mantle"));
+   iSuccessful = SymTable_pushScope(oSymTable);
+   ASSURE(iSuccessful);
+   ASSURE(strcmp((char*)SymTable_remove(oSymTable, "Gehrig"),
+      "First Base") == 0);
+   iSuccessful = SymTable_putBorrowed(oSymTable, "Jeter", "Captain");
+   ASSURE(iSuccessful);
+   iSuccessful = SymTable_popScope(oSymTable);
+   ASSURE(iSuccessful);
+   ASSURE(strcmp((char*)SymTable_get(oSymTable, "Gehrig"), "First Base")
+      == 0);
+   ASSURE(strcmp((char*)SymTable_get(oSymTable, "Jeter"), "Shortstop")
+      == 0);
+   ASSURE(SymTable_getLength(oSymTable) == 5);
+
+   oSymTableCopy = SymTable_snapshot(oSymTable);
+   ASSURE(oSymTableCopy != NULL);
+
+   /* The key-value pairs of the block are reused after a clear. */
+   SymTable_clear(oSymTable);
+   for (i = 0; i < PAIR_COUNT; i++)
+      SymTable_put(oSymTable, apvValues[i], apcKeys[i]);
+   ASSURE(SymTable_getLength(oSymTable) == PAIR_COUNT);
+   ASSURE(strcmp((char*)SymTable_get(oSymTable, "Pitcher"), "Gehrig")
+      == 0);
+   SymTable_free(oSymTable);
+
+   ASSURE(SymTable_getLength(oSymTableCopy) == 5);
+   ASSURE(strcmp((char*)SymTable_get(oSymTableCopy, "Ruth"), "Pitcher")
+      == 0);
+   ASSURE(strcmp((char*)SymTable_get(oSymTableCopy, "Berra"), "Catcher")
+      == 0);
+   SymTable_free(oSymTableCopy);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return the sum of the counts pvDstValue and pvSrcValue, which are
+   offsets from the array pvExtra, as an offset from it too. pcKey is
+   unused. */
+
+static void *addCounts(const char *pcKey, void *pvDstValue,
+   void *pvSrcValue, void *pvExtra)
+{
+   char *pcBase = (char*)pvExtra;
+
+   assert(pcKey != NULL);
+   assert(pvExtra != NULL);
+
+   return pcBase + ((char*)pvDstValue - pcBase)
+      + ((char*)pvSrcValue - pcBase);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test the SymTable_merge() function. */
+
+static void testMerge(void)
+{
+   enum {MAX_KEY_LENGTH = 10, KEY_COUNT = 300};
+   /* A count n is stored as the value acCounts + n. */
+   static char acCounts[2 * KEY_COUNT + 1];
+   struct CountingPool sPool = {0, 0, (size_t)-1, 0};
+   SymTable_Allocator sAllocator;
+   SymTable_T oDst;
+   SymTable_T oSrc;
+   const char *apcKeys[2];
+   const void *apvValues[2];
+   char acKey[MAX_KEY_LENGTH];
+   int iSuccessful;
+   int i;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing the SymTable_merge() function.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   /* Counting words: the keys 0 to KEY_COUNT-1 are in oDst, and the
+      even keys up to 2*KEY_COUNT-2 in oSrc, each counted once. */
+   oDst = SymTable_new();
+   ASSURE(oDst != NULL);
+   oSrc = SymTable_new();
+   ASSURE(oSrc != NULL);
+   for (i = 0; i < KEY_COUNT; i++)
+   {
+      sprintf(acKey, "%d", i);
+      iSuccessful = SymTable_put(oDst, acKey, acCounts + 1);
+      ASSURE(iSuccessful);
+      sprintf(acKey, "%d", 2 * i);
+      iSuccessful = SymTable_put(oSrc, acKey, acCounts + 1);
+      ASSURE(iSuccessful);
+   }
+   iSuccessful = SymTable_merge(oDst, oSrc, addCounts, acCounts);
+   ASSURE(iSuccessful);
+   ASSURE(SymTable_getLength(oSrc) == 0);
+   ASSURE(! SymTable_contains(oSrc, "0"));
+   ASSURE(SymTable_getLength(oDst) == KEY_COUNT + KEY_COUNT / 2);
+   for (i = 0; i < 2 * KEY_COUNT; i++)
+   {
+      sprintf(acKey, "%d", i);
+      if (i < KEY_COUNT && i % 2 == 0)
+         ASSURE(SymTable_get(oDst, acKey) == acCounts + 2);
+      else if (i < KEY_COUNT || i % 2 == 0)
+         ASSURE(SymTable_get(oDst, acKey) == acCounts + 1);
+      else
+         ASSURE(! SymTable_contains(oDst, acKey));
+   }
+
+   /* Merging into an empty SymTable takes everything, and the emptied
+      SymTable can be used again. Without pfCombine, oDst keeps its
+      values. */
+   iSuccessful = SymTable_put(oSrc, "1", acCounts + 7);
+   ASSURE(iSuccessful);
+   iSuccessful = SymTable_merge(oSrc, oDst, NULL, NULL);
+   ASSURE(iSuccessful);
+   ASSURE(SymTable_getLength(oDst) == 0);
+   ASSURE(SymTable_getLength(oSrc) == KEY_COUNT + KEY_COUNT / 2);
+   ASSURE(SymTable_get(oSrc, "1") == acCounts + 7);
+   ASSURE(SymTable_get(oSrc, "2") == acCounts + 2);
+   iSuccessful = SymTable_put(oDst, "2", acCounts + 3);
+   ASSURE(iSuccessful);
+
+   /* A SymTable with an open scope cannot be merged. */
+   iSuccessful = SymTable_pushScope(oDst);
+   ASSURE(iSuccessful);
+   iSuccessful = SymTable_merge(oDst, oSrc, addCounts, acCounts);
+   ASSURE(! iSuccessful);
+   iSuccessful = SymTable_merge(oSrc, oDst, addCounts, acCounts);
+   ASSURE(! iSuccessful);
+   ASSURE(SymTable_get(oSrc, "2") == acCounts + 2);
+   iSuccessful = SymTable_popScope(oDst);
+   ASSURE(iSuccessful);
+   iSuccessful = SymTable_merge(oSrc, oDst, addCounts, acCounts);
+   ASSURE(iSuccessful);
+   ASSURE(SymTable_get(oSrc, "2") == acCounts + 5);
+   SymTable_free(oDst);
+
+   /* The key-value pairs of SymTable_fromArrays() outlive their
+      block. */
+   apcKeys[0] = "2";
+   apcKeys[1] = "Ruth";
+   apvValues[0] = acCounts + 1;
+   apvValues[1] = acCounts + 1;
+   oDst = SymTable_fromArrays(apcKeys, apvValues, 2);
+   ASSURE(oDst != NULL);
+   iSuccessful = SymTable_merge(oSrc, oDst, addCounts, acCounts);
+   ASSURE(iSuccessful);
+   SymTable_free(oDst);
+   ASSURE(SymTable_get(oSrc, "2") == acCounts + 6);
+   ASSURE(SymTable_get(oSrc, "Ruth") == acCounts + 1);
+
+   /* A SymTable with another allocator gets copies. Running out of
+      memory leaves each key-value pair in one of the two SymTables,
+      and merging again finishes the job. */
+   sAllocator.pfAlloc = countingAlloc;
+   sAllocator.pfFree = countingFree;
+   sAllocator.pvContext = &sPool;
+   oDst = SymTable_newWithAllocator(&sAllocator);
+   ASSURE(oDst != NULL);
+   for (i = 0; i < KEY_COUNT; i += 3)
+   {
+      sprintf(acKey, "%d", i);
+      iSuccessful = SymTable_put(oDst, acKey, acCounts + 1);
+      ASSURE(iSuccessful);
+   }
+   sPool.uLimit = sPool.uTotal + 40;
+   iSuccessful = SymTable_merge(oDst, oSrc, addCounts, acCounts);
+   ASSURE(! iSuccessful);
+   ASSURE(SymTable_getLength(oSrc) > 0);
+   sPool.uLimit = (size_t)-1;
+   iSuccessful = SymTable_merge(oDst, oSrc, addCounts, acCounts);
+   ASSURE(iSuccessful);
+   ASSURE(SymTable_getLength(oSrc) == 0);
+   ASSURE(SymTable_getLength(oDst) == KEY_COUNT + KEY_COUNT / 2 + 1);
+   ASSURE(SymTable_get(oDst, "0") == acCounts + 3);
+   ASSURE(SymTable_get(oDst, "1") == acCounts + 7);
+   ASSURE(SymTable_get(oDst, "2") == acCounts + 6);
+   ASSURE(SymTable_get(oDst, "3") == acCounts + 2);
+   ASSURE(SymTable_get(oDst, "4") == acCounts + 2);
+   ASSURE(SymTable_get(oDst, "5") == acCounts + 1);
+   ASSURE(SymTable_get(oDst, "Ruth") == acCounts + 1);
+   SymTable_free(oSrc);
+   SymTable_free(oDst);
+   ASSURE(sPool.uLive == 0);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test the SymTable_clone() function. */
+
+static void testClone(void)
+{
+   enum {MAX_KEY_LENGTH = 10, LONG_KEY_LENGTH = 100, KEY_COUNT = 1500};
+   struct CountingPool sPool = {0, 0, (size_t)-1, 0};
+   SymTable_Allocator sAllocator;
+   SymTable_T oSymTable;
+   SymTable_T oClone;
+   SymTable_T oCloneOfClone;
+   char acKey[MAX_KEY_LENGTH];
+   char acLongKey[LONG_KEY_LENGTH + 1];
+   int iSuccessful;
+   int i;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing the SymTable_clone() function.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   sAllocator.pfAlloc = countingAlloc;
+   sAllocator.pfFree = countingFree;
+   sAllocator.pvContext = &sPool;
+   oSymTable = SymTable_newWithAllocator(&sAllocator);
+   ASSURE(oSymTable != NULL);
+
+   oClone = SymTable_clone(oSymTable);
+   ASSURE(oClone != NULL);
+   ASSURE(SymTable_getLength(oClone) == 0);
+   SymTable_free(oClone);
+
+   /* Keys longer than the clone first makes room for are copied
+      whole. */
+   memset(acLongKey, 'a', LONG_KEY_LENGTH);
+   acLongKey[LONG_KEY_LENGTH] = '\0';
+   iSuccessful = SymTable_put(oSymTable, acLongKey, "long");
+   ASSURE(iSuccessful);
+   iSuccessful = SymTable_put(oSymTable, "Ruth", "Right Field");
+   ASSURE(iSuccessful);
+   acLongKey[0] = 'b';
+   iSuccessful = SymTable_put(oSymTable, acLongKey, "longer");
+   ASSURE(iSuccessful);
+   oClone = SymTable_clone(oSymTable);
+   ASSURE(oClone != NULL);
+   ASSURE(SymTable_getLength(oClone) == 3);
+   ASSURE(strcmp((char*)SymTable_get(oClone, acLongKey), "longer") == 0);
+   ASSURE(strcmp((char*)SymTable_get(oClone, "Ruth"), "Right Field")
+      == 0);
+   acLongKey[0] = 'a';
+   ASSURE(strcmp((char*)SymTable_get(oClone, acLongKey), "long") == 0);
+   SymTable_free(oClone);
+
+   /* The key-value pairs put before a clear are not cloned. */
+   for (i = 0; i < KEY_COUNT; i++)
+   {
+      sprintf(acKey, "%d", i);
+      iSuccessful = SymTable_put(oSymTable, acKey, "old");
+      ASSURE(iSuccessful);
+   }
+   SymTable_clear(oSymTable);
+   for (i = 0; i < KEY_COUNT; i += 2)
+   {
+      sprintf(acKey, "%d", i);
+      iSuccessful = SymTable_put(oSymTable, acKey, "even");
+      ASSURE(iSuccessful);
+   }
+   iSuccessful = SymTable_putBorrowed(oSymTable, "Ruth", "Right Field");
+   ASSURE(iSuccessful);
+
+   /* The clone holds the innermost key-value pairs, and no scope. */
+   iSuccessful = SymTable_pushScope(oSymTable);
+   ASSURE(iSuccessful);
+   iSuccessful = SymTable_put(oSymTable, "Ruth", "Pitcher");
+   ASSURE(iSuccessful);
+   ASSURE(SymTable_remove(oSymTable, "0") != NULL);
+   oClone = SymTable_clone(oSymTable);
+   ASSURE(oClone != NULL);
+   ASSURE(! SymTable_popScope(oClone));
+   iSuccessful = SymTable_popScope(oSymTable);
+   ASSURE(iSuccessful);
+   ASSURE(SymTable_getLength(oClone) == KEY_COUNT / 2);
+   ASSURE(strcmp((char*)SymTable_get(oClone, "Ruth"), "Pitcher") == 0);
+   ASSURE(! SymTable_contains(oClone, "0"));
+   ASSURE(! SymTable_contains(oClone, "1"));
+   for (i = 2; i < KEY_COUNT; i += 2)
+   {
+      sprintf(acKey, "%d", i);
+      ASSURE(strcmp((char*)SymTable_get(oClone, acKey), "even") == 0);
+   }
+
+   /* Neither SymTable sees the changes of the other. */
+   ASSURE(strcmp((char*)SymTable_replace(oClone, "2", "two"), "even")
+      == 0);
+   ASSURE(SymTable_remove(oClone, "4") != NULL);
+   iSuccessful = SymTable_put(oClone, "1", "odd");
+   ASSURE(iSuccessful);
+   iSuccessful = SymTable_put(oSymTable, "Gehrig", "First Base");
+   ASSURE(iSuccessful);
+   ASSURE(strcmp((char*)SymTable_get(oSymTable, "2"), "even") == 0);
+   ASSURE(SymTable_contains(oSymTable, "4"));
+   ASSURE(! SymTable_contains(oSymTable, "1"));
+   ASSURE(! SymTable_contains(oClone, "Gehrig"));
+
+   /* A clone is a SymTable like any other, and can be cloned. */
+   iSuccessful = SymTable_pushScope(oClone);
+   ASSURE(iSuccessful);
+   ASSURE(SymTable_remove(oClone, "Ruth") != NULL);
+   iSuccessful = SymTable_put(oClone, "2", "shadow");
+   ASSURE(iSuccessful);
+   oCloneOfClone = SymTable_clone(oClone);
+   ASSURE(oCloneOfClone != NULL);
+   iSuccessful = SymTable_popScope(oClone);
+   ASSURE(iSuccessful);
+   ASSURE(strcmp((char*)SymTable_get(oClone, "Ruth"), "Pitcher") == 0);
+   ASSURE(strcmp((char*)SymTable_get(oClone, "2"), "two") == 0);
+   ASSURE(! SymTable_contains(oCloneOfClone, "Ruth"));
+   ASSURE(strcmp((char*)SymTable_get(oCloneOfClone, "2"), "shadow")
+      == 0);
+   ASSURE(SymTable_getLength(oCloneOfClone) == KEY_COUNT / 2 - 1);
+
+   /* The key-value pairs of a clone are reused after a clear. */
+   SymTable_clear(oClone);
+   for (i = 0; i < KEY_COUNT; i++)
+   {
+      sprintf(acKey, "%d", i);
+      iSuccessful = SymTable_put(oClone, acKey, "new");
+      ASSURE(iSuccessful);
+   }
+   ASSURE(SymTable_getLength(oClone) == KEY_COUNT);
+   SymTable_free(oClone);
+   ASSURE(SymTable_getLength(oCloneOfClone) == KEY_COUNT / 2 - 1);
+   SymTable_free(oCloneOfClone);
+
+   /* A clone that cannot allocate fails and leaves nothing behind. */
+   sPool.uLimit = sPool.uTotal;
+   oClone = SymTable_clone(oSymTable);
+   ASSURE(oClone == NULL);
+   sPool.uLimit = (size_t)-1;
+   ASSURE(SymTable_getLength(oSymTable) == KEY_COUNT / 2 + 2);
+   SymTable_free(oSymTable);
+   ASSURE(sPool.uLive == 0);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test SymTable_enableFilter. A SymTable behaves the same with or
+   without a filter, so the checks hold whatever it returns. */
+
+static void testFilter(void)
+{
+   enum {MAX_KEY_LENGTH = 10, KEY_COUNT = 2000};
+   SymTable_T oSymTable;
+   SymTable_T oOther;
+   SymTable_T oClone;
+   SymTable_Stats sStats;
+   char acKey[MAX_KEY_LENGTH];
+   int iFiltered;
+   int iSuccessful;
+   int i;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing SymTable_enableFilter.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   oSymTable = SymTable_new();
+   ASSURE(oSymTable != NULL);
+   iFiltered = SymTable_enableFilter(oSymTable);
+
+   /* Every key put is found through the bucket array's growth, and
+      the absent ones are not. */
+   for (i = 0; i < KEY_COUNT; i += 2)
+   {
+      sprintf(acKey, "%d", i);
+      iSuccessful = SymTable_put(oSymTable, acKey, "even");
+      ASSURE(iSuccessful);
+   }
+   for (i = 0; i < KEY_COUNT; i++)
+   {
+      sprintf(acKey, "%d", i);
+      ASSURE(SymTable_contains(oSymTable, acKey) == (i % 2 == 0));
+      ASSURE((SymTable_get(oSymTable, acKey) != NULL) == (i % 2 == 0));
+   }
+   ASSURE(SymTable_replace(oSymTable, "1", "odd") == NULL);
+   ASSURE(SymTable_remove(oSymTable, "1") == NULL);
+
+   /* A removed key is gone even though the filter still holds it,
+      and can be put again. */
+   ASSURE(SymTable_remove(oSymTable, "0") != NULL);
+   ASSURE(! SymTable_contains(oSymTable, "0"));
+   iSuccessful = SymTable_put(oSymTable, "0", "zero");
+   ASSURE(iSuccessful);
+   ASSURE(strcmp((char*)SymTable_get(oSymTable, "0"), "zero") == 0);
+
+   /* Popping a scope brings back the keys removed in it. */
+   iSuccessful = SymTable_pushScope(oSymTable);
+   ASSURE(iSuccessful);
+   ASSURE(SymTable_remove(oSymTable, "2") != NULL);
+   iSuccessful = SymTable_put(oSymTable, "3", "odd");
+   ASSURE(iSuccessful);
+   ASSURE(SymTable_contains(oSymTable, "3"));
+   iSuccessful = SymTable_popScope(oSymTable);
+   ASSURE(iSuccessful);
+   ASSURE(SymTable_contains(oSymTable, "2"));
+   ASSURE(! SymTable_contains(oSymTable, "3"));
+
+   /* A clone keeps the filter's answers. */
+   oClone = SymTable_clone(oSymTable);
+   ASSURE(oClone != NULL);
+   ASSURE(SymTable_getLength(oClone) == KEY_COUNT / 2);
+   ASSURE(SymTable_contains(oClone, "4"));
+   ASSURE(! SymTable_contains(oClone, "5"));
+   SymTable_free(oClone);
+
+   /* Keys merged into a table with a filter are found. */
+   oOther = SymTable_new();
+   ASSURE(oOther != NULL);
+   for (i = 1; i < KEY_COUNT; i += 2)
+   {
+      sprintf(acKey, "%d", i);
+      iSuccessful = SymTable_put(oOther, acKey, "odd");
+      ASSURE(iSuccessful);
+   }
+   iSuccessful = SymTable_merge(oSymTable, oOther, NULL, NULL);
+   ASSURE(iSuccessful);
+   ASSURE(SymTable_getLength(oSymTable) == KEY_COUNT);
+   for (i = 0; i < KEY_COUNT; i++)
+   {
+      sprintf(acKey, "%d", i);
+      ASSURE(SymTable_contains(oSymTable, acKey));
+   }
+   SymTable_free(oOther);
+
+   /* A cleared table forgets its keys, and finds the new ones. */
+   SymTable_clear(oSymTable);
+   ASSURE(! SymTable_contains(oSymTable, "4"));
+   iSuccessful = SymTable_put(oSymTable, "Ruth", "Right Field");
+   ASSURE(iSuccessful);
+   ASSURE(SymTable_contains(oSymTable, "Ruth"));
+   ASSURE(! SymTable_contains(oSymTable, "Gehrig"));
+
+   /* Most misses are answered by the filter alone. */
+   for (i = 0; i < KEY_COUNT; i++)
+   {
+      sprintf(acKey, "%d", i);
+      ASSURE(! SymTable_contains(oSymTable, acKey));
+   }
+   if (SymTable_getStats(oSymTable, &sStats) && iFiltered)
+      ASSURE(sStats.uFilterRejects > KEY_COUNT / 2);
+   else
+      ASSURE(sStats.uFilterRejects == 0);
+
+   SymTable_free(oSymTable);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test SymTable_enableCache. A SymTable behaves the same with or
+   without a cache, so the checks hold whatever it returns. */
+
+static void testCache(void)
+{
+   enum {MAX_KEY_LENGTH = 10, KEY_COUNT = 1000, REPEAT_COUNT = 100};
+   SymTable_T oSymTable;
+   SymTable_T oOther;
+   SymTable_T oClone;
+   SymTable_Stats sStats;
+   char acKey[MAX_KEY_LENGTH];
+   int iCached;
+   int iSuccessful;
+   int i;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing SymTable_enableCache.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   oSymTable = SymTable_new();
+   ASSURE(oSymTable != NULL);
+   iCached = SymTable_enableCache(oSymTable);
+   ASSURE(SymTable_enableCache(oSymTable) == iCached);
+
+   /* Repeated lookups of the same keys, through the table's growth. */
+   for (i = 0; i < KEY_COUNT; i++)
+   {
+      sprintf(acKey, "%d", i);
+      iSuccessful = SymTable_put(oSymTable, acKey, "number");
+      ASSURE(iSuccessful);
+      ASSURE(SymTable_contains(oSymTable, "Ruth") == (i > 0));
+      if (i == 0)
+      {
+         iSuccessful = SymTable_put(oSymTable, "Ruth", "Right Field");
+         ASSURE(iSuccessful);
+      }
+   }
+   for (i = 0; i < REPEAT_COUNT; i++)
+   {
+      ASSURE(strcmp((char*)SymTable_get(oSymTable, "Ruth"),
+         "Right Field") == 0);
+      ASSURE(SymTable_contains(oSymTable, "Ruth"));
+      ASSURE(! SymTable_contains(oSymTable, "Gehrig"));
+   }
+
+   /* The same address holding another key finds that key. */
+   for (i = 0; i < KEY_COUNT; i++)
+   {
+      sprintf(acKey, "%d", i);
+      ASSURE(SymTable_contains(oSymTable, acKey));
+      sprintf(acKey, "x%d", i);
+      ASSURE(! SymTable_contains(oSymTable, acKey));
+   }
+
+   /* A replaced value is seen, and a removed key is gone. */
+   ASSURE(strcmp((char*)SymTable_replace(oSymTable, "Ruth", "Pitcher"),
+      "Right Field") == 0);
+   ASSURE(strcmp((char*)SymTable_get(oSymTable, "Ruth"), "Pitcher")
+      == 0);
+   ASSURE(SymTable_remove(oSymTable, "Ruth") != NULL);
+   ASSURE(! SymTable_contains(oSymTable, "Ruth"));
+   ASSURE(SymTable_get(oSymTable, "Ruth") == NULL);
+   iSuccessful = SymTable_put(oSymTable, "Ruth", "Right Field");
+   ASSURE(iSuccessful);
+   ASSURE(strcmp((char*)SymTable_get(oSymTable, "Ruth"),
+      "Right Field") == 0);
+
+   /* A shadowing put hides the cached key-value pair, and popping the
+      scope brings it back. */
+   iSuccessful = SymTable_pushScope(oSymTable);
+   ASSURE(iSuccessful);
+   iSuccessful = SymTable_put(oSymTable, "Ruth", "Pitcher");
+   ASSURE(iSuccessful);
+   ASSURE(strcmp((char*)SymTable_get(oSymTable, "Ruth"), "Pitcher")
+      == 0);
+   ASSURE(SymTable_remove(oSymTable, "Ruth") != NULL);
+   ASSURE(strcmp((char*)SymTable_get(oSymTable, "Ruth"), "Right Field")
+      == 0);
+   iSuccessful = SymTable_popScope(oSymTable);
+   ASSURE(iSuccessful);
+   ASSURE(strcmp((char*)SymTable_get(oSymTable, "Ruth"), "Right Field")
+      == 0);
+
+   /* A clone has a cache of its own. */
+   oClone = SymTable_clone(oSymTable);
+   ASSURE(oClone != NULL);
+   ASSURE(strcmp((char*)SymTable_get(oClone, "Ruth"), "Right Field")
+      == 0);
+   ASSURE(SymTable_remove(oClone, "Ruth") != NULL);
+   ASSURE(! SymTable_contains(oClone, "Ruth"));
+   ASSURE(SymTable_contains(oSymTable, "Ruth"));
+   SymTable_free(oClone);
+
+   /* Merging empties the table merged from. */
+   oOther = SymTable_new();
+   ASSURE(oOther != NULL);
+   iSuccessful = SymTable_enableCache(oOther);
+   ASSURE(iSuccessful == iCached);
+   iSuccessful = SymTable_put(oOther, "Gehrig", "First Base");
+   ASSURE(iSuccessful);
+   ASSURE(SymTable_contains(oOther, "Gehrig"));
+   iSuccessful = SymTable_merge(oSymTable, oOther, NULL, NULL);
+   ASSURE(iSuccessful);
+   ASSURE(! SymTable_contains(oOther, "Gehrig"));
+   ASSURE(SymTable_contains(oSymTable, "Gehrig"));
+   SymTable_free(oOther);
+
+   /* A cleared table forgets its keys. */
+   SymTable_clear(oSymTable);
+   ASSURE(! SymTable_contains(oSymTable, "Ruth"));
+   ASSURE(! SymTable_contains(oSymTable, "Gehrig"));
+
+   /* The repeated lookups were answered by the cache. */
+   if (SymTable_getStats(oSymTable, &sStats) && iCached)
+   {
+      ASSURE(sStats.uCacheHits >= 3 * REPEAT_COUNT / 2);
+      ASSURE(sStats.uCacheMisses > 0);
+   }
+   else
+      ASSURE(sStats.uCacheHits == 0);
+
+   SymTable_free(oSymTable);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test a SymTable through heavy removal: most of its keys are removed,
+   with and without open scopes, and the survivors must keep their
+   values. In the hash table implementation this squeezes the removed
+   key-value pairs out of its array while scopes are open. */
+
+static void testRemovalChurn(void)
+{
+   enum {MAX_KEY_LENGTH = 10, KEY_COUNT = 1000, KEEP_EVERY = 8};
+   SymTable_T oSymTable;
+   char acKey[MAX_KEY_LENGTH];
+   size_t uCount;
+   int iSuccessful;
+   int i;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing removal churn.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   oSymTable = SymTable_new();
+   ASSURE(oSymTable != NULL);
+
+   /* Remove all but every KEEP_EVERYth key. */
+   for (i = 0; i < KEY_COUNT; i++)
+   {
+      sprintf(acKey, "%d", i);
+      iSuccessful = SymTable_put(oSymTable, acKey, "outer");
+      ASSURE(iSuccessful);
+   }
+   for (i = 0; i < KEY_COUNT; i++)
+   {
+      sprintf(acKey, "%d", i);
+      if (i % KEEP_EVERY != 0)
+         ASSURE(SymTable_remove(oSymTable, acKey) != NULL);
+   }
+   ASSURE(SymTable_getLength(oSymTable) == KEY_COUNT / KEEP_EVERY);
+   uCount = 0;
+   SymTable_map(oSymTable, countBinding, &uCount);
+   ASSURE(uCount == KEY_COUNT / KEEP_EVERY);
+
+   /* Shadow the survivors, then put and pop a scope of new keys, and
+      put as many again, which refills the room those keys left while
+      the outer scope is open. */
+   iSuccessful = SymTable_pushScope(oSymTable);
+   ASSURE(iSuccessful);
+   for (i = 0; i < KEY_COUNT; i += KEEP_EVERY)
+   {
+      sprintf(acKey, "%d", i);
+      iSuccessful = SymTable_put(oSymTable, acKey, "shadow");
+      ASSURE(iSuccessful);
+   }
+   iSuccessful = SymTable_pushScope(oSymTable);
+   ASSURE(iSuccessful);
+   for (i = 0; i < KEY_COUNT; i++)
+   {
+      sprintf(acKey, "x%d", i);
+      iSuccessful = SymTable_put(oSymTable, acKey, "inner");
+      ASSURE(iSuccessful);
+   }
+   iSuccessful = SymTable_popScope(oSymTable);
+   ASSURE(iSuccessful);
+   for (i = 0; i < KEY_COUNT; i++)
+   {
+      sprintf(acKey, "y%d", i);
+      iSuccessful = SymTable_put(oSymTable, acKey, "refill");
+      ASSURE(iSuccessful);
+   }
+   for (i = 0; i < KEY_COUNT; i += KEEP_EVERY)
+   {
+      sprintf(acKey, "%d", i);
+      ASSURE(strcmp((char*)SymTable_remove(oSymTable, acKey), "shadow")
+         == 0);
+      ASSURE(strcmp((char*)SymTable_get(oSymTable, acKey), "outer")
+         == 0);
+   }
+   ASSURE(! SymTable_contains(oSymTable, "x0"));
+   ASSURE(strcmp((char*)SymTable_get(oSymTable, "y0"), "refill") == 0);
+
+   /* Popping the outer scope restores the survivors alone. */
+   iSuccessful = SymTable_popScope(oSymTable);
+   ASSURE(iSuccessful);
+   ASSURE(SymTable_getLength(oSymTable) == KEY_COUNT / KEEP_EVERY);
+   uCount = 0;
+   SymTable_map(oSymTable, countBinding, &uCount);
+   ASSURE(uCount == KEY_COUNT / KEEP_EVERY);
+   for (i = 0; i < KEY_COUNT; i++)
+   {
+      sprintf(acKey, "%d", i);
+      ASSURE(SymTable_contains(oSymTable, acKey) == (i % KEEP_EVERY == 0));
+      sprintf(acKey, "y%d", i);
+      ASSURE(! SymTable_contains(oSymTable, acKey));
+   }
+
+   /* Removing the rest leaves an empty table that still works. */
+   for (i = 0; i < KEY_COUNT; i += KEEP_EVERY)
+   {
+      sprintf(acKey, "%d", i);
+      ASSURE(strcmp((char*)SymTable_remove(oSymTable, acKey), "outer")
+         == 0);
+   }
+   ASSURE(SymTable_getLength(oSymTable) == 0);
+   iSuccessful = SymTable_put(oSymTable, "Ruth", "Right Field");
+   ASSURE(iSuccessful);
+   ASSURE(strcmp((char*)SymTable_get(oSymTable, "Ruth"), "Right Field")
+      == 0);
+
+   SymTable_free(oSymTable);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Evictions records the key-value pairs that a bounded SymTable
+   evicts: how many, and the key and value of the last one. */
+
+struct Evictions
+{
+   int iCount;
+   char acKey[10];
+   const char *pcValue;
+};
+
+/* Record the eviction of the binding whose key is pcKey and whose
+   value is pvValue in the Evictions pvExtra. */
+
+static void recordEviction(const char *pcKey, void *pvValue,
+   void *pvExtra)
+{
+   struct Evictions *psEvictions = (struct Evictions*)pvExtra;
+
+   assert(pcKey != NULL);
+   assert(pvExtra != NULL);
+
+   psEvictions->iCount++;
+   strncpy(psEvictions->acKey, pcKey, sizeof(psEvictions->acKey) - 1);
+   psEvictions->acKey[sizeof(psEvictions->acKey) - 1] = '\0';
+   psEvictions->pcValue = (const char*)pvValue;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test SymTable_newBounded. The implementations without a bound
+   return NULL, and the test stops there. A long run of puts, gets and
+   removals is checked against a list of the keys in order of use. */
+
+static void testBounded(void)
+{
+   enum {MAX_KEY_LENGTH = 10, BOUND = 50, KEY_COUNT = 200,
+      OP_COUNT = 20000};
+   SymTable_T oSymTable;
+   SymTable_T oOther;
+   SymTable_T oClone;
+   struct Evictions sEvictions;
+   char acKey[MAX_KEY_LENGTH];
+   int aiOrder[BOUND + 1];
+   int iOrderLength = 0;
+   unsigned long ulState = 217;
+   int iExpectedEvictions = 0;
+   int iSuccessful;
+   int iKey;
+   int iPosition;
+   int i;
+   int j;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing SymTable_newBounded.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   memset(&sEvictions, 0, sizeof(sEvictions));
+   oSymTable = SymTable_newBounded(3, recordEviction, &sEvictions);
+   if (oSymTable == NULL)
+      return;
+
+   /* The least recently put key goes first. */
+   iSuccessful = SymTable_put(oSymTable, "Ruth", "Right Field");
+   ASSURE(iSuccessful);
+   iSuccessful = SymTable_put(oSymTable, "Gehrig", "First Base");
+   ASSURE(iSuccessful);
+   iSuccessful = SymTable_put(oSymTable, "Mantle", "Center Field");
+   ASSURE(iSuccessful);
+   ASSURE(sEvictions.iCount == 0);
+   iSuccessful = SymTable_put(oSymTable, "Jeter", "Shortstop");
+   ASSURE(iSuccessful);
+   ASSURE(SymTable_getLength(oSymTable) == 3);
+   ASSURE(sEvictions.iCount == 1);
+   ASSURE(strcmp(sEvictions.acKey, "Ruth") == 0);
+   ASSURE(strcmp(sEvictions.pcValue, "Right Field") == 0);
+   ASSURE(! SymTable_contains(oSymTable, "Ruth"));
+
+   /* A get is a use, and a contains is not. */
+   ASSURE(strcmp((char*)SymTable_get(oSymTable, "Gehrig"),
+      "First Base") == 0);
+   ASSURE(SymTable_contains(oSymTable, "Mantle"));
+   iSuccessful = SymTable_put(oSymTable, "Berra", "Catcher");
+   ASSURE(iSuccessful);
+   ASSURE(strcmp(sEvictions.acKey, "Mantle") == 0);
+
+   /* A replace and an upsert of a key that is there are uses. */
+   ASSURE(strcmp((char*)SymTable_replace(oSymTable, "Jeter", "Captain"),
+      "Shortstop") == 0);
+   ASSURE(SymTable_upsert(oSymTable, "Gehrig", NULL) != NULL);
+   ASSURE(SymTable_upsert(oSymTable, "DiMaggio", NULL) != NULL);
+   ASSURE(sEvictions.iCount == 3);
+   ASSURE(strcmp(sEvictions.acKey, "Berra") == 0);
+   ASSURE(SymTable_contains(oSymTable, "Jeter"));
+   ASSURE(SymTable_contains(oSymTable, "Gehrig"));
+   ASSURE(SymTable_contains(oSymTable, "DiMaggio"));
+
+   /* A failed put, a removal and a scope evict nothing. */
+   iSuccessful = SymTable_put(oSymTable, "Jeter", "Shortstop");
+   ASSURE(! iSuccessful);
+   ASSURE(strcmp((char*)SymTable_remove(oSymTable, "Jeter"), "Captain")
+      == 0);
+   iSuccessful = SymTable_pushScope(oSymTable);
+   ASSURE(! iSuccessful);
+   ASSURE(sEvictions.iCount == 3);
+   ASSURE(SymTable_getLength(oSymTable) == 2);
+
+   /* A clone has the same bound and order of use. */
+   oClone = SymTable_clone(oSymTable);
+   ASSURE(oClone != NULL);
+   iSuccessful = SymTable_put(oClone, "Ruth", "Right Field");
+   ASSURE(iSuccessful);
+   iSuccessful = SymTable_put(oClone, "Mantle", "Center Field");
+   ASSURE(iSuccessful);
+   ASSURE(sEvictions.iCount == 4);
+   ASSURE(strcmp(sEvictions.acKey, "Gehrig") == 0);
+   ASSURE(SymTable_getLength(oClone) == 3);
+   ASSURE(SymTable_contains(oSymTable, "Gehrig"));
+   SymTable_free(oClone);
+
+   /* A merge makes the merged keys the most recently used. */
+   oOther = SymTable_new();
+   ASSURE(oOther != NULL);
+   iSuccessful = SymTable_put(oOther, "Ruth", "Right Field");
+   ASSURE(iSuccessful);
+   iSuccessful = SymTable_put(oOther, "Gehrig", "Pitcher");
+   ASSURE(iSuccessful);
+   iSuccessful = SymTable_put(oOther, "Mantle", "Center Field");
+   ASSURE(iSuccessful);
+   iSuccessful = SymTable_merge(oSymTable, oOther, NULL, NULL);
+   ASSURE(iSuccessful);
+   ASSURE(SymTable_getLength(oOther) == 0);
+   ASSURE(SymTable_getLength(oSymTable) == 3);
+   ASSURE(sEvictions.iCount == 5);
+   ASSURE(strcmp(sEvictions.acKey, "DiMaggio") == 0);
+   ASSURE(strcmp((char*)SymTable_get(oSymTable, "Gehrig"), "First Base")
+      == 0);
+   SymTable_free(oOther);
+
+   /* Clearing evicts nothing, and the bound still holds after. */
+   SymTable_clear(oSymTable);
+   ASSURE(SymTable_getLength(oSymTable) == 0);
+   ASSURE(sEvictions.iCount == 5);
+   SymTable_free(oSymTable);
+
+   /* A long run against aiOrder, the keys in order of use from the
+      least recently used. */
+   memset(&sEvictions, 0, sizeof(sEvictions));
+   oSymTable = SymTable_newBounded(BOUND, recordEviction, &sEvictions);
+   ASSURE(oSymTable != NULL);
+   for (i = 0; i < OP_COUNT; i++)
+   {
+      ulState = (ulState * 1103515245UL + 12345UL) & 0x7FFFFFFFUL;
+      iKey = (int)((ulState >> 8) % KEY_COUNT);
+      sprintf(acKey, "%d", iKey);
+      for (iPosition = 0; iPosition < iOrderLength; iPosition++)
+         if (aiOrder[iPosition] == iKey)
+            break;
+      if (ulState % 8 == 0)
+      {
+         /* Remove the key. */
+         ASSURE((SymTable_remove(oSymTable, acKey) != NULL)
+            == (iPosition < iOrderLength));
+         if (iPosition < iOrderLength)
+         {
+            for (j = iPosition; j < iOrderLength - 1; j++)
+               aiOrder[j] = aiOrder[j + 1];
+            iOrderLength--;
+         }
+         continue;
+      }
+      if (iPosition < iOrderLength)
+      {
+         /* Get the key, which makes it the most recently used. */
+         ASSURE(strcmp((char*)SymTable_get(oSymTable, acKey), "value")
+            == 0);
+         for (j = iPosition; j < iOrderLength - 1; j++)
+            aiOrder[j] = aiOrder[j + 1];
+         aiOrder[iOrderLength - 1] = iKey;
+         continue;
+      }
+      /* Put the key, which evicts the least recently used once the
+         table is full. */
+      ASSURE(! SymTable_contains(oSymTable, acKey));
+      iSuccessful = SymTable_put(oSymTable, acKey, "value");
+      ASSURE(iSuccessful);
+      aiOrder[iOrderLength++] = iKey;
+      if (iOrderLength > BOUND)
+      {
+         iExpectedEvictions++;
+         sprintf(acKey, "%d", aiOrder[0]);
+         ASSURE(strcmp(sEvictions.acKey, acKey) == 0);
+         for (j = 0; j < iOrderLength - 1; j++)
+            aiOrder[j] = aiOrder[j + 1];
+         iOrderLength--;
+      }
+      ASSURE(sEvictions.iCount == iExpectedEvictions);
+      ASSURE(SymTable_getLength(oSymTable) == (size_t)iOrderLength);
+   }
+   for (iKey = 0; iKey < KEY_COUNT; iKey++)
+   {
+      sprintf(acKey, "%d", iKey);
+      for (iPosition = 0; iPosition < iOrderLength; iPosition++)
+         if (aiOrder[iPosition] == iKey)
+            break;
+      ASSURE(SymTable_contains(oSymTable, acKey)
+         == (iPosition < iOrderLength));
+   }
+   ASSURE(iExpectedEvictions > 0);
+   SymTable_free(oSymTable);
+}
+
+/*--------------------------------------------------------------------*/
+
 static void testLargeTable(int iBindingCount)
 {
    enum {MAX_KEY_LENGTH = 10};
@@ -919,6 +3244,280 @@ static void testLargeTable(int iBindingCount)
 
 /*--------------------------------------------------------------------*/
 
+/* Put iBindingCount bindings into a SymTable object made with
+   SymTable_newWithCapacity, and print the CPU time consumed, which
+   can be compared with that of testLargeTable. Also reserve room in
+   a table that already has bindings. */
+
+static void testLargeReservedTable(int iBindingCount)
+{
+   /* MAX_KEY_LENGTH has room for the sign, the digits and the NUL of
+      any int. */
+   enum {MAX_KEY_LENGTH = 12, SMALL_COUNT = 100};
+
+   SymTable_T oSymTable;
+   SymTable_Stats sStats;
+   char acKey[MAX_KEY_LENGTH];
+   int i;
+   int iSuccessful;
+   clock_t iInitialClock;
+   clock_t iFinalClock;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing a potentially large SymTable object with reserved "
+      "capacity.\n");
+   printf("No output except CPU time consumed should appear here:\n");
+   fflush(stdout);
+
+   /* Reserving room keeps the bindings that are already there. */
+   oSymTable = SymTable_new();
+   ASSURE(oSymTable != NULL);
+   for (i = 0; i < SMALL_COUNT; i++)
+   {
+      sprintf(acKey, "%d", i);
+      iSuccessful = SymTable_put(oSymTable, acKey, NULL);
+      ASSURE(iSuccessful);
+   }
+   iSuccessful = SymTable_reserve(oSymTable, (size_t)iBindingCount);
+   ASSURE(iSuccessful);
+   iSuccessful = SymTable_reserve(oSymTable, 0);
+   ASSURE(iSuccessful);
+   ASSURE(SymTable_getLength(oSymTable) == SMALL_COUNT);
+   for (i = 0; i < SMALL_COUNT; i++)
+   {
+      sprintf(acKey, "%d", i);
+      ASSURE(SymTable_contains(oSymTable, acKey));
+   }
+   SymTable_free(oSymTable);
+
+   iInitialClock = clock();
+
+   oSymTable = SymTable_newWithCapacity((size_t)iBindingCount);
+   ASSURE(oSymTable != NULL);
+   for (i = 0; i < iBindingCount; i++)
+   {
+      sprintf(acKey, "%d", i);
+      iSuccessful = SymTable_put(oSymTable, acKey, NULL);
+      ASSURE(iSuccessful);
+   }
+   for (i = 0; i < iBindingCount; i++)
+   {
+      sprintf(acKey, "%d", i);
+      ASSURE(SymTable_contains(oSymTable, acKey));
+   }
+
+   /* The table never grew, unless it was asked for more than the
+      65521 buckets that a hash table can have. */
+   if (SymTable_getStats(oSymTable, &sStats) && iBindingCount <= 65521)
+      ASSURE(sStats.uResizes == 0);
+
+   SymTable_free(oSymTable);
+
+   iFinalClock = clock();
+   printf("CPU time (%d bindings, reserved):  %f seconds\n", iBindingCount,
+      ((double)(iFinalClock - iInitialClock)) / CLOCKS_PER_SEC);
+   fflush(stdout);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test SymTable_openLogged, SymTable_setLogBatch, SymTable_syncLog
+   and SymTable_checkpoint. Each table is reopened from its log and
+   checkpoint, and a long run of changes in batches is checked against
+   an unlogged table. */
+
+static void testLogged(void)
+{
+   enum {MAX_KEY_LENGTH = 10, KEY_COUNT = 300, OP_COUNT = 5000,
+      BATCH = 64};
+   SymTable_T oSymTable;
+   SymTable_T oExpected;
+   const char *pcPath = "testsymtable.log";
+   const char *pcCheckpoint = "testsymtable.log.checkpoint";
+   char acJeter[] = "Jeter";
+   char acMantle[] = "Mantle";
+   char acGehrig[] = "Gehrig";
+   char acRuth[] = "Ruth";
+   char acShortstop[] = "Shortstop";
+   char acCenterField[] = "Center Field";
+   char acFirstBase[] = "First Base";
+   char acRightField[] = "Right Field";
+   char acKey[MAX_KEY_LENGTH];
+   int aiValues[KEY_COUNT];
+   unsigned long ulState = 217;
+   FILE *psFile;
+   int iKey;
+   int i;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing SymTable_openLogged, SymTable_setLogBatch,\n");
+   printf("SymTable_syncLog and SymTable_checkpoint.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   remove(pcPath);
+   remove(pcCheckpoint);
+
+   oSymTable = SymTable_new();
+   ASSURE(oSymTable != NULL);
+   ASSURE(! SymTable_setLogBatch(oSymTable, BATCH));
+   ASSURE(! SymTable_syncLog(oSymTable));
+   ASSURE(! SymTable_checkpoint(oSymTable));
+   SymTable_free(oSymTable);
+
+   /* A new log starts empty, and its changes are there when it is
+      reopened. */
+   oSymTable = SymTable_openLogged(pcPath);
+   ASSURE(oSymTable != NULL);
+   ASSURE(SymTable_getLength(oSymTable) == 0);
+   ASSURE(SymTable_put(oSymTable, acJeter, acShortstop));
+   ASSURE(SymTable_put(oSymTable, acMantle, acCenterField));
+   ASSURE(SymTable_put(oSymTable, acGehrig, acFirstBase));
+   ASSURE(! SymTable_put(oSymTable, acGehrig, acRightField));
+   ASSURE(SymTable_replace(oSymTable, acGehrig, acRightField)
+      == acFirstBase);
+   ASSURE(SymTable_remove(oSymTable, acMantle) == acCenterField);
+   ASSURE(SymTable_remove(oSymTable, acRuth) == NULL);
+   ASSURE(SymTable_upsert(oSymTable, acRuth, NULL) == NULL);
+   ASSURE(! SymTable_pushScope(oSymTable));
+   ASSURE(SymTable_syncLog(oSymTable));
+   SymTable_free(oSymTable);
+
+   oSymTable = SymTable_openLogged(pcPath);
+   ASSURE(oSymTable != NULL);
+   ASSURE(SymTable_getLength(oSymTable) == 2);
+   ASSURE(SymTable_get(oSymTable, acJeter) == acShortstop);
+   ASSURE(SymTable_get(oSymTable, acGehrig) == acRightField);
+   ASSURE(! SymTable_contains(oSymTable, acMantle));
+
+   /* After a checkpoint the log holds only the later changes. */
+   ASSURE(SymTable_checkpoint(oSymTable));
+   ASSURE(SymTable_put(oSymTable, acRuth, acRightField));
+   SymTable_free(oSymTable);
+   oSymTable = SymTable_openLogged(pcPath);
+   ASSURE(oSymTable != NULL);
+   ASSURE(SymTable_getLength(oSymTable) == 3);
+   ASSURE(SymTable_get(oSymTable, acRuth) == acRightField);
+   ASSURE(SymTable_get(oSymTable, acJeter) == acShortstop);
+
+   /* A clear is logged too. */
+   SymTable_clear(oSymTable);
+   ASSURE(SymTable_put(oSymTable, acMantle, acCenterField));
+   SymTable_free(oSymTable);
+   oSymTable = SymTable_openLogged(pcPath);
+   ASSURE(oSymTable != NULL);
+   ASSURE(SymTable_getLength(oSymTable) == 1);
+   ASSURE(SymTable_get(oSymTable, acMantle) == acCenterField);
+
+   /* A checkpoint that already holds the logged changes, as after a
+      crash before the log was emptied, gives the same table. */
+   ASSURE(SymTable_put(oSymTable, acJeter, acShortstop));
+   ASSURE(SymTable_replace(oSymTable, acMantle, acFirstBase)
+      == acCenterField);
+   ASSURE(SymTable_remove(oSymTable, acJeter) == acShortstop);
+   ASSURE(SymTable_put(oSymTable, acJeter, acRightField));
+   ASSURE(SymTable_save(oSymTable, pcCheckpoint));
+   SymTable_free(oSymTable);
+   oSymTable = SymTable_openLogged(pcPath);
+   ASSURE(oSymTable != NULL);
+   ASSURE(SymTable_getLength(oSymTable) == 2);
+   ASSURE(SymTable_get(oSymTable, acMantle) == acFirstBase);
+   ASSURE(SymTable_get(oSymTable, acJeter) == acRightField);
+   SymTable_free(oSymTable);
+
+   /* A record cut short at the end of the log is dropped, and the
+      next records follow the last whole one. */
+   psFile = fopen(pcPath, "ab");
+   ASSURE(psFile != NULL);
+   if (psFile != NULL)
+   {
+      fputs("torn", psFile);
+      fclose(psFile);
+   }
+   oSymTable = SymTable_openLogged(pcPath);
+   ASSURE(oSymTable != NULL);
+   ASSURE(SymTable_getLength(oSymTable) == 2);
+   ASSURE(SymTable_put(oSymTable, acRuth, acShortstop));
+   SymTable_free(oSymTable);
+   oSymTable = SymTable_openLogged(pcPath);
+   ASSURE(oSymTable != NULL);
+   ASSURE(SymTable_getLength(oSymTable) == 3);
+   ASSURE(SymTable_get(oSymTable, acRuth) == acShortstop);
+   SymTable_free(oSymTable);
+
+   /* A log that is not a log is never overwritten. */
+   psFile = fopen(pcCheckpoint, "wb");
+   ASSURE(psFile != NULL);
+   if (psFile != NULL)
+   {
+      fputs("not a snapshot", psFile);
+      fclose(psFile);
+   }
+   ASSURE(SymTable_openLogged(pcPath) == NULL);
+   remove(pcCheckpoint);
+   remove(pcPath);
+
+   /* Changes made in batches, with checkpoints now and then, survive
+      every reopening. */
+   oSymTable = SymTable_openLogged(pcPath);
+   ASSURE(oSymTable != NULL);
+   oExpected = SymTable_new();
+   ASSURE(oExpected != NULL);
+   ASSURE(SymTable_setLogBatch(oSymTable, BATCH));
+   for (i = 0; i < KEY_COUNT; i++)
+      aiValues[i] = i;
+   for (i = 0; i < OP_COUNT; i++)
+   {
+      ulState = ulState * 1103515245UL + 12345UL;
+      iKey = (int)((ulState >> 8) % KEY_COUNT);
+      sprintf(acKey, "%d", iKey);
+      switch ((ulState >> 20) % 4)
+      {
+         case 0:
+            ASSURE(SymTable_put(oSymTable, acKey, &aiValues[iKey])
+               == SymTable_put(oExpected, acKey, &aiValues[iKey]));
+            break;
+         case 1:
+            ASSURE(SymTable_replace(oSymTable, acKey,
+               &aiValues[(iKey + i) % KEY_COUNT])
+               == SymTable_replace(oExpected, acKey,
+               &aiValues[(iKey + i) % KEY_COUNT]));
+            break;
+         default:
+            ASSURE(SymTable_remove(oSymTable, acKey)
+               == SymTable_remove(oExpected, acKey));
+            break;
+      }
+      if (i % 1000 == 999)
+      {
+         if (i % 2000 == 999)
+            ASSURE(SymTable_checkpoint(oSymTable));
+         SymTable_free(oSymTable);
+         oSymTable = SymTable_openLogged(pcPath);
+         ASSURE(oSymTable != NULL);
+         if (oSymTable == NULL)
+            break;
+         ASSURE(SymTable_setLogBatch(oSymTable, BATCH));
+         ASSURE(SymTable_getLength(oSymTable)
+            == SymTable_getLength(oExpected));
+         for (iKey = 0; iKey < KEY_COUNT; iKey++)
+         {
+            sprintf(acKey, "%d", iKey);
+            ASSURE(SymTable_get(oSymTable, acKey)
+               == SymTable_get(oExpected, acKey));
+         }
+      }
+   }
+   if (oSymTable != NULL)
+      SymTable_free(oSymTable);
+   SymTable_free(oExpected);
+
+   remove(pcPath);
+   remove(pcCheckpoint);
+}
+
+/*--------------------------------------------------------------------*/
+
 /* Test the SymTable ADT.  Write the output of the tests to stdout.
    As always, argc is the command-line argument count, argv contains
    the command-line arguments, and argv[0] is the name of the
@@ -962,7 +3561,27 @@ int main(int argc, char *argv[])
    testLongKey();
    testTableOfTables();
    testCollisions();
+   testSaveAndOpenMapped();
+   testSnapshot();
+   testScopes();
+   testStats();
+   testMemoryUsage();
+   testAllocator();
+   testClear();
+   testUpsert();
+   testLengthKeys();
+   testPutBorrowed();
+   testFromArrays();
+   testMerge();
+   testClone();
+   testFilter();
+   testCache();
+   testRemovalChurn();
+   testBounded();
+   testLogged();
    testLargeTable(iBindingCount);
+   testLargeReservedTable(iBindingCount);
+   testLargeSnapshot(iBindingCount);
 
    printf("------------------------------------------------------\n");
    printf("End of %s.\n", argv[0]);
@@ -0,0 +1,435 @@
+/*--------------------------------------------------------------------*/
+/* testsymtabledefine.c                                               */
+/* Author: Tharun Kumar Tiruppali Kalidoss                            */
+/*--------------------------------------------------------------------*/
+
+#include "symtable.h"
+#include "symtabledefine.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <string.h>
+#include <assert.h>
+
+/*--------------------------------------------------------------------*/
+
+#define ASSURE(i) assure(i, __LINE__)
+
+/* MAX_KEY_LENGTH is the size of the buffers that hold decimal keys. */
+enum {MAX_KEY_LENGTH = 12};
+
+/* StrIntTable_T maps strings to ints. */
+SYMTABLE_DEFINE(StrIntTable, const char *, int, SymTableDefine_hashString,
+   SymTableDefine_equalString);
+
+/* LongDoubleTable_T maps longs to doubles. */
+SYMTABLE_DEFINE(LongDoubleTable, long, double, SymTableDefine_hashLong,
+   SymTableDefine_equalLong);
+
+/*--------------------------------------------------------------------*/
+
+/* If !iSuccessful, print a message to stdout indicating that the
+   test at line iLineNum failed. */
+
+static void assure(int iSuccessful, int iLineNum)
+{
+   if (! iSuccessful)
+   {
+      printf("Test at line %d failed.\n", iLineNum);
+      fflush(stdout);
+   }
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Add *piValue to the sum pointed to by pvExtra, then double
+   *piValue. pcKey is unused. */
+
+static void sumAndDouble(const char *pcKey, int *piValue, void *pvExtra)
+{
+   assert(pcKey != NULL);
+   assert(piValue != NULL);
+   assert(pvExtra != NULL);
+
+   *(int*)pvExtra += *piValue;
+   *piValue *= 2;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test the functions of a table defined with SYMTABLE_DEFINE. */
+
+static void testBasics(void)
+{
+   StrIntTable_T oTable;
+   char acJeter[] = "Jeter";
+   int *piValue;
+   int iOldValue;
+   int iSuccessful;
+   int iFound;
+   int iSum;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing the functions of a SYMTABLE_DEFINE table.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   oTable = StrIntTable_new();
+   ASSURE(oTable != NULL);
+   ASSURE(StrIntTable_getLength(oTable) == 0);
+   ASSURE(StrIntTable_get(oTable, "Jeter") == NULL);
+
+   iSuccessful = StrIntTable_put(oTable, acJeter, 2);
+   ASSURE(iSuccessful);
+   iSuccessful = StrIntTable_put(oTable, "Mantle", 7);
+   ASSURE(iSuccessful);
+   iSuccessful = StrIntTable_put(oTable, "Gehrig", 4);
+   ASSURE(iSuccessful);
+   iSuccessful = StrIntTable_put(oTable, "", 0);
+   ASSURE(iSuccessful);
+   ASSURE(StrIntTable_getLength(oTable) == 4);
+
+   /* A key is found by its characters, not by its address. */
+   iSuccessful = StrIntTable_put(oTable, "Jeter", 3);
+   ASSURE(! iSuccessful);
+   ASSURE(StrIntTable_getLength(oTable) == 4);
+
+   piValue = StrIntTable_get(oTable, "Jeter");
+   ASSURE(piValue != NULL && *piValue == 2);
+   piValue = StrIntTable_get(oTable, "Mantle");
+   ASSURE(piValue != NULL && *piValue == 7);
+   piValue = StrIntTable_get(oTable, "");
+   ASSURE(piValue != NULL && *piValue == 0);
+   iFound = StrIntTable_contains(oTable, "Gehrig");
+   ASSURE(iFound);
+   iFound = StrIntTable_contains(oTable, "Ruth");
+   ASSURE(! iFound);
+
+   /* The value can be changed through the pointer that get
+      returns. */
+   piValue = StrIntTable_get(oTable, "Gehrig");
+   ASSURE(piValue != NULL);
+   if (piValue != NULL)
+      *piValue = 5;
+   piValue = StrIntTable_get(oTable, "Gehrig");
+   ASSURE(piValue != NULL && *piValue == 5);
+
+   iSuccessful = StrIntTable_replace(oTable, "Mantle", 8, &iOldValue);
+   ASSURE(iSuccessful);
+   ASSURE(iOldValue == 7);
+   iSuccessful = StrIntTable_replace(oTable, "Mantle", 9, NULL);
+   ASSURE(iSuccessful);
+   piValue = StrIntTable_get(oTable, "Mantle");
+   ASSURE(piValue != NULL && *piValue == 9);
+   iSuccessful = StrIntTable_replace(oTable, "Ruth", 3, &iOldValue);
+   ASSURE(! iSuccessful);
+   iFound = StrIntTable_contains(oTable, "Ruth");
+   ASSURE(! iFound);
+
+   iSum = 0;
+   StrIntTable_map(oTable, sumAndDouble, &iSum);
+   ASSURE(iSum == 2 + 9 + 5 + 0);
+   piValue = StrIntTable_get(oTable, "Jeter");
+   ASSURE(piValue != NULL && *piValue == 4);
+
+   iSuccessful = StrIntTable_remove(oTable, "Jeter", &iOldValue);
+   ASSURE(iSuccessful);
+   ASSURE(iOldValue == 4);
+   iSuccessful = StrIntTable_remove(oTable, "Jeter", &iOldValue);
+   ASSURE(! iSuccessful);
+   iSuccessful = StrIntTable_remove(oTable, "", NULL);
+   ASSURE(iSuccessful);
+   ASSURE(StrIntTable_getLength(oTable) == 2);
+
+   StrIntTable_clear(oTable);
+   ASSURE(StrIntTable_getLength(oTable) == 0);
+   iFound = StrIntTable_contains(oTable, "Mantle");
+   ASSURE(! iFound);
+   iSuccessful = StrIntTable_put(oTable, "Mantle", 7);
+   ASSURE(iSuccessful);
+
+   StrIntTable_free(oTable);
+   StrIntTable_free(NULL);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Put more keys into a table than its largest bucket count, so that
+   it goes through every bucket count, check every key, then remove
+   half of them and check every key again. */
+
+static void testGrowth(void)
+{
+   enum {KEY_COUNT = 100000};
+
+   LongDoubleTable_T oTable;
+   double *pdValue;
+   double dOldValue = 0.0;
+   long l;
+   int iSuccessful;
+   int iFound;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing a growing SYMTABLE_DEFINE table.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   oTable = LongDoubleTable_new();
+   ASSURE(oTable != NULL);
+   for (l = 0; l < KEY_COUNT; l++)
+   {
+      iSuccessful = LongDoubleTable_put(oTable, -l * 1021, l + 0.5);
+      ASSURE(iSuccessful);
+   }
+   ASSURE(LongDoubleTable_getLength(oTable) == KEY_COUNT);
+
+   for (l = 0; l < KEY_COUNT; l++)
+   {
+      pdValue = LongDoubleTable_get(oTable, -l * 1021);
+      ASSURE(pdValue != NULL && *pdValue == l + 0.5);
+   }
+   iFound = LongDoubleTable_contains(oTable, 1021);
+   ASSURE(! iFound);
+
+   for (l = 0; l < KEY_COUNT; l += 2)
+   {
+      iSuccessful = LongDoubleTable_remove(oTable, -l * 1021, &dOldValue);
+      ASSURE(iSuccessful);
+      ASSURE(dOldValue == l + 0.5);
+   }
+   ASSURE(LongDoubleTable_getLength(oTable) == KEY_COUNT / 2);
+   for (l = 0; l < KEY_COUNT; l++)
+   {
+      iFound = LongDoubleTable_contains(oTable, -l * 1021);
+      ASSURE(iFound == (l % 2 == 1));
+   }
+
+   LongDoubleTable_free(oTable);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return a buffer of iBindingCount keys, the decimal numbers 0 to
+   iBindingCount-1, each MAX_KEY_LENGTH bytes apart. */
+
+static char *makeKeys(int iBindingCount)
+{
+   char *pcKeys;
+   int i;
+
+   pcKeys = (char*)malloc((size_t)iBindingCount * MAX_KEY_LENGTH + 1);
+   ASSURE(pcKeys != NULL);
+   if (pcKeys == NULL)
+      exit(EXIT_FAILURE);
+   for (i = 0; i < iBindingCount; i++)
+      sprintf(pcKeys + (size_t)i * MAX_KEY_LENGTH, "%d", i);
+   return pcKeys;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Run the workload of the large table test of testsymtable.c on a
+   SymTable with the iBindingCount keys at pcKeys, each bound to its
+   number: put every key, with SymTable_putBorrowed if iBorrowed is 1,
+   get them alternating from the smallest and the largest remaining
+   key, and remove them in the same order. Return the CPU time
+   consumed. */
+
+static clock_t runSymTable(const char *pcKeys, int iBindingCount,
+   int iBorrowed)
+{
+   SymTable_T oSymTable;
+   const char *pcKey;
+   void *pvValue;
+   int i;
+   int iSmall;
+   int iLarge;
+   int iSuccessful;
+   clock_t iInitialClock;
+   clock_t iFinalClock;
+
+   iInitialClock = clock();
+   oSymTable = SymTable_new();
+   ASSURE(oSymTable != NULL);
+   for (i = 0; i < iBindingCount; i++)
+   {
+      pcKey = pcKeys + (size_t)i * MAX_KEY_LENGTH;
+      if (iBorrowed)
+         iSuccessful = SymTable_putBorrowed(oSymTable, pcKey,
+            (void*)(size_t)i);
+      else
+         iSuccessful = SymTable_put(oSymTable, pcKey, (void*)(size_t)i);
+      ASSURE(iSuccessful);
+   }
+
+   iSmall = 0;
+   iLarge = iBindingCount - 1;
+   while (iSmall <= iLarge)
+   {
+      pvValue = SymTable_get(oSymTable,
+         pcKeys + (size_t)iSmall * MAX_KEY_LENGTH);
+      ASSURE((size_t)pvValue == (size_t)iSmall);
+      iSmall++;
+      pvValue = SymTable_get(oSymTable,
+         pcKeys + (size_t)iLarge * MAX_KEY_LENGTH);
+      ASSURE((size_t)pvValue == (size_t)iLarge);
+      iLarge--;
+   }
+
+   iSmall = 0;
+   iLarge = iBindingCount - 1;
+   while (iSmall <= iLarge)
+   {
+      pvValue = SymTable_remove(oSymTable,
+         pcKeys + (size_t)iSmall * MAX_KEY_LENGTH);
+      ASSURE((size_t)pvValue == (size_t)iSmall);
+      iSmall++;
+      if (iSmall > iLarge)
+         break;
+      pvValue = SymTable_remove(oSymTable,
+         pcKeys + (size_t)iLarge * MAX_KEY_LENGTH);
+      ASSURE((size_t)pvValue == (size_t)iLarge);
+      iLarge--;
+   }
+   ASSURE(SymTable_getLength(oSymTable) == 0);
+   SymTable_free(oSymTable);
+   iFinalClock = clock();
+
+   return iFinalClock - iInitialClock;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Run the same workload as runSymTable on a StrIntTable_T. Return
+   the CPU time consumed. */
+
+static clock_t runStrIntTable(const char *pcKeys, int iBindingCount)
+{
+   StrIntTable_T oTable;
+   int *piValue;
+   int iValue = 0;
+   int i;
+   int iSmall;
+   int iLarge;
+   int iSuccessful;
+   clock_t iInitialClock;
+   clock_t iFinalClock;
+
+   iInitialClock = clock();
+   oTable = StrIntTable_new();
+   ASSURE(oTable != NULL);
+   for (i = 0; i < iBindingCount; i++)
+   {
+      iSuccessful = StrIntTable_put(oTable,
+         pcKeys + (size_t)i * MAX_KEY_LENGTH, i);
+      ASSURE(iSuccessful);
+   }
+
+   iSmall = 0;
+   iLarge = iBindingCount - 1;
+   while (iSmall <= iLarge)
+   {
+      piValue = StrIntTable_get(oTable,
+         pcKeys + (size_t)iSmall * MAX_KEY_LENGTH);
+      ASSURE(piValue != NULL && *piValue == iSmall);
+      iSmall++;
+      piValue = StrIntTable_get(oTable,
+         pcKeys + (size_t)iLarge * MAX_KEY_LENGTH);
+      ASSURE(piValue != NULL && *piValue == iLarge);
+      iLarge--;
+   }
+
+   iSmall = 0;
+   iLarge = iBindingCount - 1;
+   while (iSmall <= iLarge)
+   {
+      iSuccessful = StrIntTable_remove(oTable,
+         pcKeys + (size_t)iSmall * MAX_KEY_LENGTH, &iValue);
+      ASSURE(iSuccessful && iValue == iSmall);
+      iSmall++;
+      if (iSmall > iLarge)
+         break;
+      iSuccessful = StrIntTable_remove(oTable,
+         pcKeys + (size_t)iLarge * MAX_KEY_LENGTH, &iValue);
+      ASSURE(iSuccessful && iValue == iLarge);
+      iLarge--;
+   }
+   ASSURE(StrIntTable_getLength(oTable) == 0);
+   StrIntTable_free(oTable);
+   iFinalClock = clock();
+
+   return iFinalClock - iInitialClock;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Run the large table workload with iBindingCount string keys bound
+   to ints on a SymTable, once copying the keys and once borrowing
+   them, and on a StrIntTable_T, and write to stdout the CPU time
+   consumed by each. */
+
+static void testLargeTable(int iBindingCount)
+{
+   char *pcKeys;
+   clock_t iCopiedClock;
+   clock_t iBorrowedClock;
+   clock_t iTypedClock;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing a potentially large SYMTABLE_DEFINE table.\n");
+   printf("No output except CPU time consumed should appear here:\n");
+   fflush(stdout);
+
+   pcKeys = makeKeys(iBindingCount);
+   iCopiedClock = runSymTable(pcKeys, iBindingCount, 0);
+   iBorrowedClock = runSymTable(pcKeys, iBindingCount, 1);
+   iTypedClock = runStrIntTable(pcKeys, iBindingCount);
+   free(pcKeys);
+
+   printf("SymTable_put CPU time (%d bindings):  %f seconds\n",
+      iBindingCount, ((double)iCopiedClock) / CLOCKS_PER_SEC);
+   printf("SymTable_putBorrowed CPU time (%d bindings):  %f seconds\n",
+      iBindingCount, ((double)iBorrowedClock) / CLOCKS_PER_SEC);
+   printf("StrIntTable CPU time (%d bindings):  %f seconds\n",
+      iBindingCount, ((double)iTypedClock) / CLOCKS_PER_SEC);
+   fflush(stdout);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test SYMTABLE_DEFINE.  Write the output of the tests to stdout. As
+   always, argc is the command-line argument count, argv contains the
+   command-line arguments, and argv[0] is the name of the executable
+   binary file. argv[1] is the number of bindings to put into a
+   potentially large table.  Exit with EXIT_FAILURE if argv[1] is
+   missing or not numeric.  Otherwise return 0. */
+
+int main(int argc, char *argv[])
+{
+   int iBindingCount;
+
+   if (argc != 2)
+   {
+      fprintf(stderr, "Usage: %s bindingcount\n", argv[0]);
+      exit(EXIT_FAILURE);
+   }
+
+   if (sscanf(argv[1], "%d", &iBindingCount) != 1)
+   {
+      fprintf(stderr, "bindingcount must be numeric\n");
+      exit(EXIT_FAILURE);
+   }
+   if (iBindingCount < 0)
+   {
+      fprintf(stderr, "bindingcount cannot be negative\n");
+      exit(EXIT_FAILURE);
+   }
+
+   testBasics();
+   testGrowth();
+   testLargeTable(iBindingCount);
+
+   printf("------------------------------------------------------\n");
+   printf("End of %s.\n", argv[0]);
+   return 0;
+}
@@ -0,0 +1,312 @@
+/*--------------------------------------------------------------------*/
+/* testsymtablefrozen.c                                               */
+/* Author: Tharun Kumar Tiruppali Kalidoss                            */
+/*--------------------------------------------------------------------*/
+
+#include "symtable.h"
+#include "symtablefrozen.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <string.h>
+#include <assert.h>
+#include <malloc.h>
+
+/*--------------------------------------------------------------------*/
+
+#define ASSURE(i) assure(i, __LINE__)
+
+/* MAX_KEY_LENGTH is the size of the buffers that hold decimal keys. */
+enum {MAX_KEY_LENGTH = 12};
+
+/*--------------------------------------------------------------------*/
+
+/* If !iSuccessful, print a message to stdout indicating that the
+   test at line iLineNum failed. */
+
+static void assure(int iSuccessful, int iLineNum)
+{
+   if (! iSuccessful)
+   {
+      printf("Test at line %d failed.\n", iLineNum);
+      fflush(stdout);
+   }
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Increment the counter pointed to by pvExtra. pcKey and pvValue
+   are unused. */
+
+static void countBinding(const char *pcKey, void *pvValue,
+   void *pvExtra)
+{
+   assert(pcKey != NULL);
+   assert(pvExtra != NULL);
+   (void)pvValue;
+
+   (*(size_t*)pvExtra)++;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return the number of bytes of heap memory currently allocated by
+   the process, as reported by the C library. */
+
+static size_t heapInUse(void)
+{
+   struct mallinfo2 sInfo = mallinfo2();
+   return sInfo.uordblks + sInfo.hblkhd;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test the most basic SymTableFrozen functions. */
+
+static void testBasics(void)
+{
+   SymTable_T oSymTable;
+   SymTableFrozen_T oSymTableFrozen;
+   char acShortstop[] = "Shortstop";
+   char acCenterField[] = "Center Field";
+   char acFirstBase[] = "First Base";
+   char *pcValue;
+   int iSuccessful;
+   int iFound;
+   size_t uCount;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing the most basic SymTableFrozen functions.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   oSymTable = SymTable_new();
+   ASSURE(oSymTable != NULL);
+
+   /* An empty table freezes into an empty frozen table. */
+   oSymTableFrozen = SymTable_freeze(oSymTable);
+   ASSURE(oSymTableFrozen != NULL);
+   ASSURE(SymTableFrozen_getLength(oSymTableFrozen) == 0);
+   iFound = SymTableFrozen_contains(oSymTableFrozen, "Jeter");
+   ASSURE(! iFound);
+   SymTableFrozen_free(oSymTableFrozen);
+
+   iSuccessful = SymTable_put(oSymTable, "Jeter", acShortstop);
+   ASSURE(iSuccessful);
+   iSuccessful = SymTable_put(oSymTable, "Mantle", acCenterField);
+   ASSURE(iSuccessful);
+   iSuccessful = SymTable_put(oSymTable, "Gehrig", acFirstBase);
+   ASSURE(iSuccessful);
+   iSuccessful = SymTable_put(oSymTable, "", NULL);
+   ASSURE(iSuccessful);
+
+   oSymTableFrozen = SymTable_freeze(oSymTable);
+   ASSURE(oSymTableFrozen != NULL);
+
+   /* The frozen table must not depend on the original. */
+   SymTable_free(oSymTable);
+
+   ASSURE(SymTableFrozen_getLength(oSymTableFrozen) == 4);
+
+   pcValue = (char*)SymTableFrozen_get(oSymTableFrozen, "Jeter");
+   ASSURE(pcValue == acShortstop);
+   pcValue = (char*)SymTableFrozen_get(oSymTableFrozen, "Mantle");
+   ASSURE(pcValue == acCenterField);
+   pcValue = (char*)SymTableFrozen_get(oSymTableFrozen, "Gehrig");
+   ASSURE(pcValue == acFirstBase);
+
+   iFound = SymTableFrozen_contains(oSymTableFrozen, "");
+   ASSURE(iFound);
+   pcValue = (char*)SymTableFrozen_get(oSymTableFrozen, "");
+   ASSURE(pcValue == NULL);
+
+   iFound = SymTableFrozen_contains(oSymTableFrozen, "Ruth");
+   ASSURE(! iFound);
+   pcValue = (char*)SymTableFrozen_get(oSymTableFrozen, "Ruth");
+   ASSURE(pcValue == NULL);
+
+   uCount = 0;
+   SymTableFrozen_map(oSymTableFrozen, countBinding, &uCount);
+   ASSURE(uCount == 4);
+
+   SymTableFrozen_free(oSymTableFrozen);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Fill oSymTable with iBindingCount bindings whose keys are the
+   decimal numbers 0 to iBindingCount-1, each bound to the value
+   (void*)(i+1). */
+
+static void fillTable(SymTable_T oSymTable, int iBindingCount)
+{
+   char acKey[MAX_KEY_LENGTH];
+   int i;
+   int iSuccessful;
+
+   for (i = 0; i < iBindingCount; i++)
+   {
+      sprintf(acKey, "%d", i);
+      iSuccessful = SymTable_put(oSymTable, acKey, (void*)(size_t)(i + 1));
+      ASSURE(iSuccessful);
+   }
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return a buffer of iBindingCount keys, each MAX_KEY_LENGTH bytes
+   apart, in random order: the decimal numbers 0 to iBindingCount-1 if
+   iMiss is 0, and keys that are absent from a table filled by
+   fillTable otherwise. The order is shuffled so that lookups do not
+   walk the buckets of a hash table in sequence. */
+
+static char *makeKeys(int iBindingCount, int iMiss)
+{
+   char acKey[MAX_KEY_LENGTH];
+   char *pcKeys;
+   int i;
+   int j;
+
+   pcKeys = (char*)malloc((size_t)iBindingCount * MAX_KEY_LENGTH + 1);
+   ASSURE(pcKeys != NULL);
+   if (pcKeys == NULL)
+      exit(EXIT_FAILURE);
+   for (i = 0; i < iBindingCount; i++)
+      sprintf(pcKeys + (size_t)i * MAX_KEY_LENGTH, "%d",
+         iMiss ? -i - 1 : i);
+   srand(217);
+   for (i = iBindingCount - 1; i > 0; i--)
+   {
+      j = rand() % (i + 1);
+      memcpy(acKey, pcKeys + (size_t)i * MAX_KEY_LENGTH, MAX_KEY_LENGTH);
+      memcpy(pcKeys + (size_t)i * MAX_KEY_LENGTH,
+         pcKeys + (size_t)j * MAX_KEY_LENGTH, MAX_KEY_LENGTH);
+      memcpy(pcKeys + (size_t)j * MAX_KEY_LENGTH, acKey, MAX_KEY_LENGTH);
+   }
+   return pcKeys;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Freeze a table of iBindingCount bindings, check every binding and
+   as many misses, and write to stdout the CPU time consumed by the
+   same lookups in the SymTable and in the SymTableFrozen, and the
+   heap memory used by each. */
+
+static void testLargeTable(int iBindingCount)
+{
+   SymTable_T oSymTable;
+   SymTableFrozen_T oSymTableFrozen;
+   char *pcHitKeys;
+   char *pcMissKeys;
+   int i;
+   size_t uHits;
+   size_t uHeapBefore;
+   size_t uTableBytes;
+   size_t uFrozenBytes;
+   clock_t iInitialClock;
+   clock_t iFinalClock;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing a potentially large SymTableFrozen object.\n");
+   printf("No output except CPU time and memory should appear here:\n");
+   fflush(stdout);
+
+   uHeapBefore = heapInUse();
+   oSymTable = SymTable_new();
+   ASSURE(oSymTable != NULL);
+   fillTable(oSymTable, iBindingCount);
+   uTableBytes = heapInUse() - uHeapBefore;
+
+   uHeapBefore = heapInUse();
+   iInitialClock = clock();
+   oSymTableFrozen = SymTable_freeze(oSymTable);
+   iFinalClock = clock();
+   uFrozenBytes = heapInUse() - uHeapBefore;
+   ASSURE(oSymTableFrozen != NULL);
+   ASSURE(SymTableFrozen_getLength(oSymTableFrozen)
+      == (size_t)iBindingCount);
+   printf("Freeze time (%d bindings):  %f seconds\n", iBindingCount,
+      ((double)(iFinalClock - iInitialClock)) / CLOCKS_PER_SEC);
+
+   /* Look up every key, then as many keys that are absent. */
+   pcHitKeys = makeKeys(iBindingCount, 0);
+   pcMissKeys = makeKeys(iBindingCount, 1);
+
+   uHits = 0;
+   iInitialClock = clock();
+   for (i = 0; i < iBindingCount; i++)
+      uHits += SymTable_get(oSymTable,
+         pcHitKeys + (size_t)i * MAX_KEY_LENGTH) != NULL;
+   for (i = 0; i < iBindingCount; i++)
+      uHits += (size_t)SymTable_contains(oSymTable,
+         pcMissKeys + (size_t)i * MAX_KEY_LENGTH);
+   iFinalClock = clock();
+   ASSURE(uHits == (size_t)iBindingCount);
+   printf("SymTable lookup time (%d hits, %d misses):  %f seconds\n",
+      iBindingCount, iBindingCount,
+      ((double)(iFinalClock - iInitialClock)) / CLOCKS_PER_SEC);
+
+   uHits = 0;
+   iInitialClock = clock();
+   for (i = 0; i < iBindingCount; i++)
+      uHits += SymTableFrozen_get(oSymTableFrozen,
+         pcHitKeys + (size_t)i * MAX_KEY_LENGTH) != NULL;
+   for (i = 0; i < iBindingCount; i++)
+      uHits += (size_t)SymTableFrozen_contains(oSymTableFrozen,
+         pcMissKeys + (size_t)i * MAX_KEY_LENGTH);
+   iFinalClock = clock();
+   ASSURE(uHits == (size_t)iBindingCount);
+   printf("SymTableFrozen lookup time (%d hits, %d misses):  %f seconds\n",
+      iBindingCount, iBindingCount,
+      ((double)(iFinalClock - iInitialClock)) / CLOCKS_PER_SEC);
+   printf("SymTable memory (%d bindings):  %lu bytes\n",
+      iBindingCount, (unsigned long)uTableBytes);
+   printf("SymTableFrozen memory (%d bindings):  %lu bytes\n",
+      iBindingCount, (unsigned long)uFrozenBytes);
+   fflush(stdout);
+
+   free(pcHitKeys);
+   free(pcMissKeys);
+   SymTableFrozen_free(oSymTableFrozen);
+   SymTable_free(oSymTable);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test the SymTableFrozen ADT.  Write the output of the tests to
+   stdout. As always, argc is the command-line argument count, argv
+   contains the command-line arguments, and argv[0] is the name of the
+   executable binary file. argv[1] is the number of bindings to put
+   into a potentially large SymTableFrozen object.  Exit with
+   EXIT_FAILURE if argv[1] is missing or not numeric.  Otherwise
+   return 0. */
+
+int main(int argc, char *argv[])
+{
+   int iBindingCount;
+
+   if (argc != 2)
+   {
+      fprintf(stderr, "Usage: %s bindingcount\n", argv[0]);
+      exit(EXIT_FAILURE);
+   }
+
+   if (sscanf(argv[1], "%d", &iBindingCount) != 1)
+   {
+      fprintf(stderr, "bindingcount must be numeric\n");
+      exit(EXIT_FAILURE);
+   }
+   if (iBindingCount < 0)
+   {
+      fprintf(stderr, "bindingcount cannot be negative\n");
+      exit(EXIT_FAILURE);
+   }
+
+   testBasics();
+   testLargeTable(iBindingCount);
+
+   printf("------------------------------------------------------\n");
+   printf("End of %s.\n", argv[0]);
+   return 0;
+}
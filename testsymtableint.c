@@ -0,0 +1,451 @@
+/*--------------------------------------------------------------------*/
+/* testsymtableint.c                                                  */
+/* Author: Tharun Kumar Tiruppali Kalidoss                            */
+/*--------------------------------------------------------------------*/
+
+#include "symtable.h"
+#include "symtableint.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <string.h>
+#include <limits.h>
+#include <assert.h>
+#include <malloc.h>
+
+/*--------------------------------------------------------------------*/
+
+#define ASSURE(i) assure(i, __LINE__)
+
+/* MAX_KEY_LENGTH is the size of the buffers that hold decimal keys. */
+enum {MAX_KEY_LENGTH = 12};
+
+/*--------------------------------------------------------------------*/
+
+/* If !iSuccessful, print a message to stdout indicating that the
+   test at line iLineNum failed. */
+
+static void assure(int iSuccessful, int iLineNum)
+{
+   if (! iSuccessful)
+   {
+      printf("Test at line %d failed.\n", iLineNum);
+      fflush(stdout);
+   }
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Add lKey to the sum pointed to by pvExtra, and check that pvValue
+   is (void*)(lKey+1). */
+
+static void sumKeys(long lKey, void *pvValue, void *pvExtra)
+{
+   assert(pvExtra != NULL);
+
+   ASSURE(pvValue == (void*)(size_t)(lKey + 1));
+   *(long*)pvExtra += lKey;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return the number of bytes of heap memory currently allocated by
+   the process, as reported by the C library. */
+
+static size_t heapInUse(void)
+{
+   struct mallinfo2 sInfo = mallinfo2();
+   return sInfo.uordblks + sInfo.hblkhd;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test the most basic SymTableInt functions. */
+
+static void testBasics(void)
+{
+   SymTableInt_T oSymTableInt;
+   char acShortstop[] = "Shortstop";
+   char acCenterField[] = "Center Field";
+   char acFirstBase[] = "First Base";
+   char *pcValue;
+   int iSuccessful;
+   int iFound;
+   long lSum;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing the most basic SymTableInt functions.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   oSymTableInt = SymTableInt_new();
+   ASSURE(oSymTableInt != NULL);
+   ASSURE(SymTableInt_getLength(oSymTableInt) == 0);
+   iFound = SymTableInt_contains(oSymTableInt, 2);
+   ASSURE(! iFound);
+
+   iSuccessful = SymTableInt_put(oSymTableInt, 2, acShortstop);
+   ASSURE(iSuccessful);
+   iSuccessful = SymTableInt_put(oSymTableInt, 7, acCenterField);
+   ASSURE(iSuccessful);
+   iSuccessful = SymTableInt_put(oSymTableInt, 4, acFirstBase);
+   ASSURE(iSuccessful);
+   ASSURE(SymTableInt_getLength(oSymTableInt) == 3);
+
+   /* A key that is already there is not put again. */
+   iSuccessful = SymTableInt_put(oSymTableInt, 2, acFirstBase);
+   ASSURE(! iSuccessful);
+   ASSURE(SymTableInt_getLength(oSymTableInt) == 3);
+
+   pcValue = (char*)SymTableInt_get(oSymTableInt, 2);
+   ASSURE(pcValue == acShortstop);
+   pcValue = (char*)SymTableInt_get(oSymTableInt, 7);
+   ASSURE(pcValue == acCenterField);
+   pcValue = (char*)SymTableInt_get(oSymTableInt, 4);
+   ASSURE(pcValue == acFirstBase);
+   pcValue = (char*)SymTableInt_get(oSymTableInt, 3);
+   ASSURE(pcValue == NULL);
+
+   /* 0, negative keys, the extreme keys and NULL values are
+      ordinary. */
+   iSuccessful = SymTableInt_put(oSymTableInt, 0, NULL);
+   ASSURE(iSuccessful);
+   iSuccessful = SymTableInt_put(oSymTableInt, -1, acShortstop);
+   ASSURE(iSuccessful);
+   iSuccessful = SymTableInt_put(oSymTableInt, LONG_MIN, acCenterField);
+   ASSURE(iSuccessful);
+   iSuccessful = SymTableInt_put(oSymTableInt, LONG_MAX, acFirstBase);
+   ASSURE(iSuccessful);
+   ASSURE(SymTableInt_getLength(oSymTableInt) == 7);
+   iFound = SymTableInt_contains(oSymTableInt, 0);
+   ASSURE(iFound);
+   pcValue = (char*)SymTableInt_get(oSymTableInt, 0);
+   ASSURE(pcValue == NULL);
+   pcValue = (char*)SymTableInt_get(oSymTableInt, -1);
+   ASSURE(pcValue == acShortstop);
+   pcValue = (char*)SymTableInt_get(oSymTableInt, LONG_MIN);
+   ASSURE(pcValue == acCenterField);
+   pcValue = (char*)SymTableInt_get(oSymTableInt, LONG_MAX);
+   ASSURE(pcValue == acFirstBase);
+
+   pcValue = (char*)SymTableInt_replace(oSymTableInt, 7, acShortstop);
+   ASSURE(pcValue == acCenterField);
+   pcValue = (char*)SymTableInt_get(oSymTableInt, 7);
+   ASSURE(pcValue == acShortstop);
+   pcValue = (char*)SymTableInt_replace(oSymTableInt, 8, acShortstop);
+   ASSURE(pcValue == NULL);
+   iFound = SymTableInt_contains(oSymTableInt, 8);
+   ASSURE(! iFound);
+
+   pcValue = (char*)SymTableInt_remove(oSymTableInt, 2);
+   ASSURE(pcValue == acShortstop);
+   pcValue = (char*)SymTableInt_remove(oSymTableInt, 2);
+   ASSURE(pcValue == NULL);
+   iFound = SymTableInt_contains(oSymTableInt, 2);
+   ASSURE(! iFound);
+   ASSURE(SymTableInt_getLength(oSymTableInt) == 6);
+
+   SymTableInt_clear(oSymTableInt);
+   ASSURE(SymTableInt_getLength(oSymTableInt) == 0);
+   iFound = SymTableInt_contains(oSymTableInt, 4);
+   ASSURE(! iFound);
+
+   /* map visits every key-value pair once. */
+   iSuccessful = SymTableInt_put(oSymTableInt, 10, (void*)11);
+   ASSURE(iSuccessful);
+   iSuccessful = SymTableInt_put(oSymTableInt, -20, (void*)(size_t)-19);
+   ASSURE(iSuccessful);
+   iSuccessful = SymTableInt_put(oSymTableInt, 30, (void*)31);
+   ASSURE(iSuccessful);
+   lSum = 0;
+   SymTableInt_map(oSymTableInt, sumKeys, &lSum);
+   ASSURE(lSum == 20);
+
+   SymTableInt_free(oSymTableInt);
+   SymTableInt_free(NULL);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Fill a table to just below the load at which it grows, so that
+   long runs of occupied slots form, remove the keys in a shuffled
+   order and check after every removal that the others can still be
+   found. */
+
+static void testProbing(void)
+{
+   enum {KEY_COUNT = 380};
+
+   SymTableInt_T oSymTableInt;
+   long alKeys[KEY_COUNT];
+   long lKey;
+   int i;
+   int j;
+   int iSuccessful;
+   int iFound;
+   void *pvValue;
+   size_t uBytes;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing a nearly full SymTableInt object.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   oSymTableInt = SymTableInt_newWithCapacity(KEY_COUNT);
+   ASSURE(oSymTableInt != NULL);
+   uBytes = SymTableInt_memoryUsage(oSymTableInt);
+   for (i = 0; i < KEY_COUNT; i++)
+   {
+      alKeys[i] = (i % 2 == 0 ? 1 : -1) * ((long)i << 20);
+      iSuccessful = SymTableInt_put(oSymTableInt, alKeys[i],
+         (void*)(size_t)(alKeys[i] + 1));
+      ASSURE(iSuccessful);
+   }
+   ASSURE(SymTableInt_getLength(oSymTableInt) == KEY_COUNT);
+   ASSURE(SymTableInt_memoryUsage(oSymTableInt) == uBytes);
+
+   srand(217);
+   for (i = KEY_COUNT - 1; i > 0; i--)
+   {
+      j = rand() % (i + 1);
+      lKey = alKeys[i];
+      alKeys[i] = alKeys[j];
+      alKeys[j] = lKey;
+   }
+
+   for (i = 0; i < KEY_COUNT; i++)
+   {
+      pvValue = SymTableInt_remove(oSymTableInt, alKeys[i]);
+      ASSURE(pvValue == (void*)(size_t)(alKeys[i] + 1));
+      iFound = SymTableInt_contains(oSymTableInt, alKeys[i]);
+      ASSURE(! iFound);
+      for (j = i + 1; j < KEY_COUNT; j++)
+      {
+         pvValue = SymTableInt_get(oSymTableInt, alKeys[j]);
+         ASSURE(pvValue == (void*)(size_t)(alKeys[j] + 1));
+      }
+   }
+   ASSURE(SymTableInt_getLength(oSymTableInt) == 0);
+
+   /* An emptied table is refilled as if it were new. */
+   for (i = 0; i < KEY_COUNT; i++)
+   {
+      iSuccessful = SymTableInt_put(oSymTableInt, alKeys[i], NULL);
+      ASSURE(iSuccessful);
+   }
+   ASSURE(SymTableInt_getLength(oSymTableInt) == KEY_COUNT);
+
+   SymTableInt_free(oSymTableInt);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Run the workload of the large table test of testsymtable.c on a
+   SymTable whose keys are the decimal numbers 0 to iBindingCount-1:
+   put every key, get them alternating from the smallest and the
+   largest remaining key, and remove them in the same order. Store in
+   *puBytes the heap memory used by the full table, and return the
+   CPU time consumed. */
+
+static clock_t runStringTable(int iBindingCount, size_t *puBytes)
+{
+   SymTable_T oSymTable;
+   char acKey[MAX_KEY_LENGTH];
+   void *pvValue;
+   int i;
+   int iSmall;
+   int iLarge;
+   int iSuccessful;
+   size_t uHeapBefore;
+   clock_t iInitialClock;
+   clock_t iFinalClock;
+
+   uHeapBefore = heapInUse();
+   iInitialClock = clock();
+   oSymTable = SymTable_new();
+   ASSURE(oSymTable != NULL);
+   for (i = 0; i < iBindingCount; i++)
+   {
+      sprintf(acKey, "%d", i);
+      iSuccessful = SymTable_put(oSymTable, acKey, (void*)(size_t)(i + 1));
+      ASSURE(iSuccessful);
+   }
+   *puBytes = heapInUse() - uHeapBefore;
+
+   iSmall = 0;
+   iLarge = iBindingCount - 1;
+   while (iSmall <= iLarge)
+   {
+      sprintf(acKey, "%d", iSmall);
+      pvValue = SymTable_get(oSymTable, acKey);
+      ASSURE(pvValue == (void*)(size_t)(iSmall + 1));
+      iSmall++;
+      sprintf(acKey, "%d", iLarge);
+      pvValue = SymTable_get(oSymTable, acKey);
+      ASSURE(pvValue == (void*)(size_t)(iLarge + 1));
+      iLarge--;
+   }
+
+   iSmall = 0;
+   iLarge = iBindingCount - 1;
+   while (iSmall < iLarge)
+   {
+      sprintf(acKey, "%d", iSmall);
+      pvValue = SymTable_remove(oSymTable, acKey);
+      ASSURE(pvValue == (void*)(size_t)(iSmall + 1));
+      iSmall++;
+      sprintf(acKey, "%d", iLarge);
+      pvValue = SymTable_remove(oSymTable, acKey);
+      ASSURE(pvValue == (void*)(size_t)(iLarge + 1));
+      iLarge--;
+   }
+   if (iSmall == iLarge)
+   {
+      sprintf(acKey, "%d", iSmall);
+      pvValue = SymTable_remove(oSymTable, acKey);
+      ASSURE(pvValue == (void*)(size_t)(iSmall + 1));
+   }
+   ASSURE(SymTable_getLength(oSymTable) == 0);
+   SymTable_free(oSymTable);
+   iFinalClock = clock();
+
+   return iFinalClock - iInitialClock;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Run the same workload as runStringTable on a SymTableInt whose
+   keys are the numbers 0 to iBindingCount-1. Store in *puBytes the
+   heap memory used by the full table, and return the CPU time
+   consumed. */
+
+static clock_t runIntTable(int iBindingCount, size_t *puBytes)
+{
+   SymTableInt_T oSymTableInt;
+   void *pvValue;
+   int i;
+   int iSmall;
+   int iLarge;
+   int iSuccessful;
+   size_t uHeapBefore;
+   clock_t iInitialClock;
+   clock_t iFinalClock;
+
+   uHeapBefore = heapInUse();
+   iInitialClock = clock();
+   oSymTableInt = SymTableInt_new();
+   ASSURE(oSymTableInt != NULL);
+   for (i = 0; i < iBindingCount; i++)
+   {
+      iSuccessful = SymTableInt_put(oSymTableInt, i, (void*)(size_t)(i + 1));
+      ASSURE(iSuccessful);
+   }
+   *puBytes = heapInUse() - uHeapBefore;
+
+   iSmall = 0;
+   iLarge = iBindingCount - 1;
+   while (iSmall <= iLarge)
+   {
+      pvValue = SymTableInt_get(oSymTableInt, iSmall);
+      ASSURE(pvValue == (void*)(size_t)(iSmall + 1));
+      iSmall++;
+      pvValue = SymTableInt_get(oSymTableInt, iLarge);
+      ASSURE(pvValue == (void*)(size_t)(iLarge + 1));
+      iLarge--;
+   }
+
+   iSmall = 0;
+   iLarge = iBindingCount - 1;
+   while (iSmall < iLarge)
+   {
+      pvValue = SymTableInt_remove(oSymTableInt, iSmall);
+      ASSURE(pvValue == (void*)(size_t)(iSmall + 1));
+      iSmall++;
+      pvValue = SymTableInt_remove(oSymTableInt, iLarge);
+      ASSURE(pvValue == (void*)(size_t)(iLarge + 1));
+      iLarge--;
+   }
+   if (iSmall == iLarge)
+   {
+      pvValue = SymTableInt_remove(oSymTableInt, iSmall);
+      ASSURE(pvValue == (void*)(size_t)(iSmall + 1));
+   }
+   ASSURE(SymTableInt_getLength(oSymTableInt) == 0);
+   SymTableInt_free(oSymTableInt);
+   iFinalClock = clock();
+
+   return iFinalClock - iInitialClock;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Run the large table workload with iBindingCount integer keys on a
+   SymTable, formatting each key as a string, and on a SymTableInt,
+   and write to stdout the CPU time consumed by each and the heap
+   memory used by each full table. */
+
+static void testLargeTable(int iBindingCount)
+{
+   size_t uTableBytes;
+   size_t uIntBytes;
+   clock_t iTableClock;
+   clock_t iIntClock;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing a potentially large SymTableInt object.\n");
+   printf("No output except CPU time and memory should appear here:\n");
+   fflush(stdout);
+
+   iTableClock = runStringTable(iBindingCount, &uTableBytes);
+   iIntClock = runIntTable(iBindingCount, &uIntBytes);
+
+   printf("SymTable CPU time (%d bindings):  %f seconds\n",
+      iBindingCount, ((double)iTableClock) / CLOCKS_PER_SEC);
+   printf("SymTableInt CPU time (%d bindings):  %f seconds\n",
+      iBindingCount, ((double)iIntClock) / CLOCKS_PER_SEC);
+   printf("SymTable memory (%d bindings):  %lu bytes\n",
+      iBindingCount, (unsigned long)uTableBytes);
+   printf("SymTableInt memory (%d bindings):  %lu bytes\n",
+      iBindingCount, (unsigned long)uIntBytes);
+   fflush(stdout);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test the SymTableInt ADT.  Write the output of the tests to
+   stdout. As always, argc is the command-line argument count, argv
+   contains the command-line arguments, and argv[0] is the name of the
+   executable binary file. argv[1] is the number of bindings to put
+   into a potentially large SymTableInt object.  Exit with
+   EXIT_FAILURE if argv[1] is missing or not numeric.  Otherwise
+   return 0. */
+
+int main(int argc, char *argv[])
+{
+   int iBindingCount;
+
+   if (argc != 2)
+   {
+      fprintf(stderr, "Usage: %s bindingcount\n", argv[0]);
+      exit(EXIT_FAILURE);
+   }
+
+   if (sscanf(argv[1], "%d", &iBindingCount) != 1)
+   {
+      fprintf(stderr, "bindingcount must be numeric\n");
+      exit(EXIT_FAILURE);
+   }
+   if (iBindingCount < 0)
+   {
+      fprintf(stderr, "bindingcount cannot be negative\n");
+      exit(EXIT_FAILURE);
+   }
+
+   testBasics();
+   testProbing();
+   testLargeTable(iBindingCount);
+
+   printf("------------------------------------------------------\n");
+   printf("End of %s.\n", argv[0]);
+   return 0;
+}
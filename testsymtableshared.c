@@ -0,0 +1,618 @@
+/*--------------------------------------------------------------------*/
+/* testsymtableshared.c                                               */
+/* Author: Tharun Kumar Tiruppali Kalidoss                            */
+/*--------------------------------------------------------------------*/
+
+#define _POSIX_C_SOURCE 200809L
+#include "symtable.h"
+#include "symtableshared.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <string.h>
+#include <assert.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+/*--------------------------------------------------------------------*/
+
+#define ASSURE(i) assure(i, __LINE__)
+
+/* MAX_KEY_LENGTH is the size of the buffers that hold decimal keys,
+   MAX_NAME_LENGTH the size of the buffers that hold segment names,
+   and WORKER_COUNT the number of processes that share the large
+   table. */
+enum {MAX_KEY_LENGTH = 12, MAX_NAME_LENGTH = 64, WORKER_COUNT = 4};
+
+/*--------------------------------------------------------------------*/
+
+/* If !iSuccessful, print a message to stdout indicating that the
+   test at line iLineNum failed. */
+
+static void assure(int iSuccessful, int iLineNum)
+{
+   if (! iSuccessful)
+   {
+      printf("Test at line %d failed.\n", iLineNum);
+      fflush(stdout);
+   }
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Increment the counter pointed to by pvExtra. */
+
+static void countBinding(const char *pcKey, void *pvValue,
+   void *pvExtra)
+{
+   assert(pcKey != NULL);
+   assert(pvExtra != NULL);
+
+   (void)pvValue;
+   (*(size_t*)pvExtra)++;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Write to pcName a segment name that no other run of this program
+   uses, ending with pcSuffix. */
+
+static void makeName(char *pcName, const char *pcSuffix)
+{
+   sprintf(pcName, "/testsymtableshared.%ld.%s", (long)getpid(),
+      pcSuffix);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return the number of bytes of the process's memory that are
+   resident, and store in *puShared how many of them are shared with
+   other processes, as reported by /proc/self/statm. Return 0 if they
+   cannot be read. */
+
+static size_t residentBytes(size_t *puShared)
+{
+   FILE *psFile;
+   unsigned long ulSize;
+   unsigned long ulResident;
+   unsigned long ulShared;
+   int iCount;
+
+   *puShared = 0;
+   psFile = fopen("/proc/self/statm", "r");
+   if (psFile == NULL)
+      return 0;
+   iCount = fscanf(psFile, "%lu %lu %lu", &ulSize, &ulResident,
+      &ulShared);
+   fclose(psFile);
+   if (iCount != 3)
+      return 0;
+   *puShared = (size_t)ulShared * (size_t)sysconf(_SC_PAGESIZE);
+   return (size_t)ulResident * (size_t)sysconf(_SC_PAGESIZE);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test the most basic SymTableShared functions within one process. */
+
+static void testBasics(void)
+{
+   enum {MAX_KEY_LENGTH = 16, CHURN_COUNT = 10000};
+
+   SymTableShared_T oSymTableShared;
+   SymTableShared_T oOther;
+   SymTable_T oSymTable;
+   char acName[MAX_NAME_LENGTH];
+   char acShortstop[] = "Shortstop";
+   char acCenterField[] = "Center Field";
+   char acFirstBase[] = "First Base";
+   char *pcValue;
+   int iSuccessful;
+   int iFound;
+   int iFd;
+   size_t uCount;
+   char acKey[MAX_KEY_LENGTH];
+   int i;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing the most basic SymTableShared functions.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   makeName(acName, "basics");
+   oSymTableShared = SymTableShared_open(acName);
+   ASSURE(oSymTableShared == NULL);
+
+   /* Room for three pairs and 22 key characters. */
+   oSymTableShared = SymTableShared_create(acName, 3, 22);
+   ASSURE(oSymTableShared != NULL);
+   ASSURE(SymTableShared_create(acName, 3, 22) == NULL);
+   ASSURE(SymTableShared_getLength(oSymTableShared) == 0);
+   ASSURE(SymTableShared_memoryUsage(oSymTableShared) > 0);
+
+   iSuccessful = SymTableShared_put(oSymTableShared, "Jeter",
+      acShortstop);
+   ASSURE(iSuccessful);
+   iSuccessful = SymTableShared_put(oSymTableShared, "Mantle",
+      acCenterField);
+   ASSURE(iSuccessful);
+   iSuccessful = SymTableShared_put(oSymTableShared, "Jeter",
+      acFirstBase);
+   ASSURE(! iSuccessful);
+   iSuccessful = SymTableShared_put(oSymTableShared, "Gehrig",
+      acFirstBase);
+   ASSURE(iSuccessful);
+   ASSURE(SymTableShared_getLength(oSymTableShared) == 3);
+
+   /* Every pair is taken. */
+   iSuccessful = SymTableShared_put(oSymTableShared, "Ruth", NULL);
+   ASSURE(! iSuccessful);
+
+   pcValue = (char*)SymTableShared_get(oSymTableShared, "Jeter");
+   ASSURE(pcValue == acShortstop);
+   pcValue = (char*)SymTableShared_get(oSymTableShared, "Ruth");
+   ASSURE(pcValue == NULL);
+   iFound = SymTableShared_contains(oSymTableShared, "Gehrig");
+   ASSURE(iFound);
+   iFound = SymTableShared_contains(oSymTableShared, "Ruth");
+   ASSURE(! iFound);
+
+   pcValue = (char*)SymTableShared_replace(oSymTableShared, "Mantle",
+      acFirstBase);
+   ASSURE(pcValue == acCenterField);
+   pcValue = (char*)SymTableShared_replace(oSymTableShared, "Ruth",
+      acFirstBase);
+   ASSURE(pcValue == NULL);
+
+   /* A second view of the segment sees the same table. */
+   oOther = SymTableShared_open(acName);
+   ASSURE(oOther != NULL);
+   ASSURE(SymTableShared_getLength(oOther) == 3);
+   ASSURE(SymTableShared_memoryUsage(oOther)
+      == SymTableShared_memoryUsage(oSymTableShared));
+   pcValue = (char*)SymTableShared_get(oOther, "Mantle");
+   ASSURE(pcValue == acFirstBase);
+
+   /* A removed pair is reused, and so are its key characters once
+      the keys after them are moved down. */
+   pcValue = (char*)SymTableShared_remove(oOther, "Jeter");
+   ASSURE(pcValue == acShortstop);
+   pcValue = (char*)SymTableShared_remove(oOther, "Jeter");
+   ASSURE(pcValue == NULL);
+   iFound = SymTableShared_contains(oSymTableShared, "Jeter");
+   ASSURE(! iFound);
+   iSuccessful = SymTableShared_put(oSymTableShared, "", NULL);
+   ASSURE(iSuccessful);
+   iFound = SymTableShared_contains(oOther, "");
+   ASSURE(iFound);
+   pcValue = (char*)SymTableShared_remove(oSymTableShared, "");
+   ASSURE(pcValue == NULL);
+   /* 21 of the 22 key characters have been handed out, and 7 of
+      them were freed. */
+   iSuccessful = SymTableShared_put(oSymTableShared, "Berra",
+      acShortstop);
+   ASSURE(iSuccessful);
+   pcValue = (char*)SymTableShared_get(oOther, "Berra");
+   ASSURE(pcValue == acShortstop);
+   pcValue = (char*)SymTableShared_get(oOther, "Mantle");
+   ASSURE(pcValue == acFirstBase);
+   pcValue = (char*)SymTableShared_get(oOther, "Gehrig");
+   ASSURE(pcValue == acFirstBase);
+   pcValue = (char*)SymTableShared_remove(oOther, "Berra");
+   ASSURE(pcValue == acShortstop);
+   /* 8 characters are free, which is one too few. */
+   iSuccessful = SymTableShared_put(oSymTableShared, "DiMaggio", NULL);
+   ASSURE(! iSuccessful);
+   ASSURE(SymTableShared_getLength(oOther) == 2);
+
+   uCount = 0;
+   SymTableShared_map(oOther, countBinding, &uCount);
+   ASSURE(uCount == 2);
+
+   SymTableShared_close(oOther);
+   SymTableShared_close(oSymTableShared);
+
+   /* The table outlives every view until its name is removed. */
+   oSymTableShared = SymTableShared_open(acName);
+   ASSURE(oSymTableShared != NULL);
+   ASSURE(SymTableShared_getLength(oSymTableShared) == 2);
+   SymTableShared_close(oSymTableShared);
+   ASSURE(SymTableShared_unlink(acName));
+   ASSURE(! SymTableShared_unlink(acName));
+   ASSURE(SymTableShared_open(acName) == NULL);
+
+   /* A segment that does not hold a table is rejected. */
+   iFd = shm_open(acName, O_RDWR | O_CREAT | O_EXCL, 0600);
+   ASSURE(iFd >= 0);
+   ASSURE(ftruncate(iFd, 4096) == 0);
+   close(iFd);
+   ASSURE(SymTableShared_open(acName) == NULL);
+   ASSURE(SymTableShared_unlink(acName));
+
+   /* SymTable_share copies every pair of a SymTable. */
+   oSymTable = SymTable_new();
+   ASSURE(oSymTable != NULL);
+   oSymTableShared = SymTable_share(oSymTable, acName);
+   ASSURE(oSymTableShared != NULL);
+   ASSURE(SymTableShared_getLength(oSymTableShared) == 0);
+   iSuccessful = SymTableShared_put(oSymTableShared, "Jeter", NULL);
+   ASSURE(! iSuccessful);
+   SymTableShared_close(oSymTableShared);
+   ASSURE(SymTableShared_unlink(acName));
+
+   iSuccessful = SymTable_put(oSymTable, "Jeter", acShortstop);
+   ASSURE(iSuccessful);
+   iSuccessful = SymTable_put(oSymTable, "Mantle", acCenterField);
+   ASSURE(iSuccessful);
+   iSuccessful = SymTable_put(oSymTable, "", acFirstBase);
+   ASSURE(iSuccessful);
+   oSymTableShared = SymTable_share(oSymTable, acName);
+   ASSURE(oSymTableShared != NULL);
+   SymTable_free(oSymTable);
+   ASSURE(SymTableShared_getLength(oSymTableShared) == 3);
+   pcValue = (char*)SymTableShared_get(oSymTableShared, "Mantle");
+   ASSURE(pcValue == acCenterField);
+   pcValue = (char*)SymTableShared_get(oSymTableShared, "");
+   ASSURE(pcValue == acFirstBase);
+   SymTableShared_close(oSymTableShared);
+   ASSURE(SymTableShared_unlink(acName));
+
+   /* Keys of many lengths put and removed over and over never use
+      up the key characters. */
+   oSymTableShared = SymTableShared_create(acName, 4, 64);
+   ASSURE(oSymTableShared != NULL);
+   iSuccessful = SymTableShared_put(oSymTableShared, "Mantle",
+      acCenterField);
+   ASSURE(iSuccessful);
+   for (i = 0; i < CHURN_COUNT; i++)
+   {
+      sprintf(acKey, "%.*s%d", i % 8, "Gehrig-G", i);
+      iSuccessful = SymTableShared_put(oSymTableShared, acKey,
+         acFirstBase);
+      ASSURE(iSuccessful);
+      if (i >= 2)
+      {
+         sprintf(acKey, "%.*s%d", (i - 2) % 8, "Gehrig-G", i - 2);
+         pcValue = (char*)SymTableShared_remove(oSymTableShared,
+            acKey);
+         ASSURE(pcValue == acFirstBase);
+      }
+   }
+   ASSURE(SymTableShared_getLength(oSymTableShared) == 3);
+   pcValue = (char*)SymTableShared_get(oSymTableShared, "Mantle");
+   ASSURE(pcValue == acCenterField);
+   SymTableShared_close(oSymTableShared);
+   ASSURE(SymTableShared_unlink(acName));
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test that changes made by one process are seen by another. */
+
+static void testProcesses(void)
+{
+   SymTableShared_T oSymTableShared;
+   char acName[MAX_NAME_LENGTH];
+   char acKey[MAX_KEY_LENGTH];
+   pid_t iPid;
+   int iStatus;
+   int i;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing a SymTableShared shared by two processes.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   makeName(acName, "processes");
+   oSymTableShared = SymTableShared_create(acName, 1000, 10000);
+   ASSURE(oSymTableShared != NULL);
+   if (oSymTableShared == NULL)
+      return;
+   ASSURE(SymTableShared_put(oSymTableShared, "Jeter", (void*)1));
+
+   iPid = fork();
+   ASSURE(iPid >= 0);
+   if (iPid == 0)
+   {
+      SymTableShared_T oChild;
+
+      /* The child maps the segment afresh, at its own address. */
+      SymTableShared_close(oSymTableShared);
+      oChild = SymTableShared_open(acName);
+      ASSURE(oChild != NULL);
+      if (oChild == NULL)
+         exit(EXIT_FAILURE);
+      ASSURE(SymTableShared_get(oChild, "Jeter") == (void*)1);
+      ASSURE(SymTableShared_replace(oChild, "Jeter", (void*)2)
+         == (void*)1);
+      for (i = 0; i < 500; i++)
+      {
+         sprintf(acKey, "%d", i);
+         ASSURE(SymTableShared_put(oChild, acKey, (void*)(size_t)i));
+      }
+      SymTableShared_close(oChild);
+      exit(0);
+   }
+   ASSURE(waitpid(iPid, &iStatus, 0) == iPid);
+   ASSURE(WIFEXITED(iStatus) && WEXITSTATUS(iStatus) == 0);
+
+   ASSURE(SymTableShared_getLength(oSymTableShared) == 501);
+   ASSURE(SymTableShared_get(oSymTableShared, "Jeter") == (void*)2);
+   for (i = 0; i < 500; i++)
+   {
+      sprintf(acKey, "%d", i);
+      ASSURE(SymTableShared_get(oSymTableShared, acKey)
+         == (void*)(size_t)i);
+   }
+   SymTableShared_close(oSymTableShared);
+   ASSURE(SymTableShared_unlink(acName));
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return a buffer of iBindingCount keys, each MAX_KEY_LENGTH bytes
+   apart: the decimal numbers 0 to iBindingCount-1 in random order.
+   The order is shuffled so that lookups do not walk the buckets of a
+   hash table in sequence. */
+
+static char *makeKeys(int iBindingCount)
+{
+   char acKey[MAX_KEY_LENGTH];
+   char *pcKeys;
+   int i;
+   int j;
+
+   pcKeys = (char*)malloc((size_t)iBindingCount * MAX_KEY_LENGTH + 1);
+   ASSURE(pcKeys != NULL);
+   if (pcKeys == NULL)
+      exit(EXIT_FAILURE);
+   for (i = 0; i < iBindingCount; i++)
+      sprintf(pcKeys + (size_t)i * MAX_KEY_LENGTH, "%d", i);
+   srand(217);
+   for (i = iBindingCount - 1; i > 0; i--)
+   {
+      j = rand() % (i + 1);
+      memcpy(acKey, pcKeys + (size_t)i * MAX_KEY_LENGTH, MAX_KEY_LENGTH);
+      memcpy(pcKeys + (size_t)i * MAX_KEY_LENGTH,
+         pcKeys + (size_t)j * MAX_KEY_LENGTH, MAX_KEY_LENGTH);
+      memcpy(pcKeys + (size_t)j * MAX_KEY_LENGTH, acKey, MAX_KEY_LENGTH);
+   }
+   return pcKeys;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* WorkerReport is what a worker process sends back to the parent
+   through a pipe. */
+
+struct WorkerReport
+{
+   /* uGrowth is the growth of the worker's resident memory while it
+      loaded or mapped the table and looked up every key, and
+      uPrivateGrowth the part of it that is not shared. */
+   size_t uGrowth;
+   size_t uPrivateGrowth;
+   /* iLookupClock is the CPU time of the lookups. */
+   clock_t iLookupClock;
+   /* uHits is the number of keys found. */
+   size_t uHits;
+};
+
+/* Run one worker process that looks up the iBindingCount keys of
+   pcKeys, in a SymTable of its own if pcName is NULL and in the
+   SymTableShared named pcName otherwise, and write its WorkerReport
+   to the file descriptor iFd. Never returns. */
+
+static void runWorker(const char *pcName, const char *pcKeys,
+   int iBindingCount, int iFd)
+{
+   struct WorkerReport sReport;
+   SymTable_T oSymTable = NULL;
+   SymTableShared_T oSymTableShared = NULL;
+   char acKey[MAX_KEY_LENGTH];
+   size_t uBefore;
+   size_t uSharedBefore;
+   size_t uAfter;
+   size_t uSharedAfter;
+   clock_t iInitialClock;
+   int i;
+
+   uBefore = residentBytes(&uSharedBefore);
+   if (pcName == NULL)
+   {
+      oSymTable = SymTable_new();
+      for (i = 0; i < iBindingCount && oSymTable != NULL; i++)
+      {
+         sprintf(acKey, "%d", i);
+         (void)SymTable_put(oSymTable, acKey, (void*)(size_t)(i + 1));
+      }
+   }
+   else
+      oSymTableShared = SymTableShared_open(pcName);
+   if (oSymTable == NULL && oSymTableShared == NULL)
+      _exit(EXIT_FAILURE);
+
+   sReport.uHits = 0;
+   iInitialClock = clock();
+   for (i = 0; i < iBindingCount; i++)
+   {
+      if (oSymTable != NULL)
+         sReport.uHits += SymTable_get(oSymTable,
+            pcKeys + (size_t)i * MAX_KEY_LENGTH) != NULL;
+      else
+         sReport.uHits += SymTableShared_get(oSymTableShared,
+            pcKeys + (size_t)i * MAX_KEY_LENGTH) != NULL;
+   }
+   sReport.iLookupClock = clock() - iInitialClock;
+
+   uAfter = residentBytes(&uSharedAfter);
+   sReport.uGrowth = uAfter - uBefore;
+   sReport.uPrivateGrowth = (uAfter - uSharedAfter)
+      - (uBefore - uSharedBefore);
+   if (write(iFd, &sReport, sizeof(sReport)) != (ssize_t)sizeof(sReport))
+      _exit(EXIT_FAILURE);
+   _exit(0);
+}
+
+/* Run WORKER_COUNT worker processes on the iBindingCount keys of
+   pcKeys as runWorker does, and store the sum of their reports in
+   *psTotal. */
+
+static void runWorkers(const char *pcName, const char *pcKeys,
+   int iBindingCount, struct WorkerReport *psTotal)
+{
+   struct WorkerReport sReport;
+   int aiPipe[2];
+   pid_t iPid;
+   int iStatus;
+   int i;
+
+   memset(psTotal, 0, sizeof(*psTotal));
+   fflush(stdout);
+   ASSURE(pipe(aiPipe) == 0);
+   for (i = 0; i < WORKER_COUNT; i++)
+   {
+      iPid = fork();
+      ASSURE(iPid >= 0);
+      if (iPid == 0)
+      {
+         close(aiPipe[0]);
+         runWorker(pcName, pcKeys, iBindingCount, aiPipe[1]);
+      }
+   }
+   close(aiPipe[1]);
+   for (i = 0; i < WORKER_COUNT; i++)
+   {
+      ASSURE(read(aiPipe[0], &sReport, sizeof(sReport))
+         == (ssize_t)sizeof(sReport));
+      psTotal->uGrowth += sReport.uGrowth;
+      psTotal->uPrivateGrowth += sReport.uPrivateGrowth;
+      psTotal->iLookupClock += sReport.iLookupClock;
+      psTotal->uHits += sReport.uHits;
+   }
+   close(aiPipe[0]);
+   for (i = 0; i < WORKER_COUNT; i++)
+   {
+      ASSURE(wait(&iStatus) > 0);
+      ASSURE(WIFEXITED(iStatus) && WEXITSTATUS(iStatus) == 0);
+   }
+}
+
+/* Load a table of iBindingCount bindings into each of WORKER_COUNT
+   processes, and then share one copy of it among as many, and write
+   to stdout the memory used by the processes and the CPU time of
+   their lookups in each case. */
+
+static void testLargeTable(int iBindingCount)
+{
+   SymTable_T oSymTable;
+   SymTableShared_T oSymTableShared;
+   struct WorkerReport sPrivate;
+   struct WorkerReport sShared;
+   char acName[MAX_NAME_LENGTH];
+   char acKey[MAX_KEY_LENGTH];
+   char *pcKeys;
+   size_t uSegmentBytes;
+   double dLookups;
+   int i;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing a potentially large SymTableShared object.\n");
+   printf("No output except CPU time and memory should appear here:\n");
+   fflush(stdout);
+
+   pcKeys = makeKeys(iBindingCount);
+   runWorkers(NULL, pcKeys, iBindingCount, &sPrivate);
+   ASSURE(sPrivate.uHits == (size_t)WORKER_COUNT * iBindingCount);
+
+   oSymTable = SymTable_new();
+   ASSURE(oSymTable != NULL);
+   for (i = 0; i < iBindingCount; i++)
+   {
+      sprintf(acKey, "%d", i);
+      ASSURE(SymTable_put(oSymTable, acKey, (void*)(size_t)(i + 1)));
+   }
+   makeName(acName, "large");
+   oSymTableShared = SymTable_share(oSymTable, acName);
+   ASSURE(oSymTableShared != NULL);
+   SymTable_free(oSymTable);
+   if (oSymTableShared == NULL)
+   {
+      free(pcKeys);
+      return;
+   }
+   uSegmentBytes = SymTableShared_memoryUsage(oSymTableShared);
+   runWorkers(acName, pcKeys, iBindingCount, &sShared);
+   ASSURE(sShared.uHits == (size_t)WORKER_COUNT * iBindingCount);
+   SymTableShared_close(oSymTableShared);
+   ASSURE(SymTableShared_unlink(acName));
+
+   /* The memory of the shared case counts the segment once and each
+      process's private pages. */
+   dLookups = (double)WORKER_COUNT * (iBindingCount > 0 ? iBindingCount : 1);
+   printf("SymTable lookup time (%d processes, %d hits each):  "
+      "%f seconds, %.1f ns per get\n", WORKER_COUNT, iBindingCount,
+      ((double)sPrivate.iLookupClock) / CLOCKS_PER_SEC,
+      1e9 * sPrivate.iLookupClock / CLOCKS_PER_SEC / dLookups);
+   printf("SymTableShared lookup time (%d processes, %d hits each):  "
+      "%f seconds, %.1f ns per get\n", WORKER_COUNT, iBindingCount,
+      ((double)sShared.iLookupClock) / CLOCKS_PER_SEC,
+      1e9 * sShared.iLookupClock / CLOCKS_PER_SEC / dLookups);
+   printf("SymTable RSS (%d processes, %d bindings each):  "
+      "%lu bytes\n", WORKER_COUNT, iBindingCount,
+      (unsigned long)sPrivate.uGrowth);
+   printf("SymTableShared RSS (%d processes, %d bindings shared):  "
+      "%lu bytes, %lu of them private, segment %lu bytes\n",
+      WORKER_COUNT, iBindingCount, (unsigned long)sShared.uGrowth,
+      (unsigned long)sShared.uPrivateGrowth,
+      (unsigned long)uSegmentBytes);
+   printf("SymTableShared memory (%d processes):  %lu bytes\n",
+      WORKER_COUNT,
+      (unsigned long)(sShared.uPrivateGrowth + uSegmentBytes));
+   fflush(stdout);
+
+   free(pcKeys);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test the SymTableShared ADT.  Write the output of the tests to
+   stdout. As always, argc is the command-line argument count, argv
+   contains the command-line arguments, and argv[0] is the name of the
+   executable binary file. argv[1] is the number of bindings to put
+   into a potentially large SymTableShared object.  Exit with
+   EXIT_FAILURE if argv[1] is missing or not numeric.  Otherwise
+   return 0. */
+
+int main(int argc, char *argv[])
+{
+   int iBindingCount;
+
+   if (argc != 2)
+   {
+      fprintf(stderr, "Usage: %s bindingcount\n", argv[0]);
+      exit(EXIT_FAILURE);
+   }
+
+   if (sscanf(argv[1], "%d", &iBindingCount) != 1)
+   {
+      fprintf(stderr, "bindingcount must be numeric\n");
+      exit(EXIT_FAILURE);
+   }
+   if (iBindingCount < 0)
+   {
+      fprintf(stderr, "bindingcount cannot be negative\n");
+      exit(EXIT_FAILURE);
+   }
+
+   testBasics();
+   testProcesses();
+   testLargeTable(iBindingCount);
+
+   printf("------------------------------------------------------\n");
+   printf("End of %s.\n", argv[0]);
+   return 0;
+}
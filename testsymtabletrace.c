@@ -0,0 +1,595 @@
+/*--------------------------------------------------------------------*/
+/* testsymtabletrace.c                                                */
+/* Author: Tharun Kumar Tiruppali Kalidoss                            */
+/*--------------------------------------------------------------------*/
+
+#include "symtable.h"
+#include "symtabletrace.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <string.h>
+#include <assert.h>
+
+/*--------------------------------------------------------------------*/
+
+#define ASSURE(i) assure(i, __LINE__)
+
+/* MAX_KEY_LENGTH is the size of the buffers that hold decimal keys. */
+enum {MAX_KEY_LENGTH = 12};
+
+/* TRACE_PATH is the trace file written by the tests, and
+   DAMAGED_PATH a damaged copy of it. */
+static const char TRACE_PATH[] = "testsymtabletrace.trace";
+static const char DAMAGED_PATH[] = "testsymtabletrace.damaged";
+
+/* IMAGE_PATH is the snapshot saved by the tests, and LOG_PATH the log
+   they open, whose checkpoint is CHECKPOINT_PATH. */
+static const char IMAGE_PATH[] = "testsymtabletrace.image";
+static const char LOG_PATH[] = "testsymtabletrace.log";
+static const char CHECKPOINT_PATH[] = "testsymtabletrace.log.checkpoint";
+
+/*--------------------------------------------------------------------*/
+
+/* If !iSuccessful, print a message to stdout indicating that the
+   test at line iLineNum failed. */
+
+static void assure(int iSuccessful, int iLineNum)
+{
+   if (! iSuccessful)
+   {
+      printf("Test at line %d failed.\n", iLineNum);
+      fflush(stdout);
+   }
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Get the key pcKey from the SymTable pointed to by pvExtra, so that
+   the get is traced during the map. */
+
+static void getBinding(const char *pcKey, void *pvValue, void *pvExtra)
+{
+   assert(pcKey != NULL);
+   assert(pvExtra != NULL);
+
+   (void)pvValue;
+   (void)SymTable_get((SymTable_T)pvExtra, pcKey);
+}
+
+/* Return pvDstValue; the function passed to SymTable_merge. */
+
+static void *keepFirst(const char *pcKey, void *pvDstValue,
+   void *pvSrcValue, void *pvExtra)
+{
+   (void)pcKey;
+   (void)pvSrcValue;
+   (void)pvExtra;
+   return pvDstValue;
+}
+
+/* Return a block of uSize bytes from malloc; the allocation function
+   of the allocator passed to SymTable_newWithAllocator. */
+
+static void *allocateBlock(size_t uSize, void *pvContext)
+{
+   (void)pvContext;
+   return malloc(uSize);
+}
+
+/* Free pvBlock; the freeing function of the allocator passed to
+   SymTable_newWithAllocator. */
+
+static void freeBlock(void *pvBlock, void *pvContext)
+{
+   (void)pvContext;
+   free(pvBlock);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Read the next record of oTrace, and check that it is a call of eOp
+   on table uTable with the key pcKey (NULL for none), the argument
+   uArgument and the result uResult. */
+
+static void checkRecord(SymTableTrace_T oTrace, SymTableTrace_Op eOp,
+   size_t uTable, const char *pcKey, size_t uArgument, size_t uResult)
+{
+   SymTableTrace_Record sRecord;
+   int iStatus;
+
+   iStatus = SymTableTrace_next(oTrace, &sRecord);
+   ASSURE(iStatus == 1);
+   if (iStatus != 1)
+      return;
+   ASSURE(sRecord.eOp == eOp);
+   ASSURE(sRecord.uTable == uTable);
+   if (pcKey == NULL)
+      ASSURE(sRecord.pcKey == NULL);
+   else
+      ASSURE(sRecord.pcKey != NULL
+         && sRecord.uKeyLength == strlen(pcKey)
+         && memcmp(sRecord.pcKey, pcKey, sRecord.uKeyLength) == 0);
+   ASSURE(sRecord.uArgument == uArgument);
+   ASSURE(sRecord.uResult == uResult);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Copy the first uSize bytes of the file pcFrom to the file pcTo. */
+
+static void copyPrefix(const char *pcFrom, const char *pcTo,
+   size_t uSize)
+{
+   FILE *psFrom;
+   FILE *psTo;
+   int iChar;
+
+   psFrom = fopen(pcFrom, "rb");
+   psTo = fopen(pcTo, "wb");
+   ASSURE(psFrom != NULL && psTo != NULL);
+   if (psFrom == NULL || psTo == NULL)
+      exit(EXIT_FAILURE);
+   while (uSize-- > 0 && (iChar = getc(psFrom)) != EOF)
+      putc(iChar, psTo);
+   fclose(psFrom);
+   fclose(psTo);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test that the traced SymTable functions are recorded while a trace
+   is being recorded, and read back as they were made. */
+
+static void testBasics(void)
+{
+   SymTable_T oSymTable;
+   SymTable_T oClone;
+   SymTable_T oUntraced;
+   SymTableTrace_T oTrace;
+   SymTableTrace_Record sRecord;
+   char acShortstop[] = "Shortstop";
+   void **ppvSlot;
+   int iInserted;
+   int i;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing the recording and reading of traces.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   ASSURE(! SymTableTrace_isRecording());
+   ASSURE(! SymTableTrace_stop());
+   ASSURE(! SymTableTrace_start("no/such/directory/x.trace"));
+   ASSURE(! SymTableTrace_isRecording());
+
+   /* Calls made before the trace starts are not recorded. */
+   oUntraced = SymTable_new();
+   ASSURE(oUntraced != NULL);
+   ASSURE(SymTable_put(oUntraced, "Ruth", NULL));
+
+   ASSURE(SymTableTrace_start(TRACE_PATH));
+   ASSURE(SymTableTrace_isRecording());
+   oSymTable = SymTable_new();
+   ASSURE(oSymTable != NULL);
+   ASSURE(SymTable_put(oSymTable, "Jeter", acShortstop));
+   ASSURE(! SymTable_put(oSymTable, "Jeter", NULL));
+   ASSURE(SymTable_putN(oSymTable, "Mantles", 6, NULL));
+   ASSURE(SymTable_containsN(oSymTable, "Mantles", 6));
+   ASSURE(SymTable_get(oSymTable, "Jeter") == acShortstop);
+   ASSURE(SymTable_get(oSymTable, "Gehrig") == NULL);
+   ASSURE(SymTable_replace(oSymTable, "Mantle", acShortstop) == NULL);
+   ppvSlot = SymTable_upsert(oSymTable, "", &iInserted);
+   ASSURE(ppvSlot != NULL && iInserted);
+   if (ppvSlot != NULL)
+      *ppvSlot = acShortstop;
+   ppvSlot = SymTable_upsert(oSymTable, "", &iInserted);
+   ASSURE(ppvSlot != NULL && ! iInserted);
+   ASSURE(SymTable_getLength(oSymTable) == 3);
+   oClone = SymTable_clone(oSymTable);
+   ASSURE(oClone != NULL);
+   SymTable_map(oSymTable, getBinding, oClone);
+   ASSURE(SymTable_remove(oClone, "Jeter") == acShortstop);
+   ASSURE(SymTable_contains(oUntraced, "Ruth"));
+   SymTable_clear(oSymTable);
+   ASSURE(SymTable_reserve(oSymTable, 100));
+   SymTable_free(oSymTable);
+   SymTable_free(oClone);
+   ASSURE(SymTableTrace_stop());
+   ASSURE(! SymTableTrace_isRecording());
+
+   /* Calls made after the trace stops are not recorded. */
+   ASSURE(SymTable_get(oUntraced, "Ruth") == NULL);
+   SymTable_free(oUntraced);
+
+   oTrace = SymTableTrace_open(TRACE_PATH);
+   ASSURE(oTrace != NULL);
+   if (oTrace == NULL)
+      return;
+   checkRecord(oTrace, SYMTABLETRACE_NEW, 1, NULL, 0, 1);
+   checkRecord(oTrace, SYMTABLETRACE_PUT, 1, "Jeter", 1, 1);
+   checkRecord(oTrace, SYMTABLETRACE_PUT, 1, "Jeter", 0, 0);
+   checkRecord(oTrace, SYMTABLETRACE_PUTN, 1, "Mantle", 0, 1);
+   checkRecord(oTrace, SYMTABLETRACE_CONTAINSN, 1, "Mantle", 0, 1);
+   checkRecord(oTrace, SYMTABLETRACE_GET, 1, "Jeter", 0, 1);
+   checkRecord(oTrace, SYMTABLETRACE_GET, 1, "Gehrig", 0, 0);
+   checkRecord(oTrace, SYMTABLETRACE_REPLACE, 1, "Mantle", 1, 0);
+   checkRecord(oTrace, SYMTABLETRACE_UPSERT, 1, "", 0, 2);
+   checkRecord(oTrace, SYMTABLETRACE_UPSERT, 1, "", 0, 1);
+   checkRecord(oTrace, SYMTABLETRACE_GETLENGTH, 1, NULL, 0, 3);
+   checkRecord(oTrace, SYMTABLETRACE_CLONE, 1, NULL, 2, 1);
+   checkRecord(oTrace, SYMTABLETRACE_MAP, 1, NULL, 0, 0);
+   /* The gets made by getBinding follow the map. */
+   for (i = 0; i < 3; i++)
+   {
+      ASSURE(SymTableTrace_next(oTrace, &sRecord) == 1);
+      ASSURE(sRecord.eOp == SYMTABLETRACE_GET && sRecord.uTable == 2
+         && sRecord.uResult == 1);
+   }
+   checkRecord(oTrace, SYMTABLETRACE_REMOVE, 2, "Jeter", 0, 1);
+   /* A table made before the trace started gets a number when it is
+      first seen. */
+   checkRecord(oTrace, SYMTABLETRACE_CONTAINS, 3, "Ruth", 0, 1);
+   checkRecord(oTrace, SYMTABLETRACE_CLEAR, 1, NULL, 0, 0);
+   checkRecord(oTrace, SYMTABLETRACE_RESERVE, 1, NULL, 100, 1);
+   checkRecord(oTrace, SYMTABLETRACE_FREE, 1, NULL, 0, 0);
+   checkRecord(oTrace, SYMTABLETRACE_FREE, 2, NULL, 0, 0);
+   ASSURE(SymTableTrace_next(oTrace, &sRecord) == 0);
+   SymTableTrace_close(oTrace);
+
+   /* A trace cut short in a record is damaged from there on. The cut
+      falls after the magic number, the four bytes of the first record
+      and the first three of the second, inside its key. */
+   copyPrefix(TRACE_PATH, DAMAGED_PATH, 8 + 4 + 3);
+   oTrace = SymTableTrace_open(DAMAGED_PATH);
+   ASSURE(oTrace != NULL);
+   if (oTrace != NULL)
+   {
+      checkRecord(oTrace, SYMTABLETRACE_NEW, 1, NULL, 0, 1);
+      ASSURE(SymTableTrace_next(oTrace, &sRecord) == -1);
+      ASSURE(SymTableTrace_next(oTrace, &sRecord) == -1);
+      SymTableTrace_close(oTrace);
+   }
+
+   /* A file that is not a trace is rejected. */
+   copyPrefix(TRACE_PATH, DAMAGED_PATH, 4);
+   ASSURE(SymTableTrace_open(DAMAGED_PATH) == NULL);
+   ASSURE(SymTableTrace_open("no/such/directory/x.trace") == NULL);
+
+   ASSURE(strcmp(SymTableTrace_opName(SYMTABLETRACE_PUT), "put") == 0);
+   ASSURE(strcmp(SymTableTrace_opName(SYMTABLETRACE_CLEAR), "clear")
+      == 0);
+   ASSURE(strcmp(SymTableTrace_opName(SYMTABLETRACE_POPSCOPE),
+      "popScope") == 0);
+
+   remove(TRACE_PATH);
+   remove(DAMAGED_PATH);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test that the functions that make, copy, merge, scope, tune, save
+   and open tables are recorded, and that the calls SymTable_save,
+   SymTable_openLogged and SymTable_checkpoint make themselves are
+   not. */
+
+static void testTableFunctions(void)
+{
+   enum {BOUND = 2};
+   const char *apcKeys[2];
+   const void *apvValues[2];
+   SymTable_Allocator sAllocator;
+   SymTable_T oArrays;
+   SymTable_T oAllocated;
+   SymTable_T oBounded;
+   SymTable_T oSnapshot;
+   SymTable_T oMapped;
+   SymTable_T oLogged;
+   SymTableTrace_T oTrace;
+   SymTableTrace_Record sRecord;
+   char acCatcher[] = "Catcher";
+
+   printf("------------------------------------------------------\n");
+   printf("Testing the tracing of the other table functions.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   apcKeys[0] = "Berra";
+   apcKeys[1] = "Ford";
+   apvValues[0] = acCatcher;
+   apvValues[1] = NULL;
+   sAllocator.pfAlloc = allocateBlock;
+   sAllocator.pfFree = freeBlock;
+   sAllocator.pvContext = NULL;
+   remove(LOG_PATH);
+   remove(CHECKPOINT_PATH);
+
+   ASSURE(SymTableTrace_start(TRACE_PATH));
+   oArrays = SymTable_fromArrays(apcKeys, apvValues, 2);
+   oAllocated = SymTable_newWithAllocator(&sAllocator);
+   oBounded = SymTable_newBounded(BOUND, NULL, NULL);
+   ASSURE(oArrays != NULL && oAllocated != NULL && oBounded != NULL);
+   if (oArrays == NULL || oAllocated == NULL || oBounded == NULL)
+      exit(EXIT_FAILURE);
+   ASSURE(SymTable_enableFilter(oArrays));
+   ASSURE(SymTable_enableCache(oArrays));
+   ASSURE(SymTable_pushScope(oArrays));
+   ASSURE(SymTable_put(oArrays, "Mantle", NULL));
+   ASSURE(SymTable_popScope(oArrays));
+   ASSURE(! SymTable_popScope(oArrays));
+   ASSURE(SymTable_put(oAllocated, "Berra", NULL));
+   ASSURE(SymTable_put(oAllocated, "Mantle", NULL));
+   ASSURE(SymTable_merge(oArrays, oAllocated, keepFirst, NULL));
+   ASSURE(SymTable_merge(oArrays, oBounded, NULL, NULL));
+   oSnapshot = SymTable_snapshot(oArrays);
+   ASSURE(oSnapshot != NULL);
+   ASSURE(SymTable_save(oArrays, IMAGE_PATH));
+   oMapped = SymTable_openMapped(IMAGE_PATH);
+   ASSURE(oMapped != NULL);
+   oLogged = SymTable_openLogged(LOG_PATH);
+   ASSURE(oLogged != NULL);
+   if (oLogged != NULL)
+   {
+      ASSURE(SymTable_setLogBatch(oLogged, 4));
+      ASSURE(SymTable_put(oLogged, "Ruth", NULL));
+      ASSURE(SymTable_syncLog(oLogged));
+      ASSURE(SymTable_checkpoint(oLogged));
+      SymTable_free(oLogged);
+   }
+   SymTable_free(oMapped);
+   SymTable_free(oSnapshot);
+   SymTable_free(oArrays);
+   SymTable_free(oAllocated);
+   SymTable_free(oBounded);
+   ASSURE(SymTableTrace_stop());
+
+   oTrace = SymTableTrace_open(TRACE_PATH);
+   ASSURE(oTrace != NULL);
+   if (oTrace == NULL)
+      return;
+   checkRecord(oTrace, SYMTABLETRACE_FROMARRAYS, 1, NULL, 2, 1);
+   checkRecord(oTrace, SYMTABLETRACE_FROMARRAYSPAIR, 1, "Berra", 1, 0);
+   checkRecord(oTrace, SYMTABLETRACE_FROMARRAYSPAIR, 1, "Ford", 0, 0);
+   checkRecord(oTrace, SYMTABLETRACE_NEWWITHALLOCATOR, 2, NULL, 0, 1);
+   checkRecord(oTrace, SYMTABLETRACE_NEWBOUNDED, 3, NULL, BOUND, 1);
+   checkRecord(oTrace, SYMTABLETRACE_ENABLEFILTER, 1, NULL, 0, 1);
+   checkRecord(oTrace, SYMTABLETRACE_ENABLECACHE, 1, NULL, 0, 1);
+   checkRecord(oTrace, SYMTABLETRACE_PUSHSCOPE, 1, NULL, 0, 1);
+   checkRecord(oTrace, SYMTABLETRACE_PUT, 1, "Mantle", 0, 1);
+   checkRecord(oTrace, SYMTABLETRACE_POPSCOPE, 1, NULL, 0, 1);
+   checkRecord(oTrace, SYMTABLETRACE_POPSCOPE, 1, NULL, 0, 0);
+   checkRecord(oTrace, SYMTABLETRACE_PUT, 2, "Berra", 0, 1);
+   checkRecord(oTrace, SYMTABLETRACE_PUT, 2, "Mantle", 0, 1);
+   /* A merge records twice the number of its second table, plus 1 if
+      it was passed a combine function. */
+   checkRecord(oTrace, SYMTABLETRACE_MERGE, 1, NULL, 2 * 2 + 1, 1);
+   checkRecord(oTrace, SYMTABLETRACE_MERGE, 1, NULL, 2 * 3, 1);
+   checkRecord(oTrace, SYMTABLETRACE_SNAPSHOT, 1, NULL, 4, 1);
+   /* The save records nothing, nor do the calls it makes. */
+   checkRecord(oTrace, SYMTABLETRACE_OPENMAPPED, 5, IMAGE_PATH, 0, 1);
+   checkRecord(oTrace, SYMTABLETRACE_OPENLOGGED, 6, LOG_PATH, 0, 1);
+   checkRecord(oTrace, SYMTABLETRACE_SETLOGBATCH, 6, NULL, 4, 1);
+   checkRecord(oTrace, SYMTABLETRACE_PUT, 6, "Ruth", 0, 1);
+   checkRecord(oTrace, SYMTABLETRACE_SYNCLOG, 6, NULL, 0, 1);
+   /* The checkpoint is recorded, but not the calls it makes. */
+   checkRecord(oTrace, SYMTABLETRACE_CHECKPOINT, 6, NULL, 0, 1);
+   checkRecord(oTrace, SYMTABLETRACE_FREE, 6, NULL, 0, 0);
+   checkRecord(oTrace, SYMTABLETRACE_FREE, 5, NULL, 0, 0);
+   checkRecord(oTrace, SYMTABLETRACE_FREE, 4, NULL, 0, 0);
+   checkRecord(oTrace, SYMTABLETRACE_FREE, 1, NULL, 0, 0);
+   checkRecord(oTrace, SYMTABLETRACE_FREE, 2, NULL, 0, 0);
+   checkRecord(oTrace, SYMTABLETRACE_FREE, 3, NULL, 0, 0);
+   ASSURE(SymTableTrace_next(oTrace, &sRecord) == 0);
+   SymTableTrace_close(oTrace);
+
+   remove(TRACE_PATH);
+   remove(IMAGE_PATH);
+   remove(LOG_PATH);
+   remove(CHECKPOINT_PATH);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test that many live tables keep their numbers while others are
+   freed and made, and that a table made after another is freed gets a
+   number of its own. */
+
+static void testManyTables(void)
+{
+   enum {TABLE_COUNT = 300};
+   SymTable_T aoTables[TABLE_COUNT];
+   SymTableTrace_T oTrace;
+   SymTableTrace_Record sRecord;
+   size_t uExpected;
+   int i;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing the numbering of many traced tables.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   ASSURE(SymTableTrace_start(TRACE_PATH));
+   for (i = 0; i < TABLE_COUNT; i++)
+   {
+      aoTables[i] = SymTable_new();
+      ASSURE(aoTables[i] != NULL);
+      if (aoTables[i] == NULL)
+         exit(EXIT_FAILURE);
+   }
+   /* Every third table is freed and replaced by a new one. */
+   for (i = 0; i < TABLE_COUNT; i += 3)
+      SymTable_free(aoTables[i]);
+   for (i = 0; i < TABLE_COUNT; i += 3)
+   {
+      aoTables[i] = SymTable_new();
+      ASSURE(aoTables[i] != NULL);
+      if (aoTables[i] == NULL)
+         exit(EXIT_FAILURE);
+   }
+   for (i = 0; i < TABLE_COUNT; i++)
+      ASSURE(SymTable_getLength(aoTables[i]) == 0);
+   for (i = 0; i < TABLE_COUNT; i++)
+      SymTable_free(aoTables[i]);
+   ASSURE(SymTableTrace_stop());
+
+   oTrace = SymTableTrace_open(TRACE_PATH);
+   ASSURE(oTrace != NULL);
+   if (oTrace == NULL)
+      return;
+   for (i = 0; i < TABLE_COUNT; i++)
+      checkRecord(oTrace, SYMTABLETRACE_NEW, (size_t)i + 1, NULL, 0, 1);
+   for (i = 0; i < TABLE_COUNT; i += 3)
+      checkRecord(oTrace, SYMTABLETRACE_FREE, (size_t)i + 1, NULL, 0, 0);
+   for (i = 0; i < TABLE_COUNT; i += 3)
+      checkRecord(oTrace, SYMTABLETRACE_NEW,
+         (size_t)(TABLE_COUNT + i / 3 + 1), NULL, 0, 1);
+   for (i = 0; i < TABLE_COUNT; i++)
+   {
+      uExpected = i % 3 == 0 ? (size_t)(TABLE_COUNT + i / 3 + 1)
+         : (size_t)i + 1;
+      checkRecord(oTrace, SYMTABLETRACE_GETLENGTH, uExpected, NULL, 0, 0);
+   }
+   for (i = 0; i < TABLE_COUNT; i++)
+   {
+      uExpected = i % 3 == 0 ? (size_t)(TABLE_COUNT + i / 3 + 1)
+         : (size_t)i + 1;
+      checkRecord(oTrace, SYMTABLETRACE_FREE, uExpected, NULL, 0, 0);
+   }
+   ASSURE(SymTableTrace_next(oTrace, &sRecord) == 0);
+   SymTableTrace_close(oTrace);
+   remove(TRACE_PATH);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Put, get and remove iBindingCount keys, and return the CPU time
+   consumed. */
+
+static clock_t runWorkload(int iBindingCount)
+{
+   SymTable_T oSymTable;
+   char acKey[MAX_KEY_LENGTH];
+   clock_t iInitialClock;
+   int i;
+
+   iInitialClock = clock();
+   oSymTable = SymTable_new();
+   ASSURE(oSymTable != NULL);
+   if (oSymTable == NULL)
+      exit(EXIT_FAILURE);
+   for (i = 0; i < iBindingCount; i++)
+   {
+      sprintf(acKey, "%d", i);
+      ASSURE(SymTable_put(oSymTable, acKey, (void*)(size_t)(i + 1)));
+   }
+   for (i = 0; i < iBindingCount; i++)
+   {
+      sprintf(acKey, "%d", i);
+      ASSURE(SymTable_get(oSymTable, acKey) == (void*)(size_t)(i + 1));
+   }
+   for (i = 0; i < iBindingCount; i++)
+   {
+      sprintf(acKey, "%d", i);
+      ASSURE(SymTable_remove(oSymTable, acKey) != NULL);
+   }
+   SymTable_free(oSymTable);
+   return clock() - iInitialClock;
+}
+
+/* Run the workload of runWorkload with iBindingCount keys without and
+   with tracing, check the trace, and write to stdout the CPU time
+   consumed by each and the size of the trace. */
+
+static void testLargeTable(int iBindingCount)
+{
+   SymTableTrace_T oTrace;
+   SymTableTrace_Record sRecord;
+   clock_t iPlainClock;
+   clock_t iTracedClock;
+   size_t uRecords;
+   long lTraceBytes;
+   FILE *psFile;
+   int iStatus;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing a potentially large traced SymTable object.\n");
+   printf("No output except CPU time and memory should appear here:\n");
+   fflush(stdout);
+
+   iPlainClock = runWorkload(iBindingCount);
+   ASSURE(SymTableTrace_start(TRACE_PATH));
+   iTracedClock = runWorkload(iBindingCount);
+   ASSURE(SymTableTrace_stop());
+
+   uRecords = 0;
+   oTrace = SymTableTrace_open(TRACE_PATH);
+   ASSURE(oTrace != NULL);
+   if (oTrace != NULL)
+   {
+      while ((iStatus = SymTableTrace_next(oTrace, &sRecord)) == 1)
+         uRecords++;
+      ASSURE(iStatus == 0);
+      SymTableTrace_close(oTrace);
+   }
+   ASSURE(uRecords == 3 * (size_t)iBindingCount + 2);
+
+   lTraceBytes = 0;
+   psFile = fopen(TRACE_PATH, "rb");
+   ASSURE(psFile != NULL);
+   if (psFile != NULL)
+   {
+      fseek(psFile, 0, SEEK_END);
+      lTraceBytes = ftell(psFile);
+      fclose(psFile);
+   }
+   remove(TRACE_PATH);
+
+   printf("SymTable CPU time (%d bindings):  %f seconds\n",
+      iBindingCount, ((double)iPlainClock) / CLOCKS_PER_SEC);
+   printf("Traced SymTable CPU time (%d bindings):  %f seconds\n",
+      iBindingCount, ((double)iTracedClock) / CLOCKS_PER_SEC);
+   printf("Trace size (%lu calls):  %ld bytes\n",
+      (unsigned long)uRecords, lTraceBytes);
+   fflush(stdout);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test the tracing layer.  Write the output of the tests to stdout.
+   As always, argc is the command-line argument count, argv contains
+   the command-line arguments, and argv[0] is the name of the
+   executable binary file. argv[1] is the number of bindings to put
+   into a potentially large traced SymTable object.  Exit with
+   EXIT_FAILURE if argv[1] is missing or not numeric.  Otherwise
+   return 0. */
+
+int main(int argc, char *argv[])
+{
+   int iBindingCount;
+
+   if (argc != 2)
+   {
+      fprintf(stderr, "Usage: %s bindingcount\n", argv[0]);
+      exit(EXIT_FAILURE);
+   }
+
+   if (sscanf(argv[1], "%d", &iBindingCount) != 1)
+   {
+      fprintf(stderr, "bindingcount must be numeric\n");
+      exit(EXIT_FAILURE);
+   }
+   if (iBindingCount < 0)
+   {
+      fprintf(stderr, "bindingcount cannot be negative\n");
+      exit(EXIT_FAILURE);
+   }
+
+   testBasics();
+   testTableFunctions();
+   testManyTables();
+   testLargeTable(iBindingCount);
+
+   printf("------------------------------------------------------\n");
+   printf("End of %s.\n", argv[0]);
+   return 0;
+}